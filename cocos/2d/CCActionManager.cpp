@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
 #include "base/uthash.h"
+#include "base/CCTrace.h"
 
 NS_CC_BEGIN
 //
@@ -368,6 +369,7 @@ ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) con
 // main loop
 void ActionManager::update(float dt)
 {
+    CC_TRACE_ZONE("ActionManager::update");
     for (tHashElement *elt = _targets; elt != nullptr; )
     {
         _currentTarget = elt;
@@ -27,10 +27,14 @@
 
 #include "2d/CCClippingNode.h"
 #include "2d/CCDrawingPrimitives.h"
+#include "2d/CCDrawNode.h"
+#include "2d/CCLayer.h"
+#include "2d/CCSprite.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "base/CCDirector.h"
+#include "base/CCCamera.h"
 
 
 NS_CC_BEGIN
@@ -40,6 +44,66 @@ static GLint g_sStencilBits = -1;
 // this will allow nesting up to n ClippingNode,
 // where n is the number of bits of the stencil buffer.
 static GLint s_layer = -1;
+// number of stencil clippings visited, by clipping nodes and layouts: a clipping node only reuses the stencil
+// of its previous sibling when no other stencil was visited since
+static unsigned int s_stencilVisits = 0;
+
+// what the stencil-buffer-based clipping nodes draw in each stencil layer, recorded while the scene is visited,
+// so that a clipping node can reuse the stencil drawn by its previous sibling when it is the same
+struct StencilLayerContent
+{
+    const ClippingNode* clipper;
+    const Node* parent;
+    const Node* stencil;
+    Mat4 transform;
+    bool inverted;
+    GLfloat alphaThreshold;
+    float globalZOrder;
+    unsigned int stencilVisits;
+    unsigned int frame;
+    const Camera* camera;
+};
+static std::vector<StencilLayerContent> s_stencilLayerContents;
+// stencil layer of the clipping node being visited
+static int s_visitLayer = -1;
+
+// true when the rect, in the space of transform, stays an axis-aligned rectangle on screen
+static bool isProjectedRectAligned(const Mat4& projection, const Mat4& transform, const Rect& rect)
+{
+    Mat4 matrix = projection * transform;
+    const Vec2 corners[4] = {
+        Vec2(rect.getMinX(), rect.getMinY()),
+        Vec2(rect.getMaxX(), rect.getMinY()),
+        Vec2(rect.getMaxX(), rect.getMaxY()),
+        Vec2(rect.getMinX(), rect.getMaxY())
+    };
+
+    Vec2 points[4];
+    Vec2 minPoint(FLT_MAX, FLT_MAX);
+    Vec2 maxPoint(-FLT_MAX, -FLT_MAX);
+    for (int i = 0; i < 4; ++i)
+    {
+        Vec4 clip;
+        matrix.transformVector(Vec4(corners[i].x, corners[i].y, 0, 1), &clip);
+        if (clip.w <= 0)
+            return false;
+
+        points[i].set(clip.x / clip.w, clip.y / clip.w);
+        minPoint.x = MIN(minPoint.x, points[i].x);
+        minPoint.y = MIN(minPoint.y, points[i].y);
+        maxPoint.x = MAX(maxPoint.x, points[i].x);
+        maxPoint.y = MAX(maxPoint.y, points[i].y);
+    }
+
+    // a projected rectangle which is not aligned covers less than its bounding box
+    float area = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        area += points[i].cross(points[(i + 1) % 4]);
+    }
+    float boundingArea = (maxPoint.x - minPoint.x) * (maxPoint.y - minPoint.y);
+    return fabsf(fabsf(area) * 0.5f - boundingArea) <= boundingArea * 1e-4f;
+}
 
 static void setProgram(Node *n, GLProgram *p)
 {
@@ -55,6 +119,9 @@ ClippingNode::ClippingNode()
 : _stencil(nullptr)
 , _alphaThreshold(0.0f)
 , _inverted(false)
+, _scissorClippingEnabled(true)
+, _reuseStencilLayer(false)
+, _currentScissorEnabled(GL_FALSE)
 , _currentStencilEnabled(GL_FALSE)
 , _currentStencilWriteMask(~0)
 , _currentStencilFunc(GL_ALWAYS)
@@ -68,7 +135,7 @@ ClippingNode::ClippingNode()
 , _currentAlphaTestFunc(GL_ALWAYS)
 , _currentAlphaTestRef(1)
 {
-
+    _currentScissorBox[0] = _currentScissorBox[1] = _currentScissorBox[2] = _currentScissorBox[3] = 0;
 }
 
 ClippingNode::~ClippingNode()
@@ -231,6 +298,8 @@ void ClippingNode::drawFullScreenQuadClearStencil()
 
 void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     if(!_visible)
         return;
     
@@ -245,41 +314,90 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
 
     //Add group command
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
         
     _groupCommand.init(_globalZOrder);
     renderer->addCommand(&_groupCommand);
 
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
-    _beforeVisitCmd.init(_globalZOrder);
-    _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisit, this);
-    renderer->addCommand(&_beforeVisitCmd);
-    if (_alphaThreshold < 1)
+    // an unrotated rectangular stencil is replaced by the scissor test, it is checked against the projection
+    // of every camera the content is rendered with
+    bool scissorClipping = _scissorClippingEnabled && getScissorStencilRect(_scissorStencilRect);
+    if (scissorClipping)
     {
+        _scissorStencilTransform = _modelViewTransform * _stencil->getNodeToParentTransform();
+        scissorClipping = isProjectedRectAligned(director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION), _scissorStencilTransform, _scissorStencilRect);
+        for (const auto& camera : Camera::getVisitingCameras())
+        {
+            if (!scissorClipping)
+                break;
+            scissorClipping = isProjectedRectAligned(camera->getViewProjectionMatrix(), _scissorStencilTransform, _scissorStencilRect);
+        }
+    }
+
+    if (scissorClipping)
+    {
+        _beforeVisitCmd.init(_globalZOrder);
+        _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisitScissor, this);
+        renderer->addCommand(&_beforeVisitCmd);
+    }
+    else
+    {
+        s_visitLayer++;
+        _reuseStencilLayer = canReuseStencilLayer();
+        notifyStencilVisit();
+
+        _beforeVisitCmd.init(_globalZOrder);
+        _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisit, this);
+        renderer->addCommand(&_beforeVisitCmd);
+        // the stencil layer may already hold this stencil, drawn by the previous sibling
+        if (!_reuseStencilLayer)
+        {
+            if (_alphaThreshold < 1)
+            {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
 #else
-        // since glAlphaTest do not exists in OES, use a shader that writes
-        // pixel only if greater than an alpha threshold
-        GLProgram *program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
-        GLint alphaValueLocation = glGetUniformLocation(program->getProgram(), GLProgram::UNIFORM_NAME_ALPHA_TEST_VALUE);
-        // set our alphaThreshold
-        program->use();
-        program->setUniformLocationWith1f(alphaValueLocation, _alphaThreshold);
-        // we need to recursively apply this shader to all the nodes in the stencil node
-        // FIXME: we should have a way to apply shader to all nodes without having to do this
-        setProgram(_stencil, program);
-        
+                // since glAlphaTest do not exists in OES, use a shader that writes
+                // pixel only if greater than an alpha threshold
+                GLProgram *program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
+                GLint alphaValueLocation = glGetUniformLocation(program->getProgram(), GLProgram::UNIFORM_NAME_ALPHA_TEST_VALUE);
+                // set our alphaThreshold
+                program->use();
+                program->setUniformLocationWith1f(alphaValueLocation, _alphaThreshold);
+                // we need to recursively apply this shader to all the nodes in the stencil node
+                // FIXME: we should have a way to apply shader to all nodes without having to do this
+                setProgram(_stencil, program);
+                
 #endif
 
-    }
-    _stencil->visit(renderer, _modelViewTransform, flags);
+            }
+            _stencil->visit(renderer, _modelViewTransform, flags);
+        }
 
-    _afterDrawStencilCmd.init(_globalZOrder);
-    _afterDrawStencilCmd.func = CC_CALLBACK_0(ClippingNode::onAfterDrawStencil, this);
-    renderer->addCommand(&_afterDrawStencilCmd);
+        if (s_stencilLayerContents.size() <= (size_t)s_visitLayer)
+        {
+            s_stencilLayerContents.resize(s_visitLayer + 1);
+        }
+        StencilLayerContent& content = s_stencilLayerContents[s_visitLayer];
+        content.clipper = this;
+        content.parent = _parent;
+        content.stencil = _stencil;
+        content.transform = _modelViewTransform;
+        content.inverted = _inverted;
+        content.alphaThreshold = _alphaThreshold;
+        content.globalZOrder = _globalZOrder;
+        content.stencilVisits = s_stencilVisits;
+        content.frame = director->getTotalFrames();
+        content.camera = Camera::getVisitingCamera();
+
+        renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
+        _afterDrawStencilCmd.init(_globalZOrder);
+        _afterDrawStencilCmd.func = CC_CALLBACK_0(ClippingNode::onAfterDrawStencil, this);
+        renderer->addCommand(&_afterDrawStencilCmd);
+    }
 
     int i = 0;
-    bool visibleByCamera = isVisitableByVisitingCamera();
     
     if(!_children.empty())
     {
@@ -295,19 +413,28 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
                 break;
         }
         // self draw
-        if (visibleByCamera)
+        if (isVisitableByVisitingCamera())
             this->draw(renderer, _modelViewTransform, flags);
         
         for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
             (*it)->visit(renderer, _modelViewTransform, flags);
     }
-    else if (visibleByCamera)
+    else if (isVisitableByVisitingCamera())
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
 
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _afterVisitCmd.init(_globalZOrder);
-    _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisit, this);
+    if (scissorClipping)
+    {
+        _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisitScissor, this);
+    }
+    else
+    {
+        _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisit, this);
+        s_visitLayer--;
+    }
     renderer->addCommand(&_afterVisitCmd);
 
     renderer->popGroup();
@@ -347,16 +474,166 @@ void ClippingNode::setInverted(bool inverted)
     _inverted = inverted;
 }
 
+bool ClippingNode::isScissorClippingEnabled() const
+{
+    return _scissorClippingEnabled;
+}
+
+void ClippingNode::setScissorClippingEnabled(bool enabled)
+{
+    _scissorClippingEnabled = enabled;
+}
+
+bool ClippingNode::getScissorStencilRect(Rect& rect) const
+{
+    if (_stencil == nullptr || !_stencil->isVisible() || _inverted || _alphaThreshold < 1 || _stencil->getChildrenCount() > 0)
+    {
+        return false;
+    }
+
+    // the whole geometry of the stencil is drawn in the stencil buffer when there is no alpha test
+    if (auto sprite = dynamic_cast<Sprite*>(_stencil))
+    {
+        if (sprite->getBatchNode() != nullptr)
+            return false;
+
+        V3F_C4B_T2F_Quad quad = sprite->getQuad();
+        float minX = MIN(MIN(quad.bl.vertices.x, quad.br.vertices.x), MIN(quad.tl.vertices.x, quad.tr.vertices.x));
+        float minY = MIN(MIN(quad.bl.vertices.y, quad.br.vertices.y), MIN(quad.tl.vertices.y, quad.tr.vertices.y));
+        float maxX = MAX(MAX(quad.bl.vertices.x, quad.br.vertices.x), MAX(quad.tl.vertices.x, quad.tr.vertices.x));
+        float maxY = MAX(MAX(quad.bl.vertices.y, quad.br.vertices.y), MAX(quad.tl.vertices.y, quad.tr.vertices.y));
+        rect.setRect(minX, minY, maxX - minX, maxY - minY);
+        return true;
+    }
+    if (dynamic_cast<LayerColor*>(_stencil))
+    {
+        rect.setRect(0, 0, _stencil->getContentSize().width, _stencil->getContentSize().height);
+        return true;
+    }
+    if (auto drawNode = dynamic_cast<DrawNode*>(_stencil))
+    {
+        return drawNode->getFilledRect(rect);
+    }
+    return false;
+}
+
+GLint ClippingNode::pushStencilLayer()
+{
+    return ++s_layer;
+}
+
+void ClippingNode::popStencilLayer()
+{
+    s_layer--;
+}
+
+void ClippingNode::notifyStencilVisit()
+{
+    s_stencilVisits++;
+}
+
+bool ClippingNode::canReuseStencilLayer() const
+{
+    // commands of groups with the same non-zero global Z order aren't rendered in a stable order
+    if (_parent == nullptr || _globalZOrder != 0 || s_stencilLayerContents.size() <= (size_t)s_visitLayer)
+    {
+        return false;
+    }
+
+    const StencilLayerContent& content = s_stencilLayerContents[s_visitLayer];
+    if (content.stencil != _stencil
+        || content.parent != _parent
+        || content.inverted != _inverted
+        || content.alphaThreshold != _alphaThreshold
+        || content.globalZOrder != _globalZOrder
+        || content.stencilVisits != s_stencilVisits
+        || content.frame != Director::getInstance()->getTotalFrames()
+        || content.camera != Camera::getVisitingCamera()
+        || memcmp(content.transform.m, _modelViewTransform.m, sizeof(_modelViewTransform.m)) != 0)
+    {
+        return false;
+    }
+
+    // nothing may have been drawn between the two siblings, another node could have used the stencil buffer
+    auto& siblings = _parent->getChildren();
+    auto it = std::find(siblings.begin(), siblings.end(), this);
+    return it != siblings.begin() && it != siblings.end() && *(it - 1) == content.clipper;
+}
+
+void ClippingNode::onBeforeVisitScissor()
+{
+    // project the stencil rectangle in window coordinates with the projection of the camera being rendered
+    Mat4 matrix = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION) * _scissorStencilTransform;
+    const Vec2 corners[4] = {
+        Vec2(_scissorStencilRect.getMinX(), _scissorStencilRect.getMinY()),
+        Vec2(_scissorStencilRect.getMaxX(), _scissorStencilRect.getMinY()),
+        Vec2(_scissorStencilRect.getMaxX(), _scissorStencilRect.getMaxY()),
+        Vec2(_scissorStencilRect.getMinX(), _scissorStencilRect.getMaxY())
+    };
+
+    Vec2 minPoint(FLT_MAX, FLT_MAX);
+    Vec2 maxPoint(-FLT_MAX, -FLT_MAX);
+    for (int i = 0; i < 4; ++i)
+    {
+        Vec4 clip;
+        matrix.transformVector(Vec4(corners[i].x, corners[i].y, 0, 1), &clip);
+        minPoint.x = MIN(minPoint.x, clip.x / clip.w);
+        minPoint.y = MIN(minPoint.y, clip.y / clip.w);
+        maxPoint.x = MAX(maxPoint.x, clip.x / clip.w);
+        maxPoint.y = MAX(maxPoint.y, clip.y / clip.w);
+    }
+
+    // the viewport is not the window one when rendering into a RenderTexture
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    // round like the rasterization of the stencil would: pixels whose center is inside the rectangle
+    GLint left = (GLint)floorf(viewport[0] + (minPoint.x + 1) * 0.5f * viewport[2] + 0.5f);
+    GLint bottom = (GLint)floorf(viewport[1] + (minPoint.y + 1) * 0.5f * viewport[3] + 0.5f);
+    GLint right = (GLint)floorf(viewport[0] + (maxPoint.x + 1) * 0.5f * viewport[2] + 0.5f);
+    GLint top = (GLint)floorf(viewport[1] + (maxPoint.y + 1) * 0.5f * viewport[3] + 0.5f);
+
+    // manually save the scissor state, and intersect with the enclosing scissor rectangle
+    _currentScissorEnabled = glIsEnabled(GL_SCISSOR_TEST);
+    if (_currentScissorEnabled)
+    {
+        glGetIntegerv(GL_SCISSOR_BOX, _currentScissorBox);
+        left = MAX(left, _currentScissorBox[0]);
+        bottom = MAX(bottom, _currentScissorBox[1]);
+        right = MIN(right, _currentScissorBox[0] + _currentScissorBox[2]);
+        top = MIN(top, _currentScissorBox[1] + _currentScissorBox[3]);
+    }
+    else
+    {
+        glEnable(GL_SCISSOR_TEST);
+    }
+
+    glScissor(left, bottom, MAX(right - left, 0), MAX(top - bottom, 0));
+}
+
+void ClippingNode::onAfterVisitScissor()
+{
+    // manually restore the scissor state
+    if (_currentScissorEnabled)
+    {
+        glScissor(_currentScissorBox[0], _currentScissorBox[1], _currentScissorBox[2], _currentScissorBox[3]);
+    }
+    else
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+}
+
 void ClippingNode::onBeforeVisit()
 {
     ///////////////////////////////////
     // INIT
 
     // increment the current layer
-    s_layer++;
+    GLint layer = pushStencilLayer();
 
     // mask of the current layer (ie: for layer 3: 00000100)
-    GLint mask_layer = 0x1 << s_layer;
+    GLint mask_layer = 0x1 << layer;
     // mask of all layers less than the current (ie: for layer 3: 00000011)
     GLint mask_layer_l = mask_layer - 1;
     // mask of all layers less than or equal to the current (ie: for layer 3: 00000111)
@@ -394,6 +671,10 @@ void ClippingNode::onBeforeVisit()
     // only disabling depth buffer update should do
     glDepthMask(GL_FALSE);
 
+    // the previous sibling left the same stencil in this layer, nothing to draw
+    if (_reuseStencilLayer)
+        return;
+
     ///////////////////////////////////
     // CLEAR STENCIL BUFFER
 
@@ -446,7 +727,7 @@ void ClippingNode::onBeforeVisit()
 void ClippingNode::onAfterDrawStencil()
 {
     // restore alpha test state
-    if (_alphaThreshold < 1)
+    if (_alphaThreshold < 1 && !_reuseStencilLayer)
     {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
         // manually restore the alpha test state
@@ -497,7 +778,7 @@ void ClippingNode::onAfterVisit()
     }
 
     // we are done using this layer, decrement
-    s_layer--;
+    popStencilLayer();
 }
 
 NS_CC_END
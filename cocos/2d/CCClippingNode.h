@@ -39,6 +39,8 @@ NS_CC_BEGIN
  It draws its content (childs) clipped using a stencil.
  The stencil is an other Node that will not be drawn.
  The clipping is done using the alpha part of the stencil (adjusted with an alphaThreshold).
+ When the stencil is an unrotated rectangle (a Sprite, a LayerColor or a DrawNode filled with a rectangle),
+ the content is clipped with the scissor test instead, which doesn't draw anything in the stencil buffer.
  */
 class CC_DLL ClippingNode : public Node
 {
@@ -74,6 +76,30 @@ public:
     bool isInverted() const;
     void setInverted(bool inverted);
 
+    /** Whether rectangular, unrotated stencils are clipped with the scissor test.
+     The stencil must not be inverted, have no children and the alpha threshold must be 1.
+     Nested scissor clippings are intersected with each other.
+     This default to true.
+     */
+    bool isScissorClippingEnabled() const;
+    void setScissorClippingEnabled(bool enabled);
+
+    /** The stencil layers are shared by the clipping nodes and the stencil clipping of ui::Layout, which nest
+     in the same stencil buffer. pushStencilLayer() returns the layer to draw the stencil in, while rendering,
+     popStencilLayer() releases it.
+     * @js NA
+     * @lua NA
+     */
+    static GLint pushStencilLayer();
+    static void popStencilLayer();
+
+    /** Called while visiting a node which draws in a stencil layer: the clipping nodes visited after it
+     don't reuse the stencil of a previous sibling.
+     * @js NA
+     * @lua NA
+     */
+    static void notifyStencilVisit();
+
     // Overrides
     /**
      * @js NA
@@ -120,14 +146,34 @@ protected:
     */
     void drawFullScreenQuadClearStencil();
 
+    /** Returns true when the stencil can be replaced by the scissor test and stores its rectangle, in stencil space */
+    bool getScissorStencilRect(Rect& rect) const;
+
+    /** Returns true when the stencil layer still holds the stencil drawn by the previous sibling, at the same place.
+     Both must have a global Z order of 0, so that they render in the order they are visited, and nothing in the
+     content of the previous sibling may draw in the stencil buffer.
+     */
+    bool canReuseStencilLayer() const;
+
     Node* _stencil;
     GLfloat _alphaThreshold;
     bool    _inverted;
+    bool    _scissorClippingEnabled;
 
     //renderData and callback
     void onBeforeVisit();
     void onAfterDrawStencil();
     void onAfterVisit();
+    void onBeforeVisitScissor();
+    void onAfterVisitScissor();
+
+    // when true, the stencil is neither cleared nor drawn: the stencil layer already holds it
+    bool _reuseStencilLayer;
+
+    Rect _scissorStencilRect;
+    Mat4 _scissorStencilTransform;
+    GLboolean _currentScissorEnabled;
+    GLint _currentScissorBox[4];
 
     GLboolean _currentStencilEnabled;
     GLuint _currentStencilWriteMask;
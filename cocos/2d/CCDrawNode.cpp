@@ -34,6 +34,8 @@
 #include "2d/CCActionCatmullRom.h"
 #include "platform/CCGL.h"
 
+#include <string.h>
+
 NS_CC_BEGIN
 
 // Vec2 == CGPoint in 32-bits, but not in 64-bits (OS X)
@@ -101,6 +103,46 @@ static inline Tex2F __t(const Vec2 &v)
 	return *(Tex2F*)&v;
 }
 
+// Batched DrawNodes draw independent triangles, they all use these indices.
+// Commands keep a pointer to them until the renderer draws, so the array is allocated once,
+// large enough for any batched node, and never moves.
+static unsigned short* getBatchIndices()
+{
+    static unsigned short s_batchIndices[Renderer::VBO_SIZE];
+    static bool s_batchIndicesInitialized = false;
+    if (!s_batchIndicesInitialized)
+    {
+        for (int i = 0; i < Renderer::VBO_SIZE; ++i)
+        {
+            s_batchIndices[i] = (unsigned short)i;
+        }
+        s_batchIndicesInitialized = true;
+    }
+    return s_batchIndices;
+}
+
+// Lines were drawn 2 pixels wide with glLineWidth
+static const float BATCH_LINE_HALF_WIDTH = 1.0f;
+
+static inline void setBatchVertex(V3F_C4B_T2F* vertex, const Vec3& position, const Color4B& color)
+{
+    vertex->vertices = position;
+    vertex->colors = color;
+    vertex->texCoords = Tex2F(0.0f, 0.0f);
+}
+
+// Two triangles for a quad, the shader fills it when the texture coordinates are 0
+static inline V3F_C4B_T2F* addBatchQuad(V3F_C4B_T2F* vertex, const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d, const Color4B& colorAB, const Color4B& colorCD)
+{
+    setBatchVertex(vertex++, a, colorAB);
+    setBatchVertex(vertex++, b, colorAB);
+    setBatchVertex(vertex++, c, colorCD);
+    setBatchVertex(vertex++, a, colorAB);
+    setBatchVertex(vertex++, c, colorCD);
+    setBatchVertex(vertex++, d, colorCD);
+    return vertex;
+}
+
 // implementation of DrawNode
 
 DrawNode::DrawNode()
@@ -124,6 +166,7 @@ DrawNode::DrawNode()
 , _bufferCountGLLine(0)
 , _bufferGLLine(nullptr)
 , _dirtyGLLine(false)
+, _batched(true)
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 }
@@ -289,8 +332,110 @@ bool DrawNode::init()
     return true;
 }
 
+void DrawNode::setBatched(bool batched)
+{
+    _batched = batched;
+
+    // the GPU buffers weren't updated while batched
+    _dirty = true;
+    _dirtyGLLine = true;
+    _dirtyGLPoint = true;
+}
+
+bool DrawNode::updateBatch(const Mat4 &transform)
+{
+    // each line and each point becomes two triangles
+    int vertexCount = _bufferCount + (_bufferCountGLLine / 2 + _bufferCountGLPoint) * 6;
+    if (vertexCount == 0 || vertexCount >= Renderer::VBO_SIZE || getGLProgramState()->getVertexAttribsFlags() != 0)
+    {
+        return false;
+    }
+
+    bool dirty = _dirty || _dirtyGLLine || _dirtyGLPoint;
+    if (!dirty && memcmp(_batchTransform.m, transform.m, sizeof(transform.m)) == 0)
+    {
+        return true;
+    }
+
+    _batchVertices.resize(vertexCount);
+    V3F_C4B_T2F* vertex = _batchVertices.data();
+
+    for (int i = 0; i < _bufferCount; ++i, ++vertex)
+    {
+        const V2F_C4B_T2F& source = _buffer[i];
+        vertex->vertices.set(source.vertices.x, source.vertices.y, 0.0f);
+        transform.transformPoint(&vertex->vertices);
+        vertex->colors = source.colors;
+        vertex->texCoords = source.texCoords;
+    }
+
+    float halfSize = _pointSize * 0.5f;
+    for (int i = 0; i < _bufferCountGLPoint; ++i)
+    {
+        const V2F_C4B_T2F& source = _bufferGLPoint[i];
+        Vec3 p(source.vertices.x, source.vertices.y, 0.0f);
+        transform.transformPoint(&p);
+        vertex = addBatchQuad(vertex,
+                              Vec3(p.x - halfSize, p.y - halfSize, p.z),
+                              Vec3(p.x + halfSize, p.y - halfSize, p.z),
+                              Vec3(p.x + halfSize, p.y + halfSize, p.z),
+                              Vec3(p.x - halfSize, p.y + halfSize, p.z),
+                              source.colors, source.colors);
+    }
+
+    for (int i = 0; i + 1 < _bufferCountGLLine; i += 2)
+    {
+        const V2F_C4B_T2F& from = _bufferGLLine[i];
+        const V2F_C4B_T2F& to = _bufferGLLine[i + 1];
+        Vec3 a(from.vertices.x, from.vertices.y, 0.0f);
+        Vec3 b(to.vertices.x, to.vertices.y, 0.0f);
+        transform.transformPoint(&a);
+        transform.transformPoint(&b);
+
+        // widened in world space, so that lines keep their width whatever the node's scale
+        Vec2 normal = Vec2(b.x - a.x, b.y - a.y).getPerp();
+        normal.normalize();
+        normal *= BATCH_LINE_HALF_WIDTH;
+
+        vertex = addBatchQuad(vertex,
+                              Vec3(a.x - normal.x, a.y - normal.y, a.z),
+                              Vec3(a.x + normal.x, a.y + normal.y, a.z),
+                              Vec3(b.x + normal.x, b.y + normal.y, b.z),
+                              Vec3(b.x - normal.x, b.y - normal.y, b.z),
+                              from.colors, to.colors);
+    }
+
+    _batchTransform = transform;
+    _dirty = false;
+    _dirtyGLLine = false;
+    _dirtyGLPoint = false;
+    return true;
+}
+
 void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
+    if (_batched && updateBatch(transform))
+    {
+        // the vertices are already transformed
+        TrianglesCommand::Triangles triangles;
+        triangles.verts = _batchVertices.data();
+        triangles.indices = getBatchIndices();
+        triangles.vertCount = _batchVertices.size();
+        triangles.indexCount = _batchVertices.size();
+
+        _trianglesCommand.init(_globalZOrder, 0, getGLProgramState(), _blendFunc, triangles, Mat4::IDENTITY);
+        renderer->addCommand(&_trianglesCommand);
+        return;
+    }
+
+    if (_batched)
+    {
+        // too large to be batched this frame, the GPU buffers weren't kept up to date
+        _dirty = true;
+        _dirtyGLLine = true;
+        _dirtyGLPoint = true;
+    }
+
     if(_bufferCount)
     {
         _customCommand.init(_globalZOrder);
@@ -398,7 +543,11 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t flags)
     glProgram->setUniformLocationWith1f(glProgram->getUniformLocation("u_pointSize"), _pointSize);
     
     glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
+    if (_dirtyGLPoint)
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
+        _dirtyGLPoint = false;
+    }
 
     GL::enableVertexAttribs( GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_COLOR);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
@@ -413,6 +562,8 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t flags)
 
 void DrawNode::drawPoint(const Vec2& position, const float pointSize, const Color4F &color)
 {
+    ensureCapacityGLPoint(1);
+    
     V2F_C4B_T2F *point = (V2F_C4B_T2F*)(_bufferGLPoint + _bufferCountGLPoint);
     V2F_C4B_T2F a = {position, Color4B(color), Tex2F(0.0, 0.0) };
     *point = a;
@@ -421,6 +572,7 @@ void DrawNode::drawPoint(const Vec2& position, const float pointSize, const Colo
     _pointColor = color;
     
     _bufferCountGLPoint += 1;
+    _dirtyGLPoint = true;
 }
 
 void DrawNode::drawPoints(const Vec2 *position, unsigned int numberOfPoints, const Color4F &color)
@@ -438,6 +590,7 @@ void DrawNode::drawPoints(const Vec2 *position, unsigned int numberOfPoints, con
     _pointColor = color;
     
     _bufferCountGLPoint += numberOfPoints;
+    _dirtyGLPoint = true;
 }
 
 void DrawNode::drawLine(const Vec2 &origin, const Vec2 &destination, const Color4F &color)
@@ -499,6 +652,7 @@ void DrawNode::drawPoly(const Vec2 *poli, unsigned int numberOfPoints, bool clos
     }
     
     _bufferCountGLLine += vertext_count;
+    _dirtyGLLine = true;
 }
 
 void DrawNode::drawCircle(const Vec2& center, float radius, float angle, unsigned int segments, bool drawLineToCenter, float scaleX, float scaleY, const Color4F &color)
@@ -921,6 +1075,83 @@ void DrawNode::clear()
     _dirtyGLPoint = true;
 }
 
+// true when the interiors of the triangles a and b overlap by more than epsilon along every edge normal
+static bool trianglesOverlap(const V2F_C4B_T2F* a, const V2F_C4B_T2F* b, float epsilon)
+{
+    const V2F_C4B_T2F* triangles[2] = { a, b };
+    for (int t = 0; t < 2; ++t)
+    {
+        for (int edge = 0; edge < 3; ++edge)
+        {
+            Vec2 axis = v2fperp(v2fsub(triangles[t][(edge + 1) % 3].vertices, triangles[t][edge].vertices));
+            if (axis.isZero())
+                continue;
+            axis.normalize();
+
+            float minA = FLT_MAX, maxA = -FLT_MAX, minB = FLT_MAX, maxB = -FLT_MAX;
+            for (int i = 0; i < 3; ++i)
+            {
+                float projection = v2fdot(a[i].vertices, axis);
+                minA = MIN(minA, projection);
+                maxA = MAX(maxA, projection);
+                projection = v2fdot(b[i].vertices, axis);
+                minB = MIN(minB, projection);
+                maxB = MAX(maxB, projection);
+            }
+            if (MIN(maxA, maxB) - MAX(minA, minB) <= epsilon)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool DrawNode::getFilledRect(Rect& rect) const
+{
+    // the overlap test is quadratic, rectangles drawn with a border are made of 10 triangles
+    static const int MAX_TRIANGLES = 16;
+    int triangleCount = _bufferCount / 3;
+    if (triangleCount == 0 || triangleCount > MAX_TRIANGLES || _bufferCountGLPoint > 0 || _bufferCountGLLine > 0)
+    {
+        return false;
+    }
+
+    Vec2 minPoint(FLT_MAX, FLT_MAX);
+    Vec2 maxPoint(-FLT_MAX, -FLT_MAX);
+    float area = 0;
+    for (int i = 0; i < triangleCount; ++i)
+    {
+        const V2F_C4B_T2F* triangle = _buffer + i * 3;
+        for (int j = 0; j < 3; ++j)
+        {
+            minPoint.x = MIN(minPoint.x, triangle[j].vertices.x);
+            minPoint.y = MIN(minPoint.y, triangle[j].vertices.y);
+            maxPoint.x = MAX(maxPoint.x, triangle[j].vertices.x);
+            maxPoint.y = MAX(maxPoint.y, triangle[j].vertices.y);
+        }
+        area += fabsf((triangle[1].vertices - triangle[0].vertices).cross(triangle[2].vertices - triangle[0].vertices)) * 0.5f;
+    }
+
+    // triangles which don't overlap and whose areas add up to the area of their bounding box fill it
+    float boundingArea = (maxPoint.x - minPoint.x) * (maxPoint.y - minPoint.y);
+    if (boundingArea <= 0 || fabsf(area - boundingArea) > boundingArea * 1e-4f)
+    {
+        return false;
+    }
+
+    float epsilon = MAX(maxPoint.x - minPoint.x, maxPoint.y - minPoint.y) * 1e-4f;
+    for (int i = 0; i < triangleCount; ++i)
+    {
+        for (int j = i + 1; j < triangleCount; ++j)
+        {
+            if (trianglesOverlap(_buffer + i * 3, _buffer + j * 3, epsilon))
+                return false;
+        }
+    }
+
+    rect.setRect(minPoint.x, minPoint.y, maxPoint.x - minPoint.x, maxPoint.y - minPoint.y);
+    return true;
+}
+
 const BlendFunc& DrawNode::getBlendFunc() const
 {
     return _blendFunc;
@@ -34,6 +34,7 @@
 #include "2d/CCNode.h"
 #include "base/ccTypes.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "math/CCMath.h"
 
 NS_CC_BEGIN
@@ -109,6 +110,12 @@ public:
     
     /** Clear the geometry in the node's buffer. */
     void clear();
+
+    /** Returns true when the node only holds triangles which fill an axis-aligned rectangle without overlapping,
+     * like the geometry of drawSolidRect(), and stores that rectangle, in node space, in rect.
+     * ClippingNode uses it to clip with the scissor test instead of the stencil buffer.
+     */
+    bool getFilledRect(Rect& rect) const;
     /**
     * @js NA
     * @lua NA
@@ -123,6 +130,18 @@ public:
     */
     void setBlendFunc(const BlendFunc &blendFunc);
 
+    /**
+     * When batched, the geometry is transformed on the CPU and drawn with a TrianglesCommand,
+     * so that consecutive DrawNodes with the same shader and blend function share draw calls.
+     * Lines and points are turned into triangles. The vertices are only transformed again when
+     * the node moves or its geometry changes.
+     * Disable it for large geometry which doesn't change: the node then keeps its vertices in
+     * its own GPU buffers, only uploaded when they change, and draws them with its own commands.
+     * Geometry too large for the renderer's batch is always drawn that way. Default is true.
+     */
+    void setBatched(bool batched);
+    bool isBatched() const { return _batched; }
+
     void onDraw(const Mat4 &transform, uint32_t flags);
     void onDrawGLLine(const Mat4 &transform, uint32_t flags);
     void onDrawGLPoint(const Mat4 &transform, uint32_t flags);
@@ -139,6 +158,7 @@ protected:
     void ensureCapacity(int count);
     void ensureCapacityGLPoint(int count);
     void ensureCapacityGLLine(int count);
+    bool updateBatch(const Mat4 &transform);
 
     GLuint      _vao;
     GLuint      _vbo;
@@ -170,6 +190,11 @@ protected:
     bool        _dirtyGLPoint;
     bool        _dirtyGLLine;
 
+    bool        _batched;
+    TrianglesCommand _trianglesCommand;
+    std::vector<V3F_C4B_T2F> _batchVertices;
+    Mat4        _batchTransform;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(DrawNode);
 };
@@ -33,9 +33,11 @@
 #include "renderer/CCRenderer.h"
 #include "renderer/ccGLStateCache.h"
 #include "base/CCDirector.h"
+#include "base/CCCamera.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventCustom.h"
+#include "base/CCTrace.h"
 
 #include "deprecated/CCString.h"
 
@@ -809,7 +811,7 @@ void Label::setFontScale(float fontScale)
 
 void Label::onDraw(const Mat4& transform, bool transformUpdated)
 {
-    CC_PROFILER_START("Label - draw");
+    CC_TRACE_ZONE("Label::onDraw");
 
     // Optimization: Fast Dispatch
     if( _batchNodes.size() == 1 && _textureAtlas->getTotalQuads() == 0 )
@@ -850,8 +852,6 @@ void Label::onDraw(const Mat4& transform, bool transformUpdated)
     {
         batchNode->getTextureAtlas()->drawQuads();
     }
-
-    CC_PROFILER_STOP("Label - draw");
 }
 
 void Label::drawShadowWithoutBlur()
@@ -877,8 +877,8 @@ void Label::drawShadowWithoutBlur()
 
 void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
-    // Don't do calculate the culling if the transform was not updated
-    bool transformUpdated = flags & FLAGS_TRANSFORM_DIRTY;
+    // Don't do calculate the culling if the transform and the cameras were not updated
+    bool transformUpdated = flags & (FLAGS_TRANSFORM_DIRTY | FLAGS_CAMERA_DIRTY);
     _insideBounds = transformUpdated ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
 
     if(_insideBounds) {
@@ -1051,6 +1051,8 @@ void Label::drawTextSprite(Renderer *renderer, uint32_t parentFlags)
 
 void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     if (! _visible || _originalUTF8String.empty() || !isVisitableByVisitingCamera())
     {
         return;
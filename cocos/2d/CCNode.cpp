@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCCamera.h"
+#include "base/CCTrace.h"
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
@@ -218,6 +219,13 @@ void Node::cleanup()
     this->unscheduleAllSelectors();
 
 #if CC_ENABLE_SCRIPT_BINDING
+    // the update was unscheduled with the selectors, its handler goes with it
+    if (_updateScriptHandler)
+    {
+        ScriptEngineManager::getInstance()->getScriptEngine()->removeScriptHandler(_updateScriptHandler);
+        _updateScriptHandler = 0;
+    }
+
     if ( _scriptType != kScriptTypeNone)
     {
         int action = kNodeOnCleanup;
@@ -1238,6 +1246,11 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
 
 bool Node::isVisitableByVisitingCamera() const
 {
+    if (!Camera::getVisitingCameras().empty())
+    {
+        return Camera::selectVisitingCameras(_cameraMask);
+    }
+
     auto camera = Camera::getVisitingCamera();
     bool visibleByCamera = camera ? (unsigned short)camera->getCameraFlag() & _cameraMask : true;
     return visibleByCamera;
@@ -1251,6 +1264,10 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
         return;
     }
 
+    // gives the camera selection back to the parent, which may draw itself after visiting its children
+    Camera::SelectionScope cameraSelection;
+
+    CC_TRACE_ZONE("Node::visit");
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
 
     // IMPORTANT:
@@ -1259,8 +1276,6 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     Director* director = Director::getInstance();
     director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
-    
-    bool visibleByCamera = isVisitableByVisitingCamera();
 
     int i = 0;
 
@@ -1278,13 +1293,13 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
                 break;
         }
         // self draw
-        if (visibleByCamera)
+        if (isVisitableByVisitingCamera())
             this->draw(renderer, _modelViewTransform, flags);
 
         for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
             (*it)->visit(renderer, _modelViewTransform, flags);
     }
-    else if (visibleByCamera)
+    else if (isVisitableByVisitingCamera())
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
@@ -1617,7 +1632,7 @@ void Node::pauseSchedulerAndActions()
 void Node::update(float fDelta)
 {
 #if CC_ENABLE_SCRIPT_BINDING
-    if (0 != _updateScriptHandler)
+    if (0 != _updateScriptHandler && !_scheduler->queueScriptUpdateHandler(_updateScriptHandler, this))
     {
         //only lua use
         SchedulerScriptData data(_updateScriptHandler,fDelta);
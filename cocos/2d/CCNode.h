@@ -107,6 +107,8 @@ public:
     enum {
         FLAGS_TRANSFORM_DIRTY = (1 << 0),
         FLAGS_CONTENT_SIZE_DIRTY = (1 << 1),
+        // a camera of the scene moved, what was culled has to be checked again
+        FLAGS_CAMERA_DIRTY = (1 << 2),
 
         FLAGS_DIRTY_MASK = (FLAGS_TRANSFORM_DIRTY | FLAGS_CONTENT_SIZE_DIRTY),
     };
@@ -989,6 +991,8 @@ public:
 
     /**
      * Schedules for lua script.
+     * When Scheduler::setScriptUpdateBatchingEnabled is on, the handler is called together with
+     * the other lua 'update' handlers of the same priority, after the native updates of that priority.
      * @js NA
      */
     void scheduleUpdateWithPriorityLua(int handler, int priority);
@@ -1577,7 +1581,8 @@ protected:
     bool doEnumerate(std::string name, std::function<bool (Node *)> callback) const;
     bool doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const;
     
-    //check whether this camera mask is visible by the current visiting camera
+    //check whether this camera mask is visible by the current visiting camera.
+    //when the scene is visited once for all its cameras, it also selects the cameras the next commands are rendered by, so call it right before drawing
     bool isVisitableByVisitingCamera() const;
     
 #if CC_USE_PHYSICS
@@ -1698,6 +1703,9 @@ protected:
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
     
+    // creates the nodes of its instances without autoreleasing them
+    friend class Prefab;
+    
 #if CC_USE_PHYSICS
     friend class Layer;
 #endif //CC_USTPS
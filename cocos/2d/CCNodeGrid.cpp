@@ -25,6 +25,7 @@
 #include "2d/CCNodeGrid.h"
 #include "2d/CCGrid.h"
 #include "renderer/CCRenderer.h"
+#include "base/CCCamera.h"
 
 NS_CC_BEGIN
 
@@ -80,17 +81,21 @@ void NodeGrid::onGridEndDraw()
 
 void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     // quick return if not visible. children won't be drawn.
     if (!_visible)
     {
         return;
     }
     
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _groupCommand.init(_globalZOrder);
     renderer->addCommand(&_groupCommand);
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
     bool dirty = (parentFlags & FLAGS_TRANSFORM_DIRTY) || _transformUpdated;
+    uint32_t flags = (dirty ? FLAGS_TRANSFORM_DIRTY : 0) | (parentFlags & FLAGS_CAMERA_DIRTY);
     if(dirty)
         _modelViewTransform = this->transform(parentTransform);
     _transformUpdated = false;
@@ -118,11 +123,10 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t p
 
     if(_gridTarget)
     {
-        _gridTarget->visit(renderer, _modelViewTransform, dirty);
+        _gridTarget->visit(renderer, _modelViewTransform, flags);
     }
     
     int i = 0;
-    bool visibleByCamera = isVisitableByVisitingCamera();
 
     if(!_children.empty())
     {
@@ -133,21 +137,21 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t p
             auto node = _children.at(i);
 
             if ( node && node->getLocalZOrder() < 0 )
-                node->visit(renderer, _modelViewTransform, dirty);
+                node->visit(renderer, _modelViewTransform, flags);
             else
                 break;
         }
         // self draw,currently we have nothing to draw on NodeGrid, so there is no need to add render command
-        if (visibleByCamera)
-            this->draw(renderer, _modelViewTransform, dirty);
+        if (isVisitableByVisitingCamera())
+            this->draw(renderer, _modelViewTransform, flags);
 
         for(auto it=_children.cbegin()+i; it != _children.cend(); ++it) {
-            (*it)->visit(renderer, _modelViewTransform, dirty);
+            (*it)->visit(renderer, _modelViewTransform, flags);
         }
     }
-    else if (visibleByCamera)
+    else if (isVisitableByVisitingCamera())
     {
-        this->draw(renderer, _modelViewTransform, dirty);
+        this->draw(renderer, _modelViewTransform, flags);
     }
     
     // FIX ME: Why need to set _orderOfArrival to 0??
@@ -160,6 +164,7 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t p
         director->setProjection(beforeProjectionType);
     }
 
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _gridEndCommand.init(_globalZOrder);
     _gridEndCommand.func = CC_CALLBACK_0(NodeGrid::onGridEndDraw, this);
     renderer->addCommand(&_gridEndCommand);
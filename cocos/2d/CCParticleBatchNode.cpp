@@ -36,6 +36,8 @@
 #include "renderer/CCQuadCommand.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCTextureAtlas.h"
+#include "base/CCCamera.h"
+#include "base/CCTrace.h"
 #include "deprecated/CCString.h"
 
 NS_CC_BEGIN
@@ -114,6 +116,8 @@ bool ParticleBatchNode::initWithFile(const std::string& fileImage, int capacity)
 // Don't call visit on it's children
 void ParticleBatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     // CAREFUL:
     // This visit is almost identical to Node#visit
     // with the exception that it doesn't call visit on it's children
@@ -396,7 +400,7 @@ void ParticleBatchNode::removeAllChildrenWithCleanup(bool doCleanup)
 
 void ParticleBatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
-    CC_PROFILER_START("CCParticleBatchNode - draw");
+    CC_TRACE_ZONE("ParticleBatchNode::draw");
 
     if( _textureAtlas->getTotalQuads() == 0 )
     {
@@ -410,7 +414,6 @@ void ParticleBatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t
                        _textureAtlas,
                        _modelViewTransform);
     renderer->addCommand(&_batchCommand);
-    CC_PROFILER_STOP("CCParticleBatchNode - draw");
 }
 
 
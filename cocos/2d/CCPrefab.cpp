@@ -0,0 +1,401 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCPrefab.h"
+
+#include <typeinfo>
+
+#include "2d/CCNode.h"
+#include "2d/CCSprite.h"
+#include "2d/CCSpriteFrame.h"
+#include "base/CCEventDispatcher.h"
+#include "renderer/CCGLProgramState.h"
+
+NS_CC_BEGIN
+
+Prefab* Prefab::create(Node* node)
+{
+    Prefab* ret = new (std::nothrow) Prefab();
+    if (ret && ret->init(node))
+    {
+        ret->autorelease();
+    }
+    else
+    {
+        CC_SAFE_DELETE(ret);
+    }
+    return ret;
+}
+
+Prefab::Prefab()
+: _cursor(0)
+{
+}
+
+Prefab::~Prefab()
+{
+    for (auto instance : _instances)
+    {
+        for (auto node : instance->nodes)
+        {
+            node->release();
+        }
+        delete instance;
+    }
+
+    for (auto& nodeTemplate : _templates)
+    {
+        CC_SAFE_RELEASE(nodeTemplate.glProgramState);
+        CC_SAFE_RELEASE(nodeTemplate.spriteFrame);
+    }
+}
+
+bool Prefab::init(Node* node)
+{
+    CCASSERT(node, "node can't be null");
+
+    captureNode(node, -1);
+
+    for (const auto& nodeTemplate : _templates)
+    {
+        if (nodeTemplate.parent == -2)
+        {
+            CCLOG("Prefab: only Node and Sprite objects can be captured");
+            return false;
+        }
+    }
+    return true;
+}
+
+void Prefab::captureNode(Node* node, int parent)
+{
+    _templates.push_back(NodeTemplate());
+    NodeTemplate& nodeTemplate = _templates.back();
+
+    // subclasses may have state which isn't captured, they are refused
+    const std::type_info& type = typeid(*node);
+    Sprite* sprite = (type == typeid(Sprite)) ? static_cast<Sprite*>(node) : nullptr;
+
+    nodeTemplate.isSprite = (sprite != nullptr);
+    nodeTemplate.parent = (sprite || type == typeid(Node)) ? parent : -2;
+    nodeTemplate.childrenCount = node->getChildrenCount();
+    nodeTemplate.position = node->getPosition();
+    nodeTemplate.positionZ = node->getPositionZ();
+    nodeTemplate.scaleX = node->getScaleX();
+    nodeTemplate.scaleY = node->getScaleY();
+    nodeTemplate.scaleZ = node->getScaleZ();
+    nodeTemplate.rotationSkewX = node->getRotationSkewX();
+    nodeTemplate.rotationSkewY = node->getRotationSkewY();
+    nodeTemplate.skewX = node->getSkewX();
+    nodeTemplate.skewY = node->getSkewY();
+    nodeTemplate.anchorPoint = node->getAnchorPoint();
+    nodeTemplate.ignoreAnchorPointForPosition = node->isIgnoreAnchorPointForPosition();
+    nodeTemplate.contentSize = node->getContentSize();
+    nodeTemplate.visible = node->isVisible();
+    nodeTemplate.tag = node->getTag();
+    nodeTemplate.name = node->getName();
+    nodeTemplate.localZOrder = node->getLocalZOrder();
+    nodeTemplate.globalZOrder = node->getGlobalZOrder();
+    nodeTemplate.color = node->getColor();
+    nodeTemplate.opacity = node->getOpacity();
+    nodeTemplate.cascadeColorEnabled = node->isCascadeColorEnabled();
+    nodeTemplate.cascadeOpacityEnabled = node->isCascadeOpacityEnabled();
+    nodeTemplate.cameraMask = node->getCameraMask();
+    nodeTemplate.glProgramState = node->getGLProgramState();
+    CC_SAFE_RETAIN(nodeTemplate.glProgramState);
+
+    nodeTemplate.spriteFrame = nullptr;
+    nodeTemplate.flippedX = false;
+    nodeTemplate.flippedY = false;
+    nodeTemplate.blendFunc = BlendFunc::DISABLE;
+    if (sprite)
+    {
+        if (sprite->getTexture())
+        {
+            nodeTemplate.spriteFrame = sprite->getSpriteFrame();
+            CC_SAFE_RETAIN(nodeTemplate.spriteFrame);
+        }
+        nodeTemplate.flippedX = sprite->isFlippedX();
+        nodeTemplate.flippedY = sprite->isFlippedY();
+        nodeTemplate.blendFunc = sprite->getBlendFunc();
+    }
+
+    // the reference is invalidated by the children's push_back
+    int index = (int)_templates.size() - 1;
+    for (auto child : node->getChildren())
+    {
+        captureNode(child, index);
+    }
+}
+
+void Prefab::applyTemplate(const NodeTemplate& nodeTemplate, Node* node)
+{
+    if (nodeTemplate.isSprite)
+    {
+        Sprite* sprite = static_cast<Sprite*>(node);
+        if (nodeTemplate.spriteFrame)
+        {
+            sprite->setSpriteFrame(nodeTemplate.spriteFrame);
+        }
+        sprite->setFlippedX(nodeTemplate.flippedX);
+        sprite->setFlippedY(nodeTemplate.flippedY);
+        sprite->setBlendFunc(nodeTemplate.blendFunc);
+    }
+
+    node->setPosition(nodeTemplate.position);
+    node->setPositionZ(nodeTemplate.positionZ);
+    node->setScaleX(nodeTemplate.scaleX);
+    node->setScaleY(nodeTemplate.scaleY);
+    node->setScaleZ(nodeTemplate.scaleZ);
+    node->setRotationSkewX(nodeTemplate.rotationSkewX);
+    node->setRotationSkewY(nodeTemplate.rotationSkewY);
+    node->setSkewX(nodeTemplate.skewX);
+    node->setSkewY(nodeTemplate.skewY);
+    node->setAnchorPoint(nodeTemplate.anchorPoint);
+    node->ignoreAnchorPointForPosition(nodeTemplate.ignoreAnchorPointForPosition);
+    node->setContentSize(nodeTemplate.contentSize);
+    node->setVisible(nodeTemplate.visible);
+    node->setTag(nodeTemplate.tag);
+    node->setName(nodeTemplate.name);
+    node->setLocalZOrder(nodeTemplate.localZOrder);
+    node->setGlobalZOrder(nodeTemplate.globalZOrder);
+    node->setCascadeColorEnabled(nodeTemplate.cascadeColorEnabled);
+    node->setCascadeOpacityEnabled(nodeTemplate.cascadeOpacityEnabled);
+    node->setColor(nodeTemplate.color);
+    node->setOpacity(nodeTemplate.opacity);
+    node->setCameraMask(nodeTemplate.cameraMask, false);
+    if (nodeTemplate.glProgramState && node->getGLProgramState() != nodeTemplate.glProgramState)
+    {
+        node->setGLProgramState(nodeTemplate.glProgramState);
+    }
+}
+
+Prefab::Instance* Prefab::createInstance()
+{
+    Instance* instance = new (std::nothrow) Instance();
+    instance->nodes.reserve(_templates.size());
+
+    for (const auto& nodeTemplate : _templates)
+    {
+        Node* node = nullptr;
+        if (nodeTemplate.isSprite)
+        {
+            Sprite* sprite = new (std::nothrow) Sprite();
+            if (nodeTemplate.spriteFrame)
+                sprite->initWithSpriteFrame(nodeTemplate.spriteFrame);
+            else
+                sprite->init();
+            node = sprite;
+        }
+        else
+        {
+            node = new (std::nothrow) Node();
+            node->init();
+        }
+
+        applyTemplate(nodeTemplate, node);
+        if (nodeTemplate.parent >= 0)
+        {
+            instance->nodes[nodeTemplate.parent]->addChild(node, nodeTemplate.localZOrder);
+        }
+        instance->nodes.push_back(node);
+    }
+
+    _instances.push_back(instance);
+    return instance;
+}
+
+bool Prefab::isFree(const Instance& instance) const
+{
+    // only the prefab retains the root
+    Node* root = instance.nodes[0];
+    if (root->getReferenceCount() != 1 || root->getParent())
+        return false;
+
+    // and the other nodes are only retained by the prefab and their captured parent, if they still have it
+    for (size_t i = 1; i < _templates.size(); ++i)
+    {
+        Node* node = instance.nodes[i];
+        Node* parent = node->getParent();
+        if (parent == instance.nodes[_templates[i].parent])
+        {
+            if (node->getReferenceCount() != 2)
+                return false;
+        }
+        else if (parent || node->getReferenceCount() != 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Prefab::resetInstance(Instance& instance)
+{
+    Node* root = instance.nodes[0];
+    root->cleanup();
+
+    for (size_t i = 0; i < _templates.size(); ++i)
+    {
+        const NodeTemplate& nodeTemplate = _templates[i];
+        Node* node = instance.nodes[i];
+
+        // removed children weren't cleaned up with the root
+        if (i > 0 && !node->getParent())
+        {
+            node->cleanup();
+        }
+        node->getEventDispatcher()->removeEventListenersForTarget(node);
+
+        // the children are added back below, the nodes come before their children
+        if (node->getChildrenCount() != nodeTemplate.childrenCount)
+        {
+            node->removeAllChildrenWithCleanup(true);
+        }
+        if (nodeTemplate.parent >= 0)
+        {
+            Node* parent = instance.nodes[nodeTemplate.parent];
+            if (node->getParent() != parent)
+            {
+                parent->addChild(node, nodeTemplate.localZOrder);
+            }
+        }
+
+        node->setUserData(nullptr);
+        node->setUserObject(nullptr);
+        applyTemplate(nodeTemplate, node);
+    }
+}
+
+Prefab::Instance* Prefab::findFreeInstance()
+{
+    // from where the last free instance was found, the ones before were handed out recently
+    size_t count = _instances.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t index = (_cursor + i) % count;
+        if (isFree(*_instances[index]))
+        {
+            _cursor = index + 1;
+            resetInstance(*_instances[index]);
+            return _instances[index];
+        }
+    }
+    return nullptr;
+}
+
+Node* Prefab::instantiate()
+{
+    Instance* instance = findFreeInstance();
+    if (!instance)
+    {
+        instance = createInstance();
+    }
+
+    Node* root = instance->nodes[0];
+    root->retain();
+    root->autorelease();
+    return root;
+}
+
+void Prefab::instantiate(int count, Node* parent, std::vector<Node*>* instances)
+{
+    if (instances)
+    {
+        instances->reserve(instances->size() + count);
+    }
+
+    // the instances handed out below can't become free before this returns,
+    // once none is free the next ones are created without looking again
+    bool findFree = true;
+    for (int i = 0; i < count; ++i)
+    {
+        Instance* instance = findFree ? findFreeInstance() : nullptr;
+        if (!instance)
+        {
+            findFree = false;
+            instance = createInstance();
+        }
+
+        Node* root = instance->nodes[0];
+        if (parent)
+        {
+            parent->addChild(root);
+        }
+        else
+        {
+            root->retain();
+            root->autorelease();
+        }
+
+        if (instances)
+        {
+            instances->push_back(root);
+        }
+    }
+}
+
+void Prefab::reserve(int count)
+{
+    for (ssize_t free = getFreeInstanceCount(); free < count; ++free)
+    {
+        createInstance();
+    }
+}
+
+ssize_t Prefab::getFreeInstanceCount() const
+{
+    ssize_t count = 0;
+    for (auto instance : _instances)
+    {
+        if (isFree(*instance))
+            ++count;
+    }
+    return count;
+}
+
+void Prefab::purge()
+{
+    auto iter = _instances.begin();
+    while (iter != _instances.end())
+    {
+        Instance* instance = *iter;
+        if (isFree(*instance))
+        {
+            for (auto node : instance->nodes)
+            {
+                node->release();
+            }
+            delete instance;
+            iter = _instances.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+    _cursor = 0;
+}
+
+NS_CC_END
@@ -0,0 +1,151 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCPREFAB_H__
+#define __CCPREFAB_H__
+
+#include <string>
+#include <vector>
+
+#include "base/CCRef.h"
+#include "base/ccTypes.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+class Node;
+class SpriteFrame;
+class GLProgramState;
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/**
+ * Captures a subtree of Node and Sprite objects and creates copies of it.
+ *
+ * The prefab keeps every instance it creates in a pool. An instance returns to the pool when
+ * nothing but the prefab retains its nodes anymore, typically once it was removed from its parent,
+ * and none of its nodes was moved to another parent. It is then reset to the captured state and
+ * handed out again by the next instantiate(), so spawning bullets or enemies doesn't allocate once
+ * the pool is warm.
+ *
+ * Only the properties of the nodes are captured: actions, schedulers, user data and event
+ * listeners are not, they are removed when an instance is reused and must be set up again.
+ */
+class CC_DLL Prefab : public Ref
+{
+public:
+    /** Captures the subtree. Returns nullptr if it contains other types than Node and Sprite. */
+    static Prefab* create(Node* node);
+
+    /** Returns an autoreleased instance of the subtree. */
+    Node* instantiate();
+
+    /**
+     * Creates count instances and adds them to parent, without autoreleasing them.
+     * They are also appended to instances, if not null. If parent is null, they are
+     * autoreleased so that they go back to the pool unless they are retained.
+     */
+    void instantiate(int count, Node* parent, std::vector<Node*>* instances = nullptr);
+
+    /** Creates instances ahead of time, for instance during a loading screen, until count are free. */
+    void reserve(int count);
+
+    /** Releases the free instances. */
+    void purge();
+
+    /** Number of instances owned by the prefab, and number of those which are free. */
+    ssize_t getInstanceCount() const { return _instances.size(); }
+    ssize_t getFreeInstanceCount() const;
+
+CC_CONSTRUCTOR_ACCESS:
+    Prefab();
+    virtual ~Prefab();
+
+    bool init(Node* node);
+
+protected:
+    struct NodeTemplate
+    {
+        bool isSprite;
+        int parent;                 // index of the parent template, -1 for the root
+        ssize_t childrenCount;
+
+        Vec2 position;
+        float positionZ;
+        float scaleX;
+        float scaleY;
+        float scaleZ;
+        float rotationSkewX;
+        float rotationSkewY;
+        float skewX;
+        float skewY;
+        Vec2 anchorPoint;
+        bool ignoreAnchorPointForPosition;
+        Size contentSize;
+        bool visible;
+        int tag;
+        std::string name;
+        int localZOrder;
+        float globalZOrder;
+        Color3B color;
+        GLubyte opacity;
+        bool cascadeColorEnabled;
+        bool cascadeOpacityEnabled;
+        unsigned short cameraMask;
+        GLProgramState* glProgramState;
+
+        // Sprite
+        SpriteFrame* spriteFrame;
+        bool flippedX;
+        bool flippedY;
+        BlendFunc blendFunc;
+    };
+
+    struct Instance
+    {
+        // the nodes of the subtree in the order of the templates, all retained
+        std::vector<Node*> nodes;
+    };
+
+    void captureNode(Node* node, int parent);
+    bool isFree(const Instance& instance) const;
+    Instance* createInstance();
+    Instance* findFreeInstance();
+    void resetInstance(Instance& instance);
+    void applyTemplate(const NodeTemplate& nodeTemplate, Node* node);
+
+    std::vector<NodeTemplate> _templates;
+    std::vector<Instance*> _instances;
+    size_t _cursor;
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPREFAB_H__
@@ -29,6 +29,7 @@
 #include "CCProtectedNode.h"
 
 #include "base/CCDirector.h"
+#include "base/CCCamera.h"
 
 #if CC_USE_PHYSICS
 #include "physics/CCPhysicsBody.h"
@@ -270,6 +271,8 @@ void ProtectedNode::reorderProtectedChild(cocos2d::Node *child, int localZOrder)
 
 void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     // quick return if not visible. children won't be drawn.
     if (!_visible)
     {
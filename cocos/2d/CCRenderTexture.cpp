@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/CCEventType.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
+#include "base/CCCamera.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "renderer/CCRenderer.h"
@@ -341,6 +342,7 @@ void RenderTexture::beginWithClear(float r, float g, float b, float a, float dep
     this->begin();
 
     //clear screen
+    Director::getInstance()->getRenderer()->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _beginWithClearCommand.init(_globalZOrder);
     _beginWithClearCommand.func = CC_CALLBACK_0(RenderTexture::onClear, this);
     Director::getInstance()->getRenderer()->addCommand(&_beginWithClearCommand);
@@ -362,6 +364,7 @@ void RenderTexture::clearDepth(float depthValue)
     _clearDepthCommand.init(_globalZOrder);
     _clearDepthCommand.func = CC_CALLBACK_0(RenderTexture::onClearDepth, this);
 
+    Director::getInstance()->getRenderer()->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     Director::getInstance()->getRenderer()->addCommand(&_clearDepthCommand);
 
     this->end();
@@ -382,6 +385,8 @@ void RenderTexture::clearStencil(int stencilValue)
 
 void RenderTexture::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     // override visit.
 	// Don't call visit on its children
     if (!_visible || !isVisitableByVisitingCamera())
@@ -399,7 +404,9 @@ void RenderTexture::visit(Renderer *renderer, const Mat4 &parentTransform, uint3
     director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
 
     _sprite->visit(renderer, _modelViewTransform, flags);
-    draw(renderer, _modelViewTransform, flags);
+    // the sprite selected its own cameras
+    if (isVisitableByVisitingCamera())
+        draw(renderer, _modelViewTransform, flags);
     
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 
@@ -737,6 +744,7 @@ void RenderTexture::begin()
     _groupCommand.init(_globalZOrder);
 
     Renderer *renderer =  Director::getInstance()->getRenderer();
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     renderer->addCommand(&_groupCommand);
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
@@ -755,6 +763,7 @@ void RenderTexture::end()
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
     
     Renderer *renderer = director->getRenderer();
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     renderer->addCommand(&_endCommand);
     renderer->popGroup();
     
@@ -128,38 +128,84 @@ void Scene::onProjectionChanged(EventCustom* event)
 void Scene::render(Renderer* renderer)
 {
     auto director = Director::getInstance();
+
+    // only the last default camera is used, after the other cameras
+    _renderCameras.clear();
     Camera* defaultCamera = nullptr;
     for (const auto& camera : _cameras)
     {
-        Camera::_visitingCamera = camera;
-        if (Camera::_visitingCamera->getCameraFlag() == CameraFlag::DEFAULT)
+        if (camera->getCameraFlag() == CameraFlag::DEFAULT)
+            defaultCamera = camera;
+        else
+            _renderCameras.push_back(camera);
+    }
+    if (defaultCamera)
+        _renderCameras.push_back(defaultCamera);
+
+    if (_renderCameras.empty())
+        return;
+
+    if (_renderCameras.size() > static_cast<size_t>(Renderer::MAX_CAMERA_PASSES))
+    {
+        // more cameras than passes in a mask, visit the scene once per camera
+        for (const auto& camera : _renderCameras)
         {
-            defaultCamera = Camera::_visitingCamera;
-            continue;
+            Camera::_visitingCamera = camera;
+            director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+            director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, camera->getViewProjectionMatrix());
+
+            //visit the scene
+            visit(renderer, Mat4::IDENTITY, 0);
+            renderer->render();
+
+            director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
         }
-        
-        director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
-        director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, Camera::_visitingCamera->getViewProjectionMatrix());
-        
-        //visit the scene
-        visit(renderer, Mat4::IDENTITY, 0);
-        renderer->render();
-        
-        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+        Camera::_visitingCamera = nullptr;
+        return;
     }
-    //draw with default camera
-    if (defaultCamera)
+
+    // nodes only check their culling again when a camera moved
+    uint32_t flags = 0;
+    if (_renderCameraViewProjections.size() != _renderCameras.size())
+    {
+        _renderCameraViewProjections.resize(_renderCameras.size());
+        flags |= FLAGS_CAMERA_DIRTY;
+    }
+    for (size_t i = 0; i < _renderCameras.size(); ++i)
     {
-        Camera::_visitingCamera = defaultCamera;
+        const Mat4& viewProjection = _renderCameras[i]->getViewProjectionMatrix();
+        if (memcmp(viewProjection.m, _renderCameraViewProjections[i].m, sizeof(viewProjection.m)) != 0)
+        {
+            _renderCameraViewProjections[i] = viewProjection;
+            flags |= FLAGS_CAMERA_DIRTY;
+        }
+    }
+
+    // visit the scene once, transforms are computed once and each node adds its commands to the passes of its cameras
+    renderer->beginCameraPasses(static_cast<int>(_renderCameras.size()));
+    Camera::_visitingCameras = _renderCameras;
+    Camera::_visitingCamera = _renderCameras.back();
+
+    // nodes reading the projection while they are visited get the one of the last camera, the default camera if any
+    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, _renderCameras.back()->getViewProjectionMatrix());
+    visit(renderer, Mat4::IDENTITY, flags);
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+
+    // then render each pass with the projection of its camera
+    for (size_t pass = 0; pass < _renderCameras.size(); ++pass)
+    {
+        Camera::_visitingCamera = _renderCameras[pass];
         director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
         director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, Camera::_visitingCamera->getViewProjectionMatrix());
-        
-        //visit the scene
-        visit(renderer, Mat4::IDENTITY, 0);
-        renderer->render();
-        
+
+        renderer->renderCameraPass(static_cast<int>(pass));
+
         director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
     }
+
+    renderer->endCameraPasses();
+    Camera::_visitingCameras.clear();
     Camera::_visitingCamera = nullptr;
 }
 
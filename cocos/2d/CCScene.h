@@ -76,7 +76,11 @@ public:
 
     const std::vector<BaseLight*>& getLights() const { return _lights; }
     
-    /** render the scene */
+    /**
+     * render the scene.
+     * The scene is visited once for all its cameras: each node adds its render commands to the passes of the cameras
+     * that see it (see Node::setCameraMask()), then the passes are rendered one after the other, the default camera last.
+     */
     void render(Renderer* renderer);
     
 CC_CONSTRUCTOR_ACCESS:
@@ -101,6 +105,9 @@ protected:
     EventListenerCustom*       _event;
 
     std::vector<BaseLight *> _lights;
+
+    std::vector<Camera*> _renderCameras; //cameras of the last rendered frame, in rendering order
+    std::vector<Mat4>    _renderCameraViewProjections;
     
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Scene);
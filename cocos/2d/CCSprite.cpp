@@ -582,8 +582,8 @@ void Sprite::updateTransform(void)
 
 void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
-    // Don't do calculate the culling if the transform was not updated
-    _insideBounds = (flags & FLAGS_TRANSFORM_DIRTY) ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
+    // Don't do calculate the culling if the transform and the cameras were not updated
+    _insideBounds = (flags & (FLAGS_TRANSFORM_DIRTY | FLAGS_CAMERA_DIRTY)) ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
 
     if(_insideBounds)
     {
@@ -568,6 +568,7 @@ protected:
     bool _insideBounds;                     /// whether or not the sprite was inside bounds the previous frame
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Sprite);
+    friend class Prefab;
 };
 
 
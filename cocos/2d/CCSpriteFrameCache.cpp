@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "base/CCNS.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
+#include "base/CCValueBinary.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCache.h"
 
@@ -79,7 +80,35 @@ SpriteFrameCache::~SpriteFrameCache()
     CC_SAFE_DELETE(_loadedFileNames);
 }
 
-void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D* texture)
+static void addSpriteFrameAlias(const std::string& alias, const std::string& spriteFrameName, ValueMap& spriteFramesAliases)
+{
+    if (spriteFramesAliases.find(alias) != spriteFramesAliases.end())
+    {
+        CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", alias.c_str());
+    }
+
+    spriteFramesAliases[alias] = Value(spriteFrameName);
+}
+
+static void addSpriteFrameAliases(Value& aliases, const std::string& spriteFrameName, ValueMap& spriteFramesAliases)
+{
+    for(const auto &value : aliases.asValueVector()) {
+        addSpriteFrameAlias(value.asString(), spriteFrameName, spriteFramesAliases);
+    }
+}
+
+static void addSpriteFrameAliases(const ValueBinaryNode& aliases, const std::string& spriteFrameName, ValueMap& spriteFramesAliases)
+{
+    for (ssize_t i = 0; i < aliases.size(); ++i)
+    {
+        addSpriteFrameAlias(aliases.at(i).asString(), spriteFrameName, spriteFramesAliases);
+    }
+}
+
+/* Creates a frame from its description, frameDict being either a ValueMap or a ValueBinaryNode.
+ */
+template <typename Dictionary>
+static SpriteFrame* createSpriteFrame(Dictionary& frameDict, int format, Texture2D* texture, const std::string& spriteFrameName, ValueMap& spriteFramesAliases)
 {
     /*
     Supported Zwoptex Formats:
@@ -90,7 +119,81 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
     ZWTCoordinatesFormatOptionXML1_2 = 3, // Desktop Version 1.0.2+
     */
 
-    
+    SpriteFrame* spriteFrame = nullptr;
+
+    if(format == 0) 
+    {
+        float x = frameDict["x"].asFloat();
+        float y = frameDict["y"].asFloat();
+        float w = frameDict["width"].asFloat();
+        float h = frameDict["height"].asFloat();
+        float ox = frameDict["offsetX"].asFloat();
+        float oy = frameDict["offsetY"].asFloat();
+        int ow = frameDict["originalWidth"].asInt();
+        int oh = frameDict["originalHeight"].asInt();
+        // check ow/oh
+        if(!ow || !oh)
+        {
+            CCLOGWARN("cocos2d: WARNING: originalWidth/Height not found on the SpriteFrame. AnchorPoint won't work as expected. Regenrate the .plist");
+        }
+        // abs ow/oh
+        ow = abs(ow);
+        oh = abs(oh);
+        // create frame
+        spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                     Rect(x, y, w, h),
+                                                     false,
+                                                     Vec2(ox, oy),
+                                                     Size((float)ow, (float)oh)
+                                                     );
+    } 
+    else if(format == 1 || format == 2) 
+    {
+        Rect frame = RectFromString(frameDict["frame"].asString());
+        bool rotated = false;
+
+        // rotation
+        if (format == 2)
+        {
+            rotated = frameDict["rotated"].asBool();
+        }
+
+        Vec2 offset = PointFromString(frameDict["offset"].asString());
+        Size sourceSize = SizeFromString(frameDict["sourceSize"].asString());
+
+        // create frame
+        spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                     frame,
+                                                     rotated,
+                                                     offset,
+                                                     sourceSize
+                                                     );
+    } 
+    else if (format == 3)
+    {
+        // get values
+        Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
+        Vec2 spriteOffset = PointFromString(frameDict["spriteOffset"].asString());
+        Size spriteSourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
+        Rect textureRect = RectFromString(frameDict["textureRect"].asString());
+        bool textureRotated = frameDict["textureRotated"].asBool();
+
+        // get aliases
+        addSpriteFrameAliases(frameDict["aliases"], spriteFrameName, spriteFramesAliases);
+        
+        // create frame
+        spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                     Rect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height),
+                                                     textureRotated,
+                                                     spriteOffset,
+                                                     spriteSourceSize);
+    }
+
+    return spriteFrame;
+}
+
+void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D* texture)
+{
     ValueMap& framesDict = dictionary["frames"].asValueMap();
     int format = 0;
 
@@ -114,84 +217,42 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
             continue;
         }
         
-        if(format == 0) 
-        {
-            float x = frameDict["x"].asFloat();
-            float y = frameDict["y"].asFloat();
-            float w = frameDict["width"].asFloat();
-            float h = frameDict["height"].asFloat();
-            float ox = frameDict["offsetX"].asFloat();
-            float oy = frameDict["offsetY"].asFloat();
-            int ow = frameDict["originalWidth"].asInt();
-            int oh = frameDict["originalHeight"].asInt();
-            // check ow/oh
-            if(!ow || !oh)
-            {
-                CCLOGWARN("cocos2d: WARNING: originalWidth/Height not found on the SpriteFrame. AnchorPoint won't work as expected. Regenrate the .plist");
-            }
-            // abs ow/oh
-            ow = abs(ow);
-            oh = abs(oh);
-            // create frame
-            spriteFrame = SpriteFrame::createWithTexture(texture,
-                                                         Rect(x, y, w, h),
-                                                         false,
-                                                         Vec2(ox, oy),
-                                                         Size((float)ow, (float)oh)
-                                                         );
-        } 
-        else if(format == 1 || format == 2) 
-        {
-            Rect frame = RectFromString(frameDict["frame"].asString());
-            bool rotated = false;
+        spriteFrame = createSpriteFrame(frameDict, format, texture, spriteFrameName, _spriteFramesAliases);
 
-            // rotation
-            if (format == 2)
-            {
-                rotated = frameDict["rotated"].asBool();
-            }
+        // add sprite frame
+        _spriteFrames.insert(spriteFrameName, spriteFrame);
+    }
+}
+
+void SpriteFrameCache::addSpriteFramesWithBinary(const ValueBinaryNode& dictionary, Texture2D* texture)
+{
+    const ValueBinaryNode framesDict = dictionary["frames"];
+    // a missing metadata or format reads as 0, like the plist version
+    int format = dictionary["metadata"]["format"].asInt();
+
+    // check the format
+    CCASSERT(format >=0 && format <= 3, "format is not supported for SpriteFrameCache addSpriteFramesWithBinary:textureFilename:");
 
-            Vec2 offset = PointFromString(frameDict["offset"].asString());
-            Size sourceSize = SizeFromString(frameDict["sourceSize"].asString());
-
-            // create frame
-            spriteFrame = SpriteFrame::createWithTexture(texture,
-                                                         frame,
-                                                         rotated,
-                                                         offset,
-                                                         sourceSize
-                                                         );
-        } 
-        else if (format == 3)
+    const ssize_t count = framesDict.size();
+    _spriteFrames.reserve(_spriteFrames.size() + count);
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        const char* key = framesDict.keyAt(i);
+        if (!key)
         {
-            // get values
-            Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
-            Vec2 spriteOffset = PointFromString(frameDict["spriteOffset"].asString());
-            Size spriteSourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
-            Rect textureRect = RectFromString(frameDict["textureRect"].asString());
-            bool textureRotated = frameDict["textureRotated"].asBool();
-
-            // get aliases
-            ValueVector& aliases = frameDict["aliases"].asValueVector();
-
-            for(const auto &value : aliases) {
-                std::string oneAlias = value.asString();
-                if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
-                {
-                    CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
-                }
-
-                _spriteFramesAliases[oneAlias] = Value(spriteFrameName);
-            }
-            
-            // create frame
-            spriteFrame = SpriteFrame::createWithTexture(texture,
-                                                         Rect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height),
-                                                         textureRotated,
-                                                         spriteOffset,
-                                                         spriteSourceSize);
+            continue;
+        }
+
+        std::string spriteFrameName(key);
+        SpriteFrame* spriteFrame = _spriteFrames.at(spriteFrameName);
+        if (spriteFrame)
+        {
+            continue;
         }
 
+        const ValueBinaryNode frameDict = framesDict.valueAt(i);
+        spriteFrame = createSpriteFrame(frameDict, format, texture, spriteFrameName, _spriteFramesAliases);
+
         // add sprite frame
         _spriteFrames.insert(spriteFrameName, spriteFrame);
     }
@@ -205,9 +266,17 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture
     }
     
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
 
-    addSpriteFramesWithDictionary(dict, texture);
+    if (ValueBinary::isValueBinary(data.getBytes(), data.getSize()))
+    {
+        addSpriteFramesWithBinary(ValueBinary::getRoot(data.getBytes(), data.getSize()), texture);
+    }
+    else
+    {
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromData((const char*)data.getBytes(), static_cast<int>(data.getSize()));
+        addSpriteFramesWithDictionary(dict, texture);
+    }
     _loadedFileNames->insert(plist);
 }
 
@@ -232,6 +301,32 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, const s
     }
 }
 
+std::string SpriteFrameCache::getTexturePathForFile(const std::string& plist, const std::string& textureFileName) const
+{
+    string texturePath(textureFileName);
+
+    if (!texturePath.empty())
+    {
+        // build texture path relative to plist file
+        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath.c_str(), plist);
+    }
+    else
+    {
+        // build texture path by replacing file extension
+        texturePath = plist;
+
+        // remove .xxx
+        size_t startPos = texturePath.find_last_of("."); 
+        texturePath = texturePath.erase(startPos);
+
+        // append .png
+        texturePath = texturePath.append(".png");
+
+        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    }
+    return texturePath;
+}
+
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
 {
     CCASSERT(plist.size()>0, "plist filename should not be nullptr");
@@ -239,7 +334,29 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
     if (_loadedFileNames->find(plist) == _loadedFileNames->end())
     {
         std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-        ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+        Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+
+        if (ValueBinary::isValueBinary(data.getBytes(), data.getSize()))
+        {
+            // read in place, the frames never go through a ValueMap
+            ValueBinaryNode root = ValueBinary::getRoot(data.getBytes(), data.getSize());
+            std::string texturePath = getTexturePathForFile(plist, root["metadata"]["textureFileName"].asString());
+
+            Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(texturePath.c_str());
+
+            if (texture)
+            {
+                addSpriteFramesWithBinary(root, texture);
+                _loadedFileNames->insert(plist);
+            }
+            else
+            {
+                CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+            }
+            return;
+        }
+
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromData((const char*)data.getBytes(), static_cast<int>(data.getSize()));
 
         string texturePath("");
 
@@ -250,25 +367,7 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
             texturePath = metadataDict["textureFileName"].asString();
         }
 
-        if (!texturePath.empty())
-        {
-            // build texture path relative to plist file
-            texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath.c_str(), plist);
-        }
-        else
-        {
-            // build texture path by replacing file extension
-            texturePath = plist;
-
-            // remove .xxx
-            size_t startPos = texturePath.find_last_of("."); 
-            texturePath = texturePath.erase(startPos);
-
-            // append .png
-            texturePath = texturePath.append(".png");
-
-            CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
-        }
+        texturePath = getTexturePathForFile(plist, texturePath);
 
         Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(texturePath.c_str());
 
@@ -45,6 +45,7 @@ NS_CC_BEGIN
 
 class Sprite;
 class Texture2D;
+class ValueBinaryNode;
 
 /**
  * @addtogroup sprite_nodes
@@ -167,6 +168,14 @@ private:
      */
     void addSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture);
 
+    /* Same as addSpriteFramesWithDictionary() for a binary plist (see ValueBinary), read in place.
+     */
+    void addSpriteFramesWithBinary(const ValueBinaryNode& dictionary, Texture2D *texture);
+
+    /* Reads the texture file name from the metadata of a plist or a binary plist, builds a default one if there is none.
+     */
+    std::string getTexturePathForFile(const std::string& plist, const std::string& textureFileName) const;
+
     /** Removes multiple Sprite Frames from Dictionary.
     * @since v0.99.5
     */
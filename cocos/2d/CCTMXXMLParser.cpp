@@ -28,12 +28,16 @@ THE SOFTWARE.
 
 #include "2d/CCTMXXMLParser.h"
 #include <unordered_map>
-#include <sstream>
+#include <string.h>
+#include <algorithm>
+#include <zlib.h>
 #include "2d/CCTMXTiledMap.h"
-#include "base/ZipUtils.h"
-#include "base/base64.h"
+#include "base/CCValueBinary.h"
 #include "base/CCDirector.h"
+#include "base/ccUtils.h"
+#include "deprecated/CCString.h"
 #include "platform/CCFileUtils.h"
+#include "xxhash.h"
 
 using namespace std;
 
@@ -95,8 +99,327 @@ Rect TMXTilesetInfo::getRectForGID(uint32_t gid)
     return rect;
 }
 
+// implementation TMXTileDataDecoder
+
+/** Decodes the text of a <data> element (base64, optionally zlib/gzip compressed, or csv)
+ straight into the tiles of a layer, as the text is received. */
+class TMXTileDataDecoder
+{
+public:
+    TMXTileDataDecoder(uint32_t* tiles, int tilesAmount, int layerAttribs);
+    ~TMXTileDataDecoder();
+
+    void decode(const char* text, int length);
+    /** Returns false if the data was corrupted or didn't fill the layer. */
+    bool finish();
+
+private:
+    void decodeBase64(const char* text, int length);
+    void decodeCSV(const char* text, int length);
+    void write(const unsigned char* bytes, size_t length);
+
+    uint32_t* _tiles;
+    int _tilesAmount;
+    int _layerAttribs;
+    size_t _outputLength;
+    bool _error;
+
+    // base64
+    uint32_t _bits;
+    int _bitCount;
+
+    // zlib / gzip
+    z_stream _stream;
+    bool _inflating;
+    bool _streamEnded;
+
+    // csv
+    uint32_t _gid;
+    bool _inNumber;
+    int _tileIndex;
+};
+
+TMXTileDataDecoder::TMXTileDataDecoder(uint32_t* tiles, int tilesAmount, int layerAttribs)
+: _tiles(tiles)
+, _tilesAmount(tilesAmount)
+, _layerAttribs(layerAttribs)
+, _outputLength(0)
+, _error(false)
+, _bits(0)
+, _bitCount(0)
+, _inflating(false)
+, _streamEnded(false)
+, _gid(0)
+, _inNumber(false)
+, _tileIndex(0)
+{
+    if (_layerAttribs & (TMXLayerAttribGzip | TMXLayerAttribZlib))
+    {
+        memset(&_stream, 0, sizeof(_stream));
+        // 15 + 32: zlib or gzip header, detected automatically
+        _inflating = (inflateInit2(&_stream, 15 + 32) == Z_OK);
+        _error = !_inflating;
+    }
+}
+
+TMXTileDataDecoder::~TMXTileDataDecoder()
+{
+    if (_inflating)
+    {
+        inflateEnd(&_stream);
+    }
+}
+
+void TMXTileDataDecoder::decode(const char* text, int length)
+{
+    if (_error)
+        return;
+
+    if (_layerAttribs & TMXLayerAttribCSV)
+    {
+        decodeCSV(text, length);
+    }
+    else
+    {
+        decodeBase64(text, length);
+    }
+}
+
+void TMXTileDataDecoder::decodeBase64(const char* text, int length)
+{
+    unsigned char bytes[256];
+    size_t count = 0;
+
+    for (int i = 0; i < length; ++i)
+    {
+        const char c = text[i];
+        uint32_t value;
+        if (c >= 'A' && c <= 'Z')
+            value = c - 'A';
+        else if (c >= 'a' && c <= 'z')
+            value = c - 'a' + 26;
+        else if (c >= '0' && c <= '9')
+            value = c - '0' + 52;
+        else if (c == '+')
+            value = 62;
+        else if (c == '/')
+            value = 63;
+        else
+            continue; // white spaces and the '=' padding
+
+        _bits = (_bits << 6) | value;
+        _bitCount += 6;
+        if (_bitCount >= 8)
+        {
+            _bitCount -= 8;
+            bytes[count++] = (unsigned char)(_bits >> _bitCount);
+            if (count == sizeof(bytes))
+            {
+                write(bytes, count);
+                count = 0;
+            }
+        }
+    }
+
+    if (count > 0)
+    {
+        write(bytes, count);
+    }
+}
+
+void TMXTileDataDecoder::decodeCSV(const char* text, int length)
+{
+    for (int i = 0; i < length; ++i)
+    {
+        const char c = text[i];
+        if (c >= '0' && c <= '9')
+        {
+            _gid = _gid * 10 + (c - '0');
+            _inNumber = true;
+        }
+        else if (_inNumber)
+        {
+            // a comma or a new line ends the gid
+            if (_tileIndex < _tilesAmount)
+            {
+                _tiles[_tileIndex] = _gid;
+            }
+            ++_tileIndex;
+            _gid = 0;
+            _inNumber = false;
+        }
+    }
+}
+
+void TMXTileDataDecoder::write(const unsigned char* bytes, size_t length)
+{
+    const size_t capacity = _tilesAmount * sizeof(uint32_t);
+    unsigned char* output = reinterpret_cast<unsigned char*>(_tiles);
+
+    if (!_inflating)
+    {
+        const size_t copied = std::min(length, capacity - _outputLength);
+        memcpy(output + _outputLength, bytes, copied);
+        _outputLength += copied;
+        return;
+    }
+
+    if (_streamEnded)
+        return;
+
+    _stream.next_in = const_cast<Bytef*>(bytes);
+    _stream.avail_in = (uInt)length;
+    while (_stream.avail_in > 0 && _outputLength < capacity)
+    {
+        _stream.next_out = output + _outputLength;
+        _stream.avail_out = (uInt)(capacity - _outputLength);
+
+        int err = inflate(&_stream, Z_NO_FLUSH);
+        _outputLength = capacity - _stream.avail_out;
+
+        if (err == Z_STREAM_END)
+        {
+            _streamEnded = true;
+            break;
+        }
+        if (err != Z_OK)
+        {
+            CCLOG("cocos2d: TiledMap: inflate data error %d", err);
+            _error = true;
+            break;
+        }
+    }
+}
+
+bool TMXTileDataDecoder::finish()
+{
+    if (_layerAttribs & TMXLayerAttribCSV)
+    {
+        // the last gid isn't followed by a comma
+        decodeCSV(" ", 1);
+        return _tileIndex == _tilesAmount;
+    }
+
+    return !_error && _outputLength == _tilesAmount * sizeof(uint32_t);
+}
+
+// attributes are read straight from the parser, without building a ValueMap for every element
+static const char* getAttribute(const char** atts, const char* name)
+{
+    if (atts)
+    {
+        for (int i = 0; atts[i]; i += 2)
+        {
+            if (strcmp(atts[i], name) == 0)
+            {
+                return atts[i+1];
+            }
+        }
+    }
+    return nullptr;
+}
+
+static std::string getAttributeString(const char** atts, const char* name)
+{
+    const char* value = getAttribute(atts, name);
+    return value ? value : "";
+}
+
+static int getAttributeInt(const char** atts, const char* name)
+{
+    const char* value = getAttribute(atts, name);
+    return value ? atoi(value) : 0;
+}
+
+static float getAttributeFloat(const char** atts, const char* name)
+{
+    const char* value = getAttribute(atts, name);
+    return value ? utils::atof(value) : 0.0f;
+}
+
+static Value getAttributeValue(const char** atts, const char* name)
+{
+    const char* value = getAttribute(atts, name);
+    return value ? Value(value) : Value();
+}
+
+// parses "x1,y1 x2,y2 ..." into a vector of {x, y} maps
+static ValueVector parsePoints(const char* points, const Vec2& offset)
+{
+    ValueVector pointsArray;
+    pointsArray.reserve(10);
+
+    const char* p = points;
+    while (*p)
+    {
+        ValueMap pointDict;
+        const char* end = strchr(p, ' ');
+        if (!end)
+        {
+            end = p + strlen(p);
+        }
+
+        if (end > p)
+        {
+            pointDict["x"] = Value(atoi(p) + (int)offset.x);
+            const char* comma = (const char*)memchr(p, ',', end - p);
+            if (comma)
+            {
+                pointDict["y"] = Value(atoi(comma + 1) + (int)offset.y);
+            }
+        }
+        pointsArray.push_back(Value(pointDict));
+
+        p = *end ? end + 1 : end;
+    }
+    return pointsArray;
+}
+
 // implementation TMXMapInfo
 
+static bool s_binaryCacheEnabled = false;
+
+namespace
+{
+    // bump it when the layout of the cache files changes
+    const uint32_t TMX_BINARY_CACHE_VERSION = 2;
+
+    struct TMXBinaryCacheHeader
+    {
+        char        magic[4];
+        uint32_t    version;
+        // the objects are stored in points, the cache is only valid for the same content scale factor
+        float       contentScaleFactor;
+        uint32_t    infoLength;
+        uint32_t    tilesLength;
+    };
+
+    std::string getBinaryCacheDirectory()
+    {
+        return FileUtils::getInstance()->getWritablePath() + "tmxcache/";
+    }
+}
+
+void TMXMapInfo::setBinaryCacheEnabled(bool enabled)
+{
+    s_binaryCacheEnabled = enabled;
+}
+
+bool TMXMapInfo::isBinaryCacheEnabled()
+{
+    return s_binaryCacheEnabled;
+}
+
+void TMXMapInfo::purgeBinaryCache()
+{
+    auto fileUtils = FileUtils::getInstance();
+    const std::string cacheDirectory = getBinaryCacheDirectory();
+    if (fileUtils->isDirectoryExist(cacheDirectory))
+    {
+        fileUtils->removeDirectory(cacheDirectory);
+    }
+}
+
 TMXMapInfo * TMXMapInfo::create(const std::string& tmxFile)
 {
     TMXMapInfo *ret = new (std::nothrow) TMXMapInfo();
@@ -127,12 +450,12 @@ void TMXMapInfo::internalInit(const std::string& tmxFileName, const std::string&
     {
         _TMXFileName = FileUtils::getInstance()->fullPathForFilename(tmxFileName);
     }
-    
+
     if (resourcePath.size() > 0)
     {
         _resources = resourcePath;
     }
-    
+
     _objectGroups.reserve(4);
 
     // tmp vars
@@ -151,23 +474,42 @@ bool TMXMapInfo::initWithXML(const std::string& tmxString, const std::string& re
 bool TMXMapInfo::initWithTMXFile(const std::string& tmxFile)
 {
     internalInit(tmxFile, "");
-    return parseXMLFile(_TMXFileName.c_str());
+
+    if (!s_binaryCacheEnabled)
+    {
+        return parseXMLFile(_TMXFileName.c_str());
+    }
+
+    const std::string cachePath = getBinaryCachePath();
+    if (loadBinaryCache(cachePath))
+    {
+        return true;
+    }
+
+    bool ret = parseXMLFile(_TMXFileName.c_str());
+    if (ret)
+    {
+        saveBinaryCache(cachePath);
+    }
+    return ret;
 }
 
 TMXMapInfo::TMXMapInfo()
-: _mapSize(Size::ZERO)    
+: _mapSize(Size::ZERO)
 , _tileSize(Size::ZERO)
 , _layerAttribs(0)
 , _storingCharacters(false)
 , _xmlTileIndex(0)
 , _currentFirstGID(-1)
 , _recordFirstGID(true)
+, _tileDataDecoder(nullptr)
 {
 }
 
 TMXMapInfo::~TMXMapInfo()
 {
     CCLOGINFO("deallocing TMXMapInfo: %p", this);
+    CC_SAFE_DELETE(_tileDataDecoder);
 }
 
 bool TMXMapInfo::parseXMLString(const std::string& xmlString)
@@ -191,42 +533,48 @@ bool TMXMapInfo::parseXMLString(const std::string& xmlString)
 bool TMXMapInfo::parseXMLFile(const std::string& xmlFilename)
 {
     SAXParser parser;
-    
+
     if (false == parser.init("UTF-8") )
     {
         return false;
     }
-    
+
     parser.setDelegator(this);
 
-    return parser.parse(FileUtils::getInstance()->fullPathForFilename(xmlFilename).c_str());
+    const std::string fullPath = FileUtils::getInstance()->fullPathForFilename(xmlFilename);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (data.isNull())
+    {
+        return false;
+    }
+
+    if (s_binaryCacheEnabled)
+    {
+        ValueMap source;
+        source["file"] = Value(fullPath);
+        source["size"] = Value((int)data.getSize());
+        source["hash"] = Value((int)XXH32(data.getBytes(), (int)data.getSize(), 0));
+        _sourceFiles.push_back(Value(source));
+    }
+
+    return parser.parse((const char*)data.getBytes(), data.getSize());
 }
 
 
 // the XML parser calls here with all the elements
 void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
-{    
+{
     CC_UNUSED_PARAM(ctx);
     TMXMapInfo *tmxMapInfo = this;
-    std::string elementName = (char*)name;
-    ValueMap attributeDict;
-    if (atts && atts[0])
-    {
-        for(int i = 0; atts[i]; i += 2) 
-        {
-            std::string key = (char*)atts[i];
-            std::string value = (char*)atts[i+1];
-            attributeDict.insert(std::make_pair(key, Value(value)));
-        }
-    }
-    if (elementName == "map")
+
+    if (strcmp(name, "map") == 0)
     {
-        std::string version = attributeDict["version"].asString();
+        std::string version = getAttributeString(atts, "version");
         if ( version != "1.0")
         {
             CCLOG("cocos2d: TMXFormat: Unsupported TMX version: %s", version.c_str());
         }
-        std::string orientationStr = attributeDict["orientation"].asString();
+        std::string orientationStr = getAttributeString(atts, "orientation");
         if (orientationStr == "orthogonal")
             tmxMapInfo->setOrientation(TMXOrientationOrtho);
         else if (orientationStr  == "isometric")
@@ -237,21 +585,21 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
             CCLOG("cocos2d: TMXFomat: Unsupported orientation: %d", tmxMapInfo->getOrientation());
 
         Size s;
-        s.width = attributeDict["width"].asFloat();
-        s.height = attributeDict["height"].asFloat();
+        s.width = getAttributeFloat(atts, "width");
+        s.height = getAttributeFloat(atts, "height");
         tmxMapInfo->setMapSize(s);
 
-        s.width = attributeDict["tilewidth"].asFloat();
-        s.height = attributeDict["tileheight"].asFloat();
+        s.width = getAttributeFloat(atts, "tilewidth");
+        s.height = getAttributeFloat(atts, "tileheight");
         tmxMapInfo->setTileSize(s);
 
         // The parent element is now "map"
         tmxMapInfo->setParentElement(TMXPropertyMap);
-    } 
-    else if (elementName == "tileset") 
+    }
+    else if (strcmp(name, "tileset") == 0)
     {
         // If this is an external tileset then start parsing that
-        std::string externalTilesetFilename = attributeDict["source"].asString();
+        std::string externalTilesetFilename = getAttributeString(atts, "source");
         if (externalTilesetFilename != "")
         {
             // Tileset file will be relative to the map file. So we need to convert it to an absolute path
@@ -260,31 +608,31 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
                 string dir = _TMXFileName.substr(0, _TMXFileName.find_last_of("/") + 1);
                 externalTilesetFilename = dir + externalTilesetFilename;
             }
-            else 
+            else
             {
                 externalTilesetFilename = _resources + "/" + externalTilesetFilename;
             }
             externalTilesetFilename = FileUtils::getInstance()->fullPathForFilename(externalTilesetFilename.c_str());
-            
-            _currentFirstGID = attributeDict["firstgid"].asInt();
+
+            _currentFirstGID = getAttributeInt(atts, "firstgid");
             if (_currentFirstGID < 0)
             {
                 _currentFirstGID = 0;
             }
             _recordFirstGID = false;
-            
+
             tmxMapInfo->parseXMLFile(externalTilesetFilename.c_str());
         }
         else
         {
             TMXTilesetInfo *tileset = new (std::nothrow) TMXTilesetInfo();
-            tileset->_name = attributeDict["name"].asString();
-            
+            tileset->_name = getAttributeString(atts, "name");
+
             if (_recordFirstGID)
             {
                 // unset before, so this is tmx file.
-                tileset->_firstGid = attributeDict["firstgid"].asInt();
-                
+                tileset->_firstGid = getAttributeInt(atts, "firstgid");
+
                 if (tileset->_firstGid < 0)
                 {
                     tileset->_firstGid = 0;
@@ -295,27 +643,28 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
                 tileset->_firstGid = _currentFirstGID;
                 _currentFirstGID = 0;
             }
-            
-            tileset->_spacing = attributeDict["spacing"].asInt();
-            tileset->_margin = attributeDict["margin"].asInt();
+
+            tileset->_spacing = getAttributeInt(atts, "spacing");
+            tileset->_margin = getAttributeInt(atts, "margin");
             Size s;
-            s.width = attributeDict["tilewidth"].asFloat();
-            s.height = attributeDict["tileheight"].asFloat();
+            s.width = getAttributeFloat(atts, "tilewidth");
+            s.height = getAttributeFloat(atts, "tileheight");
             tileset->_tileSize = s;
 
             tmxMapInfo->getTilesets().pushBack(tileset);
             tileset->release();
         }
     }
-    else if (elementName == "tile")
+    else if (strcmp(name, "tile") == 0)
     {
         if (tmxMapInfo->getParentElement() == TMXPropertyLayer)
         {
             TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
             Size layerSize = layer->_layerSize;
-            uint32_t gid = static_cast<uint32_t>(attributeDict["gid"].asInt());
+            const char* gidStr = getAttribute(atts, "gid");
+            uint32_t gid = gidStr ? (uint32_t)strtoul(gidStr, nullptr, 10) : 0;
             int tilesAmount = layerSize.width*layerSize.height;
-            
+
             if (_xmlTileIndex < tilesAmount)
             {
                 layer->_tiles[_xmlTileIndex++] = gid;
@@ -324,29 +673,29 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         else
         {
             TMXTilesetInfo* info = tmxMapInfo->getTilesets().back();
-            tmxMapInfo->setParentGID(info->_firstGid + attributeDict["id"].asInt());
+            tmxMapInfo->setParentGID(info->_firstGid + getAttributeInt(atts, "id"));
             tmxMapInfo->getTileProperties()[tmxMapInfo->getParentGID()] = Value(ValueMap());
             tmxMapInfo->setParentElement(TMXPropertyTile);
         }
     }
-    else if (elementName == "layer")
+    else if (strcmp(name, "layer") == 0)
     {
         TMXLayerInfo *layer = new (std::nothrow) TMXLayerInfo();
-        layer->_name = attributeDict["name"].asString();
+        layer->_name = getAttributeString(atts, "name");
 
         Size s;
-        s.width = attributeDict["width"].asFloat();
-        s.height = attributeDict["height"].asFloat();
+        s.width = getAttributeFloat(atts, "width");
+        s.height = getAttributeFloat(atts, "height");
         layer->_layerSize = s;
 
-        Value& visibleValue = attributeDict["visible"];
-        layer->_visible = visibleValue.isNull() ? true : visibleValue.asBool();
+        const char* visible = getAttribute(atts, "visible");
+        layer->_visible = !visible || (strcmp(visible, "0") != 0 && strcmp(visible, "false") != 0);
 
-        Value& opacityValue = attributeDict["opacity"];
-        layer->_opacity = opacityValue.isNull() ? 255 : (unsigned char)(255.0f * opacityValue.asFloat());
+        const char* opacity = getAttribute(atts, "opacity");
+        layer->_opacity = !opacity ? 255 : (unsigned char)(255.0f * utils::atof(opacity));
 
-        float x = attributeDict["x"].asFloat();
-        float y = attributeDict["y"].asFloat();
+        float x = getAttributeFloat(atts, "x");
+        float y = getAttributeFloat(atts, "y");
         layer->_offset = Vec2(x,y);
 
         tmxMapInfo->getLayers().pushBack(layer);
@@ -355,14 +704,14 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         // The parent element is now "layer"
         tmxMapInfo->setParentElement(TMXPropertyLayer);
 
-    } 
-    else if (elementName == "objectgroup")
+    }
+    else if (strcmp(name, "objectgroup") == 0)
     {
         TMXObjectGroup *objectGroup = new (std::nothrow) TMXObjectGroup();
-        objectGroup->setGroupName(attributeDict["name"].asString());
+        objectGroup->setGroupName(getAttributeString(atts, "name"));
         Vec2 positionOffset;
-        positionOffset.x = attributeDict["x"].asFloat() * tmxMapInfo->getTileSize().width;
-        positionOffset.y = attributeDict["y"].asFloat() * tmxMapInfo->getTileSize().height;
+        positionOffset.x = getAttributeFloat(atts, "x") * tmxMapInfo->getTileSize().width;
+        positionOffset.y = getAttributeFloat(atts, "y") * tmxMapInfo->getTileSize().height;
         objectGroup->setPositionOffset(positionOffset);
 
         tmxMapInfo->getObjectGroups().pushBack(objectGroup);
@@ -372,63 +721,67 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         tmxMapInfo->setParentElement(TMXPropertyObjectGroup);
 
     }
-    else if (elementName == "image")
+    else if (strcmp(name, "image") == 0)
     {
         TMXTilesetInfo* tileset = tmxMapInfo->getTilesets().back();
 
         // build full path
-        std::string imagename = attributeDict["source"].asString();
+        std::string imagename = getAttributeString(atts, "source");
 
         if (_TMXFileName.find_last_of("/") != string::npos)
         {
             string dir = _TMXFileName.substr(0, _TMXFileName.find_last_of("/") + 1);
             tileset->_sourceImage = dir + imagename;
         }
-        else 
+        else
         {
             tileset->_sourceImage = _resources + (_resources.size() ? "/" : "") + imagename;
         }
-    } 
-    else if (elementName == "data")
+    }
+    else if (strcmp(name, "data") == 0)
     {
-        std::string encoding = attributeDict["encoding"].asString();
-        std::string compression = attributeDict["compression"].asString();
+        std::string encoding = getAttributeString(atts, "encoding");
+        std::string compression = getAttributeString(atts, "compression");
+
+        TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
+        Size layerSize = layer->_layerSize;
+        int tilesAmount = layerSize.width*layerSize.height;
+
+        // every encoding fills the tiles in place, missing ones stay 0
+        uint32_t *tiles = (uint32_t*) calloc(tilesAmount, sizeof(uint32_t));
+        layer->_tiles = tiles;
 
         if (encoding == "")
         {
             tmxMapInfo->setLayerAttribs(tmxMapInfo->getLayerAttribs() | TMXLayerAttribNone);
-            
-            TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-            Size layerSize = layer->_layerSize;
-            int tilesAmount = layerSize.width*layerSize.height;
-
-            uint32_t *tiles = (uint32_t*) malloc(tilesAmount*sizeof(uint32_t));
-            // set all value to 0
-            memset(tiles, 0, tilesAmount*sizeof(int));
-
-            layer->_tiles = tiles;
         }
-        else if (encoding == "base64")
+        else if (encoding == "base64" || encoding == "csv")
         {
-            int layerAttribs = tmxMapInfo->getLayerAttribs();
-            tmxMapInfo->setLayerAttribs(layerAttribs | TMXLayerAttribBase64);
+            // the map info accumulates the attribs of all the layers, the decoder only gets this one's
+            int dataAttribs = (encoding == "csv") ? TMXLayerAttribCSV : TMXLayerAttribBase64;
             tmxMapInfo->setStoringCharacters(true);
 
             if( compression == "gzip" )
             {
-                layerAttribs = tmxMapInfo->getLayerAttribs();
-                tmxMapInfo->setLayerAttribs(layerAttribs | TMXLayerAttribGzip);
+                dataAttribs |= TMXLayerAttribGzip;
             } else
             if (compression == "zlib")
             {
-                layerAttribs = tmxMapInfo->getLayerAttribs();
-                tmxMapInfo->setLayerAttribs(layerAttribs | TMXLayerAttribZlib);
+                dataAttribs |= TMXLayerAttribZlib;
             }
             CCASSERT( compression == "" || compression == "gzip" || compression == "zlib", "TMX: unsupported compression method" );
+            tmxMapInfo->setLayerAttribs(tmxMapInfo->getLayerAttribs() | dataAttribs);
+
+            CC_SAFE_DELETE(_tileDataDecoder);
+            _tileDataDecoder = new (std::nothrow) TMXTileDataDecoder(tiles, tilesAmount, dataAttribs);
+        }
+        else
+        {
+            CCLOG("cocos2d: TiledMap: unsupported encoding %s", encoding.c_str());
         }
 
-    } 
-    else if (elementName == "object")
+    }
+    else if (strcmp(name, "object") == 0)
     {
         TMXObjectGroup* objectGroup = tmxMapInfo->getObjectGroups().back();
 
@@ -436,176 +789,84 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         // Create an instance of TMXObjectInfo to store the object and its properties
         ValueMap dict;
         // Parse everything automatically
-        const char* array[] = {"name", "type", "width", "height", "gid"};
-        
-        for(size_t i = 0; i < sizeof(array)/sizeof(array[0]); ++i )
-        {
-            const char* key = array[i];
-            Value value = attributeDict[key];
-            dict[key] = value;
-        }
+        dict["name"] = getAttributeValue(atts, "name");
+        dict["type"] = getAttributeValue(atts, "type");
+        dict["gid"] = getAttributeValue(atts, "gid");
 
         // But X and Y since they need special treatment
         // X
-        int x = attributeDict["x"].asInt();
+        int x = getAttributeInt(atts, "x");
         // Y
-        int y = attributeDict["y"].asInt();
-        
-        Vec2 p(x + objectGroup->getPositionOffset().x, _mapSize.height * _tileSize.height - y  - objectGroup->getPositionOffset().x - attributeDict["height"].asInt());
+        int y = getAttributeInt(atts, "y");
+        int width = getAttributeInt(atts, "width");
+        int height = getAttributeInt(atts, "height");
+
+        Vec2 p(x + objectGroup->getPositionOffset().x, _mapSize.height * _tileSize.height - y  - objectGroup->getPositionOffset().x - height);
         p = CC_POINT_PIXELS_TO_POINTS(p);
         dict["x"] = Value(p.x);
         dict["y"] = Value(p.y);
-        
-        int width = attributeDict["width"].asInt();
-        int height = attributeDict["height"].asInt();
+
         Size s(width, height);
         s = CC_SIZE_PIXELS_TO_POINTS(s);
         dict["width"] = Value(s.width);
         dict["height"] = Value(s.height);
 
         // Add the object to the objectGroup
-        objectGroup->getObjects().push_back(Value(dict));
+        objectGroup->getObjects().push_back(Value(std::move(dict)));
 
          // The parent element is now "object"
          tmxMapInfo->setParentElement(TMXPropertyObject);
 
-    } 
-    else if (elementName == "property")
+    }
+    else if (strcmp(name, "property") == 0)
     {
-        if ( tmxMapInfo->getParentElement() == TMXPropertyNone ) 
+        if ( tmxMapInfo->getParentElement() == TMXPropertyNone )
         {
             CCLOG( "TMX tile map: Parent element is unsupported. Cannot add property named '%s' with value '%s'",
-                  attributeDict["name"].asString().c_str(), attributeDict["value"].asString().c_str() );
-        } 
+                  getAttributeString(atts, "name").c_str(), getAttributeString(atts, "value").c_str() );
+        }
         else if ( tmxMapInfo->getParentElement() == TMXPropertyMap )
         {
             // The parent element is the map
-            Value value = attributeDict["value"];
-            std::string key = attributeDict["name"].asString();
-            tmxMapInfo->getProperties().insert(std::make_pair(key, value));
+            tmxMapInfo->getProperties().insert(std::make_pair(getAttributeString(atts, "name"), getAttributeValue(atts, "value")));
         }
         else if ( tmxMapInfo->getParentElement() == TMXPropertyLayer )
         {
             // The parent element is the last layer
             TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-            Value value = attributeDict["value"];
-            std::string key = attributeDict["name"].asString();
             // Add the property to the layer
-            layer->getProperties().insert(std::make_pair(key, value));
+            layer->getProperties().insert(std::make_pair(getAttributeString(atts, "name"), getAttributeValue(atts, "value")));
         }
-        else if ( tmxMapInfo->getParentElement() == TMXPropertyObjectGroup ) 
+        else if ( tmxMapInfo->getParentElement() == TMXPropertyObjectGroup )
         {
             // The parent element is the last object group
             TMXObjectGroup* objectGroup = tmxMapInfo->getObjectGroups().back();
-            Value value = attributeDict["value"];
-            std::string key = attributeDict["name"].asString();
-            objectGroup->getProperties().insert(std::make_pair(key, value));
+            objectGroup->getProperties().insert(std::make_pair(getAttributeString(atts, "name"), getAttributeValue(atts, "value")));
         }
         else if ( tmxMapInfo->getParentElement() == TMXPropertyObject )
         {
             // The parent element is the last object
             TMXObjectGroup* objectGroup = tmxMapInfo->getObjectGroups().back();
             ValueMap& dict = objectGroup->getObjects().rbegin()->asValueMap();
-
-            std::string propertyName = attributeDict["name"].asString();
-            dict[propertyName] = attributeDict["value"];
+            dict[getAttributeString(atts, "name")] = getAttributeValue(atts, "value");
         }
-        else if ( tmxMapInfo->getParentElement() == TMXPropertyTile ) 
+        else if ( tmxMapInfo->getParentElement() == TMXPropertyTile )
         {
             ValueMap& dict = tmxMapInfo->getTileProperties().at(tmxMapInfo->getParentGID()).asValueMap();
-
-            std::string propertyName = attributeDict["name"].asString();
-            dict[propertyName] = attributeDict["value"];
+            dict[getAttributeString(atts, "name")] = getAttributeValue(atts, "value");
         }
     }
-    else if (elementName == "polygon") 
+    else if (strcmp(name, "polygon") == 0 || strcmp(name, "polyline") == 0)
     {
-        // find parent object's dict and add polygon-points to it
+        // find parent object's dict and add polygon-points / polyline-points to it
         TMXObjectGroup* objectGroup = _objectGroups.back();
         ValueMap& dict = objectGroup->getObjects().rbegin()->asValueMap();
 
-        // get points value string
-        std::string value = attributeDict["points"].asString();
-        if (!value.empty())
+        const char* points = getAttribute(atts, "points");
+        if (points && points[0])
         {
-            ValueVector pointsArray;
-            pointsArray.reserve(10);
-
-            // parse points string into a space-separated set of points
-            stringstream pointsStream(value);
-            string pointPair;
-            while(std::getline(pointsStream, pointPair, ' '))
-            {
-                // parse each point combo into a comma-separated x,y point
-                stringstream pointStream(pointPair);
-                string xStr,yStr;
-                
-                ValueMap pointDict;
-
-                // set x
-                if(std::getline(pointStream, xStr, ','))
-                {
-                    int x = atoi(xStr.c_str()) + (int)objectGroup->getPositionOffset().x;
-                    pointDict["x"] = Value(x);
-                }
-
-                // set y
-                if(std::getline(pointStream, yStr, ','))
-                {
-                    int y = atoi(yStr.c_str()) + (int)objectGroup->getPositionOffset().y;
-                    pointDict["y"] = Value(y);
-                }
-                
-                // add to points array
-                pointsArray.push_back(Value(pointDict));
-            }
-            
-            dict["points"] = Value(pointsArray);
-        }
-    } 
-    else if (elementName == "polyline")
-    {
-        // find parent object's dict and add polyline-points to it
-        TMXObjectGroup* objectGroup = _objectGroups.back();
-        ValueMap& dict = objectGroup->getObjects().rbegin()->asValueMap();
-        
-        // get points value string
-        std::string value = attributeDict["points"].asString();
-        if (!value.empty())
-        {
-            ValueVector pointsArray;
-            pointsArray.reserve(10);
-            
-            // parse points string into a space-separated set of points
-            stringstream pointsStream(value);
-            string pointPair;
-            while(std::getline(pointsStream, pointPair, ' '))
-            {
-                // parse each point combo into a comma-separated x,y point
-                stringstream pointStream(pointPair);
-                string xStr,yStr;
-                
-                ValueMap pointDict;
-                
-                // set x
-                if(std::getline(pointStream, xStr, ','))
-                {
-                    int x = atoi(xStr.c_str()) + (int)objectGroup->getPositionOffset().x;
-                    pointDict["x"] = Value(x);
-                }
-                
-                // set y
-                if(std::getline(pointStream, yStr, ','))
-                {
-                    int y = atoi(yStr.c_str()) + (int)objectGroup->getPositionOffset().y;
-                    pointDict["y"] = Value(y);
-                }
-                
-                // add to points array
-                pointsArray.push_back(Value(pointDict));
-            }
-            
-            dict["polylinePoints"] = Value(pointsArray);
+            const char* key = (strcmp(name, "polygon") == 0) ? "points" : "polylinePoints";
+            dict[key] = Value(parsePoints(points, objectGroup->getPositionOffset()));
         }
     }
 }
@@ -614,54 +875,18 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
 {
     CC_UNUSED_PARAM(ctx);
     TMXMapInfo *tmxMapInfo = this;
-    std::string elementName = (char*)name;
-
-    int len = 0;
 
-    if(elementName == "data")
+    if (strcmp(name, "data") == 0)
     {
-        if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribBase64)
+        if (_tileDataDecoder)
         {
             tmxMapInfo->setStoringCharacters(false);
-            
-            TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-            
-            std::string currentString = tmxMapInfo->getCurrentString();
-            unsigned char *buffer;
-            len = base64Decode((unsigned char*)currentString.c_str(), (unsigned int)currentString.length(), &buffer);
-            if( ! buffer )
-            {
-                CCLOG("cocos2d: TiledMap: decode data error");
-                return;
-            }
-            
-            if( tmxMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib) )
-            {
-                unsigned char *deflated = nullptr;
-                Size s = layer->_layerSize;
-                // int sizeHint = s.width * s.height * sizeof(uint32_t);
-                ssize_t sizeHint = s.width * s.height * sizeof(unsigned int);
-                
-                ssize_t CC_UNUSED inflatedLen = ZipUtils::inflateMemoryWithHint(buffer, len, &deflated, sizeHint);
-                CCASSERT(inflatedLen == sizeHint, "");
-                
-                free(buffer);
-                buffer = nullptr;
-                
-                if( ! deflated )
-                {
-                    CCLOG("cocos2d: TiledMap: inflate data error");
-                    return;
-                }
-                
-                layer->_tiles = reinterpret_cast<uint32_t*>(deflated);
-            }
-            else
+
+            if (!_tileDataDecoder->finish())
             {
-                layer->_tiles = reinterpret_cast<uint32_t*>(buffer);
+                CCLOG("cocos2d: TiledMap: decode data error in layer %s", tmxMapInfo->getLayers().back()->_name.c_str());
             }
-            
-            tmxMapInfo->setCurrentString("");
+            CC_SAFE_DELETE(_tileDataDecoder);
         }
         else if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribNone)
         {
@@ -669,27 +894,27 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
         }
 
     }
-    else if (elementName == "map")
+    else if (strcmp(name, "map") == 0)
     {
         // The map element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
-    }    
-    else if (elementName == "layer")
+    }
+    else if (strcmp(name, "layer") == 0)
     {
         // The layer element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
     }
-    else if (elementName == "objectgroup")
+    else if (strcmp(name, "objectgroup") == 0)
     {
         // The objectgroup element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
-    } 
-    else if (elementName == "object") 
+    }
+    else if (strcmp(name, "object") == 0)
     {
         // The object element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
     }
-    else if (elementName == "tileset")
+    else if (strcmp(name, "tileset") == 0)
     {
         _recordFirstGID = true;
     }
@@ -698,16 +923,234 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
 void TMXMapInfo::textHandler(void *ctx, const char *ch, int len)
 {
     CC_UNUSED_PARAM(ctx);
-    TMXMapInfo *tmxMapInfo = this;
-    std::string text((char*)ch,0,len);
 
-    if (tmxMapInfo->isStoringCharacters())
+    // the tile data is decoded as it comes, it is never stored as text
+    if (_tileDataDecoder && isStoringCharacters())
     {
-        std::string currentString = tmxMapInfo->getCurrentString();
-        currentString += text;
-        tmxMapInfo->setCurrentString(currentString.c_str());
+        _tileDataDecoder->decode(ch, len);
     }
 }
 
-NS_CC_END
+// binary cache
+
+std::string TMXMapInfo::getBinaryCachePath() const
+{
+    unsigned int low = XXH32(_TMXFileName.data(), (int)_TMXFileName.size(), 0);
+    unsigned int high = XXH32(_TMXFileName.data(), (int)_TMXFileName.size(), 0x9e3779b9);
+    return getBinaryCacheDirectory() + StringUtils::format("%08x%08x.tmxb", high, low);
+}
+
+void TMXMapInfo::saveBinaryCache(const std::string& cachePath) const
+{
+    // everything but the tiles goes into a binary value map, the tiles of the layers follow it
+    ValueMap info;
+    info["sources"] = Value(_sourceFiles);
+    info["orientation"] = Value(_orientation);
+    info["mapWidth"] = Value(_mapSize.width);
+    info["mapHeight"] = Value(_mapSize.height);
+    info["tileWidth"] = Value(_tileSize.width);
+    info["tileHeight"] = Value(_tileSize.height);
+    info["properties"] = Value(_properties);
+    info["tileProperties"] = Value(_tileProperties);
+
+    ValueVector tilesets;
+    for (const auto& tileset : _tilesets)
+    {
+        ValueMap dict;
+        dict["name"] = Value(tileset->_name);
+        dict["firstGid"] = Value(tileset->_firstGid);
+        dict["tileWidth"] = Value(tileset->_tileSize.width);
+        dict["tileHeight"] = Value(tileset->_tileSize.height);
+        dict["spacing"] = Value(tileset->_spacing);
+        dict["margin"] = Value(tileset->_margin);
+        dict["sourceImage"] = Value(tileset->_sourceImage);
+        tilesets.push_back(Value(std::move(dict)));
+    }
+    info["tilesets"] = Value(std::move(tilesets));
 
+    std::string tiles;
+    ValueVector layers;
+    for (const auto& layer : _layers)
+    {
+        ValueMap dict;
+        dict["name"] = Value(layer->_name);
+        dict["width"] = Value(layer->_layerSize.width);
+        dict["height"] = Value(layer->_layerSize.height);
+        dict["visible"] = Value(layer->_visible);
+        dict["opacity"] = Value(layer->_opacity);
+        dict["offsetX"] = Value(layer->_offset.x);
+        dict["offsetY"] = Value(layer->_offset.y);
+        dict["properties"] = Value(layer->_properties);
+        dict["hasTiles"] = Value(layer->_tiles != nullptr);
+        layers.push_back(Value(std::move(dict)));
+
+        if (layer->_tiles)
+        {
+            int tilesAmount = layer->_layerSize.width * layer->_layerSize.height;
+            tiles.append(reinterpret_cast<const char*>(layer->_tiles), tilesAmount * sizeof(uint32_t));
+        }
+    }
+    info["layers"] = Value(std::move(layers));
+
+    ValueVector objectGroups;
+    for (const auto& objectGroup : _objectGroups)
+    {
+        ValueMap dict;
+        dict["name"] = Value(objectGroup->getGroupName());
+        dict["offsetX"] = Value(objectGroup->getPositionOffset().x);
+        dict["offsetY"] = Value(objectGroup->getPositionOffset().y);
+        dict["properties"] = Value(objectGroup->getProperties());
+        dict["objects"] = Value(objectGroup->getObjects());
+        objectGroups.push_back(Value(std::move(dict)));
+    }
+    info["objectGroups"] = Value(std::move(objectGroups));
+
+    Data encoded = ValueBinary::encode(Value(std::move(info)));
+    if (encoded.isNull())
+        return;
+
+    auto fileUtils = FileUtils::getInstance();
+    const std::string cacheDirectory = getBinaryCacheDirectory();
+    if (!fileUtils->isDirectoryExist(cacheDirectory) && !fileUtils->createDirectory(cacheDirectory))
+        return;
+
+    TMXBinaryCacheHeader header;
+    memcpy(header.magic, "CTMX", 4);
+    header.version = TMX_BINARY_CACHE_VERSION;
+    header.contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    header.infoLength = (uint32_t)encoded.getSize();
+    header.tilesLength = (uint32_t)tiles.size();
+
+    // write to a temporary file, a truncated cache must never be loaded
+    const std::string fileName = cachePath.substr(cacheDirectory.size());
+    const std::string tmpPath = cachePath + ".tmp";
+    FILE* fp = fopen(tmpPath.c_str(), "wb");
+    if (fp)
+    {
+        bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+            && fwrite(encoded.getBytes(), 1, encoded.getSize(), fp) == (size_t)encoded.getSize()
+            && fwrite(tiles.data(), 1, tiles.size(), fp) == tiles.size();
+        ok = (fclose(fp) == 0) && ok;
+
+        if (!ok || !fileUtils->renameFile(cacheDirectory, fileName + ".tmp", fileName))
+        {
+            fileUtils->removeFile(tmpPath);
+        }
+    }
+}
+
+bool TMXMapInfo::loadBinaryCache(const std::string& cachePath)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(cachePath))
+        return false;
+
+    Data data = fileUtils->getDataFromFile(cachePath);
+    if (data.getSize() < (ssize_t)sizeof(TMXBinaryCacheHeader))
+        return false;
+
+    TMXBinaryCacheHeader header;
+    memcpy(&header, data.getBytes(), sizeof(header));
+    if (memcmp(header.magic, "CTMX", 4) != 0 || header.version != TMX_BINARY_CACHE_VERSION
+        || header.contentScaleFactor != CC_CONTENT_SCALE_FACTOR()
+        || (ssize_t)(sizeof(header) + header.infoLength + header.tilesLength) != data.getSize())
+    {
+        return false;
+    }
+
+    const unsigned char* infoBytes = data.getBytes() + sizeof(header);
+    ValueBinaryNode info = ValueBinary::getRoot(infoBytes, header.infoLength);
+    if (info.getType() != Value::Type::MAP)
+        return false;
+
+    // stale if the map or one of its external tilesets changed
+    ValueBinaryNode sources = info["sources"];
+    if (sources.size() == 0)
+        return false;
+    for (ssize_t i = 0; i < sources.size(); ++i)
+    {
+        ValueBinaryNode source = sources.at(i);
+        Data sourceData = fileUtils->getDataFromFile(source["file"].asString());
+        if (sourceData.isNull()
+            || (int)sourceData.getSize() != source["size"].asInt()
+            || (int)XXH32(sourceData.getBytes(), (int)sourceData.getSize(), 0) != source["hash"].asInt())
+        {
+            return false;
+        }
+    }
+
+    // the tiles of the layers must add up to the stored ones before anything is filled
+    ValueBinaryNode layers = info["layers"];
+    size_t tilesLength = 0;
+    for (ssize_t i = 0; i < layers.size(); ++i)
+    {
+        ValueBinaryNode layer = layers.at(i);
+        if (layer["hasTiles"].asBool())
+        {
+            tilesLength += (int)layer["width"].asFloat() * (int)layer["height"].asFloat() * sizeof(uint32_t);
+        }
+    }
+    if (tilesLength != header.tilesLength)
+        return false;
+
+    _sourceFiles = sources.toValue().asValueVector();
+    _orientation = info["orientation"].asInt();
+    _mapSize = Size(info["mapWidth"].asFloat(), info["mapHeight"].asFloat());
+    _tileSize = Size(info["tileWidth"].asFloat(), info["tileHeight"].asFloat());
+    _properties = info["properties"].toValue().asValueMap();
+    _tileProperties = info["tileProperties"].toValue().asIntKeyMap();
+
+    ValueBinaryNode tilesets = info["tilesets"];
+    for (ssize_t i = 0; i < tilesets.size(); ++i)
+    {
+        ValueBinaryNode dict = tilesets.at(i);
+        TMXTilesetInfo *tileset = new (std::nothrow) TMXTilesetInfo();
+        tileset->_name = dict["name"].asString();
+        tileset->_firstGid = dict["firstGid"].asInt();
+        tileset->_tileSize = Size(dict["tileWidth"].asFloat(), dict["tileHeight"].asFloat());
+        tileset->_spacing = dict["spacing"].asInt();
+        tileset->_margin = dict["margin"].asInt();
+        tileset->_sourceImage = dict["sourceImage"].asString();
+        _tilesets.pushBack(tileset);
+        tileset->release();
+    }
+
+    const unsigned char* tiles = infoBytes + header.infoLength;
+    for (ssize_t i = 0; i < layers.size(); ++i)
+    {
+        ValueBinaryNode dict = layers.at(i);
+        TMXLayerInfo *layer = new (std::nothrow) TMXLayerInfo();
+        layer->_name = dict["name"].asString();
+        layer->_layerSize = Size(dict["width"].asFloat(), dict["height"].asFloat());
+        layer->_visible = dict["visible"].asBool();
+        layer->_opacity = dict["opacity"].asByte();
+        layer->_offset = Vec2(dict["offsetX"].asFloat(), dict["offsetY"].asFloat());
+        layer->_properties = dict["properties"].toValue().asValueMap();
+        if (dict["hasTiles"].asBool())
+        {
+            size_t length = (int)layer->_layerSize.width * (int)layer->_layerSize.height * sizeof(uint32_t);
+            layer->_tiles = (uint32_t*) malloc(length);
+            memcpy(layer->_tiles, tiles, length);
+            tiles += length;
+        }
+        _layers.pushBack(layer);
+        layer->release();
+    }
+
+    ValueBinaryNode objectGroups = info["objectGroups"];
+    for (ssize_t i = 0; i < objectGroups.size(); ++i)
+    {
+        ValueBinaryNode dict = objectGroups.at(i);
+        TMXObjectGroup *objectGroup = new (std::nothrow) TMXObjectGroup();
+        objectGroup->setGroupName(dict["name"].asString());
+        objectGroup->setPositionOffset(Vec2(dict["offsetX"].asFloat(), dict["offsetY"].asFloat()));
+        objectGroup->setProperties(dict["properties"].toValue().asValueMap());
+        objectGroup->setObjects(dict["objects"].toValue().asValueVector());
+        _objectGroups.pushBack(objectGroup);
+        objectGroup->release();
+    }
+
+    return true;
+}
+
+NS_CC_END
@@ -41,6 +41,7 @@ NS_CC_BEGIN
 
 class TMXLayerInfo;
 class TMXTilesetInfo;
+class TMXTileDataDecoder;
 
 /** @file
 * Internal TMX parser
@@ -60,6 +61,7 @@ enum {
     TMXLayerAttribBase64 = 1 << 1,
     TMXLayerAttribGzip = 1 << 2,
     TMXLayerAttribZlib = 1 << 3,
+    TMXLayerAttribCSV = 1 << 4,
 };
 
 enum {
@@ -278,9 +280,28 @@ public:
     inline const std::string& getTMXFileName() const { return _TMXFileName; }
     inline void setTMXFileName(const std::string& fileName){ _TMXFileName = fileName; }
 
+    /** Enables or disables the binary cache of the parsed maps.
+     When enabled, a map loaded from a tmx file is written to the writable path in a compact binary
+     form the first time, and read back from there as long as the tmx file and its external tilesets
+     don't change. Disabled by default.
+     @since v3.3
+     */
+    static void setBinaryCacheEnabled(bool enabled);
+    static bool isBinaryCacheEnabled();
+
+    /** Removes the cached maps from the writable path. */
+    static void purgeBinaryCache();
+
 protected:
     void internalInit(const std::string& tmxFileName, const std::string& resourcePath);
 
+    /// path of the binary cache file of the tmx file
+    std::string getBinaryCachePath() const;
+    /// fills the map info from its binary cache, returns false if the cache is missing or stale
+    bool loadBinaryCache(const std::string& cachePath);
+    /// writes the parsed map info to its binary cache
+    void saveBinaryCache(const std::string& cachePath) const;
+
     /// map orientation
     int    _orientation;
     /// map width & height
@@ -316,6 +337,10 @@ protected:
     ValueMapIntKey _tileProperties;
     int _currentFirstGID;
     bool _recordFirstGID;
+    //! decodes the text of the current <data> element into the tiles of the layer
+    TMXTileDataDecoder* _tileDataDecoder;
+    //! the parsed files (map and external tilesets) with their size and hash, used to validate the binary cache
+    ValueVector _sourceFiles;
 };
 
 // end of tilemap_parallax_nodes group
@@ -31,9 +31,14 @@
 
 NS_CC_BEGIN
 
+BillBoard::CameraDraw::CameraDraw()
+: zDepthInView(0.0f)
+, dirty(true)
+{
+}
+
 BillBoard::BillBoard()
-: _zDepthInView(0.0f)
-, _mode(Mode::VIEW_POINT_ORIENTED)
+: _mode(Mode::VIEW_POINT_ORIENTED)
 , _modeDirty(false)
 {
     Node::setAnchorPoint(Vec2(0.5f,0.5f));
@@ -98,10 +103,43 @@ BillBoard* BillBoard::create(Mode mode)
 
 void BillBoard::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
-    auto camera = Camera::getVisitingCamera();
-    
+    if (memcmp(_transform.m, transform.m, sizeof(float) * 16) != 0 || _modeDirty)
+    {
+        for (auto& cameraDraw : _cameraDraws)
+            cameraDraw->dirty = true;
+        _transform = transform;
+        _modeDirty = false;
+    }
+
+    const auto& cameras = Camera::getVisitingCameras();
+    if (cameras.empty())
+    {
+        drawForCamera(renderer, Camera::getVisitingCamera(), 0);
+        return;
+    }
+
+    // the scene is visited once for all its cameras, face each camera that sees the BillBoard in its own pass
+    unsigned int passMask = renderer->getCameraPassMask();
+    for (size_t pass = 0; pass < cameras.size(); ++pass)
+    {
+        if (passMask & (1u << pass))
+        {
+            renderer->setCameraPassMask(1u << pass);
+            drawForCamera(renderer, cameras[pass], pass);
+        }
+    }
+    renderer->setCameraPassMask(passMask);
+}
+
+void BillBoard::drawForCamera(Renderer *renderer, const Camera* camera, size_t index)
+{
+    while (_cameraDraws.size() <= index)
+        _cameraDraws.push_back(std::unique_ptr<CameraDraw>(new (std::nothrow) CameraDraw()));
+    auto& cameraDraw = *_cameraDraws[index];
+
+    const Mat4& transform = _transform;
     const Mat4& camWorldMat = camera->getNodeToWorldTransform();
-    if (memcmp(_camWorldMat.m, camWorldMat.m, sizeof(float) * 16) != 0 || memcmp(_transform.m, transform.m, sizeof(float) * 16) != 0 || _modeDirty)
+    if (memcmp(cameraDraw.camWorldMat.m, camWorldMat.m, sizeof(float) * 16) != 0 || cameraDraw.dirty)
     {
         Vec3 camDir;
         switch (_mode)
@@ -116,7 +154,7 @@ void BillBoard::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
                 CCASSERT(false, "invalid billboard mode");
             break;
         }
-        _modeDirty = false;
+        cameraDraw.dirty = false;
 
         if (camDir.length() < MATH_TOLERANCE)
         {
@@ -134,22 +172,22 @@ void BillBoard::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
         float ylen = sqrtf(transform.m[4] * transform.m[4] + transform.m[5] * transform.m[5] + transform.m[6] * transform.m[6]);
         float zlen = sqrtf(transform.m[8] * transform.m[8] + transform.m[9] * transform.m[9] + transform.m[10] * transform.m[10]);
 
-        _billboardTransform.m[0] = x.x * xlen; _billboardTransform.m[1] = x.y * xlen; _billboardTransform.m[2] = x.z * xlen;
-        _billboardTransform.m[4] = y.x * ylen; _billboardTransform.m[5] = y.y * ylen; _billboardTransform.m[6] = y.z * ylen;
-        _billboardTransform.m[8] = -camDir.x * zlen; _billboardTransform.m[9] = -camDir.y * zlen; _billboardTransform.m[10] = -camDir.z * zlen;
-        _billboardTransform.m[12] = transform.m[12]; _billboardTransform.m[13] = transform.m[13]; _billboardTransform.m[14] = transform.m[14];
+        Mat4& billboardTransform = cameraDraw.billboardTransform;
+        billboardTransform.m[0] = x.x * xlen; billboardTransform.m[1] = x.y * xlen; billboardTransform.m[2] = x.z * xlen;
+        billboardTransform.m[4] = y.x * ylen; billboardTransform.m[5] = y.y * ylen; billboardTransform.m[6] = y.z * ylen;
+        billboardTransform.m[8] = -camDir.x * zlen; billboardTransform.m[9] = -camDir.y * zlen; billboardTransform.m[10] = -camDir.z * zlen;
+        billboardTransform.m[12] = transform.m[12]; billboardTransform.m[13] = transform.m[13]; billboardTransform.m[14] = transform.m[14];
 
         const Mat4 &viewMat = camWorldMat.getInversed();
-        _zDepthInView = -(viewMat.m[2] * transform.m[12] + viewMat.m[6] * transform.m[13] + viewMat.m[10] * transform.m[14] + viewMat.m[14]);
-        _transform = transform;
-        _camWorldMat = camWorldMat;
+        cameraDraw.zDepthInView = -(viewMat.m[2] * transform.m[12] + viewMat.m[6] * transform.m[13] + viewMat.m[10] * transform.m[14] + viewMat.m[14]);
+        cameraDraw.camWorldMat = camWorldMat;
     }
 
     //FIXME: frustum culling here
     {
-        _quadCommand.init(_zDepthInView, _texture->getName(), getGLProgramState(), _blendFunc, &_quad, 1, _billboardTransform);
-        _quadCommand.setTransparent(true);
-        renderer->addCommand(&_quadCommand);
+        cameraDraw.quadCommand.init(cameraDraw.zDepthInView, _texture->getName(), getGLProgramState(), _blendFunc, &_quad, 1, cameraDraw.billboardTransform);
+        cameraDraw.quadCommand.setTransparent(true);
+        renderer->addCommand(&cameraDraw.quadCommand);
     }
 }
 
@@ -27,9 +27,13 @@
 
 #include "2d/CCSprite.h"
 #include "3d/3dExport.h"
+#include <memory>
+#include <vector>
 
 NS_CC_BEGIN
 
+class Camera;
+
 /**
  * Inherit from Sprite, achieve BillBoard.
  */
@@ -99,11 +103,25 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
 
-    Mat4 _camWorldMat;
+    /** orientation and command of the BillBoard for one camera */
+    struct CameraDraw
+    {
+        CameraDraw();
+
+        Mat4 camWorldMat;
+        Mat4 billboardTransform;
+        float zDepthInView;
+        bool dirty;
+        QuadCommand quadCommand;
+    };
+
+    /** orients the BillBoard to a camera and adds its command */
+    void drawForCamera(Renderer *renderer, const Camera* camera, size_t index);
+
     Mat4 _transform;
-    Mat4 _billboardTransform;
-    
-    float _zDepthInView;
+
+    // one per camera pass when the scene is visited once for all its cameras, a single one otherwise
+    std::vector<std::unique_ptr<CameraDraw>> _cameraDraws;
 
     Mode _mode;
     bool _modeDirty;
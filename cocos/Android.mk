@@ -49,6 +49,7 @@ cocos2d.cpp \
 2d/CCMotionStreak.cpp \
 2d/CCNode.cpp \
 2d/CCNodeGrid.cpp \
+2d/CCPrefab.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
@@ -117,14 +118,17 @@ base/CCIMEDispatcher.cpp \
 base/CCLight.cpp \
 base/CCNS.cpp \
 base/CCProfiling.cpp \
+base/CCTrace.cpp \
 base/ccRandom.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
+base/CCThreadPool.cpp \
 base/CCScriptSupport.cpp \
 base/CCTouch.cpp \
 base/CCUserDefault.cpp \
 base/CCUserDefault-android.cpp \
 base/CCValue.cpp \
+base/CCValueBinary.cpp \
 base/TGAlib.cpp \
 base/ZipUtils.cpp \
 base/atitc.cpp \
@@ -144,6 +148,7 @@ renderer/CCBatchCommand.cpp \
 renderer/CCCustomCommand.cpp \
 renderer/CCGLProgram.cpp \
 renderer/CCGLProgramCache.cpp \
+renderer/CCGLProgramBinaryCache.cpp \
 renderer/CCGLProgramState.cpp \
 renderer/CCGLProgramStateCache.cpp \
 renderer/CCGroupCommand.cpp \
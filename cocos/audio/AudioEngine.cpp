@@ -29,6 +29,7 @@
 #include "audio/include/AudioEngine.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
+#include "base/CCTrace.h"
 
 #if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
 #include "android/AudioEngine-inl.h"
@@ -81,6 +82,7 @@ bool AudioEngine::lazyInit()
 
 int AudioEngine::play2d(const std::string& filePath, bool loop, float volume, const AudioProfile *profile)
 {
+    CC_TRACE_ZONE("AudioEngine::play2d");
     int ret = AudioEngine::INVAILD_AUDIO_ID;
 
     do {
@@ -78,5 +78,9 @@ namespace CocosDenshion {
     void SimpleAudioEngine::stopEffect(unsigned int nSoundId) { }
     void SimpleAudioEngine::stopAllEffects() { }
     void SimpleAudioEngine::preloadEffect(const char* pszFilePath) { }
+    void SimpleAudioEngine::preloadEffectAsync(const char* pszFilePath, const std::function<void(bool)>& callback) {
+        if (callback)
+            callback(false);
+    }
     void SimpleAudioEngine::unloadEffect(const char* pszFilePath) { }
 }
@@ -292,17 +292,28 @@ namespace CocosDenshion {
         }
 
         void AndroidJavaEngine::preloadEffect(const char* pszFilePath) {
+            loadEffect(pszFilePath);
+        }
+
+        void AndroidJavaEngine::preloadEffectAsync(const char* pszFilePath, const std::function<void(bool)>& callback) {
+            bool loaded = loadEffect(pszFilePath);
+            if (callback)
+                callback(loaded);
+        }
+
+        bool AndroidJavaEngine::loadEffect(const char* pszFilePath) {
             cocos2d::JniMethodInfo methodInfo;
             std::string fullPath = CocosDenshion::android::getFullPathWithoutAssetsPrefix(pszFilePath);
         
-            if (! getJNIStaticMethodInfo(methodInfo, "preloadEffect", "(Ljava/lang/String;)V")) {
-                return ;
+            if (! getJNIStaticMethodInfo(methodInfo, "preloadEffect", "(Ljava/lang/String;)Z")) {
+                return false;
             }
         
             jstring stringArg = methodInfo.env->NewStringUTF(fullPath.c_str());
-            methodInfo.env->CallStaticVoidMethod(methodInfo.classID, methodInfo.methodID, stringArg);
+            jboolean loaded = methodInfo.env->CallStaticBooleanMethod(methodInfo.classID, methodInfo.methodID, stringArg);
             methodInfo.env->DeleteLocalRef(stringArg);
             methodInfo.env->DeleteLocalRef(methodInfo.classID);
+            return loaded;
         }
 
         void AndroidJavaEngine::unloadEffect(const char* pszFilePath) {
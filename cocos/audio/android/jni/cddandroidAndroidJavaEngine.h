@@ -54,9 +54,12 @@ namespace CocosDenshion {
             void stopEffect(unsigned int nSoundId);
             void stopAllEffects();
             void preloadEffect(const char* pszFilePath);
+            void preloadEffectAsync(const char* pszFilePath, const std::function<void(bool)>& callback);
             void unloadEffect(const char* pszFilePath);
 
         private :
+            bool loadEffect(const char* pszFilePath);
+
             static bool getJNIStaticMethodInfo(cocos2d::JniMethodInfo &methodinfo,
                                                const char *methodName,
                                                const char *paramCode);
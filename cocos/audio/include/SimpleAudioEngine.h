@@ -27,6 +27,8 @@ THE SOFTWARE.
 #ifndef _SIMPLE_AUDIO_ENGINE_H_
 #define _SIMPLE_AUDIO_ENGINE_H_
 
+#include <functional>
+
 #include "Export.h"
 
 #if defined(__GNUC__) && ((__GNUC__ >= 4) || ((__GNUC__ == 3) && (__GNUC_MINOR__ >= 1)))
@@ -222,6 +224,16 @@ public:
     */
     virtual void preloadEffect(const char* pszFilePath);
 
+    /**
+    @brief          preload a compressed audio file without blocking the caller
+    @details        on platforms which can't decode in the background the effect is preloaded synchronously
+    @param pszFilePath The path of the effect file
+    @param callback    Called on the cocos thread, with false if the file couldn't be loaded
+    @js NA
+    @lua NA
+    */
+    virtual void preloadEffectAsync(const char* pszFilePath, const std::function<void(bool)>& callback);
+
     /**
     @brief          unload the preloaded effect from internal buffer
     @param pszFilePath        The path of the effect file
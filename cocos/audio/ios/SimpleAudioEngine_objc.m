@@ -162,12 +162,14 @@ static CDBufferManager *bufferManager = nil;
   [soundEngine stopAllSounds];
 }
 
--(void) preloadEffect:(NSString*) filePath
+-(BOOL) preloadEffect:(NSString*) filePath
 {
     int soundId = [bufferManager bufferForFile:filePath create:YES];
     if (soundId == kCDNoBuffer) {
         CDLOG(@"Denshion::SimpleAudioEngine sound failed to preload %@",filePath);
+        return NO;
     }
+    return YES;
 }
 
 -(void) unloadEffect:(NSString*) filePath
@@ -440,7 +440,7 @@ void FmodAudioPlayer::stopAllEffects() {
 	mapEffectSoundChannel.clear();
 }
 
-void FmodAudioPlayer::preloadEffect(const char* pszFilePath) {
+bool FmodAudioPlayer::preloadEffect(const char* pszFilePath) {
 	FMOD::Sound* pLoadSound;
 
 	pSystem->update();
@@ -448,9 +448,10 @@ void FmodAudioPlayer::preloadEffect(const char* pszFilePath) {
 			&pLoadSound);
 	if (ERRCHECK(result)){
 		printf("sound effect in %s could not be preload", pszFilePath);
-		return;
+		return false;
 	}
 	mapEffectSound[string(pszFilePath)] = pLoadSound;
+	return true;
 }
 
 void FmodAudioPlayer::unloadEffect(const char* pszFilePath) {
@@ -132,8 +132,9 @@ public:
 	 @brief  		preload a compressed audio file
 	 @details	    the compressed audio will be decode to wave, then write into an
 	 internal buffer in SimpleaudioEngine
+	 @return		false if the file could not be loaded
 	 */
-	virtual void preloadEffect(const char* pszFilePath);
+	virtual bool preloadEffect(const char* pszFilePath);
 
 	/**
 	 @brief  		unload the preloaded effect from internal buffer
@@ -85,6 +85,7 @@ bool SimpleAudioEngine::isBackgroundMusicPlaying() {
 }
 
 void SimpleAudioEngine::preloadBackgroundMusic(const char* pszFilePath) {
+	CC_TRACE_ZONE("SimpleAudioEngine::preloadBackgroundMusic");
 	// Changing file path to full path
 	std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszFilePath);
 	return oAudioPlayer->preloadBackgroundMusic(fullPath.c_str());
@@ -106,9 +107,18 @@ void SimpleAudioEngine::stopEffect(unsigned int nSoundId) {
 }
 
 void SimpleAudioEngine::preloadEffect(const char* pszFilePath) {
+	CC_TRACE_ZONE("SimpleAudioEngine::preloadEffect");
 	// Changing file path to full path
 	std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszFilePath);
-	return oAudioPlayer->preloadEffect(fullPath.c_str());
+	oAudioPlayer->preloadEffect(fullPath.c_str());
+}
+
+void SimpleAudioEngine::preloadEffectAsync(const char* pszFilePath, const std::function<void(bool)>& callback) {
+	// Changing file path to full path
+	std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszFilePath);
+	bool loaded = oAudioPlayer->preloadEffect(fullPath.c_str());
+	if (callback)
+		callback(loaded);
 }
 
 void SimpleAudioEngine::unloadEffect(const char* pszFilePath) {
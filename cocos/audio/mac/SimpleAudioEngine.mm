@@ -106,9 +106,9 @@ static void static_stopEffect(int nSoundId)
     [[SimpleAudioEngine sharedEngine] stopEffect: nSoundId];
 }
      
-static void static_preloadEffect(const char* pszFilePath)
+static bool static_preloadEffect(const char* pszFilePath)
 {
-    [[SimpleAudioEngine sharedEngine] preloadEffect: [NSString stringWithUTF8String: pszFilePath]];
+    return [[SimpleAudioEngine sharedEngine] preloadEffect: [NSString stringWithUTF8String: pszFilePath]];
 }
      
 static void static_unloadEffect(const char* pszFilePath)
@@ -260,6 +260,15 @@ void SimpleAudioEngine::preloadEffect(const char* pszFilePath)
     static_preloadEffect(fullPath.c_str());
 }
 
+void SimpleAudioEngine::preloadEffectAsync(const char* pszFilePath, const std::function<void(bool)>& callback)
+{
+    // Changing file path to full path
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszFilePath);
+    bool loaded = static_preloadEffect(fullPath.c_str());
+    if (callback)
+        callback(loaded);
+}
+
 void SimpleAudioEngine::unloadEffect(const char* pszFilePath)
 {
     // Changing file path to full path
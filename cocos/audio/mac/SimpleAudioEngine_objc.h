@@ -87,8 +87,8 @@
 -(void) resumeAllEffects;
 /** stop all audioes */
 -(void) stopAllEffects;
-/** preloads an audio effect */
--(void) preloadEffect:(NSString*) filePath;
+/** preloads an audio effect, returns NO if it can't be loaded */
+-(BOOL) preloadEffect:(NSString*) filePath;
 /** unloads an audio effect from memory */
 -(void) unloadEffect:(NSString*) filePath;
 /** Gets a CDSoundSource object set up to play the specified file. */
@@ -1,4 +1,6 @@
 #include "OpenALDecoder.h"
+#include <mutex>
+#include <stdlib.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <AL/alut.h>
@@ -57,13 +59,27 @@ static int checkALError(const char *funcName)
 
 class AlutDecoder : public OpenALDecoder
 {
-    bool decode(OpenALFile &file, ALuint &result)
+    bool decode(OpenALFile &file, OpenALPCM &result)
     {
         if (!file.mapToMemory())
             return false;
-        result = alutCreateBufferFromFileImage(file.mappedFile, file.fileSize);
-        if (AL_NONE == result)
+
+        ALenum format = AL_NONE;
+        ALsizei size = 0;
+        ALfloat frequency = 0;
+        ALvoid *data = NULL;
+        {
+            // ALUT keeps its error state in globals
+            std::lock_guard<std::mutex> lock(_mutex);
+            data = alutLoadMemoryFromFileImage(file.mappedFile, file.fileSize, &format, &size, &frequency);
+        }
+        if (!data)
             return false;
+
+        result.format = format;
+        result.frequency = (ALsizei)frequency;
+        result.data.assign((char *)data, (char *)data + size);
+        free(data);
         return true;
     }
 
@@ -71,154 +87,235 @@ class AlutDecoder : public OpenALDecoder
     {
         return Wav == format || Raw == format;
     }
-};
 
-class DataRaii
-{
-public:
-    char *data;
-    size_t size;
-
-    DataRaii() : data(0), size(0) {}
-    ~DataRaii() { delete [] data; }
+private:
+    std::mutex _mutex;
 };
 
 #ifdef ENABLE_MPG123
-class Mpg123Decoder : public OpenALDecoder
+static mpg123_handle *newMpg123Handle()
 {
-private:
-    mpg123_handle *handle;
+    mpg123_handle *handle = mpg123_new(NULL, NULL);
+    if (handle && MPG123_OK != mpg123_format(handle, 44100, MPG123_MONO | MPG123_STEREO,
+                                             MPG123_ENC_UNSIGNED_8 | MPG123_ENC_SIGNED_16))
+        CCLOG("ERROR (CocosDenshion): cannot set specified mpg123 format.");
+    return handle;
+}
 
+static bool getMpg123Format(mpg123_handle *handle, ALenum &format, ALsizei &freq)
+{
+    int channels = 0;
+    int encoding = 0;
+    long rate = 0;
+    if (MPG123_OK != mpg123_getformat(handle, &rate, &channels, &encoding))
+        return false;
+    freq = rate;
+    if (encoding == MPG123_ENC_UNSIGNED_8) {
+        if (channels == 1)
+            format = AL_FORMAT_MONO8;
+        else
+            format = AL_FORMAT_STEREO8;
+    } else {
+        if (channels == 1)
+            format = AL_FORMAT_MONO16;
+        else
+            format = AL_FORMAT_STEREO16;
+    }
+    return true;
+}
+
+class Mpg123Stream : public OpenALStream
+{
 public:
-    class MpgOpenRaii
-    {
-    public:
-        mpg123_handle *handle;
+    Mpg123Stream() : _handle(newMpg123Handle()), _file(NULL), _opened(false) {}
 
-        MpgOpenRaii(mpg123_handle *handle) : handle(handle) {}
-        ~MpgOpenRaii() { mpg123_close(handle); }
-    };
+    ~Mpg123Stream()
+    {
+        if (_opened)
+            mpg123_close(_handle);
+        if (_handle)
+            mpg123_delete(_handle);
+        if (_file)
+            fclose(_file);
+    }
 
-    bool getInfo(ALenum &format, ALsizei &freq, ALsizei &size) const
+    bool open(OpenALFile &file)
     {
-        int channels = 0;
-        int encoding = 0;
-        long rate = 0;
-        if (MPG123_OK != mpg123_getformat(handle, &rate, &channels, &encoding))
+        if (!_handle || MPG123_OK != mpg123_open_fd(_handle, fileno(file.file)))
             return false;
-        size = mpg123_length(handle);
-        if (size == MPG123_ERR)
+        _opened = true;
+        if (!getMpg123Format(_handle, _format, _frequency))
             return false;
-        freq = rate;
-        if (encoding == MPG123_ENC_UNSIGNED_8) {
-            if (channels == 1)
-                format = AL_FORMAT_MONO8;
-            else
-                format = AL_FORMAT_STEREO8;
-        } else {
-            if (channels == 1)
-                format = AL_FORMAT_MONO16;
-            else
-                format = AL_FORMAT_STEREO16;
-        }
+        _file = file.file;
+        file.file = NULL;
         return true;
     }
 
-    bool decode(OpenALFile &file, ALuint &result)
+    long read(char *buffer, size_t size)
     {
-        if (MPG123_OK != mpg123_open_fd(handle, fileno(file.file)))
-            return false;
-        MpgOpenRaii raii(handle);
-        ALenum format = AL_NONE;
-        ALsizei freq = 0;
-        ALsizei size = 0;
-        if (!getInfo(format, freq, size))
-            return false;
-        DataRaii pcm;
-        pcm.size = size;
-        if (format == AL_FORMAT_MONO16 || format == AL_FORMAT_STEREO16)
-            pcm.size *= 2;
-        pcm.data = new char[pcm.size];
-        size_t done = 0;
-        if (MPG123_DONE != mpg123_read(handle, (unsigned char*)pcm.data, pcm.size, &done))
-            return false;
-        CCLOG("MP3 BUFFER SIZE: %ld, FORMAT %i.", (long)done, (int)format);
-        return initALBuffer(result, format, pcm.data, done, freq);
+        size_t total = 0;
+        while (total < size) {
+            size_t done = 0;
+            int status = mpg123_read(_handle, (unsigned char *)buffer + total, size - total, &done);
+            total += done;
+            if (status == MPG123_DONE)
+                break;
+            if (status != MPG123_OK)
+                return -1;
+        }
+        return (long)total;
     }
 
-    bool acceptsFormat(Format format) const
+    bool rewind()
     {
-        return Mp3 == format;
+        return mpg123_seek(_handle, 0, SEEK_SET) >= 0;
     }
 
-    Mpg123Decoder()
-        : handle(mpg123_new(NULL, NULL))
+private:
+    mpg123_handle *_handle;
+    FILE *_file;
+    bool _opened;
+};
+
+class Mpg123Decoder : public OpenALDecoder
+{
+public:
+    bool decode(OpenALFile &file, OpenALPCM &result)
     {
-        if (MPG123_OK != mpg123_format(handle, 44100, MPG123_MONO | MPG123_STEREO,
-                                       MPG123_ENC_UNSIGNED_8 | MPG123_ENC_SIGNED_16))
-            CCLOG("ERROR (CocosDenshion): cannot set specified mpg123 format.");
+        // a handle per call, files can be decoded on several threads
+        Mpg123Stream mp3;
+        if (!mp3.open(file))
+            return false;
+
+        const size_t chunkSize = 64 * 1024;
+        size_t size = 0;
+        while (true) {
+            result.data.resize(size + chunkSize);
+            long done = mp3.read(result.data.data() + size, chunkSize);
+            if (done < 0)
+                return false;
+            size += done;
+            if ((size_t)done < chunkSize)
+                break;
+        }
+        result.data.resize(size);
+        CCLOG("MP3 BUFFER SIZE: %ld, FORMAT %i.", (long)size, (int)mp3.getFormat());
+        result.format = mp3.getFormat();
+        result.frequency = mp3.getFrequency();
+        return size > 0;
+    }
+
+    OpenALStream *openStream(OpenALFile &file)
+    {
+        Mpg123Stream *stream = new Mpg123Stream();
+        if (!stream->open(file)) {
+            delete stream;
+            return NULL;
+        }
+        return stream;
     }
 
-    ~Mpg123Decoder()
+    bool acceptsFormat(Format format) const
     {
-        mpg123_delete(handle);
+        return Mp3 == format;
     }
 };
 #endif
 
 #ifndef DISABLE_VORBIS
-class VorbisDecoder : public OpenALDecoder
+class VorbisStream : public OpenALStream
 {
-    class OggRaii
-    {
-    public:
-        OggVorbis_File file;
+public:
+    VorbisStream() : _opened(false) {}
 
-        ~OggRaii() { ov_clear(&file); }
-    };
+    ~VorbisStream()
+    {
+        if (_opened)
+            ov_clear(&_file);
+    }
 
-public:
-    bool decode(OpenALFile &file, ALuint &result)
+    bool open(OpenALFile &file)
     {
-        OggRaii ogg;
-        int status = ov_test(file.file, &ogg.file, 0, 0);
-        if (status != 0) {
-            ov_clear(&ogg.file);
+        if (ov_test(file.file, &_file, 0, 0) != 0)
             return false;
-        }
-        status = ov_test_open(&ogg.file);
-        if (status != 0) {
+        // ov_clear() closes the file from now on
+        _opened = true;
+        file.file = NULL;
+        if (ov_test_open(&_file) != 0) {
             fprintf(stderr, "Could not open OGG file '%s'\n", file.debugName.c_str());
             return false;
         }
-        // As vorbis documentation says, we should not fclose() file
-        // after successful opening by vorbis functions.
-        file.file = NULL;
-        vorbis_info *info = ov_info(&ogg.file, -1);
-        ALenum  format = (info->channels == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
-
-        DataRaii pcm;
-        pcm.size = ov_pcm_total(&ogg.file, -1) * info->channels * 2;
-        pcm.data = new char[pcm.size];
+        vorbis_info *info = ov_info(&_file, -1);
+        _format = (info->channels == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+        _frequency = info->rate;
+        return true;
+    }
 
-        size_t size = 0;
+    long read(char *buffer, size_t size)
+    {
+        size_t total = 0;
         int section = 0;
-        while (size < pcm.size) {
-            status = ov_read(&ogg.file, pcm.data + size, pcm.size - size, 0, 2, 1, &section);
-            if (status > 0) {
-                size += status;
-            } else if (status < 0) {
-                fprintf(stderr, "OGG file decoding stopped, file '%s'\n", file.debugName.c_str());
-                return false;
-            } else {
+        while (total < size) {
+            long status = ov_read(&_file, buffer + total, size - total, 0, 2, 1, &section);
+            if (status > 0)
+                total += status;
+            else if (status == 0)
                 break;
-            }
+            else if (status != OV_HOLE)
+                return -1;
         }
-        if (size == 0) {
+        return (long)total;
+    }
+
+    bool rewind()
+    {
+        return ov_pcm_seek(&_file, 0) == 0;
+    }
+
+    ogg_int64_t getPCMTotal()
+    {
+        return ov_pcm_total(&_file, -1);
+    }
+
+private:
+    OggVorbis_File _file;
+    bool _opened;
+};
+
+class VorbisDecoder : public OpenALDecoder
+{
+public:
+    bool decode(OpenALFile &file, OpenALPCM &result)
+    {
+        VorbisStream ogg;
+        if (!ogg.open(file))
+            return false;
+
+        size_t size = ogg.getPCMTotal() * (ogg.getFormat() == AL_FORMAT_MONO16 ? 1 : 2) * 2;
+        result.data.resize(size);
+        long done = ogg.read(result.data.data(), size);
+        if (done < 0) {
+            fprintf(stderr, "OGG file decoding stopped, file '%s'\n", file.debugName.c_str());
+            return false;
+        }
+        if (done == 0) {
             fprintf(stderr, "Unable to read OGG data from '%s'\n", file.debugName.c_str());
-			return false;
+            return false;
+        }
+        result.data.resize(done);
+        result.format = ogg.getFormat();
+        result.frequency = ogg.getFrequency();
+        return true;
+    }
+
+    OpenALStream *openStream(OpenALFile &file)
+    {
+        VorbisStream *stream = new VorbisStream();
+        if (!stream->open(file)) {
+            delete stream;
+            return NULL;
         }
-        return initALBuffer(result, format, pcm.data, pcm.size, info->rate);
+        return stream;
     }
 
     bool acceptsFormat(Format format) const
@@ -242,7 +339,7 @@ public:
         return decoder;
     }
 
-    bool decode(OpenALFile &file, ALuint &result)
+    bool decode(OpenALFile &file, OpenALPCM &result)
     {
         if (!file.mapToMemory())
             return false;
@@ -268,8 +365,10 @@ public:
             }
         }
 
-        return initALBuffer(result, getALFormat(sampleType, channelType),
-                            pcm.GetPointer(), pcm.GetPosition(), sampleRate);
+        result.format = getALFormat(sampleType, channelType);
+        result.frequency = sampleRate;
+        result.data.assign((const char *)pcm.GetPointer(), (const char *)pcm.GetPointer() + pcm.GetPosition());
+        return true;
     }
 
     bool acceptsFormat(Format format) const
@@ -401,6 +500,55 @@ bool OpenALDecoder::initALBuffer(ALuint &result, ALenum format,
     return true;
 }
 
+bool OpenALDecoder::initALBuffer(ALuint &result, const OpenALPCM &pcm)
+{
+    return initALBuffer(result, pcm.format, pcm.data.data(), pcm.data.size(), pcm.frequency);
+}
+
+bool OpenALDecoder::decode(OpenALFile &file, ALuint &result)
+{
+    OpenALPCM pcm;
+    return decode(file, pcm) && initALBuffer(result, pcm);
+}
+
+bool OpenALDecoder::decodeFile(const std::string &fullPath, OpenALPCM &result)
+{
+    OpenALFile file;
+    file.debugName = fullPath;
+    file.file = fopen(fullPath.c_str(), "rb");
+    if (!file.file) {
+        fprintf(stderr, "Cannot read file: '%s'\n", fullPath.c_str());
+        return false;
+    }
+
+    for (size_t i = 0, n = _decoders.size(); i < n; ++i) {
+        if (!file.file)
+            break;
+        fseek(file.file, 0, SEEK_SET);
+        if (_decoders[i]->decode(file, result))
+            return true;
+    }
+    return false;
+}
+
+OpenALStream *OpenALDecoder::openFileStream(const std::string &fullPath)
+{
+    OpenALFile file;
+    file.debugName = fullPath;
+    file.file = fopen(fullPath.c_str(), "rb");
+    if (!file.file)
+        return NULL;
+
+    for (size_t i = 0, n = _decoders.size(); i < n; ++i) {
+        if (!file.file)
+            break;
+        fseek(file.file, 0, SEEK_SET);
+        if (OpenALStream *stream = _decoders[i]->openStream(file))
+            return stream;
+    }
+    return NULL;
+}
+
 const std::vector<OpenALDecoder *> &OpenALDecoder::getDecoders()
 {
     return _decoders;
@@ -29,6 +29,38 @@ struct OpenALFile
     bool mapToMemory();
 };
 
+/// Decoded samples, ready to be given to alBufferData().
+struct OpenALPCM
+{
+    ALenum format;
+    ALsizei frequency;
+    std::vector<char> data;
+
+    OpenALPCM() : format(AL_NONE), frequency(0) {}
+};
+
+/// A file decoded progressively, see OpenALDecoder::openStream().
+class OpenALStream
+{
+public:
+    virtual ~OpenALStream() {}
+
+    ALenum getFormat() const { return _format; }
+    ALsizei getFrequency() const { return _frequency; }
+
+    /// Decodes up to `size` bytes of samples.
+    /// Returns the number of bytes decoded, 0 at the end of the stream and -1 on errors.
+    virtual long read(char *buffer, size_t size) = 0;
+    /// Goes back to the first sample.
+    virtual bool rewind() = 0;
+
+protected:
+    OpenALStream() : _format(AL_NONE), _frequency(0) {}
+
+    ALenum _format;
+    ALsizei _frequency;
+};
+
 class OpenALDecoder
 {
 public:
@@ -45,16 +77,29 @@ public:
     virtual ~OpenALDecoder() {}
 
     /// Returns true if such format is supported and decoding was successful.
-    virtual bool decode(OpenALFile &file, ALuint &result) = 0;
+    /// Doesn't call OpenAL, so several files can be decoded on different threads.
+    virtual bool decode(OpenALFile &file, OpenALPCM &result) = 0;
+    /// Opens the file for progressive decoding, returns NULL if the decoder can't stream it.
+    /// On success the stream owns file.file.
+    virtual OpenALStream *openStream(OpenALFile &/*file*/) { return NULL; }
     virtual bool acceptsFormat(Format format) const = 0;
 
+    /// Decodes the whole file into a new OpenAL buffer.
+    bool decode(OpenALFile &file, ALuint &result);
+
+    /// Tries the installed decoders one after the other.
+    static bool decodeFile(const std::string &fullPath, OpenALPCM &result);
+    static OpenALStream *openFileStream(const std::string &fullPath);
+    /// Creates an OpenAL buffer holding the samples.
+    static bool initALBuffer(ALuint &result, const OpenALPCM &pcm);
+
     static const std::vector<OpenALDecoder *> &getDecoders();
     static void installDecoders();
 
 protected:
     static void addDecoder(OpenALDecoder *decoder);
-    bool initALBuffer(ALuint &result, ALenum format,
-                      const ALvoid* data, ALsizei size, ALsizei freq);
+    static bool initALBuffer(ALuint &result, ALenum format,
+                             const ALvoid* data, ALsizei size, ALsizei freq);
 
     static std::vector<OpenALDecoder *> _decoders;
 };
@@ -0,0 +1,225 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "OpenALStreamPlayer.h"
+#include <chrono>
+
+namespace CocosDenshion {
+
+// the buffers last about 1.5 seconds for 16 bits stereo at 44.1kHz, checking them every 50ms is plenty
+static const int REFILL_INTERVAL_MS = 50;
+
+OpenALStreamPlayer::OpenALStreamPlayer(OpenALStream *stream)
+    : _stream(stream)
+    , _source(AL_NONE)
+    , _state(State::STOPPED)
+    , _loop(false)
+    , _endOfStream(false)
+    , _running(false)
+{
+    for (int i = 0; i < BUFFER_COUNT; ++i)
+        _buffers[i] = AL_NONE;
+}
+
+OpenALStreamPlayer::~OpenALStreamPlayer()
+{
+    if (_running) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _running = false;
+        }
+        _condition.notify_one();
+        _thread.join();
+    }
+
+    if (_source != AL_NONE) {
+        stopSource();
+        alDeleteSources(1, &_source);
+    }
+    if (_buffers[0] != AL_NONE)
+        alDeleteBuffers(BUFFER_COUNT, _buffers);
+    delete _stream;
+}
+
+bool OpenALStreamPlayer::init()
+{
+    alGetError();
+    alGenSources(1, &_source);
+    if (alGetError() != AL_NO_ERROR) {
+        _source = AL_NONE;
+        return false;
+    }
+    alGenBuffers(BUFFER_COUNT, _buffers);
+    if (alGetError() != AL_NO_ERROR) {
+        _buffers[0] = AL_NONE;
+        return false;
+    }
+
+    _data.resize(BUFFER_SIZE);
+    _running = true;
+    _thread = std::thread(&OpenALStreamPlayer::threadFunc, this);
+    return true;
+}
+
+void OpenALStreamPlayer::play(bool loop)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    stopSource();
+    _loop = loop;
+    queueBuffers();
+    alSourcePlay(_source);
+    _state = State::PLAYING;
+}
+
+void OpenALStreamPlayer::stop()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    stopSource();
+}
+
+void OpenALStreamPlayer::pause()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_state == State::PLAYING) {
+        alSourcePause(_source);
+        _state = State::PAUSED;
+    }
+}
+
+void OpenALStreamPlayer::resume()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_state == State::PAUSED) {
+        alSourcePlay(_source);
+        _state = State::PLAYING;
+    }
+}
+
+void OpenALStreamPlayer::rewind()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    State state = _state;
+    stopSource();
+    if (state == State::STOPPED)
+        return;
+
+    queueBuffers();
+    alSourcePlay(_source);
+    _state = State::PLAYING;
+    if (state == State::PAUSED) {
+        alSourcePause(_source);
+        _state = State::PAUSED;
+    }
+}
+
+bool OpenALStreamPlayer::isPlaying()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _state == State::PLAYING;
+}
+
+void OpenALStreamPlayer::stopSource()
+{
+    alSourceStop(_source);
+    // detaching the buffer of a stopped source unqueues all its buffers
+    alSourcei(_source, AL_BUFFER, 0);
+    _stream->rewind();
+    _endOfStream = false;
+    _state = State::STOPPED;
+}
+
+void OpenALStreamPlayer::queueBuffers()
+{
+    for (int i = 0; i < BUFFER_COUNT; ++i) {
+        if (!fillBuffer(_buffers[i]))
+            break;
+        alSourceQueueBuffers(_source, 1, &_buffers[i]);
+    }
+}
+
+bool OpenALStreamPlayer::fillBuffer(ALuint buffer)
+{
+    if (_endOfStream)
+        return false;
+
+    size_t size = 0;
+    bool rewound = false;
+    while (size < BUFFER_SIZE) {
+        long done = _stream->read(_data.data() + size, BUFFER_SIZE - size);
+        if (done > 0) {
+            size += done;
+            rewound = false;
+            continue;
+        }
+        // an empty stream must not be rewound forever
+        if (done == 0 && _loop && !rewound && _stream->rewind()) {
+            rewound = true;
+            continue;
+        }
+        break;
+    }
+
+    if (size == 0) {
+        _endOfStream = true;
+        return false;
+    }
+    alBufferData(buffer, _stream->getFormat(), _data.data(), (ALsizei)size, _stream->getFrequency());
+    return true;
+}
+
+void OpenALStreamPlayer::threadFunc()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        _condition.wait_for(lock, std::chrono::milliseconds(REFILL_INTERVAL_MS));
+        if (!_running)
+            break;
+        if (_state != State::PLAYING)
+            continue;
+
+        ALint processed = 0;
+        alGetSourcei(_source, AL_BUFFERS_PROCESSED, &processed);
+        while (processed-- > 0) {
+            ALuint buffer = AL_NONE;
+            alSourceUnqueueBuffers(_source, 1, &buffer);
+            if (fillBuffer(buffer))
+                alSourceQueueBuffers(_source, 1, &buffer);
+        }
+
+        ALint state = AL_STOPPED;
+        alGetSourcei(_source, AL_SOURCE_STATE, &state);
+        if (state != AL_PLAYING) {
+            ALint queued = 0;
+            alGetSourcei(_source, AL_BUFFERS_QUEUED, &queued);
+            if (queued > 0) {
+                // the decoding was late and the source ran out of samples
+                alSourcePlay(_source);
+            } else {
+                // played to the end
+                stopSource();
+            }
+        }
+    }
+}
+
+} // namespace CocosDenshion
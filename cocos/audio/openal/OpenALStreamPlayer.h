@@ -0,0 +1,95 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef COCOSDENSHION_OPENALSTREAMPLAYER_H
+#define COCOSDENSHION_OPENALSTREAMPLAYER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <AL/al.h>
+#include "OpenALDecoder.h"
+
+namespace CocosDenshion {
+
+/// Plays an OpenALStream through a small queue of OpenAL buffers,
+/// refilled by a decoding thread while the source plays.
+/// Memory usage doesn't depend on the length of the file.
+class OpenALStreamPlayer
+{
+public:
+    static const int BUFFER_COUNT = 4;
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    /// Takes the ownership of the stream.
+    explicit OpenALStreamPlayer(OpenALStream *stream);
+    /// Stops the playback and the decoding thread.
+    ~OpenALStreamPlayer();
+
+    /// Creates the OpenAL source and buffers and starts the decoding thread.
+    bool init();
+
+    ALuint getSource() const { return _source; }
+
+    /// Starts playing from the beginning.
+    void play(bool loop);
+    void stop();
+    void pause();
+    void resume();
+    void rewind();
+
+    /// Whether the stream is playing, even if the source is briefly starved.
+    bool isPlaying();
+
+private:
+    enum class State
+    {
+        STOPPED,
+        PLAYING,
+        PAUSED
+    };
+
+    void threadFunc();
+    void stopSource();
+    void queueBuffers();
+    bool fillBuffer(ALuint buffer);
+
+    OpenALStream *_stream;
+    ALuint _source;
+    ALuint _buffers[BUFFER_COUNT];
+    std::vector<char> _data;
+
+    State _state;
+    bool _loop;
+    bool _endOfStream;
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _running;
+};
+
+} // namespace CocosDenshion
+
+#endif // COCOSDENSHION_OPENALSTREAMPLAYER_H
@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include <AL/alc.h>
 #include <AL/alut.h>
 #include "OpenALDecoder.h"
+#include "OpenALStreamPlayer.h"
+#include "base/CCThreadPool.h"
 
 #ifdef ENABLE_MPG123
 #include <mpg123.h>
@@ -45,6 +47,12 @@ using namespace std;
 
 namespace CocosDenshion {
 
+// Memory used by the samples of the loaded effects. Beyond it, the effects
+// played the longest time ago are unloaded, and decoded again when played.
+#ifndef CC_OPENAL_EFFECTS_CACHE_SIZE
+#define CC_OPENAL_EFFECTS_CACHE_SIZE (32 * 1024 * 1024)
+#endif
+
 struct soundData {
     ALuint buffer;
     ALuint source;
@@ -52,11 +60,20 @@ struct soundData {
     float pitch;
     float pan;
     float gain;
+    size_t size;
+    unsigned int lastUse;
 };
 
 typedef map<string, soundData *> EffectsMap;
 EffectsMap s_effects;
 
+static size_t s_effectsSize = 0;
+static unsigned int s_effectsUseCounter = 0;
+
+// callbacks of the effects being decoded by preloadEffectAsync()
+typedef map<string, vector<std::function<void(bool)>>> PendingEffectsMap;
+static PendingEffectsMap s_pendingEffects;
+
 typedef enum {
     PLAYING,
     STOPPED,
@@ -75,6 +92,10 @@ typedef map<string, backgroundMusicData *> BackgroundMusicsMap;
 BackgroundMusicsMap s_backgroundMusics;
 
 static ALuint s_backgroundSource = AL_NONE;
+// background music not preloaded, decoded while it plays
+static OpenALStreamPlayer *s_backgroundStream = nullptr;
+// kept when the music is stopped without releasing its data, to play it again
+static std::string s_backgroundStreamPath;
 
 static SimpleAudioEngine  *s_engine = nullptr;
 
@@ -117,6 +138,22 @@ static void stopBackground(bool bReleaseData)
     // Stop request can come from
     //   - stopBackgroundMusic(..)
     //   - end(..)
+    if (s_backgroundStream)
+    {
+        if (bReleaseData)
+        {
+            delete s_backgroundStream;
+            s_backgroundStream = nullptr;
+            s_backgroundStreamPath.clear();
+        }
+        else
+        {
+            s_backgroundStream->stop();
+        }
+        s_backgroundSource = AL_NONE;
+        return;
+    }
+
     if (s_backgroundSource != AL_NONE)
         alSourceStop(s_backgroundSource);
 
@@ -145,6 +182,82 @@ static void setBackgroundVolume(float volume)
     alSourcef(s_backgroundSource, AL_GAIN, volume);
 }
 
+static void deleteEffect(EffectsMap::iterator iter)
+{
+    checkALError("deleteEffect:init");
+
+    alSourceStop(iter->second->source);
+    checkALError("deleteEffect:alSourceStop");
+
+    alDeleteSources(1, &iter->second->source);
+    checkALError("deleteEffect:alDeleteSources");
+
+    alDeleteBuffers(1, &iter->second->buffer);
+    checkALError("deleteEffect:alDeleteBuffers");
+
+    s_effectsSize -= iter->second->size;
+    delete iter->second;
+    s_effects.erase(iter);
+}
+
+// unloads the least recently played effects, except the ones playing, until an effect of incomingSize fits the cache
+static void trimEffects(size_t incomingSize)
+{
+    while (!s_effects.empty() && s_effectsSize + incomingSize > CC_OPENAL_EFFECTS_CACHE_SIZE)
+    {
+        EffectsMap::iterator oldest = s_effects.end();
+        for (auto it = s_effects.begin(); it != s_effects.end(); ++it)
+        {
+            ALint state;
+            alGetSourcei(it->second->source, AL_SOURCE_STATE, &state);
+            if (state == AL_PLAYING || state == AL_PAUSED)
+                continue;
+            if (oldest == s_effects.end() || it->second->lastUse < oldest->second->lastUse)
+                oldest = it;
+        }
+        if (oldest == s_effects.end())
+            break;
+        deleteEffect(oldest);
+    }
+}
+
+static bool addEffect(const std::string& fullPath, const OpenALPCM& pcm)
+{
+    checkALError("addEffect:init");
+
+    // trims before inserting, the new effect must not be the one unloaded
+    trimEffects(pcm.data.size());
+
+    ALuint buffer = AL_NONE;
+    if (!OpenALDecoder::initALBuffer(buffer, pcm))
+        return false;
+
+    ALuint source = AL_NONE;
+    alGenSources(1, &source);
+    if (checkALError("addEffect:alGenSources") != AL_NO_ERROR)
+    {
+        alDeleteBuffers(1, &buffer);
+        return false;
+    }
+
+    alSourcei(source, AL_BUFFER, buffer);
+    checkALError("addEffect:alSourcei");
+
+    soundData  *data = new soundData;
+    data->isLooped = false;
+    data->buffer = buffer;
+    data->source = source;
+    data->pitch = 1.0;
+    data->pan = 0.0;
+    data->gain = 1.0;
+    data->size = pcm.data.size();
+    data->lastUse = ++s_effectsUseCounter;
+
+    s_effects.insert(EffectsMap::value_type(fullPath, data));
+    s_effectsSize += data->size;
+    return true;
+}
+
 SimpleAudioEngine::SimpleAudioEngine()
 {
     alutInit(0, 0);
@@ -176,21 +289,12 @@ void SimpleAudioEngine::end()
     checkALError("end:init");
 
     // clear all the sound effects
-    EffectsMap::const_iterator end = s_effects.end();
-    for (auto it = s_effects.begin(); it != end; ++it)
+    while (!s_effects.empty())
     {
-        alSourceStop(it->second->source);
-        checkALError("end:alSourceStop");
-
-        alDeleteSources(1, &it->second->source);
-        checkALError("end:alDeleteSources");
-
-        alDeleteBuffers(1, &it->second->buffer);
-        checkALError("end:alDeleteBuffers");
-
-        delete it->second;
+        deleteEffect(s_effects.begin());
     }
-    s_effects.clear();
+    // the effects still being decoded are dropped when they are done
+    s_pendingEffects.clear();
 
     // and the background music too
     stopBackground(true);
@@ -265,6 +369,40 @@ void SimpleAudioEngine::playBackgroundMusic(const char* pszFilePath, bool bLoop)
     BackgroundMusicsMap::const_iterator it = s_backgroundMusics.find(fullPath);
     if (it == s_backgroundMusics.end())
     {
+        // the stream of a music stopped without releasing its data plays again
+        if (s_backgroundStream && s_backgroundStreamPath == fullPath)
+        {
+            s_backgroundSource = s_backgroundStream->getSource();
+            setBackgroundVolume(s_volume);
+            s_backgroundStream->play(bLoop);
+            checkALError("playBackgroundMusic:play");
+            return;
+        }
+        if (s_backgroundStream)
+        {
+            delete s_backgroundStream;
+            s_backgroundStream = nullptr;
+            s_backgroundStreamPath.clear();
+        }
+
+        // stream the music instead of decoding it all at once, when the decoder can
+        OpenALStream *stream = OpenALDecoder::openFileStream(fullPath);
+        if (stream)
+        {
+            OpenALStreamPlayer *player = new OpenALStreamPlayer(stream);
+            if (player->init())
+            {
+                s_backgroundStream = player;
+                s_backgroundStreamPath = fullPath;
+                s_backgroundSource = player->getSource();
+                setBackgroundVolume(s_volume);
+                player->play(bLoop);
+                checkALError("playBackgroundMusic:play");
+                return;
+            }
+            delete player;
+        }
+
         preloadBackgroundMusic(fullPath.c_str());
         it = s_backgroundMusics.find(fullPath);
     }
@@ -285,6 +423,12 @@ void SimpleAudioEngine::stopBackgroundMusic(bool bReleaseData)
     if (s_backgroundSource == AL_NONE)
         return;
 
+    if (s_backgroundStream)
+    {
+        stopBackground(bReleaseData);
+        return;
+    }
+
     ALint state;
     alGetSourcei(s_backgroundSource, AL_SOURCE_STATE, &state);
     if (state == AL_PLAYING)
@@ -297,6 +441,12 @@ void SimpleAudioEngine::pauseBackgroundMusic()
     if (s_backgroundSource == AL_NONE)
         return;
 
+    if (s_backgroundStream)
+    {
+        s_backgroundStream->pause();
+        return;
+    }
+
     ALint state;
     alGetSourcei(s_backgroundSource, AL_SOURCE_STATE, &state);
     if (state == AL_PLAYING)
@@ -311,6 +461,12 @@ void SimpleAudioEngine::resumeBackgroundMusic()
     if (s_backgroundSource == AL_NONE)
         return;
 
+    if (s_backgroundStream)
+    {
+        s_backgroundStream->resume();
+        return;
+    }
+
     ALint state;
     alGetSourcei(s_backgroundSource, AL_SOURCE_STATE, &state);
     if (state == AL_PAUSED)
@@ -325,6 +481,12 @@ void SimpleAudioEngine::rewindBackgroundMusic()
     if (s_backgroundSource == AL_NONE)
         return;
 
+    if (s_backgroundStream)
+    {
+        s_backgroundStream->rewind();
+        return;
+    }
+
     // Rewind and prevent the last state the source had
     ALint state;
     alGetSourcei(s_backgroundSource, AL_SOURCE_STATE, &state);
@@ -358,6 +520,9 @@ bool SimpleAudioEngine::isBackgroundMusicPlaying()
     if (s_backgroundSource == AL_NONE)
         return false;
 
+    if (s_backgroundStream)
+        return s_backgroundStream->isPlaying();
+
     ALint play_status;
     alGetSourcei(s_backgroundSource, AL_SOURCE_STATE, &play_status);
     checkALError("isBackgroundMusicPlaying:alGetSourcei");
@@ -429,6 +594,7 @@ unsigned int SimpleAudioEngine::playEffect(const char* pszFilePath, bool bLoop,
     checkALError("playEffect:init");
 
     soundData &d = *iter->second;
+    d.lastUse = ++s_effectsUseCounter;
     d.isLooped = bLoop;
     d.pitch = pitch;
     d.pan = pan;
@@ -460,46 +626,54 @@ void SimpleAudioEngine::preloadEffect(const char* pszFilePath)
     // check if we have this already
     if (iter == s_effects.end())
     {
-        ALuint      buffer = AL_NONE;
-        ALuint      source = AL_NONE;
-        
+        OpenALPCM pcm;
+        if (OpenALDecoder::decodeFile(fullPath, pcm))
+            addEffect(fullPath, pcm);
+    }
+}
 
-        checkALError("preloadEffect:init");
-        OpenALFile file;
-        file.debugName = pszFilePath;
-        file.file = fopen(fullPath.c_str(), "rb");
-        if (!file.file) {
-            fprintf(stderr, "Cannot read file: '%s'\n", fullPath.data());
-            return;
-        }
-        
-        bool success = false;
-        const std::vector<OpenALDecoder *> &decoders = OpenALDecoder::getDecoders();
-        for (size_t i = 0, n = decoders.size(); !success && i < n; ++i)
-            success = decoders[i]->decode(file, buffer);
-        file.clear();
+void SimpleAudioEngine::preloadEffectAsync(const char* pszFilePath, const std::function<void(bool)>& callback)
+{
+    // Changing file path to full path
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszFilePath);
 
-        alGenSources(1, &source);
+    if (s_effects.find(fullPath) != s_effects.end())
+    {
+        if (callback)
+            callback(true);
+        return;
+    }
 
-        if (checkALError("preloadEffect:alGenSources") != AL_NO_ERROR)
-        {
-            alDeleteBuffers(1, &buffer);
-            return;
-        }
+    // the file may already be decoding
+    auto pending = s_pendingEffects.find(fullPath);
+    if (pending != s_pendingEffects.end())
+    {
+        pending->second.push_back(callback);
+        return;
+    }
+    s_pendingEffects[fullPath].push_back(callback);
 
-        alSourcei(source, AL_BUFFER, buffer);
-        checkALError("preloadEffect:alSourcei");
-        
-        soundData  *data = new soundData;
-        data->isLooped = false;
-        data->buffer = buffer;
-        data->source = source;
-        data->pitch = 1.0;
-        data->pan = 0.0;
-        data->gain = 1.0;
+    ThreadPool::getInstance()->pushTask([fullPath]() {
+        auto pcm = std::make_shared<OpenALPCM>();
+        bool decoded = OpenALDecoder::decodeFile(fullPath, *pcm);
 
-        s_effects.insert(EffectsMap::value_type(fullPath, data));
-    }
+        // OpenAL buffers are created on the cocos thread
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([fullPath, pcm, decoded]() {
+            auto pending = s_pendingEffects.find(fullPath);
+            if (pending == s_pendingEffects.end())
+                return;
+
+            auto callbacks = std::move(pending->second);
+            s_pendingEffects.erase(pending);
+
+            bool loaded = (s_effects.find(fullPath) != s_effects.end()) || (decoded && addEffect(fullPath, *pcm));
+            for (const auto& callback : callbacks)
+            {
+                if (callback)
+                    callback(loaded);
+            }
+        });
+    });
 }
 
 void SimpleAudioEngine::unloadEffect(const char* pszFilePath)
@@ -511,19 +685,7 @@ void SimpleAudioEngine::unloadEffect(const char* pszFilePath)
 
     if (iter != s_effects.end())
     {
-        checkALError("unloadEffect:init");
-
-        alSourceStop(iter->second->source);
-        checkALError("unloadEffect:alSourceStop");
-
-        alDeleteSources(1, &iter->second->source);
-        checkALError("unloadEffect:DeletSources");
-
-        alDeleteBuffers(1, &iter->second->buffer);
-        checkALError("unloadEffect:alDeleteBuffers");
-        delete iter->second;
-
-        s_effects.erase(iter);
+        deleteEffect(iter);
     }
 }
 
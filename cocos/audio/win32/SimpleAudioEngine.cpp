@@ -192,6 +192,17 @@ void SimpleAudioEngine::preloadEffect(const char* pszFilePath)
     } while (0);
 }
 
+void SimpleAudioEngine::preloadEffectAsync(const char* pszFilePath, const std::function<void(bool)>& callback)
+{
+    preloadEffect(pszFilePath);
+    if (callback)
+    {
+        // preloadEffect() only keeps the effects it could open
+        bool loaded = pszFilePath && sharedList().end() != sharedList().find(_Hash(pszFilePath));
+        callback(loaded);
+    }
+}
+
 void SimpleAudioEngine::pauseEffect(unsigned int nSoundId)
 {
     EffectList::iterator p = sharedList().find(nSoundId);
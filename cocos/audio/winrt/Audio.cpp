@@ -464,18 +464,18 @@ bool Audio::IsSoundEffectStarted(unsigned int sound)
     return m_soundEffects[sound].m_soundEffectStarted;
 }
 
-void Audio::PreloadSoundEffect(const char* pszFilePath, bool isMusic)
+bool Audio::PreloadSoundEffect(const char* pszFilePath, bool isMusic)
 {
 
     if (m_engineExperiencedCriticalError) {
-        return;
+        return false;
     }
 
     int sound = Hash(pszFilePath);
 
 	if (m_soundEffects.end() != m_soundEffects.find(sound))
     {
-       return;
+       return true;
     }
 
 	MediaStreamer mediaStreamer;
@@ -542,6 +542,8 @@ void Audio::PreloadSoundEffect(const char* pszFilePath, bool isMusic)
 	m_soundEffects[sound].m_audioBuffer.pContext = &m_soundEffects[sound];
 	m_soundEffects[sound].m_audioBuffer.Flags = XAUDIO2_END_OF_STREAM;
     m_soundEffects[sound].m_audioBuffer.LoopCount = 0;
+
+    return m_soundEffects[sound].m_soundEffectBufferLength > 0;
 }
 
 void Audio::UnloadSoundEffect(const char* pszFilePath)
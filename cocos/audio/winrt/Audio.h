@@ -146,7 +146,7 @@ public:
     void ResumeAllSoundEffects();
     void StopAllSoundEffects();
 
-    void PreloadSoundEffect(const char* pszFilePath, bool isMusic = false);
+    bool PreloadSoundEffect(const char* pszFilePath, bool isMusic = false);
     void UnloadSoundEffect(const char* pszFilePath);
     void UnloadSoundEffect(unsigned int sound);
 };
@@ -514,10 +514,10 @@ std::string CCUnicodeToUtf8(const wchar_t* pwszStr)
 	return ret;
 }
 
-void Audio::PreloadSoundEffect(const char* pszFilePath, bool isMusic)
+bool Audio::PreloadSoundEffect(const char* pszFilePath, bool isMusic)
 {
     if (m_engineExperiencedCriticalError) {
-        return;
+        return false;
     }
 
     int sound = Hash(pszFilePath);
@@ -572,6 +572,8 @@ void Audio::PreloadSoundEffect(const char* pszFilePath, bool isMusic)
 	m_soundEffects[sound].m_audioBuffer.pContext = &m_soundEffects[sound];
 	m_soundEffects[sound].m_audioBuffer.Flags = XAUDIO2_END_OF_STREAM;
     m_soundEffects[sound].m_audioBuffer.LoopCount = 0;
+
+    return m_soundEffects[sound].m_soundEffectBufferLength > 0;
 }
 
 void Audio::UnloadSoundEffect(const char* pszFilePath)
@@ -136,6 +136,13 @@ void SimpleAudioEngine::preloadEffect(const char* pszFilePath)
     sharedAudioController()->PreloadSoundEffect(pszFilePath);
 }
 
+void SimpleAudioEngine::preloadEffectAsync(const char* pszFilePath, const std::function<void(bool)>& callback)
+{
+    bool loaded = sharedAudioController()->PreloadSoundEffect(pszFilePath);
+    if (callback)
+        callback(loaded);
+}
+
 void SimpleAudioEngine::pauseEffect(unsigned int nSoundId)
 {
     sharedAudioController()->PauseSoundEffect(nSoundId);
@@ -25,10 +25,55 @@
 #include "base/CCDirector.h"
 #include "platform/CCGLView.h"
 #include "2d/CCScene.h"
+#include "renderer/CCRenderer.h"
 
 NS_CC_BEGIN
 
 Camera* Camera::_visitingCamera = nullptr;
+std::vector<Camera*> Camera::_visitingCameras;
+
+bool Camera::selectVisitingCameras(unsigned short cameraMask)
+{
+    unsigned int passMask = 0;
+    Camera* first = nullptr;
+    for (size_t pass = 0; pass < _visitingCameras.size(); ++pass)
+    {
+        auto camera = _visitingCameras[pass];
+        if (camera->_cameraFlag & cameraMask)
+        {
+            passMask |= 1u << pass;
+            if (!first)
+                first = camera;
+        }
+    }
+
+    Director::getInstance()->getRenderer()->setCameraPassMask(passMask);
+    if (first)
+        _visitingCamera = first;
+    return passMask != 0;
+}
+
+Camera::SelectionScope::SelectionScope()
+: _renderer(nullptr)
+, _passMask(0)
+, _visitingCamera(nullptr)
+{
+    if (!_visitingCameras.empty())
+    {
+        _renderer = Director::getInstance()->getRenderer();
+        _passMask = _renderer->getCameraPassMask();
+        _visitingCamera = Camera::_visitingCamera;
+    }
+}
+
+Camera::SelectionScope::~SelectionScope()
+{
+    if (_renderer)
+    {
+        _renderer->setCameraPassMask(_passMask);
+        Camera::_visitingCamera = _visitingCamera;
+    }
+}
 
 Camera* Camera::create()
 {
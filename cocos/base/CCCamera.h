@@ -134,6 +134,36 @@ public:
     
     static const Camera* getVisitingCamera() { return _visitingCamera; }
 
+    /**
+     * Cameras of the render passes of the current frame, in rendering order, when the scene is visited once for all of them.
+     * Empty when the scene is visited once per camera.
+     */
+    static const std::vector<Camera*>& getVisitingCameras() { return _visitingCameras; }
+
+    /**
+     * Selects the render passes of the cameras that see a node with the given camera mask: the next render commands are added to them,
+     * and getVisitingCamera() returns the first of these cameras. Returns false if no camera sees the node.
+     * Only used when the scene is visited once for all its cameras.
+     */
+    static bool selectVisitingCameras(unsigned short cameraMask);
+
+    /**
+     * Saves the selection of selectVisitingCameras() and restores it when destroyed.
+     * Node::visit() and the engine nodes that visit their children themselves use it, so a node drawn after its children
+     * still adds its commands to the passes of its own cameras.
+     */
+    class CC_DLL SelectionScope
+    {
+    public:
+        SelectionScope();
+        ~SelectionScope();
+
+    private:
+        Renderer* _renderer;
+        unsigned int _passMask;
+        Camera* _visitingCamera;
+    };
+
 CC_CONSTRUCTOR_ACCESS:
     Camera();
     ~Camera();
@@ -166,6 +196,7 @@ protected:
     unsigned short _cameraFlag; // camera flag
     
     static Camera* _visitingCamera;
+    static std::vector<Camera*> _visitingCameras;
     
     friend class Director;
 };
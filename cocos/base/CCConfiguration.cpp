@@ -44,6 +44,7 @@ Configuration::Configuration()
 , _supportsBGRA8888(false)
 , _supportsDiscardFramebuffer(false)
 , _supportsShareableVAO(false)
+, _supportsProgramBinary(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -142,6 +143,18 @@ void Configuration::gatherGPUInfo()
     _supportsShareableVAO = checkForGLExtension("vertex_array_object");
 	_valueDict["gl.supports_vertex_array_object"] = Value(_supportsShareableVAO);
 
+    // some drivers expose the extension without any binary format
+    GLint binaryFormats = 0;
+#if defined(GL_NUM_PROGRAM_BINARY_FORMATS_OES)
+    if (checkForGLExtension("get_program_binary"))
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &binaryFormats);
+#elif defined(GL_NUM_PROGRAM_BINARY_FORMATS)
+    if (checkForGLExtension("get_program_binary"))
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+#endif
+    _supportsProgramBinary = binaryFormats > 0;
+    _valueDict["gl.supports_program_binary"] = Value(_supportsProgramBinary);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -247,6 +260,11 @@ bool Configuration::supportsShareableVAO() const
 #endif
 }
 
+bool Configuration::supportsProgramBinary() const
+{
+    return _supportsProgramBinary;
+}
+
 int Configuration::getMaxSupportDirLightInShader() const
 {
     return _maxDirLightInShader;
@@ -110,6 +110,11 @@ public:
      @since v2.0.0
      */
 	bool supportsShareableVAO() const;
+
+    /** Whether or not program binaries can be retrieved and loaded back (get_program_binary).
+     @since v3.3
+     */
+    bool supportsProgramBinary() const;
     
     /** Max support directional light in shader, for Sprite3D
      @since v3.3
@@ -162,6 +167,7 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsProgramBinary;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
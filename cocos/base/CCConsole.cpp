@@ -63,6 +63,7 @@
 #include "renderer/CCTextureCache.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include "base/CCTrace.h"
 NS_CC_BEGIN
 
 extern const char* cocos2dVersion(void);
@@ -295,6 +296,7 @@ Console::Console()
         { "texture", "Flush or print the TextureCache info. Args: [flush | ] ", std::bind(&Console::commandTextures, this, std::placeholders::_1, std::placeholders::_2) },
         { "director", "director commands, type -h or [director help] to list supported directives", std::bind(&Console::commandDirector, this, std::placeholders::_1, std::placeholders::_2) },
         { "touch", "simulate touch event via console, type -h or [touch help] to list supported directives", std::bind(&Console::commandTouch, this, std::placeholders::_1, std::placeholders::_2) },
+        { "trace", "Record a trace for chrome://tracing. Args: [start [events_per_thread] | stop | save [filename] | ]", std::bind(&Console::commandTrace, this, std::placeholders::_1, std::placeholders::_2) },
         { "upload", "upload file. Args: [filename base64_encoded_data]", std::bind(&Console::commandUpload, this, std::placeholders::_1) },
         { "version", "print version string ", [](int fd, const std::string& args) {
             mydprintf(fd, "%s\n", cocos2dVersion());
@@ -592,6 +594,54 @@ void Console::commandTextures(int fd, const std::string& args)
 }
 
 
+void Console::commandTrace(int fd, const std::string& args)
+{
+    auto argv = split(args, ' ');
+
+    if (args.length() == 0)
+    {
+        mydprintf(fd, "trace is %s\n", Trace::isRecording() ? "recording" : "stopped");
+    }
+    else if (argv[0] == "start")
+    {
+        size_t eventsPerThread = 65536;
+        if (argv.size() > 1)
+        {
+            eventsPerThread = (size_t)std::max(atoi(argv[1].c_str()), 1);
+        }
+        Trace::start(eventsPerThread);
+        mydprintf(fd, "trace started\n");
+    }
+    else if (argv[0] == "stop")
+    {
+        Trace::stop();
+        mydprintf(fd, "trace stopped\n");
+    }
+    else if (argv[0] == "save")
+    {
+        std::string filename = argv.size() > 1 ? argv[1] : "trace.json";
+        std::string fullPath = FileUtils::getInstance()->getWritablePath() + filename;
+        // runs between two frames, no zone of the cocos thread is open
+        Scheduler *sched = Director::getInstance()->getScheduler();
+        sched->performFunctionInCocosThread( [=](){
+            bool recording = Trace::isRecording();
+            Trace::stop();
+            bool saved = Trace::writeToFile(fullPath);
+            if (recording)
+            {
+                // the trace was stopped to be read, keep recording in a new one of the same size
+                Trace::start(Trace::getEventsPerThread());
+            }
+            mydprintf(fd, saved ? "trace saved to %s\n" : "can't write %s\n", fullPath.c_str());
+            sendPrompt(fd);
+        } );
+    }
+    else
+    {
+        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'start', 'stop', 'save' or nothing\n", args.c_str());
+    }
+}
+
 void Console::commandDirector(int fd, const std::string& args)
 {
      auto director = Director::getInstance();
@@ -122,6 +122,7 @@ protected:
     void commandProjection(int fd, const std::string &args);
     void commandDirector(int fd, const std::string &args);
     void commandTouch(int fd, const std::string &args);
+    void commandTrace(int fd, const std::string &args);
     void commandUpload(int fd);
     // file descriptor: socket, console, etc.
     int _listenfd;
@@ -43,6 +43,7 @@ THE SOFTWARE.
 #include "2d/CCFontFreeType.h"
 #include "2d/CCLabelAtlas.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramBinaryCache.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/CCTextureCache.h"
 #include "renderer/ccGLStateCache.h"
@@ -57,7 +58,9 @@ THE SOFTWARE.
 #include "base/CCConsole.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
+#include "base/CCThreadPool.h"
 #include "platform/CCApplication.h"
+#include "base/CCTrace.h"
 //#include "platform/CCGLViewImpl.h"
 
 /**
@@ -84,6 +87,7 @@ const char *Director::EVENT_PROJECTION_CHANGED = "director_projection_changed";
 const char *Director::EVENT_AFTER_DRAW = "director_after_draw";
 const char *Director::EVENT_AFTER_VISIT = "director_after_visit";
 const char *Director::EVENT_AFTER_UPDATE = "director_after_update";
+const char *Director::EVENT_PURGE_CACHED_DATA = "director_purge_cached_data";
 
 Director* Director::getInstance()
 {
@@ -98,12 +102,14 @@ Director* Director::getInstance()
 }
 
 Director::Director()
+: _projectionMatrixVersion(0)
 {
 }
 
 bool Director::init(void)
 {
     setDefaultValues();
+    Trace::setThreadName("cocos2d main");
 
     // scenes
     _runningScene = nullptr;
@@ -258,6 +264,9 @@ void Director::drawScene()
         return;
     }
 
+    CC_TRACE_FRAME(_totalFrames);
+    CC_TRACE_ZONE("Director::drawScene");
+
     if (_openGLView)
     {
         _openGLView->pollEvents();
@@ -266,6 +275,7 @@ void Director::drawScene()
     //tick before glClear: issue #533
     if (! _paused)
     {
+        CC_TRACE_ZONE("Director::update");
         _scheduler->update(_deltaTime);
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
@@ -288,6 +298,7 @@ void Director::drawScene()
         _renderer->clearDrawStats();
         
         //render the scene
+        CC_TRACE_ZONE("Scene::render");
         _runningScene->render(_renderer);
         
         _eventDispatcher->dispatchEvent(_eventAfterVisit);
@@ -311,9 +322,13 @@ void Director::drawScene()
 
     _totalFrames++;
 
+    CC_TRACE_COUNTER("Draw calls", _renderer->getDrawnBatches());
+    CC_TRACE_COUNTER("Drawn vertices", _renderer->getDrawnVertices());
+
     // swap buffers
     if (_openGLView)
     {
+        CC_TRACE_ZONE("GLView::swapBuffers");
         _openGLView->swapBuffers();
     }
 
@@ -453,6 +468,7 @@ void Director::initMatrixStack()
     _modelViewMatrixStack.push(Mat4::IDENTITY);
     _projectionMatrixStack.push(Mat4::IDENTITY);
     _textureMatrixStack.push(Mat4::IDENTITY);
+    ++_projectionMatrixVersion;
 }
 
 void Director::resetMatrixStack()
@@ -469,6 +485,7 @@ void Director::popMatrix(MATRIX_STACK_TYPE type)
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
         _projectionMatrixStack.pop();
+        ++_projectionMatrixVersion;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
     {
@@ -489,6 +506,7 @@ void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
         _projectionMatrixStack.top() = Mat4::IDENTITY;
+        ++_projectionMatrixVersion;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
     {
@@ -509,6 +527,7 @@ void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
         _projectionMatrixStack.top() = mat;
+        ++_projectionMatrixVersion;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
     {
@@ -529,6 +548,7 @@ void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
         _projectionMatrixStack.top() *= mat;
+        ++_projectionMatrixVersion;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_TEXTURE == type)
     {
@@ -676,6 +696,8 @@ void Director::purgeCachedData(void)
         log("%s\n", _textureCache->getCachedTextureInfo().c_str());
     }
     FileUtils::getInstance()->purgeCachedEntries();
+
+    _eventDispatcher->dispatchCustomEvent(EVENT_PURGE_CACHED_DATA);
 }
 
 float Director::getZEye(void) const
@@ -991,6 +1013,7 @@ void Director::purgeDirector()
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
     GLProgramCache::destroyInstance();
+    GLProgramBinaryCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
     FileUtils::destroyInstance();
 
@@ -1001,6 +1024,9 @@ void Director::purgeDirector()
     
     destroyTextureCache();
 
+    // after the texture cache, its loading thread may still be decoding on the pool
+    ThreadPool::destroyInstance();
+
     CHECK_GL_ERROR_DEBUG();
     
     // OpenGL view
@@ -96,6 +96,7 @@ private:
     std::stack<Mat4> _modelViewMatrixStack;
     std::stack<Mat4> _projectionMatrixStack;
     std::stack<Mat4> _textureMatrixStack;
+    unsigned int _projectionMatrixVersion;
 protected:
     void initMatrixStack();
 public:
@@ -106,11 +107,15 @@ public:
     void multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat);
     Mat4 getMatrix(MATRIX_STACK_TYPE type);
     void resetMatrixStack();
+    /** changes every time the top of the projection stack may have changed, GLProgram uses it to share the builtin uniforms */
+    unsigned int getProjectionMatrixVersion() const { return _projectionMatrixVersion; }
 public:
     static const char *EVENT_PROJECTION_CHANGED;
     static const char* EVENT_AFTER_UPDATE;
     static const char* EVENT_AFTER_VISIT;
     static const char* EVENT_AFTER_DRAW;
+    /** dispatched by purgeCachedData(), for the caches of the extensions */
+    static const char* EVENT_PURGE_CACHED_DATA;
 
 
     /** @typedef ccDirectorProjection
@@ -324,7 +329,8 @@ public:
     // Memory Helper
 
     /** Removes all cocos2d cached data.
-     It will purge the TextureCache, SpriteFrameCache, LabelBMFont cache
+     It will purge the TextureCache, SpriteFrameCache, LabelBMFont cache, and dispatch EVENT_PURGE_CACHED_DATA
+     for the other caches. Call it when the application receives a memory warning.
      @since v0.99.3
      */
     void purgeCachedData();
@@ -24,13 +24,20 @@
 
 #include "base/CCEventCustom.h"
 #include "base/CCEvent.h"
+#include "base/CCEventListener.h"
 
 NS_CC_BEGIN
 
 EventCustom::EventCustom(const std::string& eventName)
+: EventCustom(EventListener::internListenerID(eventName))
+{
+}
+
+EventCustom::EventCustom(int eventID)
 : Event(Type::CUSTOM)
 , _userData(nullptr)
-, _eventName(eventName)
+, _eventName(&EventListener::getListenerIDForInternedID(eventID))
+, _eventID(eventID)
 {
 }
 
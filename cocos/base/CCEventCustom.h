@@ -35,6 +35,9 @@ class CC_DLL EventCustom : public Event
 public:
     /** Constructor */
     EventCustom(const std::string& eventName);
+
+    /** Constructor with the interned id of the event name, see EventListener::internListenerID() */
+    EventCustom(int eventID);
     
     /** Sets user data */
     inline void setUserData(void* data) { _userData = data; };
@@ -43,10 +46,14 @@ public:
     inline void* getUserData() const { return _userData; };
     
     /** Gets event name */
-    inline const std::string& getEventName() const { return _eventName; };
+    inline const std::string& getEventName() const { return *_eventName; };
+
+    /** Gets the interned id of the event name */
+    inline int getEventID() const { return _eventID; };
 protected:
     void* _userData;       ///< User data
-    std::string _eventName;
+    const std::string* _eventName;
+    int _eventID;
 };
 
 NS_CC_END
@@ -37,6 +37,7 @@
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
+#include "base/CCTrace.h"
 
 
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
@@ -66,28 +67,25 @@ private:
 
 NS_CC_BEGIN
 
-static EventListener::ListenerID __getListenerID(Event* event)
+int EventDispatcher::getListenerID(Event* event) const
 {
-    EventListener::ListenerID ret;
+    int ret = -1;
     switch (event->getType())
     {
         case Event::Type::ACCELERATION:
-            ret = EventListenerAcceleration::LISTENER_ID;
+            ret = _accelerationListenerID;
             break;
         case Event::Type::CUSTOM:
-            {
-                auto customEvent = static_cast<EventCustom*>(event);
-                ret = customEvent->getEventName();
-            }
+            ret = static_cast<EventCustom*>(event)->getEventID();
             break;
         case Event::Type::KEYBOARD:
-            ret = EventListenerKeyboard::LISTENER_ID;
+            ret = _keyboardListenerID;
             break;
         case Event::Type::MOUSE:
-            ret = EventListenerMouse::LISTENER_ID;
+            ret = _mouseListenerID;
             break;
         case Event::Type::FOCUS:
-            ret = EventListenerFocus::LISTENER_ID;
+            ret = _focusListenerID;
             break;
         case Event::Type::TOUCH:
             // Touch listener is very special, it contains two kinds of listeners, EventListenerTouchOneByOne and EventListenerTouchAllAtOnce.
@@ -96,7 +94,7 @@ static EventListener::ListenerID __getListenerID(Event* event)
             break;
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
         case Event::Type::GAME_CONTROLLER:
-            ret = EventListenerController::LISTENER_ID;
+            ret = _controllerListenerID;
             break;
 #endif
         default:
@@ -110,7 +108,8 @@ static EventListener::ListenerID __getListenerID(Event* event)
 EventDispatcher::EventListenerVector::EventListenerVector() :
  _fixedListeners(nullptr),
  _sceneGraphListeners(nullptr),
- _gt0Index(0)
+ _gt0Index(0),
+ _dirtyFlag(DirtyFlag::NONE)
 {
 }
 
@@ -199,17 +198,30 @@ void EventDispatcher::EventListenerVector::clear()
 
 
 EventDispatcher::EventDispatcher()
-: _inDispatch(0)
+: _nodePriorityRootNode(nullptr)
+, _nodePriorityDirty(true)
+, _inDispatch(0)
 , _isEnabled(false)
 , _nodePriorityIndex(0)
+, _controllerListenerID(-1)
 {
     _toAddedListeners.reserve(50);
     
     // fixed #4129: Mark the following listener IDs for internal use.
     // Therefore, internal listeners would not be cleaned when removeAllEventListeners is invoked.
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_FOREGROUND);
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_BACKGROUND);
-    _internalCustomListenerIDs.insert(EVENT_RENDERER_RECREATED);
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_COME_TO_FOREGROUND));
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_COME_TO_BACKGROUND));
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_RENDERER_RECREATED));
+    
+    _touchOneByOneListenerID = EventListener::internListenerID(EventListenerTouchOneByOne::LISTENER_ID);
+    _touchAllAtOnceListenerID = EventListener::internListenerID(EventListenerTouchAllAtOnce::LISTENER_ID);
+    _accelerationListenerID = EventListener::internListenerID(EventListenerAcceleration::LISTENER_ID);
+    _keyboardListenerID = EventListener::internListenerID(EventListenerKeyboard::LISTENER_ID);
+    _mouseListenerID = EventListener::internListenerID(EventListenerMouse::LISTENER_ID);
+    _focusListenerID = EventListener::internListenerID(EventListenerFocus::LISTENER_ID);
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+    _controllerListenerID = EventListener::internListenerID(EventListenerController::LISTENER_ID);
+#endif
 }
 
 EventDispatcher::~EventDispatcher()
@@ -411,6 +423,8 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     {
         listeners = new std::vector<EventListener*>();
         _nodeListenersMap.insert(std::make_pair(node, listeners));
+        // the node has no priority yet
+        _nodePriorityDirty = true;
     }
     
     listeners->push_back(listener);
@@ -454,7 +468,7 @@ void EventDispatcher::addEventListener(EventListener* listener)
 void EventDispatcher::forceAddEventListener(EventListener* listener)
 {
     EventListenerVector* listeners = nullptr;
-    EventListener::ListenerID listenerID = listener->getListenerID();
+    int listenerID = listener->getInternedListenerID();
     auto itr = _listenerMap.find(listenerID);
     if (itr == _listenerMap.end())
     {
@@ -627,7 +641,9 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         }
     };
     
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
+    // a listener can only be in the vector of its own listener ID
+    auto iter = _listenerMap.find(listener->getInternedListenerID());
+    if (iter != _listenerMap.end())
     {
         auto listeners = iter->second;
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
@@ -637,14 +653,14 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         if (isFound)
         {
             // fixed #4160: Dirty flag need to be updated after listeners were removed.
-            setDirty(listener->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+            setDirty(listener->getInternedListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
         }
         else
         {
             removeListenerInVector(fixedPriorityListeners);
             if (isFound)
             {
-                setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
+                setDirty(listener->getInternedListenerID(), DirtyFlag::FIXED_PRIORITY);
             }
         }
         
@@ -660,20 +676,11 @@ void EventDispatcher::removeEventListener(EventListener* listener)
                  "Listener should be in no lists after this is done if we're not currently in dispatch mode.");
 #endif
 
-        if (iter->second->empty())
-        {
-            _priorityDirtyFlagMap.erase(listener->getListenerID());
-            auto list = iter->second;
-            iter = _listenerMap.erase(iter);
-            CC_SAFE_DELETE(list);
-        }
-        else
+        if (listeners->empty())
         {
-            ++iter;
+            _listenerMap.erase(iter);
+            CC_SAFE_DELETE(listeners);
         }
-        
-        if (isFound)
-            break;
     }
 
     if (isFound)
@@ -700,22 +707,19 @@ void EventDispatcher::setPriority(EventListener* listener, int fixedPriority)
     if (listener == nullptr)
         return;
     
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end(); ++iter)
+    auto listeners = getListeners(listener->getInternedListenerID());
+    auto fixedPriorityListeners = listeners ? listeners->getFixedPriorityListeners() : nullptr;
+    if (fixedPriorityListeners)
     {
-        auto fixedPriorityListeners = iter->second->getFixedPriorityListeners();
-        if (fixedPriorityListeners)
+        auto found = std::find(fixedPriorityListeners->begin(), fixedPriorityListeners->end(), listener);
+        if (found != fixedPriorityListeners->end())
         {
-            auto found = std::find(fixedPriorityListeners->begin(), fixedPriorityListeners->end(), listener);
-            if (found != fixedPriorityListeners->end())
+            CCASSERT(listener->getAssociatedNode() == nullptr, "Can't set fixed priority with scene graph based listener.");
+            
+            if (listener->getFixedPriority() != fixedPriority)
             {
-                CCASSERT(listener->getAssociatedNode() == nullptr, "Can't set fixed priority with scene graph based listener.");
-                
-                if (listener->getFixedPriority() != fixedPriority)
-                {
-                    listener->setFixedPriority(fixedPriority);
-                    setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
-                }
-                return;
+                listener->setFixedPriority(fixedPriority);
+                setDirty(listener->getInternedListenerID(), DirtyFlag::FIXED_PRIORITY);
             }
         }
     }
@@ -788,6 +792,17 @@ void EventDispatcher::dispatchEvent(Event* event)
     if (!_isEnabled)
         return;
     
+    int listenerID = -1;
+    if (event->getType() != Event::Type::TOUCH)
+    {
+        // nobody listens to the event: there is nothing to sort nor to update,
+        // which makes the events dispatched every frame by the director free when they are not used
+        listenerID = getListenerID(event);
+        if (_listenerMap.find(listenerID) == _listenerMap.end())
+            return;
+    }
+    
+    CC_TRACE_ZONE("EventDispatcher::dispatchEvent");
     updateDirtyFlagForSceneGraph();
     
     
@@ -799,15 +814,11 @@ void EventDispatcher::dispatchEvent(Event* event)
         return;
     }
     
-    auto listenerID = __getListenerID(event);
-    
     sortEventListeners(listenerID);
     
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
+    auto listeners = getListeners(listenerID);
+    if (listeners)
     {
-        auto listeners = iter->second;
-        
         auto onEvent = [&event](EventListener* listener) -> bool{
             event->setCurrentTarget(listener->getAssociatedNode());
             listener->_onEvent(event);
@@ -822,19 +833,32 @@ void EventDispatcher::dispatchEvent(Event* event)
 
 void EventDispatcher::dispatchCustomEvent(const std::string &eventName, void *optionalUserData)
 {
-    EventCustom ev(eventName);
+    dispatchCustomEvent(EventListener::internListenerID(eventName), optionalUserData);
+}
+
+void EventDispatcher::dispatchCustomEvent(int eventID, void *optionalUserData)
+{
+    if (!_isEnabled || _listenerMap.find(eventID) == _listenerMap.end())
+        return;
+    
+    EventCustom ev(eventID);
     ev.setUserData(optionalUserData);
     dispatchEvent(&ev);
 }
 
+bool EventDispatcher::hasEventListener(const EventListener::ListenerID& listenerID) const
+{
+    return getListeners(EventListener::internListenerID(listenerID)) != nullptr;
+}
+
 
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
-    sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    sortEventListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    sortEventListeners(_touchOneByOneListenerID);
+    sortEventListeners(_touchAllAtOnceListenerID);
     
-    auto oneByOneListeners = getListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    auto allAtOnceListeners = getListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    auto oneByOneListeners = getListeners(_touchOneByOneListenerID);
+    auto allAtOnceListeners = getListeners(_touchAllAtOnceListenerID);
     
     // If there aren't any touch listeners, return directly.
     if (nullptr == oneByOneListeners && nullptr == allAtOnceListeners)
@@ -1025,7 +1049,7 @@ void EventDispatcher::updateListeners(Event* event)
 {
     CCASSERT(_inDispatch > 0, "If program goes here, there should be event in dispatch.");
     
-    auto onUpdateListeners = [this](const EventListener::ListenerID& listenerID)
+    auto onUpdateListeners = [this](int listenerID)
     {
         auto listenersIter = _listenerMap.find(listenerID);
         if (listenersIter == _listenerMap.end())
@@ -1084,12 +1108,12 @@ void EventDispatcher::updateListeners(Event* event)
     
     if (event->getType() == Event::Type::TOUCH)
     {
-        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_ID);
-        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+        onUpdateListeners(_touchOneByOneListenerID);
+        onUpdateListeners(_touchAllAtOnceListenerID);
     }
     else
     {
-        onUpdateListeners(__getListenerID(event));
+        onUpdateListeners(getListenerID(event));
     }
     
     if (_inDispatch > 1)
@@ -1101,7 +1125,6 @@ void EventDispatcher::updateListeners(Event* event)
     {
         if (iter->second->empty())
         {
-            _priorityDirtyFlagMap.erase(iter->first);
             delete iter->second;
             iter = _listenerMap.erase(iter);
         }
@@ -1132,30 +1155,29 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
             {
                 for (auto& l : *iter->second)
                 {
-                    setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+                    setDirty(l->getInternedListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
                 }
             }
         }
         
         _dirtyNodes.clear();
+        // the draw order of these nodes changed
+        _nodePriorityDirty = true;
     }
 }
 
-void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListeners(int listenerID)
 {
-    DirtyFlag dirtyFlag = DirtyFlag::NONE;
-    
-    auto dirtyIter = _priorityDirtyFlagMap.find(listenerID);
-    if (dirtyIter != _priorityDirtyFlagMap.end())
-    {
-        dirtyFlag = dirtyIter->second;
-    }
+    auto listeners = getListeners(listenerID);
+    if (listeners == nullptr)
+        return;
     
+    DirtyFlag dirtyFlag = listeners->getDirtyFlag();
     if (dirtyFlag != DirtyFlag::NONE)
     {
         // Clear the dirty flag first, if `rootNode` is nullptr, then set its dirty flag of scene graph priority
-        dirtyIter->second = DirtyFlag::NONE;
-
+        listeners->setDirtyFlag(DirtyFlag::NONE);
+        
         if ((int)dirtyFlag & (int)DirtyFlag::FIXED_PRIORITY)
         {
             sortEventListenersOfFixedPriority(listenerID);
@@ -1170,13 +1192,13 @@ void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listen
             }
             else
             {
-                dirtyIter->second = DirtyFlag::SCENE_GRAPH_PRIORITY;
+                listeners->setDirtyFlag(DirtyFlag::SCENE_GRAPH_PRIORITY);
             }
         }
     }
 }
 
-void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode)
+void EventDispatcher::sortEventListenersOfSceneGraphPriority(int listenerID, Node* rootNode)
 {
     auto listeners = getListeners(listenerID);
     
@@ -1187,11 +1209,19 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
+    // The priorities of the nodes are shared by all the listener IDs,
+    // the scene graph is only walked again when the draw order of the nodes with listeners changed
+    if (_nodePriorityDirty || _nodePriorityRootNode != rootNode)
+    {
+        // Reset priority index
+        _nodePriorityIndex = 0;
+        _nodePriorityMap.clear();
+
+        visitTarget(rootNode, true);
 
-    visitTarget(rootNode, true);
+        _nodePriorityRootNode = rootNode;
+        _nodePriorityDirty = false;
+    }
     
     // After sort: priority < 0, > 0
     std::sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
@@ -1207,7 +1237,7 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
 #endif
 }
 
-void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListenersOfFixedPriority(int listenerID)
 {
     auto listeners = getListeners(listenerID);
 
@@ -1244,7 +1274,7 @@ void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::Lis
     
 }
 
-EventDispatcher::EventListenerVector* EventDispatcher::getListeners(const EventListener::ListenerID& listenerID)
+EventDispatcher::EventListenerVector* EventDispatcher::getListeners(int listenerID) const
 {
     auto iter = _listenerMap.find(listenerID);
     if (iter != _listenerMap.end())
@@ -1255,7 +1285,7 @@ EventDispatcher::EventListenerVector* EventDispatcher::getListeners(const EventL
     return nullptr;
 }
 
-void EventDispatcher::removeEventListenersForListenerID(const EventListener::ListenerID& listenerID)
+void EventDispatcher::removeEventListenersForListenerID(int listenerID)
 {
     auto listenerItemIter = _listenerMap.find(listenerID);
     if (listenerItemIter != _listenerMap.end())
@@ -1295,7 +1325,7 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
-        _priorityDirtyFlagMap.erase(listenerID);
+        listeners->setDirtyFlag(DirtyFlag::NONE);
         
         if (!_inDispatch)
         {
@@ -1307,7 +1337,7 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
     
     for (auto iter = _toAddedListeners.begin(); iter != _toAddedListeners.end();)
     {
-        if ((*iter)->getListenerID() == listenerID)
+        if ((*iter)->getInternedListenerID() == listenerID)
         {
             (*iter)->setRegistered(false);
             (*iter)->release();
@@ -1324,23 +1354,23 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 {
     if (listenerType == EventListener::Type::TOUCH_ONE_BY_ONE)
     {
-        removeEventListenersForListenerID(EventListenerTouchOneByOne::LISTENER_ID);
+        removeEventListenersForListenerID(_touchOneByOneListenerID);
     }
     else if (listenerType == EventListener::Type::TOUCH_ALL_AT_ONCE)
     {
-        removeEventListenersForListenerID(EventListenerTouchAllAtOnce::LISTENER_ID);
+        removeEventListenersForListenerID(_touchAllAtOnceListenerID);
     }
     else if (listenerType == EventListener::Type::MOUSE)
     {
-        removeEventListenersForListenerID(EventListenerMouse::LISTENER_ID);
+        removeEventListenersForListenerID(_mouseListenerID);
     }
     else if (listenerType == EventListener::Type::ACCELERATION)
     {
-        removeEventListenersForListenerID(EventListenerAcceleration::LISTENER_ID);
+        removeEventListenersForListenerID(_accelerationListenerID);
     }
     else if (listenerType == EventListener::Type::KEYBOARD)
     {
-        removeEventListenersForListenerID(EventListenerKeyboard::LISTENER_ID);
+        removeEventListenersForListenerID(_keyboardListenerID);
     }
     else
     {
@@ -1350,13 +1380,14 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 
 void EventDispatcher::removeCustomEventListeners(const std::string& customEventName)
 {
-    removeEventListenersForListenerID(customEventName);
+    removeEventListenersForListenerID(EventListener::internListenerID(customEventName));
 }
 
 void EventDispatcher::removeAllEventListeners()
 {
     bool cleanMap = true;
-    std::vector<EventListener::ListenerID> types(_listenerMap.size());
+    std::vector<int> types;
+    types.reserve(_listenerMap.size());
     
     for (const auto& e : _listenerMap)
     {
@@ -1407,17 +1438,13 @@ void EventDispatcher::setDirtyForNode(Node* node)
     }
 }
 
-void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag)
+void EventDispatcher::setDirty(int listenerID, DirtyFlag flag)
 {    
-    auto iter = _priorityDirtyFlagMap.find(listenerID);
-    if (iter == _priorityDirtyFlagMap.end())
-    {
-        _priorityDirtyFlagMap.insert(std::make_pair(listenerID, flag));
-    }
-    else
+    auto listeners = getListeners(listenerID);
+    if (listeners)
     {
-        int ret = (int)flag | (int)iter->second;
-        iter->second = (DirtyFlag) ret;
+        int ret = (int)flag | (int)listeners->getDirtyFlag();
+        listeners->setDirtyFlag((DirtyFlag) ret);
     }
 }
 
@@ -133,6 +133,12 @@ public:
     /** Dispatches a Custom Event with a event name an optional user data */
     void dispatchCustomEvent(const std::string &eventName, void *optionalUserData = nullptr);
 
+    /** Dispatches a Custom Event with the interned id of its name, see EventListener::internListenerID(), and an optional user data */
+    void dispatchCustomEvent(int eventID, void *optionalUserData = nullptr);
+
+    /** Checks whether a listener is registered for a listener ID or a custom event name */
+    bool hasEventListener(const EventListener::ListenerID& listenerID) const;
+
     /////////////////////////////////////////////
     
     /** Constructor of EventDispatcher */
@@ -156,8 +162,18 @@ protected:
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
     
+    /// Priority dirty flag
+    enum class DirtyFlag
+    {
+        NONE = 0,
+        FIXED_PRIORITY = 1 << 0,
+        SCENE_GRAPH_PRIORITY = 1 << 1,
+        ALL = FIXED_PRIORITY | SCENE_GRAPH_PRIORITY
+    };
+    
     /**
      *  The vector to store event listeners with scene graph based priority and fixed priority.
+     *  The listeners are only sorted when they are dispatched an event after they changed.
      */
     class EventListenerVector
     {
@@ -176,10 +192,13 @@ protected:
         inline std::vector<EventListener*>* getSceneGraphPriorityListeners() const { return _sceneGraphListeners; };
         inline ssize_t getGt0Index() const { return _gt0Index; };
         inline void setGt0Index(ssize_t index) { _gt0Index = index; };
+        inline DirtyFlag getDirtyFlag() const { return _dirtyFlag; };
+        inline void setDirtyFlag(DirtyFlag flag) { _dirtyFlag = flag; };
     private:
         std::vector<EventListener*>* _fixedListeners;
         std::vector<EventListener*>* _sceneGraphListeners;
         ssize_t _gt0Index;
+        DirtyFlag _dirtyFlag;
     };
     
     /** Adds an event listener with item
@@ -194,23 +213,26 @@ protected:
      */
     void forceAddEventListener(EventListener* listener);
     
-    /** Gets event the listener list for the event listener type. */
-    EventListenerVector* getListeners(const EventListener::ListenerID& listenerID);
+    /** Gets event the listener list for the interned event listener ID. */
+    EventListenerVector* getListeners(int listenerID) const;
+    
+    /** Gets the interned listener ID of the listeners of an event, which is not a touch event */
+    int getListenerID(Event* event) const;
     
     /** Update dirty flag */
     void updateDirtyFlagForSceneGraph();
     
-    /** Removes all listeners with the same event listener ID */
-    void removeEventListenersForListenerID(const EventListener::ListenerID& listenerID);
+    /** Removes all listeners with the same interned event listener ID */
+    void removeEventListenersForListenerID(int listenerID);
     
     /** Sort event listener */
-    void sortEventListeners(const EventListener::ListenerID& listenerID);
+    void sortEventListeners(int listenerID);
     
     /** Sorts the listeners of specified type by scene graph priority */
-    void sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode);
+    void sortEventListenersOfSceneGraphPriority(int listenerID, Node* rootNode);
     
     /** Sorts the listeners of specified type by fixed priority */
-    void sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID);
+    void sortEventListenersOfFixedPriority(int listenerID);
     
     /** Updates all listeners
      *  1) Removes all listener items that have been marked as 'removed' when dispatching event.
@@ -230,26 +252,14 @@ protected:
     /** Dispatches event to listeners with a specified listener type */
     void dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
     
-    /// Priority dirty flag
-    enum class DirtyFlag
-    {
-        NONE = 0,
-        FIXED_PRIORITY = 1 << 0,
-        SCENE_GRAPH_PRIORITY = 1 << 1,
-        ALL = FIXED_PRIORITY | SCENE_GRAPH_PRIORITY
-    };
-    
-    /** Sets the dirty flag for a specified listener ID */
-    void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
+    /** Sets the dirty flag for a specified interned listener ID */
+    void setDirty(int listenerID, DirtyFlag flag);
     
     /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
     void visitTarget(Node* node, bool isRootNode);
     
-    /** Listeners map */
-    std::unordered_map<EventListener::ListenerID, EventListenerVector*> _listenerMap;
-    
-    /** The map of dirty flag */
-    std::unordered_map<EventListener::ListenerID, DirtyFlag> _priorityDirtyFlagMap;
+    /** Listeners map, the key is the interned listener ID */
+    std::unordered_map<int, EventListenerVector*> _listenerMap;
     
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
@@ -257,6 +267,10 @@ protected:
     /** The map of node and its event priority */
     std::unordered_map<Node*, int> _nodePriorityMap;
     
+    /** The scene the node priorities were computed for, they are computed again when it or the nodes of the listeners change */
+    Node* _nodePriorityRootNode;
+    bool _nodePriorityDirty;
+    
     /** key: Global Z Order, value: Sorted Nodes */
     std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
     
@@ -274,7 +288,16 @@ protected:
     
     int _nodePriorityIndex;
     
-    std::set<std::string> _internalCustomListenerIDs;
+    std::set<int> _internalCustomListenerIDs;
+    
+    /** Interned IDs of the listener types the dispatcher looks up itself */
+    int _touchOneByOneListenerID;
+    int _touchAllAtOnceListenerID;
+    int _accelerationListenerID;
+    int _keyboardListenerID;
+    int _mouseListenerID;
+    int _focusListenerID;
+    int _controllerListenerID;
 };
 
 
@@ -23,9 +23,44 @@
  ****************************************************************************/
 
 #include "base/CCEventListener.h"
+#include "base/ccMacros.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 
 NS_CC_BEGIN
 
+namespace
+{
+    // the names are never removed, so that the references returned by getListenerIDForInternedID() stay valid
+    std::mutex s_internedListenerIDsMutex;
+    std::unordered_map<std::string, int> s_internedListenerIDs;
+    std::deque<std::string> s_internedListenerIDNames;
+}
+
+int EventListener::internListenerID(const ListenerID& listenerID)
+{
+    std::lock_guard<std::mutex> lock(s_internedListenerIDsMutex);
+    auto iter = s_internedListenerIDs.find(listenerID);
+    if (iter != s_internedListenerIDs.end())
+    {
+        return iter->second;
+    }
+
+    int internedID = (int)s_internedListenerIDNames.size();
+    s_internedListenerIDNames.push_back(listenerID);
+    s_internedListenerIDs.insert(std::make_pair(listenerID, internedID));
+    return internedID;
+}
+
+const EventListener::ListenerID& EventListener::getListenerIDForInternedID(int internedID)
+{
+    std::lock_guard<std::mutex> lock(s_internedListenerIDsMutex);
+    CCASSERT(internedID >= 0 && internedID < (int)s_internedListenerIDNames.size(), "Invalid interned listener ID");
+    return s_internedListenerIDNames[internedID];
+}
+
 EventListener::EventListener()
 {}
     
@@ -39,6 +74,7 @@ bool EventListener::init(Type t, const ListenerID& listenerID, const std::functi
     _onEvent = callback;
     _type = t;
     _listenerID = listenerID;
+    _internedListenerID = internListenerID(listenerID);
     _isRegistered = false;
     _paused = true;
     _isEnabled = true;
@@ -60,6 +60,15 @@ public:
 
     typedef std::string ListenerID;
 
+    /** Returns the interned id of a listener ID.
+     *  Every listener ID, custom event names included, is given a small integer the first time it is seen,
+     *  the event dispatcher looks listeners up with it instead of hashing strings. Thread safe.
+     */
+    static int internListenerID(const ListenerID& listenerID);
+
+    /** Returns the listener ID an interned id was given to. The reference stays valid forever. */
+    static const ListenerID& getListenerIDForInternedID(int internedID);
+
 CC_CONSTRUCTOR_ACCESS:
     /** Constructor */
     EventListener();
@@ -118,6 +127,9 @@ protected:
      */
     inline const ListenerID& getListenerID() const { return _listenerID; };
 
+    /** Gets the interned id of the listener ID, see internListenerID() */
+    inline int getInternedListenerID() const { return _internedListenerID; };
+
     /** Sets the fixed priority for this listener
      *  @note This method is only used for `fixed priority listeners`, it needs to access a non-zero value.
      *  0 is reserved for scene graph priority listeners
@@ -144,6 +156,7 @@ protected:
 
     Type _type;                             /// Event listener type
     ListenerID _listenerID;                 /// Event listener ID
+    int _internedListenerID;                /// Interned id of the listener ID
     bool _isRegistered;                     /// Whether the listener has been added to dispatcher.
 
     int   _fixedPriority;   // The higher the number, the higher the priority, 0 is for scene graph base priority.
@@ -45,6 +45,9 @@ class ProfilingTimer;
  cocos2d builtin profiler.
 
  To use it, enable set the CC_ENABLE_PROFILERS=1 in the ccConfig.h file
+
+ The engine itself is instrumented with the trace markers of CCTrace.h, which are cheaper,
+ nest, work on every thread and export to chrome://tracing. Prefer them for new code.
  */
 
 class CC_DLL Profiler : public Ref
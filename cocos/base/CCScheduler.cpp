@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/utlist.h"
 #include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
+#include "base/CCTrace.h"
 
 NS_CC_BEGIN
 
@@ -257,6 +258,9 @@ Scheduler::Scheduler(void)
 , _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
+, _scriptUpdateBatchingEnabled(false)
+, _collectingScriptUpdates(false)
+, _scriptUpdateBatchPriority(0)
 #endif
 {
     // I don't expect to have more than 30 functions to all per frame
@@ -689,6 +693,66 @@ void Scheduler::unscheduleScriptEntry(unsigned int scheduleScriptEntryID)
     }
 }
 
+bool Scheduler::queueScriptUpdateHandler(int handler, void *target)
+{
+    if (! _collectingScriptUpdates)
+    {
+        return false;
+    }
+
+    tHashUpdateEntry *element = nullptr;
+    HASH_FIND_PTR(_hashForUpdates, &target, element);
+    if (! element)
+    {
+        return false;
+    }
+
+    _scriptUpdateHandlers.push_back(handler);
+    _scriptUpdateEntries.push_back(element->entry);
+    return true;
+}
+
+void Scheduler::flushScriptUpdateHandlers(float dt, int nextPriority)
+{
+    _scriptUpdateBatchPriority = nextPriority;
+
+    // a handler may pause or unschedule the update of a node whose handler comes later in the batch
+    auto isActive = [this](int index) {
+        const tListEntry *entry = _scriptUpdateEntriesToSend[index];
+        return ! entry->paused && ! entry->markedForDeletion;
+    };
+
+    // handlers may queue more handlers (e.g. by calling Node::update), those go into the next batch
+    while (! _scriptUpdateHandlers.empty())
+    {
+        _scriptUpdateHandlersToSend.swap(_scriptUpdateHandlers);
+        _scriptUpdateEntriesToSend.swap(_scriptUpdateEntries);
+
+        auto engine = ScriptEngineManager::getInstance()->getScriptEngine();
+        if (engine && engine->getScriptType() == kScriptTypeLua)
+        {
+            SchedulerBatchScriptData data(_scriptUpdateHandlersToSend, dt, isActive);
+            ScriptEvent event(kScheduleBatchEvent, &data);
+            engine->sendEvent(&event);
+        }
+        else if (engine)
+        {
+            for (int i = 0; i < (int)_scriptUpdateHandlersToSend.size(); ++i)
+            {
+                if (isActive(i))
+                {
+                    SchedulerScriptData data(_scriptUpdateHandlersToSend[i], dt);
+                    ScriptEvent event(kScheduleEvent, &data);
+                    engine->sendEvent(&event);
+                }
+            }
+        }
+
+        _scriptUpdateHandlersToSend.clear();
+        _scriptUpdateEntriesToSend.clear();
+    }
+}
+
 #endif
 
 void Scheduler::resumeTarget(void *target)
@@ -829,6 +893,7 @@ void Scheduler::performFunctionInCocosThread(const std::function<void ()> &funct
 // main loop
 void Scheduler::update(float dt)
 {
+    CC_TRACE_ZONE("Scheduler::update");
     _updateHashLocked = true;
 
     if (_timeScale != 1.0f)
@@ -843,11 +908,22 @@ void Scheduler::update(float dt)
     // Iterate over all the Updates' selectors
     tListEntry *entry, *tmp;
 
+#if CC_ENABLE_SCRIPT_BINDING
+    // Script 'update' handlers of the same priority are sent together once that priority is done
+    _collectingScriptUpdates = _scriptUpdateBatchingEnabled;
+#endif
+
     // updates with priority < 0
     DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
     {
         if ((! entry->paused) && (! entry->markedForDeletion))
         {
+#if CC_ENABLE_SCRIPT_BINDING
+            if (entry->priority != _scriptUpdateBatchPriority)
+            {
+                flushScriptUpdateHandlers(dt, entry->priority);
+            }
+#endif
             entry->callback(dt);
         }
     }
@@ -857,6 +933,12 @@ void Scheduler::update(float dt)
     {
         if ((! entry->paused) && (! entry->markedForDeletion))
         {
+#if CC_ENABLE_SCRIPT_BINDING
+            if (entry->priority != _scriptUpdateBatchPriority)
+            {
+                flushScriptUpdateHandlers(dt, entry->priority);
+            }
+#endif
             entry->callback(dt);
         }
     }
@@ -866,10 +948,21 @@ void Scheduler::update(float dt)
     {
         if ((! entry->paused) && (! entry->markedForDeletion))
         {
+#if CC_ENABLE_SCRIPT_BINDING
+            if (entry->priority != _scriptUpdateBatchPriority)
+            {
+                flushScriptUpdateHandlers(dt, entry->priority);
+            }
+#endif
             entry->callback(dt);
         }
     }
 
+#if CC_ENABLE_SCRIPT_BINDING
+    flushScriptUpdateHandlers(dt, 0);
+    _collectingScriptUpdates = false;
+#endif
+
     // Iterate over all the custom selectors
     for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
     {
@@ -256,6 +256,25 @@ public:
      return schedule script entry ID, used for unscheduleScriptFunc().
      */
     unsigned int scheduleScriptFunc(unsigned int handler, float interval, bool paused);
+    
+    /** Enables or disables batched dispatch of script 'update' handlers.
+     When enabled, the handlers registered with Node::scheduleUpdateWithPriorityLua are collected
+     while the update lists are ticked and the handlers of each priority are sent to the script
+     engine as a single kScheduleBatchEvent, once all the updates of that priority have run.
+     Disabled by default.
+     @since v3.3
+     */
+    void setScriptUpdateBatchingEnabled(bool enabled) { _scriptUpdateBatchingEnabled = enabled; }
+    bool isScriptUpdateBatchingEnabled() const { return _scriptUpdateBatchingEnabled; }
+    
+    /** Queues the script 'update' handler of 'target' in the batch of the priority being ticked.
+     The handler is skipped if the update of 'target' is paused or unscheduled before the batch reaches it.
+     Returns false if no batch is being collected or 'target' has no scheduled update, in which case
+     the caller dispatches the handler itself.
+     @js NA
+     @lua NA
+     */
+    bool queueScriptUpdateHandler(int handler, void *target);
 #endif
     /////////////////////////////////////
     
@@ -436,6 +455,11 @@ protected:
     void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
 
+#if CC_ENABLE_SCRIPT_BINDING
+    // sends the queued script 'update' handlers and starts collecting those of 'nextPriority'
+    void flushScriptUpdateHandlers(float dt, int nextPriority);
+#endif
+
 
     float _timeScale;
 
@@ -456,8 +480,18 @@ protected:
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
-#endif
     
+    // batched script 'update' handlers
+    bool _scriptUpdateBatchingEnabled;
+    bool _collectingScriptUpdates;
+    int _scriptUpdateBatchPriority;
+    std::vector<int> _scriptUpdateHandlers;
+    std::vector<int> _scriptUpdateHandlersToSend;
+    // the update entries of the queued handlers, they are only removed once the update lists are ticked
+    std::vector<struct _listEntry*> _scriptUpdateEntries;
+    std::vector<struct _listEntry*> _scriptUpdateEntriesToSend;
+#endif
+
     // Used for "perform Function"
     std::vector<std::function<void()>> _functionsToPerform;
     std::mutex _performMutex;
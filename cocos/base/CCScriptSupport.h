@@ -33,9 +33,11 @@
 #include "base/CCTouch.h"
 #include "base/CCEventTouch.h"
 #include "base/CCEventKeyboard.h"
+#include <functional>
 #include <map>
 #include <string>
 #include <list>
+#include <vector>
 
 typedef struct lua_State lua_State;
 
@@ -211,7 +213,8 @@ enum ScriptEventType
     kAccelerometerEvent,
     kControlEvent,
     kCommonEvent,
-    kComponentEvent
+    kComponentEvent,
+    kScheduleBatchEvent
 };
 
 struct BasicScriptData
@@ -253,6 +256,27 @@ struct SchedulerScriptData
     }
 };
 
+struct SchedulerBatchScriptData
+{
+    // lua use: the 'update' handlers of one priority, in scheduling order
+    const std::vector<int>& handlers;
+    float elapse;
+    // whether the handler at an index may still be called: its update wasn't paused or unscheduled by a previous handler
+    std::function<bool(int)> isActive;
+    
+    // Constructor
+    /**
+     * @js NA
+     * @lua NA
+     */
+    SchedulerBatchScriptData(const std::vector<int>& inHandlers,float inElapse,const std::function<bool(int)>& inIsActive)
+    : handlers(inHandlers),
+      elapse(inElapse),
+      isActive(inIsActive)
+    {
+    }
+};
+
 struct TouchesScriptData
 {
     EventTouch::EventCode actionType;
@@ -0,0 +1,166 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "base/CCThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+
+#include "platform/CCThread.h"
+
+NS_CC_BEGIN
+
+static ThreadPool* s_sharedThreadPool = nullptr;
+static std::mutex s_sharedThreadPoolMutex;
+
+ThreadPool* ThreadPool::getInstance()
+{
+    std::lock_guard<std::mutex> lock(s_sharedThreadPoolMutex);
+    if (!s_sharedThreadPool)
+    {
+        int count = static_cast<int>(std::thread::hardware_concurrency());
+        s_sharedThreadPool = new (std::nothrow) ThreadPool(count > 1 ? count - 1 : 0);
+    }
+    return s_sharedThreadPool;
+}
+
+void ThreadPool::destroyInstance()
+{
+    std::lock_guard<std::mutex> lock(s_sharedThreadPoolMutex);
+    CC_SAFE_DELETE(s_sharedThreadPool);
+}
+
+ThreadPool::ThreadPool(int threadCount)
+: _running(true)
+{
+    _threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _threads.push_back(std::thread(&ThreadPool::threadFunc, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        _running = false;
+    }
+    _taskCondition.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::pushTask(const std::function<void()>& task)
+{
+    if (_threads.empty())
+    {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        _tasks.push_back(task);
+    }
+    _taskCondition.notify_one();
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& func)
+{
+    if (count <= 0)
+        return;
+
+    if (count == 1 || _threads.empty())
+    {
+        for (int i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    // The state is shared with the helper tasks, which may still be sitting in the queue
+    // after every index has been processed by other threads.
+    struct Job
+    {
+        std::atomic<int> next;
+        std::atomic<int> done;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+    auto job = std::make_shared<Job>();
+    job->next = 0;
+    job->done = 0;
+
+    auto work = [job, count, func]() {
+        int index;
+        while ((index = job->next++) < count)
+        {
+            func(index);
+            if (++job->done == count)
+            {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->condition.notify_all();
+            }
+        }
+    };
+
+    int helpers = std::min(count - 1, static_cast<int>(_threads.size()));
+    for (int i = 0; i < helpers; ++i)
+    {
+        pushTask(work);
+    }
+
+    work();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->condition.wait(lock, [&job, count]() { return job->done == count; });
+}
+
+void ThreadPool::threadFunc()
+{
+    void* autoreleasePool = ThreadHelper::createAutoreleasePool();
+
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_taskMutex);
+            _taskCondition.wait(lock, [this]() { return !_running || !_tasks.empty(); });
+            if (_tasks.empty())
+                break;
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+
+    ThreadHelper::releaseAutoreleasePool(autoreleasePool);
+}
+
+NS_CC_END
@@ -0,0 +1,99 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCTHREADPOOL_H__
+#define __CCTHREADPOOL_H__
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/**
+ * A fixed size pool of worker threads used by the engine for CPU bound jobs
+ * (software texture decoding, animation sampling, ...).
+ *
+ * Tasks are executed in FIFO order. Nothing is ever called back on the cocos
+ * thread, use Scheduler::performFunctionInCocosThread() for that.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ThreadPool
+{
+public:
+    /** Returns the shared pool. It has one thread less than the number of hardware threads. */
+    static ThreadPool* getInstance();
+
+    /** Joins the threads of the shared pool and destroys it. */
+    static void destroyInstance();
+
+    /** Creates a pool with `threadCount` workers. 0 means every task runs on the calling thread. */
+    explicit ThreadPool(int threadCount);
+
+    /** Waits for the queued tasks to finish and joins the workers. */
+    ~ThreadPool();
+
+    /** Queues a task. It will be run on one of the worker threads. */
+    void pushTask(const std::function<void()>& task);
+
+    /**
+     * Runs `func(index)` for every index in [0, count) and returns once all of them are done.
+     *
+     * The calling thread takes part in the work, so this is safe to call from a task
+     * that is already running on the pool.
+     */
+    void parallelFor(int count, const std::function<void(int)>& func);
+
+    /** Number of worker threads, not counting the calling thread. */
+    int getThreadCount() const { return static_cast<int>(_threads.size()); }
+
+protected:
+    void threadFunc();
+
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _taskMutex;
+    std::condition_variable _taskCondition;
+    bool _running;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTHREADPOOL_H__
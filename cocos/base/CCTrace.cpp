@@ -0,0 +1,361 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "base/CCTrace.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    struct ThreadBuffer
+    {
+        ThreadBuffer() : writeIndex(0), mask(0), generation(0), tid(0), writing(false), exited(false) {}
+
+        std::vector<Trace::Event> events;
+        std::atomic<uint64_t> writeIndex;
+        uint64_t mask;
+        unsigned int generation;
+        unsigned int tid;
+        std::string name;
+        // set while the thread writes an event, Trace::stop() waits for it
+        std::atomic<bool> writing;
+        // the thread exited, the buffer is kept for its events until the next trace
+        bool exited;
+    };
+
+    std::mutex s_buffersMutex;
+    std::vector<ThreadBuffer*> s_buffers;
+    unsigned int s_nextTid = 1;
+    std::atomic<unsigned int> s_generation(0);
+    size_t s_eventsPerThread = 0;
+    std::atomic<int64_t> s_startTime(0);
+
+    void releaseThreadBuffer(void* data)
+    {
+        ThreadBuffer* buffer = static_cast<ThreadBuffer*>(data);
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        if (buffer->generation == s_generation.load(std::memory_order_relaxed) && buffer->writeIndex.load(std::memory_order_relaxed) > 0)
+        {
+            buffer->exited = true;
+            return;
+        }
+        s_buffers.erase(std::remove(s_buffers.begin(), s_buffers.end(), buffer), s_buffers.end());
+        delete buffer;
+    }
+
+#if defined(_MSC_VER)
+    // fiber local storage, unlike __declspec(thread), calls back when the thread exits
+    DWORD s_threadBufferIndex = FLS_OUT_OF_INDEXES;
+    std::once_flag s_threadBufferIndexOnce;
+
+    void NTAPI onThreadExit(PVOID data) { releaseThreadBuffer(data); }
+
+    DWORD getThreadBufferIndex()
+    {
+        std::call_once(s_threadBufferIndexOnce, [](){ s_threadBufferIndex = FlsAlloc(onThreadExit); });
+        return s_threadBufferIndex;
+    }
+
+    ThreadBuffer* getThreadLocalBuffer() { return static_cast<ThreadBuffer*>(FlsGetValue(getThreadBufferIndex())); }
+    void setThreadLocalBuffer(ThreadBuffer* buffer) { FlsSetValue(getThreadBufferIndex(), buffer); }
+#else
+    // __thread isn't available on every iOS version, pthread keys are
+    pthread_key_t s_threadBufferKey;
+    pthread_once_t s_threadBufferKeyOnce = PTHREAD_ONCE_INIT;
+
+    void createThreadBufferKey() { pthread_key_create(&s_threadBufferKey, releaseThreadBuffer); }
+
+    ThreadBuffer* getThreadLocalBuffer()
+    {
+        pthread_once(&s_threadBufferKeyOnce, createThreadBufferKey);
+        return static_cast<ThreadBuffer*>(pthread_getspecific(s_threadBufferKey));
+    }
+    void setThreadLocalBuffer(ThreadBuffer* buffer) { pthread_setspecific(s_threadBufferKey, buffer); }
+#endif
+
+    int64_t getClockTime()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    ThreadBuffer* getThreadBuffer()
+    {
+        ThreadBuffer* buffer = getThreadLocalBuffer();
+        if (!buffer)
+        {
+            buffer = new (std::nothrow) ThreadBuffer();
+            if (!buffer)
+                return nullptr;
+            std::lock_guard<std::mutex> lock(s_buffersMutex);
+            buffer->tid = s_nextTid++;
+            s_buffers.push_back(buffer);
+            setThreadLocalBuffer(buffer);
+        }
+        return buffer;
+    }
+
+    // returns the buffer of the calling thread, ready for the current trace
+    ThreadBuffer* getRecordingBuffer()
+    {
+        ThreadBuffer* buffer = getThreadBuffer();
+        if (!buffer)
+            return nullptr;
+        unsigned int generation = s_generation.load(std::memory_order_acquire);
+        if (buffer->generation != generation)
+        {
+            // first event of this thread since start()
+            std::lock_guard<std::mutex> lock(s_buffersMutex);
+            buffer->events.resize(s_eventsPerThread);
+            buffer->mask = s_eventsPerThread - 1;
+            buffer->writeIndex.store(0, std::memory_order_relaxed);
+            buffer->generation = generation;
+        }
+        return buffer;
+    }
+
+    void record(const Trace::Event& event)
+    {
+        ThreadBuffer* buffer = getRecordingBuffer();
+        if (!buffer)
+            return;
+
+        // pairs with the fence of Trace::stop(): either stop() waits for this event, or it is dropped
+        buffer->writing.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (Trace::isRecording())
+        {
+            uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+            buffer->events[index & buffer->mask] = event;
+            buffer->writeIndex.store(index + 1, std::memory_order_release);
+        }
+        buffer->writing.store(false, std::memory_order_release);
+    }
+
+    void appendEscaped(std::string& out, const char* str)
+    {
+        for (const char* c = str; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                out.push_back('\\');
+            out.push_back(*c);
+        }
+    }
+}
+
+std::atomic<bool> Trace::s_recording(false);
+
+void Trace::start(size_t eventsPerThread)
+{
+    size_t capacity = 1;
+    while (capacity < eventsPerThread)
+        capacity <<= 1;
+
+    {
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        s_eventsPerThread = capacity;
+
+        // the threads of the previous trace are gone
+        for (auto iter = s_buffers.begin(); iter != s_buffers.end();)
+        {
+            if ((*iter)->exited)
+            {
+                delete *iter;
+                iter = s_buffers.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        s_startTime.store(getClockTime(), std::memory_order_relaxed);
+        // the threads reset their buffer when they see the new generation
+        s_generation.fetch_add(1, std::memory_order_release);
+    }
+    s_recording.store(true, std::memory_order_release);
+}
+
+void Trace::stop()
+{
+    s_recording.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // a zone opened before stop() may still be writing on another thread
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    for (const auto buffer : s_buffers)
+    {
+        while (buffer->writing.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+size_t Trace::getEventsPerThread()
+{
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    return s_eventsPerThread;
+}
+
+uint64_t Trace::now()
+{
+    return (uint64_t)(getClockTime() - s_startTime.load(std::memory_order_relaxed));
+}
+
+void Trace::addZone(const char* name, uint64_t startTime, uint64_t endTime)
+{
+    Event event;
+    event.name = name;
+    event.timestamp = startTime;
+    event.duration = endTime > startTime ? endTime - startTime : 0;
+    event.type = Event::Type::ZONE;
+    event.frame = 0;
+    record(event);
+}
+
+void Trace::addCounter(const char* name, double value)
+{
+    Event event;
+    event.name = name;
+    event.timestamp = now();
+    event.value = value;
+    event.type = Event::Type::COUNTER;
+    event.frame = 0;
+    record(event);
+}
+
+void Trace::addFrame(unsigned int frame)
+{
+    Event event;
+    event.name = "Frame";
+    event.timestamp = now();
+    event.duration = 0;
+    event.type = Event::Type::FRAME;
+    event.frame = frame;
+    record(event);
+}
+
+void Trace::setThreadName(const char* name)
+{
+    ThreadBuffer* buffer = getThreadBuffer();
+    if (!buffer)
+        return;
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    buffer->name = name;
+}
+
+std::string Trace::toJSON()
+{
+    std::string json;
+    json.reserve(1024 * 1024);
+    json.append("{\"traceEvents\":[\n");
+
+    char line[256];
+    bool first = true;
+    auto separate = [&]() {
+        if (!first)
+            json.append(",\n");
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    unsigned int generation = s_generation.load(std::memory_order_acquire);
+    for (const auto buffer : s_buffers)
+    {
+        if (!buffer->name.empty())
+        {
+            separate();
+            json.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+            json.append(std::to_string(buffer->tid));
+            json.append(",\"args\":{\"name\":\"");
+            appendEscaped(json, buffer->name.c_str());
+            json.append("\"}}");
+        }
+
+        if (buffer->generation != generation || buffer->events.empty())
+            continue;
+
+        uint64_t count = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t begin = count > buffer->events.size() ? count - buffer->events.size() : 0;
+        for (uint64_t i = begin; i < count; ++i)
+        {
+            const Event& event = buffer->events[i & buffer->mask];
+            double timestamp = event.timestamp / 1000.0;
+
+            separate();
+            json.append("{\"name\":\"");
+            appendEscaped(json, event.name);
+            switch (event.type)
+            {
+                case Event::Type::ZONE:
+                    snprintf(line, sizeof(line), "\",\"cat\":\"cocos2d\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                             timestamp, event.duration / 1000.0, buffer->tid);
+                    break;
+                case Event::Type::COUNTER:
+                    snprintf(line, sizeof(line), "\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%g}}",
+                             timestamp, buffer->tid, event.value);
+                    break;
+                case Event::Type::FRAME:
+                    snprintf(line, sizeof(line), "\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%u}}",
+                             timestamp, buffer->tid, event.frame);
+                    break;
+            }
+            json.append(line);
+        }
+    }
+
+    json.append("\n],\"displayTimeUnit\":\"ns\"}\n");
+    return json;
+}
+
+bool Trace::writeToFile(const std::string& fullPath)
+{
+    std::string json = toJSON();
+
+    FILE* fp = fopen(fullPath.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("cocos2d: Trace: can't open %s", fullPath.c_str());
+        return false;
+    }
+    bool ok = fwrite(json.data(), 1, json.size(), fp) == json.size();
+    fclose(fp);
+    return ok;
+}
+
+NS_CC_END
@@ -0,0 +1,153 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __BASE_CCTRACE_H__
+#define __BASE_CCTRACE_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+#include "base/ccConfig.h"
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+/** Trace
+ Records timed zones, counters and frame markers in per thread ring buffers, and exports them
+ in the JSON format of chrome://tracing and Perfetto.
+
+ Use the CC_TRACE_XXX macros rather than the class: their names must be string literals, whose
+ address identifies the event, so recording never looks up or copies a name.
+ Each thread writes in its own buffer without locking. When a buffer is full the oldest events
+ are overwritten, so a trace keeps the last events of each thread.
+
+ Traces can also be started, stopped and saved with the "trace" command of Console.
+ @since v3.3
+ @js NA
+ @lua NA
+ */
+class CC_DLL Trace
+{
+public:
+    struct Event
+    {
+        enum class Type : uint32_t
+        {
+            ZONE,
+            COUNTER,
+            FRAME,
+        };
+
+        const char* name;
+        // nanoseconds since the trace started
+        uint64_t timestamp;
+        union
+        {
+            uint64_t duration;
+            double value;
+        };
+        Type type;
+        uint32_t frame;
+    };
+
+    /** starts recording, discarding the previous trace. eventsPerThread is rounded up to a power of 2 */
+    static void start(size_t eventsPerThread = 65536);
+    /** stops recording, waiting for the events other threads are writing. The trace is kept until the next start(). */
+    static void stop();
+    /** the capacity of the buffers of the last start(), after rounding */
+    static size_t getEventsPerThread();
+    /** whether start() was called without stop() */
+    static bool isRecording() { return s_recording.load(std::memory_order_relaxed); }
+
+    /** nanoseconds since the trace started */
+    static uint64_t now();
+
+    static void addZone(const char* name, uint64_t startTime, uint64_t endTime);
+    static void addCounter(const char* name, double value);
+    static void addFrame(unsigned int frame);
+
+    /** names the calling thread in the exported traces */
+    static void setThreadName(const char* name);
+
+    /** returns the recorded events in Chrome trace JSON. Call it after stop(). */
+    static std::string toJSON();
+    /** writes toJSON() to a file */
+    static bool writeToFile(const std::string& fullPath);
+
+private:
+    static std::atomic<bool> s_recording;
+};
+
+/** Records a zone from its construction to its destruction. See CC_TRACE_ZONE. */
+class TraceZone
+{
+public:
+    explicit TraceZone(const char* name)
+    : _name(name)
+    , _recording(Trace::isRecording())
+    , _startTime(_recording ? Trace::now() : 0)
+    {
+    }
+
+    ~TraceZone()
+    {
+        if (_recording)
+        {
+            Trace::addZone(_name, _startTime, Trace::now());
+        }
+    }
+
+private:
+    const char* _name;
+    bool _recording;
+    uint64_t _startTime;
+};
+
+#define CC_TRACE_CONCAT_(__a__, __b__) __a__##__b__
+#define CC_TRACE_CONCAT(__a__, __b__) CC_TRACE_CONCAT_(__a__, __b__)
+
+#if CC_ENABLE_TRACE
+/** records the rest of the enclosing scope. __name__ must be a string literal. */
+#define CC_TRACE_ZONE(__name__) NS_CC::TraceZone CC_TRACE_CONCAT(__ccTraceZone, __LINE__)("" __name__ "")
+/** records the value of a counter. __name__ must be a string literal. */
+#define CC_TRACE_COUNTER(__name__, __value__) do { if (NS_CC::Trace::isRecording()) NS_CC::Trace::addCounter("" __name__ "", (double)(__value__)); } while (0)
+/** marks the beginning of a frame */
+#define CC_TRACE_FRAME(__frame__) do { if (NS_CC::Trace::isRecording()) NS_CC::Trace::addFrame(__frame__); } while (0)
+#else
+#define CC_TRACE_ZONE(__name__) do {} while (0)
+#define CC_TRACE_COUNTER(__name__, __value__) do {} while (0)
+#define CC_TRACE_FRAME(__frame__) do {} while (0)
+#endif
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#endif // __BASE_CCTRACE_H__
@@ -0,0 +1,705 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "base/CCValueBinary.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+#include "base/ccUtils.h"
+
+NS_CC_BEGIN
+
+/*
+ * Layout, every field being a uint32_t:
+ *
+ *   header       magic "CCVB", version, node count, pool size, string count, string bytes
+ *   nodes        node count x (type, payload), the root is node 0
+ *   pool         containers and doubles, referenced by the payload of their node
+ *   strings      string count x offset into the string bytes
+ *   string bytes length, characters, '\0', padded to 4 bytes
+ *
+ * Payload per type: BYTE, INTEGER, BOOLEAN the value, FLOAT its bits, DOUBLE the pool offset
+ * of its 8 bytes, STRING the string index. VECTOR, MAP and INT_KEY_MAP the pool offset of
+ * [count, node...] or [count, key, node, key, node...], keys sorted in ascending order.
+ * A container is always written before its elements, so their node indices are greater
+ * than its own, which the reader checks to reject cycles.
+ */
+
+static const char VALUE_BINARY_MAGIC[4] = { 'C', 'C', 'V', 'B' };
+static const uint32_t VALUE_BINARY_VERSION = 1;
+// deeper data is considered corrupted, plists are rarely more than a few levels deep
+static const unsigned int VALUE_BINARY_MAX_DEPTH = 128;
+
+struct ValueBinaryHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t poolSize;
+    uint32_t stringCount;
+    uint32_t stringBytes;
+};
+
+static inline const ValueBinaryHeader* getHeader(const unsigned char* bytes)
+{
+    return reinterpret_cast<const ValueBinaryHeader*>(bytes);
+}
+
+static inline const uint32_t* getNodes(const unsigned char* bytes)
+{
+    return reinterpret_cast<const uint32_t*>(bytes + sizeof(ValueBinaryHeader));
+}
+
+static inline const uint32_t* getPoolStart(const unsigned char* bytes)
+{
+    return getNodes(bytes) + getHeader(bytes)->nodeCount * 2;
+}
+
+static inline const uint32_t* getStringOffsets(const unsigned char* bytes)
+{
+    return getPoolStart(bytes) + getHeader(bytes)->poolSize;
+}
+
+static inline const unsigned char* getStringBytes(const unsigned char* bytes)
+{
+    return reinterpret_cast<const unsigned char*>(getStringOffsets(bytes) + getHeader(bytes)->stringCount);
+}
+
+// ValueBinaryNode
+
+ValueBinaryNode::ValueBinaryNode()
+: _bytes(nullptr)
+, _node(nullptr)
+{
+}
+
+ValueBinaryNode::ValueBinaryNode(const unsigned char* bytes, uint32_t index)
+: _bytes(bytes)
+, _node(nullptr)
+{
+    if (index < getHeader(bytes)->nodeCount)
+    {
+        _node = getNodes(bytes) + index * 2;
+    }
+}
+
+const uint32_t* ValueBinaryNode::getPool(uint32_t offset, uint32_t count) const
+{
+    const uint32_t poolSize = getHeader(_bytes)->poolSize;
+    if (offset > poolSize || count > poolSize - offset)
+    {
+        return nullptr;
+    }
+    return getPoolStart(_bytes) + offset;
+}
+
+ValueBinaryNode ValueBinaryNode::getChild(uint32_t index) const
+{
+    const uint32_t ownIndex = static_cast<uint32_t>((_node - getNodes(_bytes)) / 2);
+    if (index <= ownIndex)
+    {
+        return ValueBinaryNode();
+    }
+    return ValueBinaryNode(_bytes, index);
+}
+
+const char* ValueBinaryNode::getString(uint32_t index, uint32_t* length) const
+{
+    const ValueBinaryHeader* header = getHeader(_bytes);
+    if (index >= header->stringCount)
+    {
+        return nullptr;
+    }
+
+    const uint32_t offset = getStringOffsets(_bytes)[index];
+    if (offset % sizeof(uint32_t) != 0 || offset > header->stringBytes || header->stringBytes - offset < sizeof(uint32_t))
+    {
+        return nullptr;
+    }
+
+    // the characters and their '\0' must fit in the string bytes
+    const unsigned char* string = getStringBytes(_bytes) + offset;
+    const uint32_t stringLength = *reinterpret_cast<const uint32_t*>(string);
+    if (stringLength >= header->stringBytes - offset - sizeof(uint32_t) || string[sizeof(uint32_t) + stringLength] != '\0')
+    {
+        return nullptr;
+    }
+
+    if (length)
+    {
+        *length = stringLength;
+    }
+    return reinterpret_cast<const char*>(string + sizeof(uint32_t));
+}
+
+Value::Type ValueBinaryNode::getType() const
+{
+    if (!_node || _node[0] > static_cast<uint32_t>(Value::Type::INT_KEY_MAP))
+    {
+        return Value::Type::NONE;
+    }
+    return static_cast<Value::Type>(_node[0]);
+}
+
+unsigned char ValueBinaryNode::asByte() const
+{
+    switch (getType())
+    {
+        case Value::Type::BYTE:
+            return static_cast<unsigned char>(_node[1]);
+        case Value::Type::STRING:
+            return static_cast<unsigned char>(atoi(getCString()));
+        default:
+            return toValue().asByte();
+    }
+}
+
+int ValueBinaryNode::asInt() const
+{
+    switch (getType())
+    {
+        case Value::Type::INTEGER:
+            return static_cast<int>(_node[1]);
+        case Value::Type::STRING:
+            return atoi(getCString());
+        default:
+            return toValue().asInt();
+    }
+}
+
+float ValueBinaryNode::asFloat() const
+{
+    switch (getType())
+    {
+        case Value::Type::FLOAT:
+        {
+            float ret;
+            memcpy(&ret, &_node[1], sizeof(ret));
+            return ret;
+        }
+        case Value::Type::STRING:
+            return utils::atof(getCString());
+        default:
+            return toValue().asFloat();
+    }
+}
+
+double ValueBinaryNode::asDouble() const
+{
+    switch (getType())
+    {
+        case Value::Type::DOUBLE:
+        {
+            double ret = 0.0;
+            const uint32_t* pool = getPool(_node[1], 2);
+            if (pool)
+            {
+                memcpy(&ret, pool, sizeof(ret));
+            }
+            return ret;
+        }
+        case Value::Type::STRING:
+            return static_cast<double>(utils::atof(getCString()));
+        default:
+            return toValue().asDouble();
+    }
+}
+
+bool ValueBinaryNode::asBool() const
+{
+    switch (getType())
+    {
+        case Value::Type::BOOLEAN:
+            return _node[1] != 0;
+        case Value::Type::STRING:
+        {
+            const char* string = getCString();
+            return (strcmp(string, "0") == 0 || strcmp(string, "false") == 0) ? false : true;
+        }
+        default:
+            return toValue().asBool();
+    }
+}
+
+std::string ValueBinaryNode::asString() const
+{
+    if (getType() == Value::Type::STRING)
+    {
+        ssize_t length = 0;
+        const char* string = getCString(&length);
+        return std::string(string, length);
+    }
+    return toValue().asString();
+}
+
+const char* ValueBinaryNode::getCString(ssize_t* length) const
+{
+    uint32_t stringLength = 0;
+    const char* string = nullptr;
+    if (getType() == Value::Type::STRING)
+    {
+        string = getString(_node[1], &stringLength);
+        if (!string)
+        {
+            // a corrupted string reads as an empty one, the number conversions expect characters
+            string = "";
+            stringLength = 0;
+        }
+    }
+
+    if (length)
+    {
+        *length = stringLength;
+    }
+    return string;
+}
+
+ssize_t ValueBinaryNode::size() const
+{
+    switch (getType())
+    {
+        case Value::Type::VECTOR:
+        case Value::Type::MAP:
+        case Value::Type::INT_KEY_MAP:
+        {
+            const uint32_t* pool = getPool(_node[1], 1);
+            if (!pool)
+            {
+                return 0;
+            }
+            const uint32_t entrySize = getType() == Value::Type::VECTOR ? 1 : 2;
+            // the entries must fit in the pool as well
+            return getPool(_node[1] + 1, pool[0] * entrySize) ? pool[0] : 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+ValueBinaryNode ValueBinaryNode::at(ssize_t index) const
+{
+    if (getType() != Value::Type::VECTOR || index < 0 || index >= size())
+    {
+        return ValueBinaryNode();
+    }
+    return getChild(getPoolStart(_bytes)[_node[1] + 1 + index]);
+}
+
+ValueBinaryNode ValueBinaryNode::operator[](const char* key) const
+{
+    if (getType() != Value::Type::MAP)
+    {
+        return ValueBinaryNode();
+    }
+
+    const uint32_t* entries = getPoolStart(_bytes) + _node[1] + 1;
+    ssize_t low = 0;
+    ssize_t high = size() - 1;
+    while (low <= high)
+    {
+        const ssize_t middle = (low + high) / 2;
+        const char* middleKey = getString(entries[middle * 2], nullptr);
+        if (!middleKey)
+        {
+            break;
+        }
+
+        const int result = strcmp(middleKey, key);
+        if (result == 0)
+        {
+            return getChild(entries[middle * 2 + 1]);
+        }
+        else if (result < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return ValueBinaryNode();
+}
+
+const char* ValueBinaryNode::keyAt(ssize_t index) const
+{
+    if (getType() != Value::Type::MAP || index < 0 || index >= size())
+    {
+        return nullptr;
+    }
+    return getString(getPoolStart(_bytes)[_node[1] + 1 + index * 2], nullptr);
+}
+
+int ValueBinaryNode::intKeyAt(ssize_t index) const
+{
+    if (getType() != Value::Type::INT_KEY_MAP || index < 0 || index >= size())
+    {
+        return 0;
+    }
+    return static_cast<int>(getPoolStart(_bytes)[_node[1] + 1 + index * 2]);
+}
+
+ValueBinaryNode ValueBinaryNode::valueAt(ssize_t index) const
+{
+    const Value::Type type = getType();
+    if ((type != Value::Type::MAP && type != Value::Type::INT_KEY_MAP) || index < 0 || index >= size())
+    {
+        return ValueBinaryNode();
+    }
+    return getChild(getPoolStart(_bytes)[_node[1] + 1 + index * 2 + 1]);
+}
+
+Value ValueBinaryNode::toValue() const
+{
+    return toValue(0);
+}
+
+Value ValueBinaryNode::toValue(unsigned int depth) const
+{
+    if (depth > VALUE_BINARY_MAX_DEPTH)
+    {
+        CCLOG("cocos2d: ValueBinary: the data is nested too deeply");
+        return Value::Null;
+    }
+
+    switch (getType())
+    {
+        case Value::Type::BYTE:
+            return Value(static_cast<unsigned char>(_node[1]));
+        case Value::Type::INTEGER:
+            return Value(static_cast<int>(_node[1]));
+        case Value::Type::FLOAT:
+            return Value(asFloat());
+        case Value::Type::DOUBLE:
+            return Value(asDouble());
+        case Value::Type::BOOLEAN:
+            return Value(_node[1] != 0);
+        case Value::Type::STRING:
+            return Value(asString());
+        case Value::Type::VECTOR:
+        {
+            const ssize_t count = size();
+            ValueVector vector;
+            vector.reserve(count);
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                vector.push_back(at(i).toValue(depth + 1));
+            }
+            return Value(std::move(vector));
+        }
+        case Value::Type::MAP:
+        {
+            const ssize_t count = size();
+            ValueMap map;
+            map.reserve(count);
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                const char* key = keyAt(i);
+                if (key)
+                {
+                    map.insert(std::make_pair(std::string(key), valueAt(i).toValue(depth + 1)));
+                }
+            }
+            return Value(std::move(map));
+        }
+        case Value::Type::INT_KEY_MAP:
+        {
+            const ssize_t count = size();
+            ValueMapIntKey map;
+            map.reserve(count);
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                map.insert(std::make_pair(intKeyAt(i), valueAt(i).toValue(depth + 1)));
+            }
+            return Value(std::move(map));
+        }
+        default:
+            return Value::Null;
+    }
+}
+
+// ValueBinary
+
+namespace
+{
+    class ValueBinaryWriter
+    {
+    public:
+        Data write(const Value& root)
+        {
+            addNode(root);
+
+            ValueBinaryHeader header;
+            memcpy(header.magic, VALUE_BINARY_MAGIC, sizeof(header.magic));
+            header.version = VALUE_BINARY_VERSION;
+            header.nodeCount = static_cast<uint32_t>(_nodes.size() / 2);
+            header.poolSize = static_cast<uint32_t>(_pool.size());
+            header.stringCount = static_cast<uint32_t>(_stringOffsets.size());
+            header.stringBytes = static_cast<uint32_t>(_strings.size());
+
+            const size_t size = sizeof(header)
+                + (_nodes.size() + _pool.size() + _stringOffsets.size()) * sizeof(uint32_t)
+                + _strings.size();
+            unsigned char* buffer = (unsigned char*)malloc(size);
+            if (!buffer)
+            {
+                return Data::Null;
+            }
+
+            unsigned char* out = buffer;
+            out = append(out, &header, sizeof(header));
+            out = append(out, _nodes.data(), _nodes.size() * sizeof(uint32_t));
+            out = append(out, _pool.data(), _pool.size() * sizeof(uint32_t));
+            out = append(out, _stringOffsets.data(), _stringOffsets.size() * sizeof(uint32_t));
+            append(out, _strings.data(), _strings.size());
+
+            Data data;
+            data.fastSet(buffer, size);
+            return data;
+        }
+
+    private:
+        static unsigned char* append(unsigned char* out, const void* data, size_t size)
+        {
+            if (size > 0)
+            {
+                memcpy(out, data, size);
+            }
+            return out + size;
+        }
+
+        uint32_t addString(const std::string& string)
+        {
+            auto iter = _stringIndices.find(string);
+            if (iter != _stringIndices.end())
+            {
+                return iter->second;
+            }
+
+            const uint32_t index = static_cast<uint32_t>(_stringOffsets.size());
+            _stringOffsets.push_back(static_cast<uint32_t>(_strings.size()));
+
+            const uint32_t length = static_cast<uint32_t>(string.size());
+            const unsigned char* lengthBytes = reinterpret_cast<const unsigned char*>(&length);
+            _strings.insert(_strings.end(), lengthBytes, lengthBytes + sizeof(length));
+            _strings.insert(_strings.end(), string.begin(), string.end());
+            _strings.push_back('\0');
+            // keeps the next length aligned
+            while (_strings.size() % sizeof(uint32_t) != 0)
+            {
+                _strings.push_back('\0');
+            }
+
+            _stringIndices.insert(std::make_pair(string, index));
+            return index;
+        }
+
+        uint32_t addNode(const Value& value)
+        {
+            const uint32_t index = static_cast<uint32_t>(_nodes.size() / 2);
+            _nodes.push_back(static_cast<uint32_t>(value.getType()));
+            _nodes.push_back(0);
+
+            uint32_t payload = 0;
+            switch (value.getType())
+            {
+                case Value::Type::BYTE:
+                    payload = value.asByte();
+                    break;
+                case Value::Type::INTEGER:
+                    payload = static_cast<uint32_t>(value.asInt());
+                    break;
+                case Value::Type::FLOAT:
+                {
+                    const float f = value.asFloat();
+                    memcpy(&payload, &f, sizeof(payload));
+                    break;
+                }
+                case Value::Type::DOUBLE:
+                {
+                    const double d = value.asDouble();
+                    payload = static_cast<uint32_t>(_pool.size());
+                    _pool.resize(_pool.size() + 2);
+                    memcpy(&_pool[payload], &d, sizeof(d));
+                    break;
+                }
+                case Value::Type::BOOLEAN:
+                    payload = value.asBool() ? 1 : 0;
+                    break;
+                case Value::Type::STRING:
+                    payload = addString(value.asString());
+                    break;
+                case Value::Type::VECTOR:
+                {
+                    const ValueVector& vector = value.asValueVector();
+                    payload = static_cast<uint32_t>(_pool.size());
+                    _pool.resize(_pool.size() + 1 + vector.size());
+                    _pool[payload] = static_cast<uint32_t>(vector.size());
+                    for (size_t i = 0; i < vector.size(); ++i)
+                    {
+                        // addNode() may grow the pool, don't keep a pointer into it
+                        const uint32_t child = addNode(vector[i]);
+                        _pool[payload + 1 + i] = child;
+                    }
+                    break;
+                }
+                case Value::Type::MAP:
+                {
+                    std::vector<ValueMap::const_iterator> entries;
+                    const ValueMap& map = value.asValueMap();
+                    entries.reserve(map.size());
+                    for (auto iter = map.cbegin(); iter != map.cend(); ++iter)
+                    {
+                        entries.push_back(iter);
+                    }
+                    std::sort(entries.begin(), entries.end(), [](const ValueMap::const_iterator& a, const ValueMap::const_iterator& b) {
+                        return strcmp(a->first.c_str(), b->first.c_str()) < 0;
+                    });
+
+                    payload = static_cast<uint32_t>(_pool.size());
+                    _pool.resize(_pool.size() + 1 + entries.size() * 2);
+                    _pool[payload] = static_cast<uint32_t>(entries.size());
+                    for (size_t i = 0; i < entries.size(); ++i)
+                    {
+                        const uint32_t key = addString(entries[i]->first);
+                        const uint32_t child = addNode(entries[i]->second);
+                        _pool[payload + 1 + i * 2] = key;
+                        _pool[payload + 1 + i * 2 + 1] = child;
+                    }
+                    break;
+                }
+                case Value::Type::INT_KEY_MAP:
+                {
+                    std::vector<ValueMapIntKey::const_iterator> entries;
+                    const ValueMapIntKey& map = value.asIntKeyMap();
+                    entries.reserve(map.size());
+                    for (auto iter = map.cbegin(); iter != map.cend(); ++iter)
+                    {
+                        entries.push_back(iter);
+                    }
+                    std::sort(entries.begin(), entries.end(), [](const ValueMapIntKey::const_iterator& a, const ValueMapIntKey::const_iterator& b) {
+                        return a->first < b->first;
+                    });
+
+                    payload = static_cast<uint32_t>(_pool.size());
+                    _pool.resize(_pool.size() + 1 + entries.size() * 2);
+                    _pool[payload] = static_cast<uint32_t>(entries.size());
+                    for (size_t i = 0; i < entries.size(); ++i)
+                    {
+                        const uint32_t child = addNode(entries[i]->second);
+                        _pool[payload + 1 + i * 2] = static_cast<uint32_t>(entries[i]->first);
+                        _pool[payload + 1 + i * 2 + 1] = child;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            _nodes[index * 2 + 1] = payload;
+            return index;
+        }
+
+        std::vector<uint32_t> _nodes;
+        std::vector<uint32_t> _pool;
+        std::vector<uint32_t> _stringOffsets;
+        std::vector<unsigned char> _strings;
+        std::unordered_map<std::string, uint32_t> _stringIndices;
+    };
+}
+
+bool ValueBinary::isValueBinary(const unsigned char* bytes, ssize_t size)
+{
+    return bytes != nullptr
+        && size >= static_cast<ssize_t>(sizeof(ValueBinaryHeader))
+        && memcmp(bytes, VALUE_BINARY_MAGIC, sizeof(VALUE_BINARY_MAGIC)) == 0;
+}
+
+Data ValueBinary::encode(const Value& root)
+{
+    if (root.getType() != Value::Type::MAP && root.getType() != Value::Type::VECTOR)
+    {
+        CCLOG("cocos2d: ValueBinary: only maps and vectors can be encoded");
+        return Data::Null;
+    }
+
+    ValueBinaryWriter writer;
+    return writer.write(root);
+}
+
+bool ValueBinary::writeToFile(const Value& root, const std::string& fullPath)
+{
+    Data data = encode(root);
+    if (data.isNull())
+    {
+        return false;
+    }
+
+    FILE* fp = fopen(fullPath.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("cocos2d: ValueBinary: can't open %s for writing", fullPath.c_str());
+        return false;
+    }
+
+    const size_t written = fwrite(data.getBytes(), 1, data.getSize(), fp);
+    fclose(fp);
+    return written == static_cast<size_t>(data.getSize());
+}
+
+ValueBinaryNode ValueBinary::getRoot(const unsigned char* bytes, ssize_t size)
+{
+    if (!isValueBinary(bytes, size))
+    {
+        return ValueBinaryNode();
+    }
+
+    const ValueBinaryHeader* header = getHeader(bytes);
+    if (header->version != VALUE_BINARY_VERSION)
+    {
+        CCLOG("cocos2d: ValueBinary: unsupported version %u", header->version);
+        return ValueBinaryNode();
+    }
+
+    const uint64_t expectedSize = sizeof(ValueBinaryHeader)
+        + (static_cast<uint64_t>(header->nodeCount) * 2 + header->poolSize + header->stringCount) * sizeof(uint32_t)
+        + header->stringBytes;
+    if (expectedSize > static_cast<uint64_t>(size))
+    {
+        CCLOG("cocos2d: ValueBinary: the data is truncated");
+        return ValueBinaryNode();
+    }
+
+    return ValueBinaryNode(bytes, 0);
+}
+
+Value ValueBinary::decode(const unsigned char* bytes, ssize_t size)
+{
+    return getRoot(bytes, size).toValue();
+}
+
+NS_CC_END
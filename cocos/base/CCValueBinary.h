@@ -0,0 +1,143 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCVALUEBINARY_H__
+#define __CCVALUEBINARY_H__
+
+#include <stdint.h>
+#include <string>
+
+#include "base/CCValue.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup data_structures
+ * @{
+ */
+
+/**
+ * A read only view on one value of a binary property list (see ValueBinary).
+ *
+ * It is two pointers wide and never allocates, except for asString() and toValue().
+ * It points into the encoded data, which must outlive it.
+ * Looking up a missing key or index returns a node of type Value::Type::NONE.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ValueBinaryNode
+{
+public:
+    ValueBinaryNode();
+
+    Value::Type getType() const;
+    bool isNull() const { return getType() == Value::Type::NONE; }
+
+    /** Scalar conversions. They follow the rules of the Value::asXXX() methods. */
+    unsigned char asByte() const;
+    int asInt() const;
+    float asFloat() const;
+    double asDouble() const;
+    bool asBool() const;
+    std::string asString() const;
+
+    /** Returns the characters of a string node without copying them, nullptr for other types. */
+    const char* getCString(ssize_t* length = nullptr) const;
+
+    /** Number of elements of a vector or of a map, 0 for scalars. */
+    ssize_t size() const;
+
+    /** Element of a vector. */
+    ValueBinaryNode at(ssize_t index) const;
+
+    /** Value of a map for the given key. Keys are sorted, so this is a binary search. */
+    ValueBinaryNode operator[](const char* key) const;
+    ValueBinaryNode operator[](const std::string& key) const { return (*this)[key.c_str()]; }
+
+    /** Key and value of the index-th entry of a map. intKeyAt() is for Value::Type::INT_KEY_MAP nodes. */
+    const char* keyAt(ssize_t index) const;
+    int intKeyAt(ssize_t index) const;
+    ValueBinaryNode valueAt(ssize_t index) const;
+
+    /** Builds the Value tree of this node. Data nested deeper than 128 levels is rejected. */
+    Value toValue() const;
+
+private:
+    ValueBinaryNode(const unsigned char* bytes, uint32_t index);
+
+    /** Element node of this container, a NONE node unless its index is after this node's. */
+    ValueBinaryNode getChild(uint32_t index) const;
+    Value toValue(unsigned int depth) const;
+
+    const uint32_t* getPool(uint32_t offset, uint32_t count) const;
+    const char* getString(uint32_t index, uint32_t* length) const;
+
+    const unsigned char* _bytes;
+    const uint32_t* _node;
+
+    friend class ValueBinary;
+};
+
+/**
+ * Compact binary serialization of ValueMap and ValueVector, used to ship plist based assets
+ * (sprite sheets, animations, particles...) without parsing XML at load time.
+ *
+ * Every string is stored once in a table and containers are flat arrays of node indices,
+ * map keys being sorted. The data can be read in place with ValueBinaryNode, or decoded
+ * into a Value tree. FileUtils::getValueMapFromFile() recognizes binary files whatever
+ * their extension, so a converted plist can keep its name.
+ *
+ * The data is written in the byte order of the machine which encoded it, little endian
+ * on every platform supported by the engine.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ValueBinary
+{
+public:
+    /** Whether the bytes start with the header of a binary property list. */
+    static bool isValueBinary(const unsigned char* bytes, ssize_t size);
+
+    /** Encodes a Value of type MAP or VECTOR. Returns Data::Null for other types. */
+    static Data encode(const Value& root);
+
+    /** Encodes the value and writes it to the given full path. */
+    static bool writeToFile(const Value& root, const std::string& fullPath);
+
+    /**
+     * Returns the root of the encoded data, a NONE node if the data isn't valid.
+     * The bytes are not copied, they must stay alive as long as the nodes are used.
+     */
+    static ValueBinaryNode getRoot(const unsigned char* bytes, ssize_t size);
+
+    /** Decodes the whole data, Value::Null if it isn't valid. */
+    static Value decode(const unsigned char* bytes, ssize_t size);
+};
+
+// end of data_structures group
+/// @}
+
+NS_CC_END
+
+#endif // __CCVALUEBINARY_H__
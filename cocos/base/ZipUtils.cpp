@@ -32,6 +32,15 @@
 #include "platform/CCFileUtils.h"
 #include "unzip.h"
 #include <map>
+#include <mutex>
+#include <vector>
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 NS_CC_BEGIN
 
@@ -484,26 +493,162 @@ void ZipUtils::setPvrEncryptionKey(unsigned int keyPart1, unsigned int keyPart2,
 // from unzip.cpp
 #define UNZ_MAXFILENAMEINZIP 256
 
+// stored entries (no compression) can be served straight from the memory mapped archive
+#define ZIP_METHOD_STORED 0
+// general purpose flag, bit 0: the entry is encrypted
+#define ZIP_FLAG_ENCRYPTED 1
+// number of idle read handles kept open, extra handles are closed when returned
+#define ZIP_MAX_IDLE_HANDLES 4
+// the data offset of an entry is only known after its local header has been read
+#define ZIP_UNKNOWN_OFFSET ((ZPOS64_T)-1)
+
 struct ZipEntryInfo
 {
     unz_file_pos pos;
     uLong uncompressed_size;
+    uLong compression_method;
+    uLong flag;
+    ZPOS64_T data_offset;
 };
 
 class ZipFilePrivate
 {
 public:
+    ZipFilePrivate()
+    : zipFile(nullptr)
+    , mappedData(nullptr)
+    , mappedSize(0)
+    , fileSize(0)
+    , fileModifiedTime(0)
+    , fileInode(0)
+    {
+    }
+
+    std::string zipFileName;
     unzFile zipFile;
     
     // std::unordered_map is faster if available on the platform
     typedef std::unordered_map<std::string, struct ZipEntryInfo> FileListContainer;
     FileListContainer fileList;
+
+    // idle read handles, getFileData() borrows one so that several threads can read at once
+    std::mutex handlesMutex;
+    std::vector<unzFile> idleHandles;
+
+    // the whole archive mapped in memory, nullptr if mapping isn't supported
+    unsigned char *mappedData;
+    size_t mappedSize;
+
+    // what the zip file looked like when it was opened, to notice it being replaced
+    long long fileSize;
+    long long fileModifiedTime;
+    long long fileInode;
+
+    unzFile acquireHandle()
+    {
+        {
+            std::lock_guard<std::mutex> lock(handlesMutex);
+            if (!idleHandles.empty())
+            {
+                unzFile handle = idleHandles.back();
+                idleHandles.pop_back();
+                return handle;
+            }
+        }
+        return unzOpen(zipFileName.c_str());
+    }
+
+    void releaseHandle(unzFile handle)
+    {
+        if (!handle)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(handlesMutex);
+            if (idleHandles.size() < ZIP_MAX_IDLE_HANDLES)
+            {
+                idleHandles.push_back(handle);
+                return;
+            }
+        }
+        unzClose(handle);
+    }
+
+    void mapArchive()
+    {
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+        int fd = open(zipFileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+
+        struct stat st;
+        if (fstat(fd, &st) == 0)
+        {
+            fileSize = st.st_size;
+            fileModifiedTime = st.st_mtime;
+            fileInode = st.st_ino;
+        }
+        if (fileSize > 0)
+        {
+            void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                mappedData = static_cast<unsigned char*>(data);
+                mappedSize = st.st_size;
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    void unmapArchive()
+    {
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+        if (mappedData)
+        {
+            munmap(mappedData, mappedSize);
+        }
+#endif
+        mappedData = nullptr;
+        mappedSize = 0;
+    }
+
+    // Returns the offset of the entry data inside the archive, reading the local header the first time.
+    ZPOS64_T dataOffset(ZipEntryInfo &entry)
+    {
+        {
+            std::lock_guard<std::mutex> lock(handlesMutex);
+            if (entry.data_offset != ZIP_UNKNOWN_OFFSET)
+                return entry.data_offset;
+        }
+
+        ZPOS64_T offset = ZIP_UNKNOWN_OFFSET;
+        unz_file_pos pos = entry.pos;
+        unzFile handle = acquireHandle();
+        if (handle
+            && unzGoToFilePos(handle, &pos) == UNZ_OK
+            && unzOpenCurrentFile(handle) == UNZ_OK)
+        {
+            offset = unzGetCurrentFileZStreamPos64(handle);
+            unzCloseCurrentFile(handle);
+        }
+        releaseHandle(handle);
+
+        std::lock_guard<std::mutex> lock(handlesMutex);
+        entry.data_offset = offset;
+        return offset;
+    }
 };
 
 ZipFile::ZipFile(const std::string &zipFile, const std::string &filter)
 : _data(new ZipFilePrivate)
 {
+    _data->zipFileName = zipFile;
     _data->zipFile = unzOpen(zipFile.c_str());
+    if (_data->zipFile)
+    {
+        _data->mapArchive();
+    }
     setFilter(filter);
 }
 
@@ -514,6 +659,15 @@ ZipFile::~ZipFile()
         unzClose(_data->zipFile);
     }
 
+    if (_data)
+    {
+        for (auto handle : _data->idleHandles)
+        {
+            unzClose(handle);
+        }
+        _data->unmapArchive();
+    }
+
     CC_SAFE_DELETE(_data);
 }
 
@@ -549,6 +703,9 @@ bool ZipFile::setFilter(const std::string &filter)
                     ZipEntryInfo entry;
                     entry.pos = posInfo;
                     entry.uncompressed_size = (uLong)fileInfo.uncompressed_size;
+                    entry.compression_method = fileInfo.compression_method;
+                    entry.flag = fileInfo.flag;
+                    entry.data_offset = ZIP_UNKNOWN_OFFSET;
                     _data->fileList[currentFileName] = entry;
                 }
             }
@@ -576,6 +733,60 @@ bool ZipFile::fileExists(const std::string &fileName) const
     return ret;
 }
 
+bool ZipFile::isOpen() const
+{
+    return _data && _data->zipFile;
+}
+
+bool ZipFile::isModified() const
+{
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    if (!isOpen())
+        return false;
+
+    struct stat st;
+    if (stat(_data->zipFileName.c_str(), &st) != 0)
+        return true;
+
+    return st.st_size != _data->fileSize || st.st_mtime != _data->fileModifiedTime || (long long)st.st_ino != _data->fileInode;
+#else
+    // the open handle prevents the file from being replaced
+    return false;
+#endif
+}
+
+const unsigned char *ZipFile::getFileDataNoCopy(const std::string &fileName, ssize_t *size)
+{
+    const unsigned char *buffer = nullptr;
+    if (size)
+        *size = 0;
+
+    do
+    {
+        CC_BREAK_IF(!_data->mappedData);
+        CC_BREAK_IF(fileName.empty());
+
+        ZipFilePrivate::FileListContainer::iterator it = _data->fileList.find(fileName);
+        CC_BREAK_IF(it == _data->fileList.end());
+
+        ZipEntryInfo &fileInfo = it->second;
+        CC_BREAK_IF(fileInfo.compression_method != ZIP_METHOD_STORED);
+        CC_BREAK_IF(fileInfo.flag & ZIP_FLAG_ENCRYPTED);
+
+        ZPOS64_T offset = _data->dataOffset(fileInfo);
+        CC_BREAK_IF(offset == ZIP_UNKNOWN_OFFSET);
+        CC_BREAK_IF(offset + fileInfo.uncompressed_size > _data->mappedSize);
+
+        buffer = _data->mappedData + offset;
+        if (size)
+        {
+            *size = fileInfo.uncompressed_size;
+        }
+    } while (0);
+
+    return buffer;
+}
+
 unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
 {
     unsigned char * buffer = nullptr;
@@ -587,26 +798,50 @@ unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
         CC_BREAK_IF(!_data->zipFile);
         CC_BREAK_IF(fileName.empty());
         
-        ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
+        ZipFilePrivate::FileListContainer::iterator it = _data->fileList.find(fileName);
         CC_BREAK_IF(it ==  _data->fileList.end());
         
-        ZipEntryInfo fileInfo = it->second;
+        const ZipEntryInfo &fileInfo = it->second;
+        unz_file_pos pos = fileInfo.pos;
+
+        // stored entries are copied out of the mapping, no need to go through unzip
+        ssize_t mappedSize = 0;
+        const unsigned char *mappedBuffer = getFileDataNoCopy(fileName, &mappedSize);
+        if (mappedBuffer)
+        {
+            buffer = (unsigned char*)malloc(mappedSize);
+            memcpy(buffer, mappedBuffer, mappedSize);
+            if (size)
+            {
+                *size = mappedSize;
+            }
+            break;
+        }
         
-        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
-        CC_BREAK_IF(UNZ_OK != nRet);
+        unzFile handle = _data->acquireHandle();
+        CC_BREAK_IF(!handle);
         
-        nRet = unzOpenCurrentFile(_data->zipFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
+        int nRet = unzGoToFilePos(handle, &pos);
+        if (UNZ_OK == nRet)
+        {
+            nRet = unzOpenCurrentFile(handle);
+        }
+        if (UNZ_OK != nRet)
+        {
+            _data->releaseHandle(handle);
+            break;
+        }
         
         buffer = (unsigned char*)malloc(fileInfo.uncompressed_size);
-        int CC_UNUSED nSize = unzReadCurrentFile(_data->zipFile, buffer, static_cast<unsigned int>(fileInfo.uncompressed_size));
+        int CC_UNUSED nSize = unzReadCurrentFile(handle, buffer, static_cast<unsigned int>(fileInfo.uncompressed_size));
         CCASSERT(nSize == 0 || nSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
         
         if (size)
         {
             *size = fileInfo.uncompressed_size;
         }
-        unzCloseCurrentFile(_data->zipFile);
+        unzCloseCurrentFile(handle);
+        _data->releaseHandle(handle);
     } while (0);
     
     return buffer;
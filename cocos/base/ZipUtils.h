@@ -221,6 +221,10 @@ namespace cocos2d
     * It will cache the file list of a particular zip file with positions inside an archive,
     * so it would be much faster to read some particular files or to check their existance.
     *
+    * getFileData() and getFileDataNoCopy() can be called from several threads at once,
+    * every reader borrows its own handle from a small pool. setFilter() must not run
+    * concurrently with them.
+    *
     * @since v2.0.5
     */
     class CC_DLL ZipFile
@@ -270,6 +274,34 @@ namespace cocos2d
         */
         unsigned char *getFileData(const std::string &fileName, ssize_t *size);
 
+        /**
+        * Get the data of a file stored without compression, straight from the memory mapped archive.
+        * @param fileName File name
+        * @param[out] size If the file can be mapped, it will be the data size, otherwise 0.
+        * @return A pointer into the archive which stays valid as long as this ZipFile is alive,
+        *         nullptr if the file is compressed, encrypted or the archive can't be mapped.
+        * @warning Do not free() the returned pointer.
+        *
+        * @since v3.3
+        */
+        const unsigned char *getFileDataNoCopy(const std::string &fileName, ssize_t *size);
+
+        /**
+        * Check whether the zip file was opened successfully.
+        *
+        * @since v3.3
+        */
+        bool isOpen() const;
+
+        /**
+        * Check whether the zip file was replaced, rewritten or removed since it was opened.
+        * The data read from a modified archive is stale, or invalid when it was memory mapped,
+        * so the ZipFile should be dropped and the archive opened again.
+        *
+        * @since v3.3
+        */
+        bool isModified() const;
+
     private:
         /** Internal data like zip file pointer / file list array and so on */
         ZipFilePrivate *_data;
@@ -259,6 +259,17 @@ To enable set it to a value different than 0. Disabled by default.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_ENABLE_TRACE
+ If enabled, the engine is instrumented with the trace markers of CCTrace.h (CC_TRACE_ZONE...).
+ They cost a test of a flag until a trace is started with Trace::start() or the "trace" console command.
+ Recorded traces can be opened in chrome://tracing or Perfetto.
+
+ To disable set it to 0. Enabled by default.
+ */
+#ifndef CC_ENABLE_TRACE
+#define CC_ENABLE_TRACE 1
+#endif
+
 /** Enable Lua engine debug log */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
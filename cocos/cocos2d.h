@@ -46,6 +46,7 @@ THE SOFTWARE.
 #include "base/CCNS.h"
 #include "base/CCData.h"
 #include "base/CCValue.h"
+#include "base/CCValueBinary.h"
 #include "base/ccConfig.h"
 #include "base/ccMacros.h"
 #include "base/ccTypes.h"
@@ -55,6 +56,7 @@ THE SOFTWARE.
 #include "base/base64.h"
 #include "base/ZipUtils.h"
 #include "base/CCProfiling.h"
+#include "base/CCTrace.h"
 #include "base/CCConsole.h"
 #include "base/ccUTF8.h"
 #include "base/CCUserDefault.h"
@@ -63,6 +65,7 @@ THE SOFTWARE.
 #include "base/ccUtils.h"
 #include "base/CCCamera.h"
 #include "base/CCLight.h"
+#include "base/CCThreadPool.h"
 
 // EventDispatcher
 #include "base/CCEventType.h"
@@ -130,6 +133,7 @@ THE SOFTWARE.
 #include "2d/CCProgressTimer.h"
 #include "2d/CCRenderTexture.h"
 #include "2d/CCNodeGrid.h"
+#include "2d/CCPrefab.h"
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCParticleSystem.h"
 #include "2d/CCParticleExamples.h"
@@ -151,6 +155,7 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramBinaryCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/ccShaders.h"
@@ -2,6 +2,8 @@
 #include <algorithm>
 
 #include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
 #include "platform/CCFileUtils.h"
 #include "2d/CCScene.h"
 #include "2d/CCSpriteFrameCache.h"
@@ -57,6 +59,45 @@ void CCBFile::setCCBFileNode(Node *pNode)
  Implementation of CCBReader
  *************************************************************************/
 
+// Everything of a ccbi file which doesn't depend on the nodes being created.
+// The node properties are still read from the bytes, the node loaders handle them.
+struct CCBReader::Template
+{
+    // Decoded animated properties of a node, keyed by the offset of its sequences in the file
+    struct NodeSequences
+    {
+        int end;
+        std::unordered_map<int, Map<std::string, CCBSequenceProperty*>> sequences;
+        std::set<std::string> animatedProps;
+    };
+
+    Template()
+    : ready(false)
+    , jsControlled(false)
+    , autoPlaySequenceId(-1)
+    , nodeGraphOffset(0)
+    {}
+
+    std::string fullPath;
+    std::string rootPath;
+    std::shared_ptr<Data> data;
+    // false until a whole node graph has been read from it
+    bool ready;
+
+    bool jsControlled;
+    std::vector<std::string> stringCache;
+    Vector<CCBSequence*> sequences;
+    int autoPlaySequenceId;
+    ValueVector keyframeCallbacks;
+    int nodeGraphOffset;
+
+    std::unordered_map<int, NodeSequences> nodeSequences;
+};
+
+static bool s_templateCacheEnabled = true;
+// Purges the templates with the other cached data, while there are templates
+static EventListenerCustom* s_templatePurgeListener = nullptr;
+
 CCBReader::CCBReader(NodeLoaderLibrary * pNodeLoaderLibrary, CCBMemberVariableAssigner * pCCBMemberVariableAssigner, CCBSelectorResolver * pCCBSelectorResolver, NodeLoaderListener * pNodeLoaderListener) 
 : _data(nullptr)
 , _bytes(nullptr)
@@ -222,9 +263,10 @@ Node* CCBReader::readNodeGraphFromFile(const char *pCCBFileName, Ref *pOwner, co
 
     std::string strPath = FileUtils::getInstance()->fullPathForFilename(strCCBFileName.c_str());
 
-    auto dataPtr = std::make_shared<Data>(FileUtils::getInstance()->getDataFromFile(strPath));
+    auto dataPtr = readFileData(strPath);
     
     Node *ret =  this->readNodeGraphFromData(dataPtr, pOwner, parentSize);
+    _template = nullptr;
     
     return ret;
 }
@@ -298,25 +340,44 @@ void CCBReader::cleanUpNodeGraph(Node *node)
 
 Node* CCBReader::readFileWithCleanUp(bool bCleanUp, CCBAnimationManagerMapPtr am)
 {
-    if (! readHeader())
-    {
-        return nullptr;
-    }
-    
-    if (! readStringCache())
+    if (_template && _template->ready)
     {
-        return nullptr;
+        readTemplateHeader();
     }
-    
-    if (! readSequences())
+    else
     {
-        return nullptr;
+        if (! readHeader() || ! readStringCache() || ! readSequences())
+        {
+            discardTemplate();
+            return nullptr;
+        }
+
+        if (_template)
+        {
+            _template->jsControlled = _jsControlled;
+            _template->sequences = _animationManager->getSequences();
+            _template->autoPlaySequenceId = _animationManager->getAutoPlaySequenceId();
+            _template->keyframeCallbacks = _animationManager->getKeyframeCallbacks();
+            _template->nodeGraphOffset = _currentByte;
+        }
     }
     
     setAnimationManagers(am);
 
     Node *pNode = readNodeGraph(nullptr);
 
+    if (_template)
+    {
+        if (pNode)
+        {
+            _template->ready = true;
+        }
+        else
+        {
+            discardTemplate();
+        }
+    }
+
     _animationManagers->insert(pNode, _animationManager);
 
     if (bCleanUp)
@@ -330,13 +391,140 @@ Node* CCBReader::readFileWithCleanUp(bool bCleanUp, CCBAnimationManagerMapPtr am
 bool CCBReader::readStringCache() {
     int numStrings = this->readInt(false);
 
+    this->_stringCache.clear();
+    this->_stringCache.reserve(numStrings);
     for(int i = 0; i < numStrings; i++) {
         this->_stringCache.push_back(this->readUTF8());
     }
 
+    // The strings are read from the template from now on
+    if (_template)
+    {
+        _template->stringCache.swap(_stringCache);
+    }
+
     return true;
 }
 
+CCBReader::TemplateMap& CCBReader::getTemplates()
+{
+    static TemplateMap templates;
+    return templates;
+}
+
+std::shared_ptr<CCBReader::Template> CCBReader::getTemplate(const std::string& fullPath)
+{
+    if (!s_templateCacheEnabled)
+    {
+        return nullptr;
+    }
+
+    auto& templates = getTemplates();
+    auto iter = templates.find(fullPath);
+    if (iter != templates.end())
+    {
+        // A template is being built by a reader up the stack, don't interfere with it
+        if (!iter->second->ready)
+        {
+            return nullptr;
+        }
+
+        // The sprite frames of the keyframes are relative to the root path
+        if (iter->second->rootPath == _CCBRootPath)
+        {
+            return iter->second;
+        }
+    }
+
+    auto data = std::make_shared<Data>(FileUtils::getInstance()->getDataFromFile(fullPath));
+    if (data->isNull())
+    {
+        return nullptr;
+    }
+
+    auto tpl = std::make_shared<Template>();
+    tpl->fullPath = fullPath;
+    tpl->rootPath = _CCBRootPath;
+    tpl->data = data;
+    templates[fullPath] = tpl;
+
+    if (!s_templatePurgeListener)
+    {
+        s_templatePurgeListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_PURGE_CACHED_DATA, [](EventCustom*){
+            CCBReader::purgeTemplateCache();
+        });
+        s_templatePurgeListener->retain();
+    }
+
+    return tpl;
+}
+
+std::shared_ptr<Data> CCBReader::readFileData(const std::string& fullPath)
+{
+    _template = getTemplate(fullPath);
+    if (_template)
+    {
+        return _template->data;
+    }
+    return std::make_shared<Data>(FileUtils::getInstance()->getDataFromFile(fullPath));
+}
+
+void CCBReader::readTemplateHeader()
+{
+    _jsControlled = _template->jsControlled;
+    _animationManager->_jsControlled = _jsControlled;
+
+    _animationManager->getSequences().pushBack(_template->sequences);
+    _animationManager->setAutoPlaySequenceId(_template->autoPlaySequenceId);
+
+    auto& keyframeCallbacks = _animationManager->getKeyframeCallbacks();
+    keyframeCallbacks.insert(keyframeCallbacks.end(), _template->keyframeCallbacks.begin(), _template->keyframeCallbacks.end());
+
+    _currentByte = _template->nodeGraphOffset;
+    _currentBit = 0;
+}
+
+void CCBReader::discardTemplate()
+{
+    if (!_template)
+    {
+        return;
+    }
+
+    // Keep _template itself, the string table may still be in use by the caller
+    auto& templates = getTemplates();
+    auto iter = templates.find(_template->fullPath);
+    if (iter != templates.end() && iter->second == _template)
+    {
+        templates.erase(iter);
+    }
+}
+
+void CCBReader::setTemplateCacheEnabled(bool enabled)
+{
+    s_templateCacheEnabled = enabled;
+    if (!enabled)
+    {
+        purgeTemplateCache();
+    }
+}
+
+bool CCBReader::isTemplateCacheEnabled()
+{
+    return s_templateCacheEnabled;
+}
+
+void CCBReader::purgeTemplateCache()
+{
+    getTemplates().clear();
+
+    if (s_templatePurgeListener)
+    {
+        Director::getInstance()->getEventDispatcher()->removeEventListener(s_templatePurgeListener);
+        CC_SAFE_RELEASE_NULL(s_templatePurgeListener);
+    }
+}
+
 bool CCBReader::readHeader()
 {
     /* If no bytes loaded, don't crash about it. */
@@ -387,11 +575,7 @@ std::string CCBReader::readUTF8()
 
     int numBytes = b0 << 8 | b1;
 
-    char* pStr = (char*)malloc(numBytes+1);
-    memcpy(pStr, _bytes+_currentByte, numBytes);
-    pStr[numBytes] = '\0';
-    ret = pStr;
-    free(pStr);
+    ret.assign(reinterpret_cast<const char*>(_bytes + _currentByte), numBytes);
 
     _currentByte += numBytes;
 
@@ -500,10 +684,10 @@ float CCBReader::readFloat()
     }
 }
 
-std::string CCBReader::readCachedString()
+const std::string& CCBReader::readCachedString()
 {
     int n = this->readInt(false);
-    return this->_stringCache[n];
+    return _template ? _template->stringCache[n] : this->_stringCache[n];
 }
 
 Node * CCBReader::readNodeGraph(Node * pParent)
@@ -547,11 +731,23 @@ Node * CCBReader::readNodeGraph(Node * pParent)
         _animationManager->setDocumentControllerName(_jsControlledName);
     }
 
-    // Read animated properties
+    // Read animated properties, once per template
+    Template::NodeSequences* nodeSequences = nullptr;
+    bool decodeSequences = true;
+    if (_template)
+    {
+        auto result = _template->nodeSequences.emplace(_currentByte, Template::NodeSequences());
+        nodeSequences = &result.first->second;
+        decodeSequences = result.second;
+        _animatedProps = &nodeSequences->animatedProps;
+    }
+    else
+    {
+        _animatedProps = new std::set<std::string>();
+    }
+
     std::unordered_map<int, Map<std::string, CCBSequenceProperty*>> seqs;
-    _animatedProps = new std::set<std::string>();
-    
-    int numSequence = readInt(false);
+    int numSequence = decodeSequences ? readInt(false) : 0;
     for (int i = 0; i < numSequence; ++i)
     {
         int seqId = readInt(false);
@@ -582,10 +778,24 @@ Node * CCBReader::readNodeGraph(Node * pParent)
         
         seqs[seqId] = seqNodeProps;
     }
+
+    if (nodeSequences)
+    {
+        if (decodeSequences)
+        {
+            nodeSequences->end = _currentByte;
+            nodeSequences->sequences = seqs;
+        }
+        else
+        {
+            _currentByte = nodeSequences->end;
+        }
+    }
     
-    if (!seqs.empty())
+    const auto& nodeSeqs = nodeSequences ? nodeSequences->sequences : seqs;
+    if (!nodeSeqs.empty())
     {
-        _animationManager->addNode(node, seqs);
+        _animationManager->addNode(node, nodeSeqs);
     }
     
     // Read properties
@@ -699,7 +909,10 @@ Node * CCBReader::readNodeGraph(Node * pParent)
 
 #endif // CCB_ENABLE_JAVASCRIPT
     
-    delete _animatedProps;
+    if (!_template)
+    {
+        delete _animatedProps;
+    }
     _animatedProps = nullptr;
 
     /* Read and add children. */
@@ -3,6 +3,7 @@
 
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "2d/CCNode.h"
 #include "base/CCData.h"
@@ -281,7 +282,7 @@ public:
      * @js NA
      * @lua NA
      */
-    std::string readCachedString();
+    const std::string& readCachedString();
     /**
      * @js NA
      * @lua NA
@@ -341,6 +342,23 @@ public:
      */
     static float getResolutionScale();
     static void setResolutionScale(float scale);
+    /**
+     * Enables the cache of decoded ccbi files, enabled by default.
+     * The files loaded by readNodeGraphFromFile() or through a CCBFile node keep their bytes,
+     * string table, sequences and keyframes, so reading them again only creates the nodes.
+     * The sequences and keyframes are shared by the animation managers of every copy.
+     * @js NA
+     * @lua NA
+     */
+    static void setTemplateCacheEnabled(bool enabled);
+    static bool isTemplateCacheEnabled();
+    /**
+     * Releases the cached files, for instance after changing the search paths.
+     * Director::purgeCachedData() calls it too.
+     * @js NA
+     * @lua NA
+     */
+    static void purgeTemplateCache();
     /**
      * @js NA
      * @lua NA
@@ -351,6 +369,15 @@ public:
     void addOwnerOutletNode(cocos2d::Node *node);
 
 private:
+    struct Template;
+    typedef std::unordered_map<std::string, std::shared_ptr<Template>> TemplateMap;
+
+    static TemplateMap& getTemplates();
+    std::shared_ptr<Template> getTemplate(const std::string& fullPath);
+    std::shared_ptr<cocos2d::Data> readFileData(const std::string& fullPath);
+    void readTemplateHeader();
+    void discardTemplate();
+
     void cleanUpNodeGraph(cocos2d::Node *pNode);
     bool readSequences();
     CCBKeyframe* readKeyframe(PropertyType type);
@@ -370,6 +397,7 @@ private:
 
 private:
     std::shared_ptr<cocos2d::Data> _data;
+    std::shared_ptr<Template> _template;
     unsigned char *_bytes;
     int _currentByte;
     int _currentBit;
@@ -261,6 +261,31 @@ void ActionTimeline::removeTimeline(Timeline* timeline)
     }
 }
 
+ssize_t ActionTimeline::getMemorySize() const
+{
+    // every timeline is referenced by _timelineList and by the list of its action tag in _timelineMap
+    ssize_t size = sizeof(*this) + _timelineList.capacity() * sizeof(Timeline*);
+    for (const auto& timelines : _timelineMap)
+    {
+        size += sizeof(timelines) + timelines.second.capacity() * sizeof(Timeline*);
+    }
+    for (auto timeline : _timelineList)
+    {
+        size += timeline->getMemorySize();
+    }
+    return size;
+}
+
+ssize_t ActionTimeline::getKeyFramesMemorySize() const
+{
+    ssize_t size = 0;
+    for (auto timeline : _timelineList)
+    {
+        size += timeline->getKeyFrames()->getMemorySize();
+    }
+    return size;
+}
+
 void ActionTimeline::setFrameEventCallFunc(std::function<void(Frame *)> listener)
 {
     _frameEventListener = listener;
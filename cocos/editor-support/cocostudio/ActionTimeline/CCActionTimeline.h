@@ -125,6 +125,11 @@ public:
 
     virtual const cocos2d::Vector<Timeline*>& getTimelines() const { return _timelineList; }
 
+    /** Bytes used by this action and its timelines. The key frames are shared with the clones
+      * of the action, getKeyFramesMemorySize() returns their size. */
+    virtual ssize_t getMemorySize() const;
+    virtual ssize_t getKeyFramesMemorySize() const;
+
     /** Set ActionTimeline's frame event callback function */
     void setFrameEventCallFunc(std::function<void(Frame *)> listener);
     void clearFrameEventCallFunc();
@@ -38,6 +38,7 @@ Frame::Frame()
     , _tween(true)
     , _timeline(nullptr)
     , _node(nullptr)
+    , _keyFrames(nullptr)
 {
 }
 
@@ -53,6 +54,14 @@ void Frame::emitEvent()
     }
 }
 
+void Frame::setDirty()
+{
+    if (_keyFrames)
+    {
+        _keyFrames->setDirty();
+    }
+}
+
 void Frame::cloneProperty(Frame* frame)
 {
     _frameIndex = frame->getFrameIndex();
@@ -37,12 +37,13 @@ THE SOFTWARE.
 NS_TIMELINE_BEGIN
 
 class Timeline;
+class TimelineKeyFrames;
 
 class CC_STUDIO_DLL Frame : public cocos2d::Ref
 {
 public:
 
-    virtual void setFrameIndex(unsigned int frameIndex) { _frameIndex = frameIndex; }
+    virtual void setFrameIndex(unsigned int frameIndex) { _frameIndex = frameIndex; setDirty(); }
     virtual unsigned int getFrameIndex() const { return _frameIndex; }
 
     virtual void setTimeline(Timeline* timeline) { _timeline = timeline; }
@@ -51,19 +52,26 @@ public:
     virtual void setNode(cocos2d::Node* node) { _node = node; }
     virtual cocos2d::Node* getNode() const { return _node; }
 
-    virtual void setTween(bool tween) { _tween = tween; }
+    virtual void setTween(bool tween) { _tween = tween; setDirty(); }
     virtual bool isTween() const { return _tween; }
 
     virtual void onEnter(Frame *nextFrame) = 0;
     virtual void apply(float percent) {}
 
     virtual Frame* clone() = 0;
+
+    /** The key frames holding this frame, they are told when the frame changes. */
+    void setKeyFrames(TimelineKeyFrames* keyFrames) { _keyFrames = keyFrames; }
+    TimelineKeyFrames* getKeyFrames() const { return _keyFrames; }
 protected:
     Frame();
     virtual ~Frame();
 
     virtual void emitEvent();
     virtual void cloneProperty(Frame* frame);
+
+    /** Invalidates the values the key frames cached from this frame, called by the setters. */
+    void setDirty();
 protected:
 
     unsigned int    _frameIndex;
@@ -71,6 +79,7 @@ protected:
 
     Timeline* _timeline;
     cocos2d::Node*  _node;
+    TimelineKeyFrames* _keyFrames;
 };
 
 
@@ -123,7 +132,7 @@ public:
     virtual void apply(float percent) override;
     virtual Frame* clone() override;
 
-    inline void  setRotation(float rotation) { _rotation = rotation; }
+    inline void  setRotation(float rotation) { _rotation = rotation; setDirty(); }
     inline float getRotation() const { return _rotation; }
 
 protected:
@@ -142,10 +151,10 @@ public:
     virtual void apply(float percent) override;
     virtual Frame* clone() override;
 
-    inline void  setSkewX(float skewx) { _skewX = skewx; }
+    inline void  setSkewX(float skewx) { _skewX = skewx; setDirty(); }
     inline float getSkewX() const { return _skewX; }
 
-    inline void  setSkewY(float skewy) { _skewY = skewy; }
+    inline void  setSkewY(float skewy) { _skewY = skewy; setDirty(); }
     inline float getSkewY() const { return _skewY; }
 
 protected:
@@ -180,11 +189,11 @@ public:
     virtual void apply(float percent) override;
     virtual Frame* clone() override;
 
-    inline void setPosition(const cocos2d::Point& position) { _position = position; }
+    inline void setPosition(const cocos2d::Point& position) { _position = position; setDirty(); }
     inline cocos2d::Point getPosition() const { return _position; }
 
-    inline void setX(float x) { _position.x = x; }
-    inline void setY(float y) { _position.y = y; }
+    inline void setX(float x) { _position.x = x; setDirty(); }
+    inline void setY(float y) { _position.y = y; setDirty(); }
 
     inline float getX() const { return _position.x; }
     inline float getY() const { return _position.y; }
@@ -206,12 +215,12 @@ public:
     virtual void apply(float percent) override;
     virtual Frame* clone() override;
 
-    inline void  setScale(float scale) { _scaleX = scale; _scaleY = scale; }
+    inline void  setScale(float scale) { _scaleX = scale; _scaleY = scale; setDirty(); }
 
-    inline void  setScaleX(float scaleX) { _scaleX = scaleX; }
+    inline void  setScaleX(float scaleX) { _scaleX = scaleX; setDirty(); }
     inline float getScaleX() const { return _scaleX; }
 
-    inline void  setScaleY(float scaleY) { _scaleY = scaleY;}
+    inline void  setScaleY(float scaleY) { _scaleY = scaleY; setDirty(); }
     inline float getScaleY() const { return _scaleY; }
 
 protected:
@@ -279,10 +288,10 @@ public:
     virtual void apply(float percent) override;
     virtual Frame* clone() override;
 
-    inline void    setAlpha(GLubyte alpha) { _alpha = alpha; }
+    inline void    setAlpha(GLubyte alpha) { _alpha = alpha; setDirty(); }
     inline GLubyte getAlpha() const { return _alpha; }
 
-    inline void    setColor(const cocos2d::Color3B& color) { _color = color; }
+    inline void    setColor(const cocos2d::Color3B& color) { _color = color; setDirty(); }
     inline cocos2d::Color3B getColor() const { return _color; }
 
 protected:
@@ -25,10 +25,217 @@ THE SOFTWARE.
 #include "CCTimeLine.h"
 #include "CCActionTimeline.h"
 
+#include <algorithm>
+#include <typeinfo>
+
 USING_NS_CC;
 
 NS_TIMELINE_BEGIN
 
+// TimelineKeyFrames
+TimelineKeyFrames* TimelineKeyFrames::create()
+{
+    TimelineKeyFrames* object = new (std::nothrow) TimelineKeyFrames();
+    if (object)
+    {
+        object->autorelease();
+        return object;
+    }
+    CC_SAFE_DELETE(object);
+    return nullptr;
+}
+
+TimelineKeyFrames::TimelineKeyFrames()
+    : _dirty(true)
+    , _shareable(true)
+    , _type(Type::CUSTOM)
+    , _stride(0)
+{
+}
+
+TimelineKeyFrames::~TimelineKeyFrames()
+{
+    for (auto frame : _frames)
+    {
+        if (frame->getKeyFrames() == this)
+        {
+            frame->setKeyFrames(nullptr);
+        }
+    }
+}
+
+void TimelineKeyFrames::addFrame(Frame* frame)
+{
+    _frames.pushBack(frame);
+    frame->setKeyFrames(this);
+    _dirty = true;
+}
+
+void TimelineKeyFrames::insertFrame(Frame* frame, int index)
+{
+    _frames.insert(index, frame);
+    frame->setKeyFrames(this);
+    _dirty = true;
+}
+
+void TimelineKeyFrames::removeFrame(Frame* frame)
+{
+    if (frame->getKeyFrames() == this)
+    {
+        frame->setKeyFrames(nullptr);
+    }
+    _frames.eraseObject(frame);
+    _dirty = true;
+}
+
+TimelineKeyFrames* TimelineKeyFrames::clone() const
+{
+    TimelineKeyFrames* keyFrames = TimelineKeyFrames::create();
+    keyFrames->_frames.reserve(_frames.size());
+    for (auto frame : _frames)
+    {
+        keyFrames->addFrame(frame->clone());
+    }
+    return keyFrames;
+}
+
+void TimelineKeyFrames::updateValues() const
+{
+    _dirty = false;
+
+    // subclasses of the built-in frames may override apply(), so the exact types are compared
+    _type = Type::CUSTOM;
+    if (!_frames.empty())
+    {
+        const std::type_info& frameType = typeid(*_frames.at(0));
+        if (frameType == typeid(RotationFrame))
+            _type = Type::ROTATION;
+        else if (frameType == typeid(SkewFrame))
+            _type = Type::SKEW;
+        else if (frameType == typeid(RotationSkewFrame))
+            _type = Type::ROTATION_SKEW;
+        else if (frameType == typeid(PositionFrame))
+            _type = Type::POSITION;
+        else if (frameType == typeid(ScaleFrame))
+            _type = Type::SCALE;
+        else if (frameType == typeid(ColorFrame))
+            _type = Type::COLOR;
+
+        for (auto frame : _frames)
+        {
+            if (typeid(*frame) != frameType)
+            {
+                _type = Type::CUSTOM;
+                break;
+            }
+        }
+    }
+
+    // the other frames are applied by themselves, which is only safe to share
+    // for the built-in ones keeping no state between onEnter() and apply()
+    _shareable = true;
+    if (_type == Type::CUSTOM)
+    {
+        for (auto frame : _frames)
+        {
+            const std::type_info& frameType = typeid(*frame);
+            if (frameType != typeid(VisibleFrame) && frameType != typeid(TextureFrame)
+                && frameType != typeid(AnchorPointFrame) && frameType != typeid(InnerActionFrame)
+                && frameType != typeid(EventFrame) && frameType != typeid(ZOrderFrame))
+            {
+                _shareable = false;
+                break;
+            }
+        }
+    }
+
+    switch (_type)
+    {
+        case Type::ROTATION:
+            _stride = 1;
+            break;
+        case Type::COLOR:
+            _stride = 4;
+            break;
+        case Type::CUSTOM:
+            _stride = 0;
+            break;
+        default:
+            _stride = 2;
+            break;
+    }
+
+    ssize_t count = _frames.size();
+    _frameIndices.resize(count);
+    _tweens.resize(count);
+    _values.resize(count * _stride);
+
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        Frame* frame = _frames.at(i);
+        _frameIndices[i] = frame->getFrameIndex();
+        _tweens[i] = frame->isTween() ? 1 : 0;
+
+        float* values = &_values[i * _stride];
+        switch (_type)
+        {
+            case Type::ROTATION:
+                values[0] = static_cast<RotationFrame*>(frame)->getRotation();
+                break;
+            case Type::SKEW:
+            case Type::ROTATION_SKEW:
+                values[0] = static_cast<SkewFrame*>(frame)->getSkewX();
+                values[1] = static_cast<SkewFrame*>(frame)->getSkewY();
+                break;
+            case Type::POSITION:
+                values[0] = static_cast<PositionFrame*>(frame)->getX();
+                values[1] = static_cast<PositionFrame*>(frame)->getY();
+                break;
+            case Type::SCALE:
+                values[0] = static_cast<ScaleFrame*>(frame)->getScaleX();
+                values[1] = static_cast<ScaleFrame*>(frame)->getScaleY();
+                break;
+            case Type::COLOR:
+            {
+                ColorFrame* colorFrame = static_cast<ColorFrame*>(frame);
+                const Color3B& color = colorFrame->getColor();
+                values[0] = colorFrame->getAlpha();
+                values[1] = color.r;
+                values[2] = color.g;
+                values[3] = color.b;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+ssize_t TimelineKeyFrames::getMemorySize() const
+{
+    ensureValues();
+
+    size_t frameSize = sizeof(Frame);
+    switch (_type)
+    {
+        case Type::ROTATION:      frameSize = sizeof(RotationFrame); break;
+        case Type::SKEW:          frameSize = sizeof(SkewFrame); break;
+        case Type::ROTATION_SKEW: frameSize = sizeof(RotationSkewFrame); break;
+        case Type::POSITION:      frameSize = sizeof(PositionFrame); break;
+        case Type::SCALE:         frameSize = sizeof(ScaleFrame); break;
+        case Type::COLOR:         frameSize = sizeof(ColorFrame); break;
+        default: break;
+    }
+
+    return sizeof(*this)
+        + _frames.size() * (sizeof(Frame*) + frameSize)
+        + _frameIndices.capacity() * sizeof(int)
+        + _tweens.capacity() * sizeof(char)
+        + _values.capacity() * sizeof(float);
+}
+
+
+// Timeline
 Timeline* Timeline::create()
 {
     Timeline* object = new (std::nothrow) Timeline();
@@ -42,10 +249,11 @@ Timeline* Timeline::create()
 }
 
 Timeline::Timeline()
-    : _currentKeyFrame(nullptr)
+    : _keyFrames(new (std::nothrow) TimelineKeyFrames())
+    , _currentKeyFrame(-1)
+    , _nextKeyFrame(-1)
     , _currentKeyFrameIndex(0)
-    , _fromIndex(0)
-    , _toIndex(0)
+    , _cursor(0)
     , _betweenDuration(0)
     , _actionTag(0)
     , _ActionTimeline(nullptr)
@@ -55,23 +263,24 @@ Timeline::Timeline()
 
 Timeline::~Timeline()
 {
+    CC_SAFE_RELEASE(_keyFrames);
 }
 
 void Timeline::gotoFrame(int frameIndex)
 {
-    if(_frames.size() == 0)
+    if(_keyFrames->size() == 0)
         return;
 
-    binarySearchKeyFrame(frameIndex);
+    updateCurrentKeyFrame(frameIndex, true);
     apply(frameIndex);
 }
 
 void Timeline::stepToFrame(int frameIndex)
 {
-    if(_frames.size() == 0)
+    if(_keyFrames->size() == 0)
         return;
 
-    updateCurrentKeyFrame(frameIndex);
+    updateCurrentKeyFrame(frameIndex, false);
     apply(frameIndex);
 }
 
@@ -80,39 +289,56 @@ Timeline* Timeline::clone()
     Timeline* timeline = Timeline::create();
     timeline->_actionTag = _actionTag;
 
-    for (auto frame : _frames)
+    TimelineKeyFrames* keyFrames = _keyFrames;
+    if (!keyFrames->isShareable())
     {
-        Frame* newFrame = frame->clone();
-        timeline->addFrame(newFrame);
+        keyFrames = keyFrames->clone();
     }
+    keyFrames->retain();
+    timeline->_keyFrames->release();
+    timeline->_keyFrames = keyFrames;
 
     return timeline;
 }
 
+void Timeline::detachKeyFrames()
+{
+    if (_keyFrames->getReferenceCount() > 1)
+    {
+        TimelineKeyFrames* keyFrames = _keyFrames->clone();
+        keyFrames->retain();
+        _keyFrames->release();
+        _keyFrames = keyFrames;
+    }
+
+    _currentKeyFrame = _nextKeyFrame = -1;
+    _cursor = 0;
+}
+
 void Timeline::addFrame(Frame* frame)
 {
-    _frames.pushBack(frame);
+    detachKeyFrames();
+    _keyFrames->addFrame(frame);
     frame->setTimeline(this);
 }
 
 void Timeline::insertFrame(Frame* frame, int index)
 {
-    _frames.insert(index, frame);
+    detachKeyFrames();
+    _keyFrames->insertFrame(frame, index);
     frame->setTimeline(this);
 }
 
 void Timeline::removeFrame(Frame* frame)
 {
-    _frames.eraseObject(frame);
+    detachKeyFrames();
+    _keyFrames->removeFrame(frame);
     frame->setTimeline(nullptr);
 }
 
 void Timeline::setNode(Node* node)
 {
-    for (auto frame : _frames)
-    {
-        frame->setNode(node);
-    }
+    _node = node;
 }
 
 Node* Timeline::getNode() const
@@ -120,129 +346,183 @@ Node* Timeline::getNode() const
     return _node;
 }
 
-void Timeline::apply(int frameIndex)
+void Timeline::bindFrame(Frame* frame)
 {
-    if (_currentKeyFrame)
+    // shared frames are bound to the timeline which uses them
+    frame->setTimeline(this);
+    if (frame->getNode() != _node)
     {
-        float currentPercent = _betweenDuration == 0 ? 0 : (frameIndex - _currentKeyFrameIndex) / (float)_betweenDuration;
-        _currentKeyFrame->apply(currentPercent);
+        frame->setNode(_node);
     }
 }
 
-void Timeline::binarySearchKeyFrame(int frameIndex)
+void Timeline::apply(int frameIndex)
 {
-    Frame *from = nullptr;
-    Frame *to   = nullptr;
+    if (_currentKeyFrame < 0)
+        return;
 
-    long length = _frames.size();
-    bool needEnterFrame = false;
+    float currentPercent = _betweenDuration == 0 ? 0 : (frameIndex - _currentKeyFrameIndex) / (float)_betweenDuration;
 
-    do 
+    TimelineKeyFrames::Type type = _keyFrames->getType();
+    if (type == TimelineKeyFrames::Type::CUSTOM)
     {
-        if (frameIndex < _frames.at(0)->getFrameIndex())
-        {
-            if(_currentKeyFrameIndex >= _frames.at(0)->getFrameIndex())
-                needEnterFrame = true;
+        Frame* frame = _keyFrames->getFrames().at(_currentKeyFrame);
+        bindFrame(frame);
+        frame->apply(currentPercent);
+        return;
+    }
+
+    if (!_node || !_keyFrames->isTween(_currentKeyFrame))
+        return;
+
+    const float* from = _keyFrames->getValues(_currentKeyFrame);
+    const float* to   = _keyFrames->getValues(_nextKeyFrame);
+    int stride = _keyFrames->getStride();
+
+    float values[4];
+    bool changed = false;
+    for (int i = 0; i < stride; ++i)
+    {
+        float between = to[i] - from[i];
+        values[i] = from[i] + between * currentPercent;
+        changed = changed || between != 0;
+    }
+    if (!changed)
+        return;
 
-            from = to = _frames.at(0);
-            _currentKeyFrameIndex = 0;
-            _betweenDuration = _frames.at(0)->getFrameIndex();
+    switch (type)
+    {
+        case TimelineKeyFrames::Type::ROTATION:
+            _node->setRotation(values[0]);
             break;
-        }
-        else if(frameIndex >= _frames.at(length - 1)->getFrameIndex())
-        {
-            from = to = _frames.at(length - 1); 
-            _currentKeyFrameIndex = _frames.at(length - 1)->getFrameIndex();
-            _betweenDuration = 0;
+        case TimelineKeyFrames::Type::SKEW:
+            _node->setSkewX(values[0]);
+            _node->setSkewY(values[1]);
             break;
-        }
-
-        long target = -1;
-        long low=0,high=length-1,mid=0;
-        while(low<=high){ 
-            mid=(low+high)/2;
-            if(frameIndex >= _frames.at(mid)->getFrameIndex() && frameIndex < _frames.at(mid+1)->getFrameIndex()) 
-            {
-                target = mid;
-                break;
-            }
-            if(_frames.at(mid)->getFrameIndex()>frameIndex)
-                high=mid-1; 
-            else
-                low=mid+1;
-        }
+        case TimelineKeyFrames::Type::ROTATION_SKEW:
+            _node->setRotationSkewX(values[0]);
+            _node->setRotationSkewY(values[1]);
+            break;
+        case TimelineKeyFrames::Type::POSITION:
+            _node->setPosition(values[0], values[1]);
+            break;
+        case TimelineKeyFrames::Type::SCALE:
+            _node->setScaleX(values[0]);
+            _node->setScaleY(values[1]);
+            break;
+        case TimelineKeyFrames::Type::COLOR:
+            _node->setOpacity((GLubyte)values[0]);
+            _node->setColor(Color3B((GLubyte)values[1], (GLubyte)values[2], (GLubyte)values[3]));
+            break;
+        default:
+            break;
+    }
+}
 
-        from = _frames.at(target);
-        to   = _frames.at(target+1);
+void Timeline::enterKeyFrame(int from, int to)
+{
+    _currentKeyFrame = from;
+    _nextKeyFrame = to;
 
-        if(target == 0 && _currentKeyFrameIndex<from->getFrameIndex())
-            needEnterFrame = true;
+    TimelineKeyFrames::Type type = _keyFrames->getType();
+    if (type == TimelineKeyFrames::Type::CUSTOM)
+    {
+        const Vector<Frame*>& frames = _keyFrames->getFrames();
+        bindFrame(frames.at(from));
+        frames.at(from)->onEnter(frames.at(to));
+        return;
+    }
 
-        _currentKeyFrameIndex = from->getFrameIndex();
-        _betweenDuration = to->getFrameIndex() - from->getFrameIndex();
-    } while (0);
+    if (!_node)
+        return;
 
-    if(needEnterFrame || _currentKeyFrame != from)
+    const float* values = _keyFrames->getValues(from);
+    switch (type)
     {
-        _currentKeyFrame = from;
-        _currentKeyFrame->onEnter(to);
+        case TimelineKeyFrames::Type::ROTATION:
+            _node->setRotation(values[0]);
+            break;
+        case TimelineKeyFrames::Type::SKEW:
+            _node->setSkewX(values[0]);
+            _node->setSkewY(values[1]);
+            break;
+        case TimelineKeyFrames::Type::ROTATION_SKEW:
+            _node->setRotationSkewX(values[0]);
+            _node->setRotationSkewY(values[1]);
+            break;
+        case TimelineKeyFrames::Type::POSITION:
+            _node->setPosition(values[0], values[1]);
+            break;
+        case TimelineKeyFrames::Type::SCALE:
+            _node->setScaleX(values[0]);
+            _node->setScaleY(values[1]);
+            break;
+        case TimelineKeyFrames::Type::COLOR:
+            _node->setOpacity((GLubyte)values[0]);
+            _node->setColor(Color3B((GLubyte)values[1], (GLubyte)values[2], (GLubyte)values[3]));
+            break;
+        default:
+            break;
     }
 }
 
-void Timeline::updateCurrentKeyFrame(int frameIndex)
+void Timeline::moveCursor(int frameIndex)
 {
-    //! If play to current frame's front or back, then find current frame again
-    if (frameIndex < _currentKeyFrameIndex || frameIndex >= _currentKeyFrameIndex + _betweenDuration)
-    {
-        Frame *from = nullptr;
-        Frame *to = nullptr;
+    // frameIndex is between the first and the last key frames. While playing, the cursor
+    // moves by one key frame at most, seeking walks from the previous position.
+    int last = (int)_keyFrames->size() - 1;
+    _cursor = std::max(0, std::min(_cursor, last - 1));
+
+    while (frameIndex < _keyFrames->getFrameIndex(_cursor))
+        --_cursor;
+    while (frameIndex >= _keyFrames->getFrameIndex(_cursor + 1))
+        ++_cursor;
+}
 
-        do 
-        {
-            long length = _frames.size();
+void Timeline::updateCurrentKeyFrame(int frameIndex, bool seek)
+{
+    //! When stepping, the key frame only changes if play to current frame's front or back
+    if (!seek && frameIndex >= _currentKeyFrameIndex && frameIndex < _currentKeyFrameIndex + _betweenDuration)
+        return;
 
-            if (frameIndex < _frames.at(0)->getFrameIndex())
-            {
-                from = to = _frames.at(0);
-                _currentKeyFrameIndex = 0;
-                _betweenDuration = _frames.at(0)->getFrameIndex();
-                break;
-            }
-            else if(frameIndex >= _frames.at(length - 1)->getFrameIndex())
-            {
-                from = to = _frames.at(length - 1);
-                _currentKeyFrameIndex = _frames.at(length - 1)->getFrameIndex();
-                _betweenDuration = 0;
-                break;
-            }
+    int last = (int)_keyFrames->size() - 1;
+    int firstIndex = _keyFrames->getFrameIndex(0);
+    int lastIndex = _keyFrames->getFrameIndex(last);
+    int from = 0;
+    int to = 0;
+    bool needEnterFrame = !seek;
 
-            do
-            {
-                _fromIndex = _toIndex;
-                from = _frames.at(_fromIndex);
-                _currentKeyFrameIndex  = from->getFrameIndex();
-
-                _toIndex = _fromIndex + 1;
-                if (_toIndex >= length)
-                {
-                    _toIndex = 0;
-                }
-
-                to = _frames.at(_toIndex);
-
-                if (frameIndex == from->getFrameIndex())
-                {
-                    break;
-                }
-            }
-            while (frameIndex < from->getFrameIndex() || frameIndex >= to->getFrameIndex());
+    if (frameIndex < firstIndex)
+    {
+        if (_currentKeyFrameIndex >= firstIndex)
+            needEnterFrame = true;
+
+        _currentKeyFrameIndex = 0;
+        _betweenDuration = firstIndex;
+    }
+    else if (frameIndex >= lastIndex)
+    {
+        from = to = last;
+        _currentKeyFrameIndex = lastIndex;
+        _betweenDuration = 0;
+    }
+    else
+    {
+        moveCursor(frameIndex);
+        from = _cursor;
+        to = _cursor + 1;
 
-            _betweenDuration = to->getFrameIndex() - from->getFrameIndex();
+        int fromIndex = _keyFrames->getFrameIndex(from);
+        if (from == 0 && _currentKeyFrameIndex < fromIndex)
+            needEnterFrame = true;
 
-        } while (0);
+        _currentKeyFrameIndex = fromIndex;
+        _betweenDuration = _keyFrames->getFrameIndex(to) - fromIndex;
+    }
 
-        _currentKeyFrame = from;
-        _currentKeyFrame->onEnter(to);
+    if (needEnterFrame || _currentKeyFrame != from)
+    {
+        enterKeyFrame(from, to);
     }
 }
 
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #ifndef __CCTIMELINE_H__
 #define __CCTIMELINE_H__
 
+#include <vector>
 #include "CCFrame.h"
 #include "CCTimelineMacro.h"
 #include "cocostudio/CocosStudioExport.h"
@@ -33,6 +34,76 @@ NS_TIMELINE_BEGIN
 
 class ActionTimeline;
 
+/**
+ * The key frames of a timeline. They don't change once loaded, so every clone of an
+ * ActionTimeline shares them, each Timeline only keeping its node and play position.
+ * The values of the built-in tweened frames (position, scale, rotation, skew, color)
+ * are also stored in flat arrays, which are rebuilt after a frame is added, removed or changed.
+ */
+class CC_STUDIO_DLL TimelineKeyFrames : public cocos2d::Ref
+{
+public:
+    enum class Type
+    {
+        CUSTOM,     // applied through Frame::onEnter() and Frame::apply()
+        ROTATION,
+        SKEW,
+        ROTATION_SKEW,
+        POSITION,
+        SCALE,
+        COLOR
+    };
+
+    static TimelineKeyFrames* create();
+
+    TimelineKeyFrames();
+    virtual ~TimelineKeyFrames();
+
+    const cocos2d::Vector<Frame*>& getFrames() const { return _frames; }
+    ssize_t size() const { return _frames.size(); }
+
+    void addFrame(Frame* frame);
+    void insertFrame(Frame* frame, int index);
+    void removeFrame(Frame* frame);
+
+    /** Rebuilds the cached values before they are used next, the frames call it when they change. */
+    void setDirty() { _dirty = true; }
+
+    /** Copies the frames, for a timeline which is changed while other timelines use them. */
+    TimelineKeyFrames* clone() const;
+
+    /**
+     * Whether the frames can be used by several timelines at once, which is the case
+     * of the built-in frames, custom ones may keep state between onEnter() and apply().
+     */
+    bool isShareable() const { ensureValues(); return _shareable; }
+
+    /** Type of the frames, the values below are only available for the tweened types. */
+    Type getType() const { ensureValues(); return _type; }
+
+    int  getFrameIndex(ssize_t index) const { ensureValues(); return _frameIndices[index]; }
+    bool isTween(ssize_t index) const { ensureValues(); return _tweens[index] != 0; }
+    int  getStride() const { ensureValues(); return _stride; }
+    const float* getValues(ssize_t index) const { ensureValues(); return &_values[index * _stride]; }
+
+    /** Bytes used by the frames and their values. */
+    ssize_t getMemorySize() const;
+
+protected:
+    void ensureValues() const { if (_dirty) updateValues(); }
+    void updateValues() const;
+
+    cocos2d::Vector<Frame*> _frames;
+
+    mutable bool _dirty;
+    mutable bool _shareable;
+    mutable Type _type;
+    mutable int  _stride;
+    mutable std::vector<int>   _frameIndices;
+    mutable std::vector<char>  _tweens;
+    mutable std::vector<float> _values;
+};
+
 class CC_STUDIO_DLL Timeline : public cocos2d::Ref
 {
 public:
@@ -44,8 +115,9 @@ public:
     virtual void gotoFrame(int frameIndex);
     virtual void stepToFrame(int frameIndex);
 
-    virtual const cocos2d::Vector<Frame*>& getFrames() const { return _frames; }
+    virtual const cocos2d::Vector<Frame*>& getFrames() const { return _keyFrames->getFrames(); }
 
+    /** Changing the frames of a timeline which shares them with its clones copies them first. */
     virtual void addFrame(Frame* frame);
     virtual void insertFrame(Frame* frame, int index);
     virtual void removeFrame(Frame* frame);
@@ -59,20 +131,30 @@ public:
     virtual void setActionTimeline(ActionTimeline* action) { _ActionTimeline = action; }
     virtual ActionTimeline* getActionTimeline() const { return _ActionTimeline; }
 
+    /** The clone shares the key frames of this timeline, unless they are of a custom Frame type. */
     virtual Timeline* clone();
 
+    TimelineKeyFrames* getKeyFrames() const { return _keyFrames; }
+
+    /** Bytes used by this timeline only, the shared key frames aren't counted. */
+    virtual ssize_t getMemorySize() const { return sizeof(*this); }
+
 protected:
     virtual void apply(int frameIndex);
 
-    virtual void binarySearchKeyFrame (int frameIndex);
-    virtual void updateCurrentKeyFrame(int frameIndex);
+    /** Moves the cursor to the key frame which contains frameIndex, from its current position. */
+    virtual void moveCursor(int frameIndex);
+    virtual void updateCurrentKeyFrame(int frameIndex, bool seek);
+    virtual void enterKeyFrame(int from, int to);
+    virtual void bindFrame(Frame* frame);
+    void detachKeyFrames();
 
-    cocos2d::Vector<Frame*> _frames;
-    Frame* _currentKeyFrame;
+    TimelineKeyFrames* _keyFrames;
+    int _currentKeyFrame;
+    int _nextKeyFrame;
     int _currentKeyFrameIndex;
+    int _cursor;
 
-    int _fromIndex;
-    int _toIndex;
     int _betweenDuration;
     int _actionTag;
 
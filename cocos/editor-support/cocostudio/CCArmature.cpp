@@ -23,10 +23,14 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "cocostudio/CCArmature.h"
+
+#include <algorithm>
+
 #include "cocostudio/CCArmatureDataManager.h"
 #include "cocostudio/CCArmatureDefine.h"
 #include "cocostudio/CCDataReaderHelper.h"
 #include "cocostudio/CCDatas.h"
+#include "cocostudio/CCDisplayFactory.h"
 #include "cocostudio/CCSkin.h"
 
 #include "renderer/CCRenderer.h"
@@ -34,6 +38,9 @@ THE SOFTWARE.
 #include "renderer/CCGLProgramState.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "base/CCDirector.h"
+#include "base/CCCamera.h"
+#include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 
 #if ENABLE_PHYSICS_BOX2D_DETECT
 #include "Box2D/Box2D.h"
@@ -46,6 +53,69 @@ using namespace cocos2d;
 
 namespace cocostudio {
 
+static bool s_parallelUpdateEnabled = false;
+static bool s_updatingPosesInParallel = false;
+// armatures updated during the current frame, with their delta time
+static cocos2d::Vector<Armature*> s_queuedArmatures;
+static std::vector<float> s_queuedDeltas;
+static const char* PARALLEL_UPDATE_KEY = "cocostudio.Armature.parallelUpdate";
+
+static void updateQueuedArmatures(float /*dt*/)
+{
+    if (s_queuedArmatures.empty())
+    {
+        return;
+    }
+
+    // The queue stays untouched until the poses are done, callbacks may update other armatures.
+    cocos2d::Vector<Armature*> armatures(std::move(s_queuedArmatures));
+    std::vector<float> deltas;
+    deltas.swap(s_queuedDeltas);
+    s_queuedArmatures.clear();
+
+    s_updatingPosesInParallel = true;
+    ThreadPool::getInstance()->parallelFor(static_cast<int>(armatures.size()), [&armatures, &deltas](int index) {
+        armatures.at(index)->updatePose(deltas[index]);
+    });
+    s_updatingPosesInParallel = false;
+
+    for (const auto& armature : armatures)
+    {
+        armature->dispatchEvents();
+    }
+}
+
+void Armature::setParallelUpdateEnabled(bool enabled)
+{
+    if (s_parallelUpdateEnabled == enabled)
+    {
+        return;
+    }
+    s_parallelUpdateEnabled = enabled;
+
+    Scheduler* scheduler = Director::getInstance()->getScheduler();
+    if (enabled)
+    {
+        // Timers run after the update selectors, so every armature of the frame is queued by then.
+        scheduler->schedule(updateQueuedArmatures, &s_queuedArmatures, 0, false, PARALLEL_UPDATE_KEY);
+    }
+    else
+    {
+        scheduler->unschedule(PARALLEL_UPDATE_KEY, &s_queuedArmatures);
+        updateQueuedArmatures(0);
+    }
+}
+
+bool Armature::isParallelUpdateEnabled()
+{
+    return s_parallelUpdateEnabled;
+}
+
+bool Armature::isUpdatingPosesInParallel()
+{
+    return s_updatingPosesInParallel;
+}
+
 Armature *Armature::create()
 {
     Armature *armature = new (std::nothrow) Armature();
@@ -264,6 +334,17 @@ void Armature::removeBone(Bone *bone, bool recursion)
 {
     CCASSERT(bone != nullptr, "bone must be added to the bone dictionary!");
 
+    // the changes deferred by updatePose() must not outlive the bone
+    _pendingZOrders.erase(std::remove_if(_pendingZOrders.begin(), _pendingZOrders.end(), [bone](const std::pair<Bone*, int>& pending) {
+        return pending.first == bone;
+    }), _pendingZOrders.end());
+    _pendingDisplayChanges.erase(std::remove_if(_pendingDisplayChanges.begin(), _pendingDisplayChanges.end(), [bone](const PendingDisplayChange& pending) {
+        return pending.bone == bone;
+    }), _pendingDisplayChanges.end());
+    _pendingParticleUpdates.erase(std::remove_if(_pendingParticleUpdates.begin(), _pendingParticleUpdates.end(), [bone](const std::pair<Bone*, float>& pending) {
+        return pending.first == bone;
+    }), _pendingParticleUpdates.end());
+
     bone->setArmature(nullptr);
     bone->removeFromParent(recursion);
 
@@ -374,7 +455,20 @@ bool Armature::getArmatureTransformDirty() const
 
 void Armature::update(float dt)
 {
-    _animation->update(dt);
+    if (s_parallelUpdateEnabled)
+    {
+        s_queuedArmatures.pushBack(this);
+        s_queuedDeltas.push_back(dt);
+        return;
+    }
+
+    updatePose(dt);
+    dispatchEvents();
+}
+
+void Armature::updatePose(float dt)
+{
+    _animation->updatePose(dt);
 
     for(const auto &bone : _topBoneList) {
         bone->update(dt);
@@ -383,6 +477,73 @@ void Armature::update(float dt)
     _armatureTransformDirty = false;
 }
 
+static void dispatchChildArmatureEvents(Bone *bone)
+{
+    if (Armature *childArmature = bone->getChildArmature())
+    {
+        childArmature->dispatchEvents();
+    }
+
+    for (const auto &child : bone->getChildren())
+    {
+        dispatchChildArmatureEvents(static_cast<Bone*>(child));
+    }
+}
+
+void Armature::dispatchEvents()
+{
+    // Changing a display removes and adds nodes, resets particle systems and releases objects,
+    // which only the cocos thread may do.
+    for (const auto &pendingDisplayChange : _pendingDisplayChanges)
+    {
+        Bone *bone = pendingDisplayChange.bone;
+        bone->getDisplayManager()->changeDisplayWithIndex(pendingDisplayChange.index, pendingDisplayChange.force);
+        // updatePose() transformed the previous display
+        DisplayFactory::updateDisplay(bone, 0, true);
+    }
+    _pendingDisplayChanges.clear();
+
+    for (const auto &pendingParticleUpdate : _pendingParticleUpdates)
+    {
+        Bone *bone = pendingParticleUpdate.first;
+        Node *display = bone->getDisplayRenderNode();
+        if (display && bone->getDisplayRenderNodeType() == CS_DISPLAY_PARTICLE)
+        {
+            DisplayFactory::updateParticleDisplay(bone, display, pendingParticleUpdate.second);
+        }
+    }
+    _pendingParticleUpdates.clear();
+
+    for (const auto &pendingZOrder : _pendingZOrders)
+    {
+        pendingZOrder.first->setLocalZOrder(pendingZOrder.second);
+    }
+    _pendingZOrders.clear();
+
+    // the armature's own events first, then the child armatures' in the order their bones are updated
+    _animation->dispatchEvents();
+
+    for(const auto &bone : _topBoneList) {
+        dispatchChildArmatureEvents(bone);
+    }
+}
+
+void Armature::addPendingZOrder(Bone *bone, int zOrder)
+{
+    _pendingZOrders.push_back(std::make_pair(bone, zOrder));
+}
+
+void Armature::addPendingDisplayChange(Bone *bone, int index, bool force)
+{
+    PendingDisplayChange change = { bone, index, force };
+    _pendingDisplayChanges.push_back(change);
+}
+
+void Armature::addPendingParticleUpdate(Bone *bone, float dt)
+{
+    _pendingParticleUpdates.push_back(std::make_pair(bone, dt));
+}
+
 void Armature::draw(cocos2d::Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     if (_parentBone == nullptr && _batchNode == nullptr)
@@ -436,6 +597,8 @@ void Armature::draw(cocos2d::Renderer *renderer, const Mat4 &transform, uint32_t
             {
                 node->visit(renderer, transform, flags);
 //                CC_NODE_DRAW_SETUP();
+                // the display selected its own cameras
+                isVisitableByVisitingCamera();
             }
             break;
             }
@@ -444,6 +607,7 @@ void Armature::draw(cocos2d::Renderer *renderer, const Mat4 &transform, uint32_t
         {
             node->visit(renderer, transform, flags);
 //            CC_NODE_DRAW_SETUP();
+            isVisitableByVisitingCamera();
         }
     }
 }
@@ -471,6 +635,8 @@ void Armature::onExit()
 
 void Armature::visit(cocos2d::Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     // quick return if not visible. children won't be drawn.
     if (!_visible || !isVisitableByVisitingCamera())
     {
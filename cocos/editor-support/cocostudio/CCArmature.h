@@ -162,6 +162,33 @@ public:
     virtual void draw(cocos2d::Renderer *renderer, const cocos2d::Mat4 &transform, uint32_t flags) override;
     virtual void update(float dt) override;
 
+    /**
+     * Advances the animation and computes the bone transforms and skin quads, without delivering any event.
+     * Poses of different armatures can be computed on different threads at the same time.
+     * update() is updatePose() followed by dispatchEvents().
+     */
+    virtual void updatePose(float dt);
+
+    /**
+     * Delivers the frame and movement events queued by updatePose(), including the ones of the child armatures.
+     * Must be called on the cocos thread.
+     */
+    virtual void dispatchEvents();
+
+    /**
+     * When enabled, Armature::update() only queues the armature. Once every node of the scene has been updated,
+     * the poses of the queued armatures are computed on the ThreadPool, then their events are delivered
+     * on the cocos thread in the order the armatures were updated.
+     * Only the tweens and the bone transforms are computed on the workers. Display changes, particle displays
+     * and z order changes are applied on the cocos thread before the events are delivered.
+     * Frame and movement callbacks are thus called after every pose of the frame is computed. Default is false.
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+    static bool isParallelUpdateEnabled();
+
+    /** Whether poses are being computed on worker threads. Bones defer their z order changes meanwhile. */
+    static bool isUpdatingPosesInParallel();
+
     virtual void onEnter() override;
     virtual void onExit() override; 
 
@@ -251,6 +278,26 @@ protected:
      */
     Bone *createBone(const std::string& boneName );
 
+    /*
+     * Used by Bone to apply a z order change in dispatchEvents(), when the pose is computed on a worker thread.
+     * @js NA
+     * @lua NA
+     */
+    void addPendingZOrder(Bone *bone, int zOrder);
+
+    /*
+     * Used by DisplayManager and DisplayFactory to apply a display change or a particle display update
+     * in dispatchEvents(), when the pose is computed on a worker thread.
+     * @js NA
+     * @lua NA
+     */
+    void addPendingDisplayChange(Bone *bone, int index, bool force);
+    void addPendingParticleUpdate(Bone *bone, float dt);
+
+    friend class Bone;
+    friend class DisplayManager;
+    friend class DisplayFactory;
+
 protected:
     ArmatureData *_armatureData;
 
@@ -272,6 +319,17 @@ protected:
 
     ArmatureAnimation *_animation;
 
+    std::vector<std::pair<Bone*, int>> _pendingZOrders;
+
+    struct PendingDisplayChange
+    {
+        Bone *bone;
+        int index;
+        bool force;
+    };
+    std::vector<PendingDisplayChange> _pendingDisplayChanges;
+    std::vector<std::pair<Bone*, float>> _pendingParticleUpdates;
+
 #if ENABLE_PHYSICS_BOX2D_DETECT
     b2Body *_body;
 #elif ENABLE_PHYSICS_CHIPMUNK_DETECT
@@ -334,6 +334,12 @@ ssize_t ArmatureAnimation::getMovementCount() const
 }
 
 void ArmatureAnimation::update(float dt)
+{
+    updatePose(dt);
+    dispatchEvents();
+}
+
+void ArmatureAnimation::updatePose(float dt)
 {
     ProcessBase::update(dt);
     
@@ -341,7 +347,10 @@ void ArmatureAnimation::update(float dt)
     {
         tween->update(dt);
     }
+}
 
+void ArmatureAnimation::dispatchEvents()
+{
     if(_frameEventQueue.size() > 0 || _movementEventQueue.size() > 0)
     {
         _armature->retain();
@@ -175,6 +175,16 @@ public:
 
     void update(float dt);
 
+    /**
+     * Advances the movement and the tweens. The events are only queued, see dispatchEvents().
+     */
+    void updatePose(float dt);
+
+    /**
+     * Delivers the frame and movement events queued since the last call.
+     */
+    void dispatchEvents();
+
     /**
      * Get current movementID
      * @return The name of current movement
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCGLProgramState.h"
 #include "base/CCDirector.h"
+#include "base/CCCamera.h"
 
 using namespace cocos2d;
 
@@ -106,6 +107,8 @@ void BatchNode::removeChild(Node* child, bool cleanup)
 
 void BatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     // quick return if not visible. children won't be drawn.
     if (!_visible || !isVisitableByVisitingCamera())
     {
@@ -167,6 +170,7 @@ void BatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 void BatchNode::generateGroupCommand()
 {
     Renderer* renderer = Director::getInstance()->getRenderer();
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _groupCommand->init(_globalZOrder);
     renderer->addCommand(_groupCommand);
 
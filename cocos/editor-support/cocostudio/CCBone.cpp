@@ -377,7 +377,17 @@ Tween *Bone::getTween()
 void Bone::setLocalZOrder(int zOrder)
 {
     if (_localZOrder != zOrder)
-        Node::setLocalZOrder(zOrder);
+    {
+        // Node::setLocalZOrder marks the event dispatcher dirty, which isn't thread safe
+        if (_armature && Armature::isUpdatingPosesInParallel())
+        {
+            _armature->addPendingZOrder(this, zOrder);
+        }
+        else
+        {
+            Node::setLocalZOrder(zOrder);
+        }
+    }
 }
 
 Mat4 Bone::getNodeToArmatureTransform() const
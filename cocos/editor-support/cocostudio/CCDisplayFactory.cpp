@@ -243,7 +243,8 @@ void DisplayFactory::updateArmatureDisplay(Bone *bone, Node *display, float dt)
     if(armature)
     {
         armature->sortAllChildren();
-        armature->update(dt);
+        // the events of child armatures are delivered by the parent's dispatchEvents()
+        armature->updatePose(dt);
     }
 }
 
@@ -275,6 +276,13 @@ void DisplayFactory::createParticleDisplay(Bone *bone, DecorativeDisplay *decoDi
 }
 void DisplayFactory::updateParticleDisplay(Bone *bone, Node *display, float dt)
 {
+    // ParticleSystemQuad uploads its quads to GL, Armature::dispatchEvents() updates it on the cocos thread
+    if (Armature::isUpdatingPosesInParallel() && bone->getArmature())
+    {
+        bone->getArmature()->addPendingParticleUpdate(bone, dt);
+        return;
+    }
+
     ParticleSystem *system = (ParticleSystem *)display;
     BaseData node;
     TransformHelp::matrixToNode(bone->getNodeToArmatureTransform(), node);
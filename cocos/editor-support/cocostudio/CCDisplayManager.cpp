@@ -220,6 +220,13 @@ void DisplayManager::changeDisplayWithIndex(int index, bool force)
 {
     CCASSERT( index < (int)_decoDisplayList.size(), "the _index value is out of range");
 
+    // applied by Armature::dispatchEvents() on the cocos thread
+    if (Armature::isUpdatingPosesInParallel() && _bone->getArmature())
+    {
+        _bone->getArmature()->addPendingDisplayChange(_bone, index, force);
+        return;
+    }
+
     _forceChangeDisplay = force;
 
     //! If index is equal to current display index,then do nothing
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "cocostudio/CCActionManagerEx.h"
 #include <fstream>
 #include <iostream>
+#include <algorithm>
 #include "WidgetReader/ButtonReader/ButtonReader.h"
 #include "WidgetReader/CheckBoxReader/CheckBoxReader.h"
 #include "WidgetReader/SliderReader/SliderReader.h"
@@ -40,6 +41,9 @@ THE SOFTWARE.
 #include "WidgetReader/ScrollViewReader/ScrollViewReader.h"
 #include "WidgetReader/ListViewReader/ListViewReader.h"
 #include "cocostudio/CocoLoader.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 
 using namespace cocos2d;
 using namespace cocos2d::ui;
@@ -48,6 +52,37 @@ namespace cocostudio {
     
 static GUIReader* sharedReader = nullptr;
 
+// A layout file, read and parsed. The binary loader points into the file data,
+// so it is released first.
+struct GUIReader::LayoutTemplate
+{
+    LayoutTemplate()
+    : binary(false)
+    , data(nullptr)
+    {
+    }
+    ~LayoutTemplate()
+    {
+        loader.reset();
+        CC_SAFE_DELETE_ARRAY(data);
+    }
+    
+    bool binary;
+    rapidjson::Document document;
+    unsigned char* data;
+    std::unique_ptr<CocoLoader> loader;
+};
+    
+static bool isBinaryLayout(const std::string& fileName)
+{
+    size_t pos = fileName.find_last_of('.');
+    if (pos == std::string::npos)
+        return false;
+    std::string extension = fileName.substr(pos);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension == ".csb";
+}
+
 GUIReader::GUIReader():
 m_strFilePath("")
 {
@@ -100,6 +135,134 @@ void GUIReader::destroyInstance()
     CC_SAFE_DELETE(sharedReader);
 }
 
+std::shared_ptr<GUIReader::LayoutTemplate> GUIReader::parseLayout(const std::string& fullPath, bool binary)
+{
+    // only uses FileUtils, it may run on a worker thread
+    std::shared_ptr<LayoutTemplate> layout = std::make_shared<LayoutTemplate>();
+    layout->binary = binary;
+    if (binary)
+    {
+        ssize_t size = 0;
+        layout->data = FileUtils::getInstance()->getFileData(fullPath, "rb", &size);
+        if (layout->data == nullptr || size <= 0)
+            return nullptr;
+        
+        layout->loader.reset(new (std::nothrow) CocoLoader());
+        if (!layout->loader || !layout->loader->ReadCocoBinBuff((char*)layout->data))
+            return nullptr;
+    }
+    else
+    {
+        std::string contentStr = FileUtils::getInstance()->getStringFromFile(fullPath);
+        if (contentStr.empty())
+            return nullptr;
+        
+        layout->document.Parse<0>(contentStr.c_str());
+        if (layout->document.HasParseError())
+        {
+            CCLOG("GetParseError %s\n", layout->document.GetParseError());
+            return nullptr;
+        }
+    }
+    return layout;
+}
+
+std::shared_ptr<GUIReader::LayoutTemplate> GUIReader::getLayout(const std::string& fileName, bool binary)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(fileName);
+    auto iter = _layouts.find(fullPath);
+    if (iter != _layouts.end() && iter->second->binary == binary)
+        return iter->second;
+    
+    // only preloaded documents are kept, the others are released with their widgets
+    return parseLayout(fullPath, binary);
+}
+
+bool GUIReader::preloadLayout(const std::string& fileName)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(fileName);
+    bool binary = isBinaryLayout(fullPath);
+    auto iter = _layouts.find(fullPath);
+    if (iter != _layouts.end() && iter->second->binary == binary)
+        return true;
+    
+    std::shared_ptr<LayoutTemplate> layout = parseLayout(fullPath, binary);
+    if (!layout)
+        return false;
+    
+    _layouts[fullPath] = layout;
+    return true;
+}
+
+void GUIReader::preloadLayoutAsync(const std::string& fileName, const std::function<void(bool)>& callback)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(fileName);
+    if (_layouts.find(fullPath) != _layouts.end())
+    {
+        if (callback)
+            callback(true);
+        return;
+    }
+    
+    // the file may already be parsing for another caller
+    auto& callbacks = _pendingLayouts[fullPath];
+    bool parsing = !callbacks.empty();
+    callbacks.push_back(callback);
+    if (parsing)
+        return;
+    
+    bool binary = isBinaryLayout(fullPath);
+    ThreadPool::getInstance()->pushTask([fullPath, binary](){
+        std::shared_ptr<LayoutTemplate> layout = parseLayout(fullPath, binary);
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([fullPath, layout](){
+            if (sharedReader)
+            {
+                sharedReader->addPreloadedLayout(fullPath, layout);
+            }
+        });
+    });
+}
+
+void GUIReader::addPreloadedLayout(const std::string& fullPath, const std::shared_ptr<LayoutTemplate>& layout)
+{
+    auto iter = _pendingLayouts.find(fullPath);
+    if (iter == _pendingLayouts.end())
+        return;
+    
+    std::vector<std::function<void(bool)>> callbacks;
+    callbacks.swap(iter->second);
+    _pendingLayouts.erase(iter);
+    
+    // a synchronous preload may have been done meanwhile
+    bool loaded = _layouts.find(fullPath) != _layouts.end();
+    if (!loaded && layout)
+    {
+        _layouts[fullPath] = layout;
+        loaded = true;
+    }
+    
+    for (const auto& callback : callbacks)
+    {
+        if (callback)
+            callback(loaded);
+    }
+}
+
+bool GUIReader::isLayoutPreloaded(const std::string& fileName) const
+{
+    return _layouts.find(FileUtils::getInstance()->fullPathForFilename(fileName)) != _layouts.end();
+}
+
+void GUIReader::removeLayout(const std::string& fileName)
+{
+    _layouts.erase(FileUtils::getInstance()->fullPathForFilename(fileName));
+}
+
+void GUIReader::removeAllLayouts()
+{
+    _layouts.clear();
+}
+
 int GUIReader::getVersionInteger(const char *str)
 {
     std::string strVersion = str;
@@ -201,17 +364,16 @@ void GUIReader::registerTypeAndCallBack(const std::string& classType,
 Widget* GUIReader::widgetFromJsonFile(const char *fileName)
 {
 	std::string jsonpath;
-	rapidjson::Document jsonDict;
     jsonpath = fileName;
 //    jsonpath = CCFileUtils::getInstance()->fullPathForFilename(fileName);
     size_t pos = jsonpath.find_last_of('/');
 	m_strFilePath = jsonpath.substr(0,pos+1);
-    std::string contentStr = FileUtils::getInstance()->getStringFromFile(jsonpath);
-	jsonDict.Parse<0>(contentStr.c_str());
-    if (jsonDict.HasParseError())
+    std::shared_ptr<LayoutTemplate> layout = getLayout(jsonpath, false);
+    if (!layout)
     {
-        CCLOG("GetParseError %s\n",jsonDict.GetParseError());
+        return nullptr;
     }
+    const rapidjson::Document& jsonDict = layout->document;
     Widget* widget = nullptr;
     const char* fileVersion = DICTOOL->getStringValue_json(jsonDict, "version");
     WidgetPropertiesReader * pReader = nullptr;
@@ -360,68 +522,60 @@ WidgetReaderProtocol* WidgetPropertiesReader::createWidgetReaderProtocol(const s
 Widget* GUIReader::widgetFromBinaryFile(const char *fileName)
 {
     std::string jsonpath;
-    rapidjson::Document jsonDict;
     jsonpath = CCFileUtils::getInstance()->fullPathForFilename(fileName);
     size_t pos = jsonpath.find_last_of('/');
     m_strFilePath = jsonpath.substr(0,pos+1);
-    ssize_t nSize = 0;
-    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(fileName);
-    unsigned char* pBuffer = FileUtils::getInstance()->getFileData(fullPath, "rb", &nSize);
+    std::shared_ptr<LayoutTemplate> layout = getLayout(jsonpath, true);
     
     const char* fileVersion = "";
     ui::Widget* widget = nullptr;
 
-    if (pBuffer != nullptr && nSize > 0)
+    if (layout)
     {
-        CocoLoader	tCocoLoader;
-        if(true == tCocoLoader.ReadCocoBinBuff((char*)pBuffer))
+        CocoLoader* pCocoLoader = layout->loader.get();
+        stExpCocoNode*	tpRootCocoNode = pCocoLoader->GetRootCocoNode();
+        
+        rapidjson::Type tType = tpRootCocoNode->GetType(pCocoLoader);
+        if (rapidjson::kObjectType == tType || rapidjson::kArrayType == tType)
         {
-            stExpCocoNode*	tpRootCocoNode = tCocoLoader.GetRootCocoNode();
+            stExpCocoNode *tpChildArray = tpRootCocoNode->GetChildArray(pCocoLoader);
             
-            rapidjson::Type tType = tpRootCocoNode->GetType(&tCocoLoader);
-            if (rapidjson::kObjectType == tType || rapidjson::kArrayType == tType)
-            {
-                stExpCocoNode *tpChildArray = tpRootCocoNode->GetChildArray(&tCocoLoader);
-                
-                
-                for (int i = 0; i < tpRootCocoNode->GetChildNum(); ++i) {
-                    std::string key = tpChildArray[i].GetName(&tCocoLoader);
-                    if (key == "version") {
-                        fileVersion = tpChildArray[i].GetValue(&tCocoLoader);
-                        break;
-                    }
+            
+            for (int i = 0; i < tpRootCocoNode->GetChildNum(); ++i) {
+                std::string key = tpChildArray[i].GetName(pCocoLoader);
+                if (key == "version") {
+                    fileVersion = tpChildArray[i].GetValue(pCocoLoader);
+                    break;
                 }
-                
-                WidgetPropertiesReader * pReader = nullptr;
-                if (fileVersion)
+            }
+            
+            WidgetPropertiesReader * pReader = nullptr;
+            if (fileVersion)
+            {
+                int versionInteger = getVersionInteger(fileVersion);
+                if (versionInteger < 250)
                 {
-                    int versionInteger = getVersionInteger(fileVersion);
-                    if (versionInteger < 250)
-                    {
-                        CCASSERT(0, "You current studio doesn't support binary format, please upgrade to the latest version!");
-                        pReader = new (std::nothrow) WidgetPropertiesReader0250();
-                        widget = pReader->createWidgetFromBinary(&tCocoLoader, tpRootCocoNode, fileName);
-                    }
-                    else
-                    {
-                        pReader = new (std::nothrow) WidgetPropertiesReader0300();
-                        widget = pReader->createWidgetFromBinary(&tCocoLoader, tpRootCocoNode, fileName);
-                    }
+                    CCASSERT(0, "You current studio doesn't support binary format, please upgrade to the latest version!");
+                    pReader = new (std::nothrow) WidgetPropertiesReader0250();
+                    widget = pReader->createWidgetFromBinary(pCocoLoader, tpRootCocoNode, fileName);
                 }
                 else
                 {
-                    pReader = new (std::nothrow) WidgetPropertiesReader0250();
-                    widget = pReader->createWidgetFromBinary(&tCocoLoader, tpRootCocoNode, fileName);
+                    pReader = new (std::nothrow) WidgetPropertiesReader0300();
+                    widget = pReader->createWidgetFromBinary(pCocoLoader, tpRootCocoNode, fileName);
                 }
-                
-                CC_SAFE_DELETE(pReader);
-
             }
+            else
+            {
+                pReader = new (std::nothrow) WidgetPropertiesReader0250();
+                widget = pReader->createWidgetFromBinary(pCocoLoader, tpRootCocoNode, fileName);
+            }
+            
+            CC_SAFE_DELETE(pReader);
+
         }
     }
     
-    CC_SAFE_DELETE_ARRAY(pBuffer);
-    
     return widget;
    
 }
@@ -30,6 +30,9 @@ THE SOFTWARE.
 #include "WidgetReader/WidgetReaderProtocol.h"
 #include "base/ObjectFactory.h"
 #include "cocostudio/CocosStudioExport.h"
+#include <functional>
+#include <memory>
+#include <unordered_map>
 
 namespace cocostudio {
     
@@ -55,6 +58,24 @@ public:
     
     cocos2d::ui::Widget* widgetFromBinaryFile(const char* fileName);
     
+    /**
+     * Parses a layout file ahead of time and keeps the document, the widgets of the next
+     * widgetFromJsonFile() or widgetFromBinaryFile() calls are created from it.
+     * Only preloaded files are kept, until removeLayout() or removeAllLayouts() is called.
+     * Binary files are recognized by their .csb extension.
+     */
+    bool preloadLayout(const std::string& fileName);
+    /**
+     * Same as preloadLayout(), but the file is read and parsed on a worker thread,
+     * which is meant for loading screens. The callback is called on the cocos thread.
+     * @js NA
+     */
+    void preloadLayoutAsync(const std::string& fileName, const std::function<void(bool)>& callback);
+    bool isLayoutPreloaded(const std::string& fileName) const;
+    /** Releases the parsed documents. The widgets created from them are not affected. */
+    void removeLayout(const std::string& fileName);
+    void removeAllLayouts();
+    
     int getVersionInteger(const char* str);
     /**
      *  @js NA
@@ -81,7 +102,14 @@ protected:
     GUIReader();
     ~GUIReader();
     
+    struct LayoutTemplate;
+    static std::shared_ptr<LayoutTemplate> parseLayout(const std::string& fullPath, bool binary);
+    std::shared_ptr<LayoutTemplate> getLayout(const std::string& fileName, bool binary);
+    void addPreloadedLayout(const std::string& fullPath, const std::shared_ptr<LayoutTemplate>& layout);
+    
     std::string m_strFilePath;
+    std::unordered_map<std::string, std::shared_ptr<LayoutTemplate>> _layouts;
+    std::unordered_map<std::string, std::vector<std::function<void(bool)>>> _pendingLayouts;
     cocos2d::ValueMap _fileDesignSizes;
     
     typedef std::map<std::string, SEL_ParseEvent>  ParseCallBackMap;
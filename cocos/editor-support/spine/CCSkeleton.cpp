@@ -63,13 +63,16 @@ void Skeleton::initialize () {
 	debugSlots = false;
 	debugBones = false;
 	timeScale = 1;
+	_drawBuffersUsed = 0;
+	_drawBuffersFrame = 0;
 
     blendFunc.src = BlendFunc::ALPHA_PREMULTIPLIED.src;
     blendFunc.dst = BlendFunc::ALPHA_PREMULTIPLIED.dst;
     
 	setOpacityModifyRGB(true);
 
-    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR));
+    // the renderer transforms the vertices of TrianglesCommands on the CPU
+    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
 }
 
 void Skeleton::setSkeletonData (spSkeletonData *skeletonData, bool isOwnsSkeletonData) {
@@ -127,18 +130,6 @@ void Skeleton::update (float deltaTime) {
 
 void Skeleton::draw(cocos2d::Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
-
-    _customCommand.init(_globalZOrder);
-    _customCommand.func = CC_CALLBACK_0(Skeleton::onDraw, this, transform, flags);
-    renderer->addCommand(&_customCommand);
-}
-    
-void Skeleton::onDraw(const Mat4 &transform, uint32_t flags)
-{
-    getGLProgram()->use();
-    getGLProgram()->setUniformsForBuiltins(transform);
-
-    GL::blendFunc(blendFunc.src, blendFunc.dst);
 	Color3B color = getColor();
 	skeleton->r = color.r / (float)255;
 	skeleton->g = color.g / (float)255;
@@ -150,8 +141,23 @@ void Skeleton::onDraw(const Mat4 &transform, uint32_t flags)
 		skeleton->b *= skeleton->a;
 	}
 
-	int additive = 0;
-	TextureAtlas* textureAtlas = 0;
+	// the buffers of the previous frames have been rendered
+	unsigned int frame = Director::getInstance()->getTotalFrames();
+	if (frame != _drawBuffersFrame) {
+		_drawBuffersFrame = frame;
+		_drawBuffersUsed = 0;
+	}
+	if (_drawBuffersUsed == _drawBuffers.size()) {
+		_drawBuffers.push_back(std::unique_ptr<DrawBuffers>(new (std::nothrow) DrawBuffers()));
+	}
+	DrawBuffers& buffers = *_drawBuffers[_drawBuffersUsed++];
+	std::vector<V3F_C4B_T2F>& vertices = buffers.vertices;
+	std::vector<GLushort>& indices = buffers.indices;
+	std::vector<Batch>& batches = buffers.batches;
+	vertices.clear();
+	indices.clear();
+	batches.clear();
+
 	V3F_C4B_T2F_Quad quad;
 	quad.tl.vertices.z = 0;
 	quad.tr.vertices.z = 0;
@@ -161,37 +167,60 @@ void Skeleton::onDraw(const Mat4 &transform, uint32_t flags)
 		spSlot* slot = skeleton->drawOrder[i];
 		if (!slot->attachment || slot->attachment->type != ATTACHMENT_REGION) continue;
 		spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-		TextureAtlas* regionTextureAtlas = getTextureAtlas(attachment);
-
-		if (slot->data->additiveBlending != additive) {
-			if (textureAtlas) {
-				textureAtlas->drawQuads();
-				textureAtlas->removeAllQuads();
-			}
-			additive = !additive;
-            GL::blendFunc(blendFunc.src, additive ? GL_ONE : blendFunc.dst);
-		} else if (regionTextureAtlas != textureAtlas && textureAtlas) {
-			textureAtlas->drawQuads();
-			textureAtlas->removeAllQuads();
-		}
-		textureAtlas = regionTextureAtlas;
-        setFittedBlendingFunc(textureAtlas);
-
-		ssize_t quadCount = textureAtlas->getTotalQuads();
-		if (textureAtlas->getCapacity() == quadCount) {
-			textureAtlas->drawQuads();
-			textureAtlas->removeAllQuads();
-			if (!textureAtlas->resizeCapacity(textureAtlas->getCapacity() * 2)) return;
+		TextureAtlas* textureAtlas = getTextureAtlas(attachment);
+
+		BlendFunc slotBlendFunc = getFittedBlendingFunc(textureAtlas);
+		if (slot->data->additiveBlending) slotBlendFunc.dst = GL_ONE;
+
+		// Starts a new batch when the texture or the blending changes, or when the indices would overflow.
+		Batch* batch = batches.empty() ? nullptr : &batches.back();
+		if (!batch || batch->texture != textureAtlas->getTexture() || batch->blendFunc != slotBlendFunc
+			|| batch->vertexCount + 4 >= Renderer::VBO_SIZE) {
+			Batch newBatch = { textureAtlas->getTexture(), slotBlendFunc, vertices.size(), 0, indices.size(), 0 };
+			batches.push_back(newBatch);
+			batch = &batches.back();
 		}
 
 		spRegionAttachment_updateQuad(attachment, slot, &quad, premultipliedAlpha);
-		textureAtlas->updateQuad(&quad, quadCount);
+
+		// same layout and winding as the quads of the QuadCommand
+		const GLushort base = static_cast<GLushort>(batch->vertexCount);
+		vertices.push_back(quad.tl);
+		vertices.push_back(quad.bl);
+		vertices.push_back(quad.tr);
+		vertices.push_back(quad.br);
+		const GLushort quadIndices[6] = { base, (GLushort)(base + 1), (GLushort)(base + 2), (GLushort)(base + 3), (GLushort)(base + 2), (GLushort)(base + 1) };
+		indices.insert(indices.end(), quadIndices, quadIndices + 6);
+		batch->vertexCount += 4;
+		batch->indexCount += 6;
 	}
-	if (textureAtlas) {
-		textureAtlas->drawQuads();
-		textureAtlas->removeAllQuads();
+
+	// The vectors don't grow anymore, the commands can point into them.
+	if (buffers.trianglesCommands.size() < batches.size()) {
+		buffers.trianglesCommands.resize(batches.size());
+	}
+	for (size_t i = 0; i < batches.size(); ++i) {
+		const Batch& batch = batches[i];
+		TrianglesCommand::Triangles triangles;
+		triangles.verts = &vertices[batch.vertexStart];
+		triangles.vertCount = batch.vertexCount;
+		triangles.indices = &indices[batch.indexStart];
+		triangles.indexCount = batch.indexCount;
+
+		// Skeletons sharing an atlas page and a blend function end up in the same draw call.
+		buffers.trianglesCommands[i].init(_globalZOrder, batch.texture->getName(), getGLProgramState(), batch.blendFunc, triangles, transform);
+		renderer->addCommand(&buffers.trianglesCommands[i]);
 	}
 
+	if (debugBones || debugSlots) {
+		_customCommand.init(_globalZOrder);
+		_customCommand.func = CC_CALLBACK_0(Skeleton::onDraw, this, transform, flags);
+		renderer->addCommand(&_customCommand);
+	}
+}
+    
+void Skeleton::onDraw(const Mat4 &transform, uint32_t flags)
+{
     if(debugBones || debugSlots) {
         Director* director = Director::getInstance();
         CCASSERT(nullptr != director, "Director is null when seting matrix stack");
@@ -338,15 +367,21 @@ void Skeleton::setBlendFunc (const cocos2d::BlendFunc& aBlendFunc) {
     this->blendFunc = aBlendFunc;
 }
     
-void Skeleton::setFittedBlendingFunc(cocos2d::TextureAtlas * nextRenderedTexture)
+BlendFunc Skeleton::getFittedBlendingFunc(cocos2d::TextureAtlas * nextRenderedTexture) const
 {
+    // a blend function set with setBlendFunc() is used as is
+    if(blendFunc != BlendFunc::ALPHA_PREMULTIPLIED)
+    {
+        return blendFunc;
+    }
+
     if(nextRenderedTexture->getTexture() && nextRenderedTexture->getTexture()->hasPremultipliedAlpha())
     {
-        GL::blendFunc(BlendFunc::ALPHA_PREMULTIPLIED.src, BlendFunc::ALPHA_PREMULTIPLIED.dst);
+        return BlendFunc::ALPHA_PREMULTIPLIED;
     }
     else
     {
-        GL::blendFunc(BlendFunc::ALPHA_NON_PREMULTIPLIED.src, BlendFunc::ALPHA_NON_PREMULTIPLIED.dst);
+        return BlendFunc::ALPHA_NON_PREMULTIPLIED;
     }
 }
 
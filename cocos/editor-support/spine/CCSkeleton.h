@@ -35,11 +35,13 @@
 #define SPINE_CCSKELETON_H_
 
 #include <spine/spine.h>
+#include <memory>
 
 #include "2d/CCNode.h"
 #include "base/CCProtocols.h"
 #include "renderer/CCTextureAtlas.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 
 namespace spine {
 
@@ -68,6 +70,7 @@ public:
 
 	virtual void update (float deltaTime) override;
 	virtual void draw(cocos2d::Renderer *renderer, const cocos2d::Mat4 &transform, uint32_t flags) override;
+	/* Draws the debug slots and bones. The attachments themselves are submitted as TrianglesCommands by draw(). */
     void onDraw(const cocos2d::Mat4 &transform, uint32_t flags);
 	void onEnter() override;
 	void onExit() override;
@@ -108,9 +111,31 @@ private:
 	bool ownsSkeletonData;
 	spAtlas* atlas;
 	void initialize ();
-    // Util function that setting blend-function by nextRenderedTexture's premultiplied flag
-    void setFittedBlendingFunc(cocos2d::TextureAtlas * nextRenderedTexture);
-    
+    // Util function that returns blendFunc, or the default blend-function fitting nextRenderedTexture's premultiplied flag
+    cocos2d::BlendFunc getFittedBlendingFunc(cocos2d::TextureAtlas * nextRenderedTexture) const;
+
+    /* Consecutive attachments sharing a texture and a blend function, drawn by one TrianglesCommand. */
+    struct Batch {
+        cocos2d::Texture2D* texture;
+        cocos2d::BlendFunc blendFunc;
+        size_t vertexStart;
+        size_t vertexCount;
+        size_t indexStart;
+        size_t indexCount;
+    };
+
+    /* What one draw() submits. The queued commands point into it until the frame is rendered. */
+    struct DrawBuffers {
+        std::vector<cocos2d::V3F_C4B_T2F> vertices;
+        std::vector<GLushort> indices;
+        std::vector<Batch> batches;
+        std::vector<cocos2d::TrianglesCommand> trianglesCommands;
+    };
+
+    /* The skeleton may be drawn several times a frame (RenderTexture, cameras), each draw() uses its own buffers. */
+    std::vector<std::unique_ptr<DrawBuffers>> _drawBuffers;
+    size_t _drawBuffersUsed;
+    unsigned int _drawBuffersFrame;
     cocos2d::CustomCommand _customCommand;    
 };
 
@@ -34,6 +34,12 @@
 #include <spine/spine-cocos2dx.h>
 #include <spine/extension.h>
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 USING_NS_CC;
 
 void _spAtlasPage_createTexture (spAtlasPage* self, const char* path) {
@@ -73,9 +79,40 @@ char* _spUtil_readFile (const char* path, int* length)
 
 /**/
 
+/* Same as spRegionAttachment_computeWorldVertices, transforming the four corners at once where SIMD is available. */
+static void computeRegionWorldVertices (spRegionAttachment* self, float x, float y, spBone* bone, float* vertices) {
+	const float* offset = self->offset;
+	x += bone->worldX;
+	y += bone->worldY;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+	// offset is x1, y1, ..., x4, y4: vld2q splits it into the four x and the four y
+	float32x4x2_t corners = vld2q_f32(offset);
+	float32x4x2_t world;
+	world.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(x), corners.val[0], bone->m00), corners.val[1], bone->m01);
+	world.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(y), corners.val[0], bone->m10), corners.val[1], bone->m11);
+	vst2q_f32(vertices, world);
+#elif defined(__SSE__)
+	// two corners per register: (x1, y1, x2, y2) and (x3, y3, x4, y4)
+	const __m128 column0 = _mm_setr_ps(bone->m00, bone->m10, bone->m00, bone->m10);
+	const __m128 column1 = _mm_setr_ps(bone->m01, bone->m11, bone->m01, bone->m11);
+	const __m128 translation = _mm_setr_ps(x, y, x, y);
+	for (int i = 0; i < 8; i += 4) {
+		const __m128 corners = _mm_loadu_ps(offset + i);
+		const __m128 cornersX = _mm_shuffle_ps(corners, corners, _MM_SHUFFLE(2, 2, 0, 0));
+		const __m128 cornersY = _mm_shuffle_ps(corners, corners, _MM_SHUFFLE(3, 3, 1, 1));
+		_mm_storeu_ps(vertices + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(cornersX, column0), _mm_mul_ps(cornersY, column1)), translation));
+	}
+#else
+	for (int i = 0; i < 8; i += 2) {
+		vertices[i] = offset[i] * bone->m00 + offset[i + 1] * bone->m01 + x;
+		vertices[i + 1] = offset[i] * bone->m10 + offset[i + 1] * bone->m11 + y;
+	}
+#endif
+}
+
 void spRegionAttachment_updateQuad (spRegionAttachment* self, spSlot* slot, V3F_C4B_T2F_Quad* quad, bool premultipliedAlpha) {
 	float vertices[8];
-	spRegionAttachment_computeWorldVertices(self, slot->skeleton->x, slot->skeleton->y, slot->bone, vertices);
+	computeRegionWorldVertices(self, slot->skeleton->x, slot->skeleton->y, slot->bone, vertices);
 
 	GLubyte r = slot->skeleton->r * slot->r * 255;
 	GLubyte g = slot->skeleton->g * slot->g * 255;
@@ -25,6 +25,7 @@ THE SOFTWARE.
 
 #include "CCFileUtils.h"
 
+#include <algorithm>
 #include <stack>
 
 #include "base/CCData.h"
@@ -32,6 +33,8 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "platform/CCSAXParser.h"
 #include "base/ccUtils.h"
+#include "base/ZipUtils.h"
+#include "base/CCValueBinary.h"
 
 #include "tinyxml2.h"
 #include "unzip.h"
@@ -129,6 +132,18 @@ public:
 		return _rootArray;
     }
 
+    ValueVector arrayWithDataOfFile(const char* filedata, int filesize)
+    {
+        _resultType = SAX_RESULT_ARRAY;
+        SAXParser parser;
+
+        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
+        parser.setDelegator(this);
+
+        parser.parse(filedata, filesize);
+        return _rootArray;
+    }
+
     void startElement(void *ctx, const char *name, const char **atts)
     {
         CC_UNUSED_PARAM(ctx);
@@ -329,12 +344,22 @@ public:
 ValueMap FileUtils::getValueMapFromFile(const std::string& filename)
 {
     const std::string fullPath = fullPathForFilename(filename.c_str());
-    DictMaker tMaker;
-    return tMaker.dictionaryWithContentsOfFile(fullPath.c_str());
+    Data data = getDataFromFile(fullPath);
+    if (data.isNull())
+    {
+        return ValueMap();
+    }
+    return getValueMapFromData((const char*)data.getBytes(), static_cast<int>(data.getSize()));
 }
 
 ValueMap FileUtils::getValueMapFromData(const char* filedata, int filesize)
 {
+    if (ValueBinary::isValueBinary((const unsigned char*)filedata, filesize))
+    {
+        Value root = ValueBinary::decode((const unsigned char*)filedata, filesize);
+        return root.getType() == Value::Type::MAP ? std::move(root.asValueMap()) : ValueMap();
+    }
+
     DictMaker tMaker;
     return tMaker.dictionaryWithDataOfFile(filedata, filesize);
 }
@@ -342,8 +367,20 @@ ValueMap FileUtils::getValueMapFromData(const char* filedata, int filesize)
 ValueVector FileUtils::getValueVectorFromFile(const std::string& filename)
 {
     const std::string fullPath = fullPathForFilename(filename.c_str());
+    Data data = getDataFromFile(fullPath);
+    if (data.isNull())
+    {
+        return ValueVector();
+    }
+
+    if (ValueBinary::isValueBinary(data.getBytes(), data.getSize()))
+    {
+        Value root = ValueBinary::decode(data.getBytes(), data.getSize());
+        return root.getType() == Value::Type::VECTOR ? std::move(root.asValueVector()) : ValueVector();
+    }
+
     DictMaker tMaker;
-    return tMaker.arrayWithContentsOfFile(fullPath.c_str());
+    return tMaker.arrayWithDataOfFile((const char*)data.getBytes(), static_cast<int>(data.getSize()));
 }
 
 
@@ -506,6 +543,7 @@ void FileUtils::destroyInstance()
 }
 
 FileUtils::FileUtils()
+: _directoryIndexEnabled(false)
 {
 }
 
@@ -523,7 +561,169 @@ bool FileUtils::init()
 
 void FileUtils::purgeCachedEntries()
 {
-    _fullPathCache.clear();
+    clearPathCaches(true);
+}
+
+void FileUtils::clearPathCaches(bool dropDirectoryIndexes)
+{
+    {
+        std::lock_guard<std::mutex> lock(_pathCacheMutex);
+        _fullPathCache.clear();
+        _missingPathCache.clear();
+    }
+
+    if (dropDirectoryIndexes)
+    {
+        std::lock_guard<std::mutex> lock(_directoryIndexesMutex);
+        std::atomic_store(&_directoryIndexes, std::shared_ptr<const DirectoryIndexMap>());
+    }
+}
+
+std::unordered_map<std::string, std::string> FileUtils::getFullPathCache() const
+{
+    std::lock_guard<std::mutex> lock(_pathCacheMutex);
+    return _fullPathCache;
+}
+
+void FileUtils::setDirectoryIndexEnabled(bool enabled)
+{
+    if (_directoryIndexEnabled != enabled)
+    {
+        _directoryIndexEnabled = enabled;
+        clearPathCaches(true);
+    }
+}
+
+std::shared_ptr<const FileUtils::DirectoryIndex> FileUtils::getDirectoryIndex(const std::string& searchPath)
+{
+    auto indexes = std::atomic_load(&_directoryIndexes);
+    if (indexes)
+    {
+        auto iter = indexes->find(searchPath);
+        if (iter != indexes->end())
+        {
+            return iter->second;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_directoryIndexesMutex);
+
+    // Another thread may have listed it while this one was waiting.
+    indexes = std::atomic_load(&_directoryIndexes);
+    if (indexes)
+    {
+        auto iter = indexes->find(searchPath);
+        if (iter != indexes->end())
+        {
+            return iter->second;
+        }
+    }
+
+    std::shared_ptr<const DirectoryIndex> index;
+    std::vector<std::string> files;
+    if (listFilesRecursivelyInternal(searchPath, &files))
+    {
+        index = std::make_shared<DirectoryIndex>(files.begin(), files.end());
+    }
+
+    auto newIndexes = indexes ? std::make_shared<DirectoryIndexMap>(*indexes) : std::make_shared<DirectoryIndexMap>();
+    (*newIndexes)[searchPath] = index;
+    std::atomic_store(&_directoryIndexes, std::shared_ptr<const DirectoryIndexMap>(newIndexes));
+    return index;
+}
+
+bool FileUtils::listFilesRecursivelyInternal(const std::string& dirPath, std::vector<std::string>* files) const
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    CC_UNUSED_PARAM(dirPath);
+    CC_UNUSED_PARAM(files);
+    return false;
+#else
+    if (dirPath.empty() || dirPath[dirPath.length()-1] != '/')
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (stat(dirPath.c_str(), &st) != 0)
+    {
+        return false;
+    }
+    DIR* dir = opendir(dirPath.c_str());
+    if (!dir)
+    {
+        return false;
+    }
+
+    // Directories still to list, relative to dirPath, with the ids of the directories above them
+    typedef std::pair<dev_t, ino_t> DirectoryId;
+    struct PendingDirectory
+    {
+        std::string relativeDir;
+        std::vector<DirectoryId> parents;
+    };
+    std::stack<PendingDirectory> subdirs;
+    std::string relativeDir;
+    std::vector<DirectoryId> parents(1, DirectoryId(st.st_dev, st.st_ino));
+    while (true)
+    {
+        while (dirent* entry = readdir(dir))
+        {
+            if (entry->d_name[0] == '.' && (entry->d_name[1] == '\0' || (entry->d_name[1] == '.' && entry->d_name[2] == '\0')))
+            {
+                continue;
+            }
+
+            std::string relativePath = relativeDir + entry->d_name;
+            bool isDirectory = (entry->d_type == DT_DIR);
+            if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK)
+            {
+                isDirectory = (stat((dirPath + relativePath).c_str(), &st) == 0 && S_ISDIR(st.st_mode));
+            }
+
+            if (isDirectory)
+            {
+                PendingDirectory pending;
+                pending.relativeDir = relativePath + "/";
+                pending.parents = parents;
+                subdirs.push(std::move(pending));
+            }
+            else
+            {
+                files->push_back(relativePath);
+            }
+        }
+        closedir(dir);
+
+        // Skips the sub directories that can't be opened, their files won't be found through the index either.
+        dir = nullptr;
+        while (!dir && !subdirs.empty())
+        {
+            relativeDir.swap(subdirs.top().relativeDir);
+            parents.swap(subdirs.top().parents);
+            subdirs.pop();
+
+            // A symbolic link to one of its parent directories would be listed endlessly.
+            std::string path = dirPath + relativeDir;
+            if (stat(path.c_str(), &st) != 0)
+            {
+                continue;
+            }
+            DirectoryId id(st.st_dev, st.st_ino);
+            if (std::find(parents.begin(), parents.end(), id) != parents.end())
+            {
+                continue;
+            }
+            parents.push_back(id);
+            dir = opendir(path.c_str());
+        }
+        if (!dir)
+        {
+            break;
+        }
+    }
+    return true;
+#endif
 }
 
 static Data getData(const std::string& filename, bool forString)
@@ -547,6 +747,10 @@ static Data getData(const std::string& filename, bool forString)
     {
         // Read the file from hardware
         std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+        if (FileUtils::getInstance()->getDataFromArchive(fullPath, forString, &ret))
+        {
+            return ret;
+        }
         FILE *fp = fopen(fullPath.c_str(), mode);
         CC_BREAK_IF(!fp);
         fseek(fp,0,SEEK_END);
@@ -610,6 +814,11 @@ unsigned char* FileUtils::getFileData(const std::string& filename, const char* m
     {
         // read the file from hardware
         const std::string fullPath = fullPathForFilename(filename);
+        if (getFileDataFromArchive(fullPath, &buffer, size))
+        {
+            break;
+        }
+
         FILE *fp = fopen(fullPath.c_str(), mode);
         CC_BREAK_IF(!fp);
         
@@ -634,41 +843,160 @@ unsigned char* FileUtils::getFileData(const std::string& filename, const char* m
 unsigned char* FileUtils::getFileDataFromZip(const std::string& zipFilePath, const std::string& filename, ssize_t *size)
 {
     unsigned char * buffer = nullptr;
-    unzFile file = nullptr;
     *size = 0;
 
     do 
     {
         CC_BREAK_IF(zipFilePath.empty());
 
-        file = unzOpen(zipFilePath.c_str());
-        CC_BREAK_IF(!file);
+        // The directory of the zip file is only read the first time, afterwards the entry is found in its index.
+        std::shared_ptr<ZipFile> archive = getArchive(zipFilePath);
+        CC_BREAK_IF(!archive);
 
-        int ret = unzLocateFile(file, filename.c_str(), 1);
-        CC_BREAK_IF(UNZ_OK != ret);
+        buffer = archive->getFileData(filename, size);
+    } while (0);
 
-        char filePathA[260];
-        unz_file_info fileInfo;
-        ret = unzGetCurrentFileInfo(file, &fileInfo, filePathA, sizeof(filePathA), nullptr, 0, nullptr, 0);
-        CC_BREAK_IF(UNZ_OK != ret);
+    return buffer;
+}
 
-        ret = unzOpenCurrentFile(file);
-        CC_BREAK_IF(UNZ_OK != ret);
+std::shared_ptr<ZipFile> FileUtils::getArchive(const std::string& zipFilePath) const
+{
+    bool reopened = false;
+    std::shared_ptr<ZipFile> archive;
+    {
+        std::lock_guard<std::mutex> lock(_archivesMutex);
 
-        buffer = (unsigned char*)malloc(fileInfo.uncompressed_size);
-        int CC_UNUSED readedSize = unzReadCurrentFile(file, buffer, static_cast<unsigned>(fileInfo.uncompressed_size));
-        CCASSERT(readedSize == 0 || readedSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
+        auto iter = _archives.find(zipFilePath);
+        if (iter != _archives.end())
+        {
+            if (!iter->second->isModified())
+            {
+                return iter->second;
+            }
 
-        *size = fileInfo.uncompressed_size;
-        unzCloseCurrentFile(file);
-    } while (0);
+            // Replaced or rewritten, its index and its mapping are stale.
+            CCLOG("cocos2d: %s was modified, opening it again", zipFilePath.c_str());
+            _archives.erase(iter);
+            reopened = true;
+        }
+
+        archive.reset(new (std::nothrow) ZipFile(zipFilePath));
+        if (archive && !archive->isOpen())
+        {
+            // Not cached, the zip file may be downloaded later on.
+            archive.reset();
+        }
+        if (archive)
+        {
+            _archives.insert(std::make_pair(zipFilePath, archive));
+        }
+    }
 
-    if (file)
+    if (reopened)
     {
-        unzClose(file);
+        // The entries of an archive search path may have changed.
+        const_cast<FileUtils*>(this)->clearPathCaches(false);
     }
+    return archive;
+}
 
-    return buffer;
+std::shared_ptr<ZipFile> FileUtils::getArchiveForFullPath(const std::string& fullPath, std::string* entryName) const
+{
+    std::string archivePath;
+    {
+        std::lock_guard<std::mutex> lock(_archivesMutex);
+        for (const auto& searchArchive : _searchArchives)
+        {
+            const std::string& searchPath = searchArchive.first;
+            if (fullPath.size() > searchPath.size() && fullPath.compare(0, searchPath.size(), searchPath) == 0)
+            {
+                if (entryName)
+                {
+                    *entryName = fullPath.substr(searchPath.size());
+                }
+                archivePath = searchArchive.second;
+                break;
+            }
+        }
+    }
+
+    if (archivePath.empty())
+    {
+        return nullptr;
+    }
+    return getArchive(archivePath);
+}
+
+bool FileUtils::getFileDataFromArchive(const std::string& fullPath, unsigned char** buffer, ssize_t* size)
+{
+    {
+        std::lock_guard<std::mutex> lock(_archivesMutex);
+        if (_searchArchives.empty())
+        {
+            return false;
+        }
+    }
+
+    std::string entryName;
+    std::shared_ptr<ZipFile> archive = getArchiveForFullPath(fullPath, &entryName);
+    if (!archive)
+    {
+        // Inside an archive search path, but the archive is gone.
+        return !entryName.empty();
+    }
+
+    *buffer = archive->getFileData(entryName, size);
+    return true;
+}
+
+bool FileUtils::getDataFromArchive(const std::string& fullPath, bool forString, Data* data)
+{
+    ssize_t size = 0;
+    unsigned char* buffer = nullptr;
+    if (!getFileDataFromArchive(fullPath, &buffer, &size))
+    {
+        return false;
+    }
+
+    if (buffer && forString)
+    {
+        buffer = (unsigned char*)realloc(buffer, size + 1);
+        buffer[size] = '\0';
+    }
+
+    if (buffer)
+    {
+        data->fastSet(buffer, size);
+    }
+    else
+    {
+        CCLOG("Get data from archive(%s) failed!", fullPath.c_str());
+    }
+    return true;
+}
+
+bool FileUtils::addSearchArchive(const std::string& archivePath, const bool front)
+{
+    const std::string fullPath = fullPathForFilename(archivePath);
+    if (!getArchive(fullPath))
+    {
+        CCLOG("cocos2d: addSearchArchive: Can't open %s", archivePath.c_str());
+        return false;
+    }
+
+    // Added as an absolute search path so that setSearchPaths(getSearchPaths()) keeps it an archive.
+    const std::string searchPath = fullPath + "/";
+    {
+        std::lock_guard<std::mutex> lock(_archivesMutex);
+        _searchArchives[searchPath] = fullPath;
+    }
+    clearPathCaches(false);
+    if (front) {
+        _searchPathArray.insert(_searchPathArray.begin(), searchPath);
+    } else {
+        _searchPathArray.push_back(searchPath);
+    }
+    return true;
 }
 
 std::string FileUtils::getNewFilename(const std::string &filename) const
@@ -711,6 +1039,43 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
     return path;
 }
 
+static std::string getRelativePathForFilename(const std::string& filename, const std::string& resolutionDirectory)
+{
+    // file_path + resolutionDirectory + file, the same layout as getPathForFilename() but relative to the search path
+    std::string relativePath;
+    size_t pos = filename.find_last_of("/");
+    if (pos != std::string::npos)
+    {
+        relativePath = filename.substr(0, pos+1);
+        relativePath += resolutionDirectory;
+        relativePath += filename.substr(pos+1);
+    }
+    else
+    {
+        relativePath = resolutionDirectory + filename;
+    }
+    return relativePath;
+}
+
+static std::string getPathForArchivedFilename(ZipFile* archive, const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath)
+{
+    const std::string entryName = getRelativePathForFilename(filename, resolutionDirectory);
+    if (!archive->fileExists(entryName))
+    {
+        return "";
+    }
+    return searchPath + entryName;
+}
+
+static std::string getPathForIndexedFilename(const std::unordered_set<std::string>& index, const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath)
+{
+    const std::string relativePath = getRelativePathForFilename(filename, resolutionDirectory);
+    if (index.find(relativePath) == index.end())
+    {
+        return "";
+    }
+    return searchPath + relativePath;
+}
 
 std::string FileUtils::fullPathForFilename(const std::string &filename)
 {
@@ -725,10 +1090,19 @@ std::string FileUtils::fullPathForFilename(const std::string &filename)
     }
 
     // Already Cached ?
-    auto cacheIter = _fullPathCache.find(filename);
-    if( cacheIter != _fullPathCache.end() )
     {
-        return cacheIter->second;
+        std::lock_guard<std::mutex> lock(_pathCacheMutex);
+        auto cacheIter = _fullPathCache.find(filename);
+        if( cacheIter != _fullPathCache.end() )
+        {
+            return cacheIter->second;
+        }
+
+        // Already searched and not found ?
+        if (_missingPathCache.find(filename) != _missingPathCache.end())
+        {
+            return filename;
+        }
     }
     
     // Get the new file name.
@@ -738,19 +1112,68 @@ std::string FileUtils::fullPathForFilename(const std::string &filename)
     
     for (auto searchIt = _searchPathArray.cbegin(); searchIt != _searchPathArray.cend(); ++searchIt)
     {
+        // Files in archives are looked up in the zip index instead of the file system.
+        std::shared_ptr<ZipFile> archive;
+        std::string archivePath;
+        {
+            std::lock_guard<std::mutex> lock(_archivesMutex);
+            if (!_searchArchives.empty())
+            {
+                auto archiveIter = _searchArchives.find(*searchIt);
+                if (archiveIter != _searchArchives.end())
+                {
+                    archivePath = archiveIter->second;
+                }
+            }
+        }
+        if (!archivePath.empty())
+        {
+            archive = getArchive(archivePath);
+            if (!archive)
+            {
+                continue;
+            }
+        }
+
+        // Directories are looked up in their listing when the directory index is enabled and they can be listed.
+        std::shared_ptr<const DirectoryIndex> index;
+        if (!archive && _directoryIndexEnabled)
+        {
+            index = getDirectoryIndex(*searchIt);
+        }
+
         for (auto resolutionIt = _searchResolutionsOrderArray.cbegin(); resolutionIt != _searchResolutionsOrderArray.cend(); ++resolutionIt)
         {
-            fullpath = this->getPathForFilename(newFilename, *resolutionIt, *searchIt);
+            if (archive)
+            {
+                fullpath = getPathForArchivedFilename(archive.get(), newFilename, *resolutionIt, *searchIt);
+            }
+            else if (index)
+            {
+                fullpath = getPathForIndexedFilename(*index, newFilename, *resolutionIt, *searchIt);
+            }
+            else
+            {
+                fullpath = this->getPathForFilename(newFilename, *resolutionIt, *searchIt);
+            }
             
             if (fullpath.length() > 0)
             {
                 // Using the filename passed in as key.
+                std::lock_guard<std::mutex> lock(_pathCacheMutex);
                 _fullPathCache.insert(std::make_pair(filename, fullpath));
                 return fullpath;
             }
         }
     }
-    
+
+    // Misses are only remembered along with the directory index, which has to be purged after runtime changes anyway.
+    if (_directoryIndexEnabled)
+    {
+        std::lock_guard<std::mutex> lock(_pathCacheMutex);
+        _missingPathCache.insert(filename);
+    }
+
     if(isPopupNotify()){
         CCLOG("cocos2d: fullPathForFilename: No file found at %s. Possible missing file.", filename.c_str());
     }
@@ -768,7 +1191,7 @@ std::string FileUtils::fullPathFromRelativeFile(const std::string &filename, con
 void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& searchResolutionsOrder)
 {
     bool existDefault = false;
-    _fullPathCache.clear();
+    clearPathCaches(false);
     _searchResolutionsOrderArray.clear();
     for(auto iter = searchResolutionsOrder.cbegin(); iter != searchResolutionsOrder.cend(); ++iter)
     {
@@ -796,6 +1219,7 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
     std::string resOrder = order;
     if (!resOrder.empty() && resOrder[resOrder.length()-1] != '/')
         resOrder.append("/");
+    clearPathCaches(false);
     if (front) {
         _searchResolutionsOrderArray.insert(_searchResolutionsOrderArray.begin(), resOrder);
     } else {
@@ -817,7 +1241,7 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
 {
     bool existDefaultRootPath = false;
     
-    _fullPathCache.clear();
+    clearPathCaches(true);
     _searchPathArray.clear();
     for (auto iter = searchPaths.cbegin(); iter != searchPaths.cend(); ++iter)
     {
@@ -858,6 +1282,7 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
     {
         path += "/";
     }
+    clearPathCaches(false);
     if (front) {
         _searchPathArray.insert(_searchPathArray.begin(), path);
     } else {
@@ -867,7 +1292,7 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
 
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
 {
-    _fullPathCache.clear();    
+    clearPathCaches(false);
     _filenameLookupDict = filenameLookupDict;
 }
 
@@ -928,6 +1353,12 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
+        std::string entryName;
+        std::shared_ptr<ZipFile> archive = getArchiveForFullPath(filename, &entryName);
+        if (archive)
+        {
+            return archive->fileExists(entryName);
+        }
         return isFileExistInternal(filename);
     }
     else
@@ -985,10 +1416,18 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath)
     }
     
     // Already Cached ?
-    auto cacheIter = _fullPathCache.find(dirPath);
-    if( cacheIter != _fullPathCache.end() )
+    std::string cachedPath;
+    {
+        std::lock_guard<std::mutex> lock(_pathCacheMutex);
+        auto cacheIter = _fullPathCache.find(dirPath);
+        if( cacheIter != _fullPathCache.end() )
+        {
+            cachedPath = cacheIter->second;
+        }
+    }
+    if (!cachedPath.empty())
     {
-        return isDirectoryExistInternal(cacheIter->second);
+        return isDirectoryExistInternal(cachedPath);
     }
     
 	std::string fullpath;
@@ -1000,7 +1439,8 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath)
             fullpath = *searchIt + dirPath + *resolutionIt;
             if (isDirectoryExistInternal(fullpath))
             {
-                const_cast<FileUtils*>(this)->_fullPathCache.insert(std::make_pair(dirPath, fullpath));
+                std::lock_guard<std::mutex> lock(_pathCacheMutex);
+                _fullPathCache.insert(std::make_pair(dirPath, fullpath));
                 return true;
             }
         }
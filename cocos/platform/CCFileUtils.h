@@ -28,6 +28,9 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
@@ -36,6 +39,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class ZipFile;
+
 /**
  * @addtogroup platform
  * @{
@@ -75,9 +80,10 @@ public:
      *        For instance, in the CocosPlayer sample, every time you run application from CocosBuilder,
      *        All the resources will be downloaded to the writable folder, before new js app launchs,
      *        this method should be invoked to clean the file search cache.
+     *        It also drops the directory indexes and the cache of files that weren't found.
      */
     virtual void purgeCachedEntries();
-    
+
     /**
      *  Gets string from a file.
      */
@@ -277,6 +283,44 @@ public:
      */
     virtual const std::vector<std::string>& getSearchPaths() const;
 
+    /**
+     *  Adds a zip archive (an OBB for instance) as a search path.
+     *  The central directory of the archive is read only once. Files inside it are then found by
+     *  fullPathForFilename like files in a directory, the full path being the archive path followed
+     *  by the name of the entry, e.g. "/sdcard/main.obb/images/hero.png".
+     *
+     *  @param archivePath The path of the zip file, it could be a relative or an absolute path.
+     *  @param front Whether the archive is searched before the other search paths.
+     *  @return true if the archive could be opened.
+     *  @since v3.3
+     */
+    bool addSearchArchive(const std::string& archivePath, const bool front=false);
+
+    /**
+     *  Reads a file that lives inside an archive added by addSearchArchive().
+     *  @note This method is used internally.
+     *  @param fullPath The full path of the file, as returned by fullPathForFilename().
+     *  @param forString Whether a '\0' should be appended after the data.
+     *  @param[out] data The content of the file, left null if it couldn't be read.
+     *  @return false if the full path doesn't point into an archive.
+     */
+    bool getDataFromArchive(const std::string& fullPath, bool forString, Data* data);
+
+    /**
+     *  Enables or disables the directory index used by fullPathForFilename.
+     *  When enabled, a search path is listed once, the first time a file is looked up in it, and the
+     *  candidate paths are checked against that listing instead of the file system.
+     *  Archive search paths always use the directory of the archive. Search paths that can't be listed,
+     *  like the apk assets on Android, keep checking the file system.
+     *  While enabled, the file names that weren't found are cached too.
+     *  The indexes are dropped when the search paths change and by purgeCachedEntries(), which should be
+     *  called after files are added to a search path at runtime.
+     *  Disabled by default.
+     *  @since v3.3
+     */
+    void setDirectoryIndexEnabled(bool enabled);
+    bool isDirectoryIndexEnabled() const { return _directoryIndexEnabled; }
+
     /**
      *  Gets the writable path.
      *  @return  The path that can be write/read a file in
@@ -384,8 +428,8 @@ public:
      */
     virtual long getFileSize(const std::string &filepath);
 
-    /** Returns the full path cache */
-    const std::unordered_map<std::string, std::string>& getFullPathCache() const { return _fullPathCache; }
+    /** Returns a copy of the full path cache */
+    std::unordered_map<std::string, std::string> getFullPathCache() const;
 
 protected:
     /**
@@ -447,7 +491,27 @@ protected:
      *  @return The full path of the file, if the file can't be found, it will return an empty string.
      */
     virtual std::string getFullPathForDirectoryAndFilename(const std::string& directory, const std::string& filename);
-    
+
+    /**
+     *  Lists the files below a directory, recursively, as paths relative to it ("images/hero.png").
+     *  Used to build the directory index of a search path.
+     *  @param dirPath The directory (with absolute path), ending with '/'.
+     *  @param[out] files The relative paths of the files found.
+     *  @return false if the directory can't be listed, its files are then looked up one by one.
+     */
+    virtual bool listFilesRecursivelyInternal(const std::string& dirPath, std::vector<std::string>* files) const;
+
+    typedef std::unordered_set<std::string> DirectoryIndex;
+
+    /**
+     *  Returns the directory index of a search path, listing the search path the first time.
+     *  @return nullptr if the search path can't be listed.
+     */
+    std::shared_ptr<const DirectoryIndex> getDirectoryIndex(const std::string& searchPath);
+
+    /** Clears the full path cache and the cache of files that weren't found, optionally dropping the directory indexes too. */
+    void clearPathCaches(bool dropDirectoryIndexes);
+
     /** 
      *  Returns the fullpath for a given filename.
      *  This is an alternative for fullPathForFilename, there are two main differences:
@@ -457,6 +521,27 @@ protected:
      *  @return The full path for the file, if not found, the return value will be an empty string
      */
     virtual std::string searchFullPathForFilename(const std::string& filename) const;
+
+    /**
+     *  Returns the zip file opened with the given path, opening it and reading its directory the first time.
+     *  The zip file is opened again when it was modified since.
+     *  @return nullptr if the zip file can't be opened.
+     */
+    std::shared_ptr<ZipFile> getArchive(const std::string& zipFilePath) const;
+
+    /**
+     *  Finds the archive search path a full path points into.
+     *  @param[out] entryName The name of the file inside the archive.
+     *  @return nullptr if the full path isn't inside an archive search path.
+     */
+    std::shared_ptr<ZipFile> getArchiveForFullPath(const std::string& fullPath, std::string* entryName) const;
+
+    /**
+     *  Reads a file that lives inside an archive added by addSearchArchive().
+     *  @param[out] buffer The content of the file allocated with malloc, nullptr if it couldn't be read.
+     *  @return false if the full path doesn't point into an archive.
+     */
+    bool getFileDataFromArchive(const std::string& fullPath, unsigned char** buffer, ssize_t* size);
     
     
     /** Dictionary used to lookup filenames based on a key.
@@ -494,6 +579,42 @@ protected:
      *  This variable is used for improving the performance of file search.
      */
     std::unordered_map<std::string, std::string> _fullPathCache;
+
+    /**
+     *  The file names fullPathForFilename couldn't find while the directory index is enabled,
+     *  so that a miss (e.g. an optional -hd variant) is only searched once.
+     */
+    std::unordered_set<std::string> _missingPathCache;
+
+    /** Guards _fullPathCache and _missingPathCache, file names are also resolved on the texture loading thread. */
+    mutable std::mutex _pathCacheMutex;
+
+    typedef std::unordered_map<std::string, std::shared_ptr<const DirectoryIndex>> DirectoryIndexMap;
+
+    /**
+     *  The directory indexes, keyed by search path. A null index marks a search path that can't be listed.
+     *  The map is never modified once published: readers take a reference with std::atomic_load and
+     *  writers publish a modified copy, so lookups don't lock.
+     */
+    std::shared_ptr<const DirectoryIndexMap> _directoryIndexes;
+
+    /** Serializes the writers of _directoryIndexes. */
+    std::mutex _directoryIndexesMutex;
+
+    bool _directoryIndexEnabled;
+
+    /**
+     *  The opened zip files, keyed by the path they were opened with.
+     *  They are shared by getFileDataFromZip() and the archive search paths. A zip file which is modified
+     *  is replaced by a new ZipFile, readers still holding the previous one keep it alive until they are done.
+     */
+    mutable std::unordered_map<std::string, std::shared_ptr<ZipFile>> _archives;
+
+    /** The paths of the archives added by addSearchArchive(), keyed by their search path (the archive path plus '/'). */
+    std::unordered_map<std::string, std::string> _searchArchives;
+
+    /** Guards _archives and _searchArchives, files are also read from the texture loading thread. */
+    mutable std::mutex _archivesMutex;
     
     /**
      *  The singleton pointer of FileUtils.
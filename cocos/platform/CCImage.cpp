@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include <string>
 #include <ctype.h>
+#include <atomic>
 
 #include "base/CCData.h"
 #include "base/ccConfig.h" // CC_USE_JPEG, CC_USE_TIFF, CC_USE_WEBP
@@ -78,12 +79,14 @@ extern "C"
 #endif
 
 #include "base/ccMacros.h"
+#include "base/CCTrace.h"
 #include "CCCommon.h"
 #include "CCStdC.h"
 #include "CCFileUtils.h"
 #include "base/CCConfiguration.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
+#include "base/CCThreadPool.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "android/CCFileUtils-android.h"
 #endif
@@ -403,6 +406,46 @@ namespace
 
 //////////////////////////////////////////////////////////////////////////
 
+//software decoding of block compressed data (etc1, s3tc, atitc)
+namespace
+{
+    // Smallest amount of 4x4 blocks worth handing to another thread.
+    static const int MIN_BLOCKS_PER_BAND = 4096;
+
+    // Decodes `bandHeight` pixel rows starting at the given addresses.
+    typedef std::function<void(unsigned char* encodeData, unsigned char* decodeData, int bandHeight)> BandDecoder;
+
+    // Splits a block compressed image into bands of block rows and decodes them on the
+    // shared thread pool. Every band decoder sees a standalone image of `width` x `bandHeight`.
+    static void decodeBlockRows(unsigned char* encodeData, unsigned char* decodeData,
+                                int width, int height,
+                                int encodedBlockRowSize, int decodedPixelRowSize,
+                                const BandDecoder& decoder)
+    {
+        int blocksPerRow = MAX((width + 3) / 4, 1);
+        int blockRows = (height + 3) / 4;
+        int blockRowsPerBand = MAX(MIN_BLOCKS_PER_BAND / blocksPerRow, 1);
+        int bandCount = (blockRows + blockRowsPerBand - 1) / blockRowsPerBand;
+
+        if (bandCount <= 1)
+        {
+            decoder(encodeData, decodeData, height);
+            return;
+        }
+
+        ThreadPool::getInstance()->parallelFor(bandCount, [=](int band) {
+            int firstRow = band * blockRowsPerBand * 4;
+            int bandHeight = MIN(blockRowsPerBand * 4, height - firstRow);
+            decoder(encodeData + band * blockRowsPerBand * encodedBlockRowSize,
+                    decodeData + firstRow * decodedPixelRowSize,
+                    bandHeight);
+        });
+    }
+}
+//block decoding end
+
+//////////////////////////////////////////////////////////////////////////
+
 namespace
 {
     typedef struct 
@@ -531,6 +574,7 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
 
 bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
 {
+    CC_TRACE_ZONE("Image::initWithImageData");
     bool ret = false;
     
     do
@@ -1552,7 +1596,16 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
                     _unpack = true;
                     _mipmaps[i].len = width*height*bytePerPixel;
                     _mipmaps[i].address = new unsigned char[width*height*bytePerPixel];
-                    if (etc1_decode_image(static_cast<const unsigned char*>(_data+dataOffset), static_cast<etc1_byte*>(_mipmaps[i].address), width, height, bytePerPixel, stride) != 0)
+                    std::atomic<bool> failed(false);
+                    decodeBlockRows(_data + dataOffset, _mipmaps[i].address, width, height,
+                                    ((width + 3) / 4) * ETC1_ENCODED_BLOCK_SIZE, stride,
+                                    [&](unsigned char* encodeData, unsigned char* decodeData, int bandHeight) {
+                                        if (etc1_decode_image(encodeData, decodeData, width, bandHeight, bytePerPixel, stride) != 0)
+                                        {
+                                            failed = true;
+                                        }
+                                    });
+                    if (failed)
                     {
                         return false;
                     }
@@ -1652,12 +1705,23 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
         _dataLen =  _width * _height * bytePerPixel;
         _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
         
-        if (etc1_decode_image(static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, static_cast<etc1_byte*>(_data), _width, _height, bytePerPixel, stride) != 0)
+        std::atomic<bool> failed(false);
+        decodeBlockRows(const_cast<unsigned char*>(data) + ETC_PKM_HEADER_SIZE, _data, _width, _height,
+                        ((_width + 3) / 4) * ETC1_ENCODED_BLOCK_SIZE, stride,
+                        [&](unsigned char* encodeData, unsigned char* decodeData, int bandHeight) {
+                            if (etc1_decode_image(encodeData, decodeData, _width, bandHeight, bytePerPixel, stride) != 0)
+                            {
+                                failed = true;
+                            }
+                        });
+        
+        if (failed)
         {
             _dataLen = 0;
             if (_data != nullptr)
             {
                 free(_data);
+                _data = nullptr;
             }
             return false;
         }
@@ -1829,6 +1893,9 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     int decodeOffset = 0;
     width = _width;  height = _height;
     
+    //software decoded levels are independent from each other, decode them all at once
+    std::vector<std::function<void()>> decodeTasks;
+    
     for (int i = 0; i < _numberOfMipmaps && (width || height); ++i)  
     {
         if (width == 0) width = 1;
@@ -1849,23 +1916,33 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
             int bytePerPixel = 4;
             unsigned int stride = width * bytePerPixel;
 
-            std::vector<unsigned char> decodeImageData(stride * height);
-            if (FOURCC_DXT1 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
-            {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT1);
-            }
-            else if (FOURCC_DXT3 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
+            S3TCDecodeFlag decodeFlag = S3TCDecodeFlag::DXT1;
+            if (FOURCC_DXT3 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT3);
+                decodeFlag = S3TCDecodeFlag::DXT3;
             }
             else if (FOURCC_DXT5 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT5);
+                decodeFlag = S3TCDecodeFlag::DXT5;
             }
             
             _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
             _mipmaps[i].len = (stride * height);
-            memcpy((void *)_mipmaps[i].address, (void *)&decodeImageData[0], _mipmaps[i].len);
+            
+            //the decoder only writes whole blocks, keep the remaining pixels black like before
+            if ((width & 3) || (height & 3))
+            {
+                memset(_mipmaps[i].address, 0, _mipmaps[i].len);
+            }
+            
+            unsigned char* encodeData = pixelData + encodeOffset;
+            unsigned char* decodeData = _mipmaps[i].address;
+            decodeTasks.push_back([=]() {
+                decodeBlockRows(encodeData, decodeData, width, height, (width / 4) * blockSize, stride,
+                                [=](unsigned char* bandEncodeData, unsigned char* bandDecodeData, int bandHeight) {
+                                    s3tc_decode(bandEncodeData, bandDecodeData, width, bandHeight, decodeFlag);
+                                });
+            });
             decodeOffset += stride * height;
         }
         
@@ -1874,6 +1951,10 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
         height >>= 1;
     }
     
+    ThreadPool::getInstance()->parallelFor(static_cast<int>(decodeTasks.size()), [&decodeTasks](int level) {
+        decodeTasks[level]();
+    });
+    
     /* end load the mipmaps */
     
     if (pixelData != nullptr)
@@ -1942,6 +2023,9 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
     int decodeOffset = 0;
     width = _width;  height = _height;
     
+    //software decoded levels are independent from each other, decode them all at once
+    std::vector<std::function<void()>> decodeTasks;
+    
     for (int i = 0; i < _numberOfMipmaps && (width || height); ++i)
     {
         if (width == 0) width = 1;
@@ -1983,25 +2067,40 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
             unsigned int stride = width * bytePerPixel;
             _renderFormat = Texture2D::PixelFormat::RGBA8888;
             
-            std::vector<unsigned char> decodeImageData(stride * height);
+            ATITCDecodeFlag decodeFlag;
             switch (header->glInternalFormat)
             {
                 case CC_GL_ATC_RGB_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_RGB);
+                    decodeFlag = ATITCDecodeFlag::ATC_RGB;
                     break;
                 case CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
+                    decodeFlag = ATITCDecodeFlag::ATC_EXPLICIT_ALPHA;
                     break;
                 case CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
+                    decodeFlag = ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA;
                     break;
                 default:
+                    decodeFlag = static_cast<ATITCDecodeFlag>(0);
                     break;
             }
 
             _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
             _mipmaps[i].len = (stride * height);
-            memcpy((void *)_mipmaps[i].address, (void *)&decodeImageData[0], _mipmaps[i].len);
+            
+            //the decoder only writes whole blocks, keep the remaining pixels black like before
+            if ((width & 3) || (height & 3))
+            {
+                memset(_mipmaps[i].address, 0, _mipmaps[i].len);
+            }
+            
+            unsigned char* encodeData = pixelData + encodeOffset;
+            unsigned char* decodeData = _mipmaps[i].address;
+            decodeTasks.push_back([=]() {
+                decodeBlockRows(encodeData, decodeData, width, height, (width / 4) * blockSize, stride,
+                                [=](unsigned char* bandEncodeData, unsigned char* bandDecodeData, int bandHeight) {
+                                    atitc_decode(bandEncodeData, bandDecodeData, width, bandHeight, decodeFlag);
+                                });
+            });
             decodeOffset += stride * height;
         }
 
@@ -2009,6 +2108,10 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
         width >>= 1;
         height >>= 1;
     }
+    
+    ThreadPool::getInstance()->parallelFor(static_cast<int>(decodeTasks.size()), [&decodeTasks](int level) {
+        decodeTasks[level]();
+    });
     /* end load the mipmaps */
     
     return true;
@@ -144,6 +144,12 @@ Data FileUtilsAndroid::getData(const std::string& filename, bool forString)
     unsigned char* data = nullptr;
     ssize_t size = 0;
     string fullPath = fullPathForFilename(filename);
+
+    Data archived;
+    if (getDataFromArchive(fullPath, forString, &archived))
+    {
+        return archived;
+    }
     
     if (fullPath[0] != '/')
     {
@@ -265,8 +271,16 @@ unsigned char* FileUtilsAndroid::getFileData(const std::string& filename, const
     }
     
     string fullPath = fullPathForFilename(filename);
-    
-    if (fullPath[0] != '/')
+
+    ssize_t archivedSize = 0;
+    if (getFileDataFromArchive(fullPath, &data, &archivedSize))
+    {
+        if (size)
+        {
+            *size = archivedSize;
+        }
+    }
+    else if (fullPath[0] != '/')
     {
         string relativePath = string();
 
@@ -221,8 +221,8 @@ public class Cocos2dxHelper {
         Cocos2dxHelper.sCocos2dMusic.setBackgroundVolume(volume);
     }
 
-    public static void preloadEffect(final String path) {
-        Cocos2dxHelper.sCocos2dSound.preloadEffect(path);
+    public static boolean preloadEffect(final String path) {
+        return Cocos2dxHelper.sCocos2dSound.preloadEffect(path) != Cocos2dxSound.INVALID_SOUND_ID;
     }
 
     public static int playEffect(final String path, final boolean isLoop, final float pitch, final float pan, final float gain) {
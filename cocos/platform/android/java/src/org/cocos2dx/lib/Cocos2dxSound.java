@@ -70,7 +70,7 @@ public class Cocos2dxSound {
     private static final int SOUND_PRIORITY = 1;
     private static final int SOUND_QUALITY = 5;
 
-    private final static int INVALID_SOUND_ID = -1;
+    final static int INVALID_SOUND_ID = -1;
     private final static int INVALID_STREAM_ID = -1;
 
     // ===========================================================
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "deprecated/CCDictionary.h"
 #include "platform/CCFileUtils.h"
 #include "platform/CCSAXParser.h"
+#include "base/CCValueBinary.h"
 #include "unzip.h"
 
 
@@ -414,24 +415,22 @@ std::string FileUtilsApple::getFullPathForDirectoryAndFilename(const std::string
 ValueMap FileUtilsApple::getValueMapFromFile(const std::string& filename)
 {
     std::string fullPath = fullPathForFilename(filename);
-    NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
-    NSDictionary* dict = [NSDictionary dictionaryWithContentsOfFile:path];
-
-    ValueMap ret;
-
-    if (dict != nil)
+    Data data = getDataFromFile(fullPath);
+    if (data.isNull())
     {
-        for (id key in [dict allKeys])
-        {
-            id value = [dict objectForKey:key];
-            addValueToDict(key, value, ret);
-        }
+        return ValueMap();
     }
-    return ret;
+    return getValueMapFromData((const char*)data.getBytes(), static_cast<int>(data.getSize()));
 }
 
 ValueMap FileUtilsApple::getValueMapFromData(const char* filedata, int filesize)
 {
+    if (ValueBinary::isValueBinary((const unsigned char*)filedata, filesize))
+    {
+        Value root = ValueBinary::decode((const unsigned char*)filedata, filesize);
+        return root.getType() == Value::Type::MAP ? std::move(root.asValueMap()) : ValueMap();
+    }
+
     NSData* file = [NSData dataWithBytes:filedata length:filesize];
     NSPropertyListFormat format;
     NSError* error;
@@ -475,6 +474,13 @@ ValueVector FileUtilsApple::getValueVectorFromFile(const std::string& filename)
     //    pPath = [[NSBundle mainBundle] pathForResource:pPath ofType:pathExtension];
     //    fixing cannot read data using Array::createWithContentsOfFile
     std::string fullPath = fullPathForFilename(filename);
+    Data data = getDataFromFile(fullPath);
+    if (ValueBinary::isValueBinary(data.getBytes(), data.getSize()))
+    {
+        Value root = ValueBinary::decode(data.getBytes(), data.getSize());
+        return root.getType() == Value::Type::VECTOR ? std::move(root.asValueVector()) : ValueVector();
+    }
+
     NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
     NSArray* array = [NSArray arrayWithContentsOfFile:path];
 
@@ -144,6 +144,12 @@ static Data getData(const std::string& filename, bool forString)
         // read the file from hardware
         std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+        Data archived;
+        if (FileUtils::getInstance()->getDataFromArchive(fullPath, forString, &archived))
+        {
+            return archived;
+        }
+
         WCHAR wszBuf[CC_MAX_PATH] = {0};
         MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, wszBuf, sizeof(wszBuf)/sizeof(wszBuf[0]));
 
@@ -218,6 +224,10 @@ unsigned char* FileUtilsWin32::getFileData(const std::string& filename, const ch
     {
         // read the file from hardware
         std::string fullPath = fullPathForFilename(filename);
+        if (getFileDataFromArchive(fullPath, &pBuffer, size))
+        {
+            break;
+        }
 
         WCHAR wszBuf[CC_MAX_PATH] = {0};
         MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, wszBuf, sizeof(wszBuf)/sizeof(wszBuf[0]));
@@ -28,13 +28,15 @@ THE SOFTWARE.
 
 #include "renderer/CCGLProgram.h"
 
+#include <algorithm>
+
 #ifndef WIN32
 #include <alloca.h>
 #endif
 
 #include "base/CCDirector.h"
-#include "base/uthash.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgramBinaryCache.h"
 #include "platform/CCFileUtils.h"
 
 #include "deprecated/CCString.h"
@@ -45,12 +47,87 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
-typedef struct _hashUniformEntry
+namespace
 {
-    GLvoid*         value;       // value
-    unsigned int    location;    // Key
-    UT_hash_handle  hh;          // hash entry
-} tHashUniformEntry;
+    // uniform values shared by every program, see GLProgram::setUniformsForBuiltins()
+    struct BuiltinUniforms
+    {
+        unsigned int version;
+        unsigned int projectionVersion;
+        unsigned int frame;
+        Mat4 projection;
+        GLfloat time[4];
+        GLfloat sinTime[4];
+        GLfloat cosTime[4];
+        GLfloat random[4];
+    };
+
+    BuiltinUniforms s_builtinUniforms = { 0, 0, 0 };
+    unsigned int s_uniformUploads = 0;
+
+    const BuiltinUniforms& updateBuiltinUniforms()
+    {
+        Director *director = Director::getInstance();
+        unsigned int projectionVersion = director->getProjectionMatrixVersion();
+        unsigned int frame = director->getTotalFrames();
+
+        // once per camera and per frame
+        if (s_builtinUniforms.version == 0
+            || s_builtinUniforms.projectionVersion != projectionVersion
+            || s_builtinUniforms.frame != frame)
+        {
+            s_builtinUniforms.version++;
+            s_builtinUniforms.projectionVersion = projectionVersion;
+            s_builtinUniforms.frame = frame;
+            s_builtinUniforms.projection = director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+
+            // This doesn't give the most accurate global time value.
+            // Cocos2D doesn't store a high precision time value, so this will have to do.
+            // Getting Mach time per frame per shader using time could be extremely expensive.
+            float time = frame * director->getAnimationInterval();
+            GLfloat timeValues[] = { time/10.0f, time, time*2, time*4 };
+            GLfloat sinValues[] = { time/8.0f, time/4.0f, time/2.0f, sinf(time) };
+            GLfloat cosValues[] = { time/8.0f, time/4.0f, time/2.0f, cosf(time) };
+            GLfloat randomValues[] = { CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1() };
+            memcpy(s_builtinUniforms.time, timeValues, sizeof(timeValues));
+            memcpy(s_builtinUniforms.sinTime, sinValues, sizeof(sinValues));
+            memcpy(s_builtinUniforms.cosTime, cosValues, sizeof(cosValues));
+            memcpy(s_builtinUniforms.random, randomValues, sizeof(randomValues));
+        }
+        return s_builtinUniforms;
+    }
+
+    unsigned int getUniformTypeSize(GLenum type)
+    {
+        switch (type)
+        {
+            case GL_FLOAT:
+            case GL_INT:
+            case GL_BOOL:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_CUBE:
+                return 4;
+            case GL_FLOAT_VEC2:
+            case GL_INT_VEC2:
+            case GL_BOOL_VEC2:
+                return 8;
+            case GL_FLOAT_VEC3:
+            case GL_INT_VEC3:
+            case GL_BOOL_VEC3:
+                return 12;
+            case GL_FLOAT_MAT3:
+                return 36;
+            case GL_FLOAT_MAT4:
+                return 64;
+            default:
+                // vec4 and mat2, a bigger value is never cached
+                return 16;
+        }
+    }
+
+    // the slots of locations beyond it aren't cached
+    const GLint MAX_CACHED_UNIFORM_LOCATION = 4096;
+}
 
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR = "ShaderPositionTextureColor";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP = "ShaderPositionTextureColor_noMVP";
@@ -140,8 +217,9 @@ GLProgram::GLProgram()
 : _program(0)
 , _vertShader(0)
 , _fragShader(0)
-, _hashForUniforms(nullptr)
 , _flags()
+, _binaryPending(false)
+, _builtinUniformsVersion(0)
 {
     memset(_builtInUniforms, 0, sizeof(_builtInUniforms));
 }
@@ -166,16 +244,6 @@ GLProgram::~GLProgram()
     {
         GL::deleteProgram(_program);
     }
-
-    tHashUniformEntry *current_element, *tmp;
-
-    // Purge uniform hash
-    HASH_ITER(hh, _hashForUniforms, current_element, tmp)
-    {
-        HASH_DEL(_hashForUniforms, current_element);
-        free(current_element->value);
-        free(current_element);
-    }
 }
 
 bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray)
@@ -196,7 +264,35 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
     CHECK_GL_ERROR_DEBUG();
 
     _vertShader = _fragShader = 0;
+    _attribBindings.clear();
+
+#if CC_USE_PROGRAM_BINARY_CACHE
+    auto binaryCache = GLProgramBinaryCache::getInstance();
+    _binaryKey = binaryCache->getKey(vShaderByteArray, fShaderByteArray);
+    _binaryPending = binaryCache->hasProgram(_binaryKey);
+    if (_binaryPending)
+    {
+        // the binary is loaded by link(), once the attributes are bound
+        _vertSource = vShaderByteArray ? vShaderByteArray : "";
+        _fragSource = fShaderByteArray ? fShaderByteArray : "";
+        return true;
+    }
+#endif
 
+    if (!compileAndAttachShaders(vShaderByteArray, fShaderByteArray))
+    {
+        return false;
+    }
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+    _shaderId = CCPrecompiledShaders::getInstance()->addShaders(vShaderByteArray, fShaderByteArray);
+#endif
+
+    return true;
+}
+
+bool GLProgram::compileAndAttachShaders(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray)
+{
     if (vShaderByteArray)
     {
         if (!compileShader(&_vertShader, GL_VERTEX_SHADER, vShaderByteArray))
@@ -226,14 +322,9 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
     {
         glAttachShader(_program, _fragShader);
     }
-    _hashForUniforms = nullptr;
     
     CHECK_GL_ERROR_DEBUG();
 
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
-    _shaderId = CCPrecompiledShaders::getInstance()->addShaders(vShaderByteArray, fShaderByteArray);
-#endif
-
     return true;
 }
 
@@ -263,9 +354,6 @@ bool GLProgram::initWithPrecompiledProgramByteArray(const GLchar* vShaderByteArr
 
     haveProgram = CCPrecompiledShaders::getInstance()->loadProgram(_program, vShaderByteArray, fShaderByteArray);
 
-    CHECK_GL_ERROR_DEBUG();
-    _hashForUniforms = nullptr;
-
     CHECK_GL_ERROR_DEBUG();  
 
     return haveProgram;
@@ -343,6 +431,7 @@ void GLProgram::parseVertexAttribs()
 void GLProgram::parseUniforms()
 {
     _userUniforms.clear();
+    clearUniformSlots();
 
     // Query and store uniforms from the program.
     GLint activeUniforms;
@@ -363,28 +452,30 @@ void GLProgram::parseUniforms()
                 glGetActiveUniform(_program, i, length, nullptr, &uniform.size, &uniform.type, uniformName);
                 uniformName[length] = '\0';
 
+                // remove possible array '[]' from uniform name
+                if(uniform.size > 1 && length > 3)
+                {
+                    char* c = strrchr(uniformName, '[');
+                    if(c)
+                    {
+                        *c = '\0';
+                    }
+                }
+                uniform.location = glGetUniformLocation(_program, uniformName);
+                GLenum __gl_error_code = glGetError(); 
+                if (__gl_error_code != GL_NO_ERROR) 
+                { 
+                    CCLOG("error: 0x%x", (int)__gl_error_code);
+                } 
+                assert(__gl_error_code == GL_NO_ERROR);
+
+                // built-ins are cached too
+                addUniformSlot(uniform.location, uniform.type, uniform.size);
+
                 // Only add uniforms that are not built-in.
                 // The ones that start with 'CC_' are built-ins
                 if(strncmp("CC_", uniformName, 3) != 0) {
-
-                    // remove possible array '[]' from uniform name
-                    if(uniform.size > 1 && length > 3)
-                    {
-                        char* c = strrchr(uniformName, '[');
-                        if(c)
-                        {
-                            *c = '\0';
-                        }
-                    }
                     uniform.name = std::string(uniformName);
-                    uniform.location = glGetUniformLocation(_program, uniformName);
-                    GLenum __gl_error_code = glGetError(); 
-                    if (__gl_error_code != GL_NO_ERROR) 
-                    { 
-                        CCLOG("error: 0x%x", (int)__gl_error_code);
-                    } 
-                    assert(__gl_error_code == GL_NO_ERROR);
-                    
                     _userUniforms[uniform.name] = uniform;
                 }
             }
@@ -392,6 +483,33 @@ void GLProgram::parseUniforms()
     }
 }
 
+void GLProgram::addUniformSlot(GLint location, GLenum type, GLint size)
+{
+    if (location < 0 || location >= MAX_CACHED_UNIFORM_LOCATION)
+        return;
+
+    if (location >= (GLint)_uniformSlotIndices.size())
+    {
+        _uniformSlotIndices.resize(location + 1, -1);
+    }
+    _uniformSlotIndices[location] = (int)_uniformSlots.size();
+
+    UniformSlot slot;
+    slot.offset = (unsigned int)_uniformValues.size();
+    slot.size = getUniformTypeSize(type) * std::max(size, 1);
+    slot.cached = 0;
+    _uniformSlots.push_back(slot);
+    _uniformValues.resize(_uniformValues.size() + slot.size);
+}
+
+void GLProgram::clearUniformSlots()
+{
+    _uniformSlots.clear();
+    _uniformSlotIndices.clear();
+    _uniformValues.clear();
+    _builtinUniformsVersion = 0;
+}
+
 Uniform* GLProgram::getUniform(const std::string &name)
 {
     const auto itr = _userUniforms.find(name);
@@ -488,6 +606,7 @@ GLint GLProgram::getUniformLocation(const std::string &attributeName) const
 void GLProgram::bindAttribLocation(const std::string &attributeName, GLuint index) const
 {
     glBindAttribLocation(_program, index, attributeName.c_str());
+    _attribBindings.append(StringUtils::format("%s=%u;", attributeName.c_str(), index));
 }
 
 void GLProgram::updateUniforms()
@@ -551,6 +670,31 @@ bool GLProgram::link()
 
     GLint status = GL_TRUE;
 
+#if CC_USE_PROGRAM_BINARY_CACHE
+    auto binaryCache = GLProgramBinaryCache::getInstance();
+    if (_binaryPending)
+    {
+        _binaryPending = false;
+        bool loaded = binaryCache->loadProgram(_program, _binaryKey, _attribBindings);
+        bool compiled = loaded || compileAndAttachShaders(_vertSource.empty() ? nullptr : _vertSource.c_str(),
+                                                          _fragSource.empty() ? nullptr : _fragSource.c_str());
+        _vertSource.clear();
+        _fragSource.clear();
+
+        if (loaded)
+        {
+            parseVertexAttribs();
+            parseUniforms();
+            return true;
+        }
+        if (!compiled)
+        {
+            return false;
+        }
+    }
+    binaryCache->setRetrievable(_program);
+#endif
+
     bindPredefinedVertexAttribs();
 
     glLinkProgram(_program);
@@ -588,6 +732,17 @@ bool GLProgram::link()
     }
 #endif
 
+#if CC_USE_PROGRAM_BINARY_CACHE
+    if (_program && !_binaryKey.empty())
+    {
+        glGetProgramiv(_program, GL_LINK_STATUS, &status);
+        if (status == GL_TRUE)
+        {
+            binaryCache->saveProgram(_program, _binaryKey, _attribBindings);
+        }
+    }
+#endif
+
     return (status == GL_TRUE);
 }
 
@@ -638,36 +793,41 @@ bool GLProgram::updateUniformLocation(GLint location, const GLvoid* data, unsign
         return false;
     }
 
-    bool updated = true;
-    tHashUniformEntry *element = nullptr;
-    HASH_FIND_INT(_hashForUniforms, &location, element);
+    ++s_uniformUploads;
 
-    if (! element)
+    // locations of array elements aren't cached
+    if (location >= (GLint)_uniformSlotIndices.size() || _uniformSlotIndices[location] < 0)
     {
-        element = (tHashUniformEntry*)malloc( sizeof(*element) );
-
-        // key
-        element->location = location;
-
-        // value
-        element->value = malloc( bytes );
-        memcpy(element->value, data, bytes );
+        return true;
+    }
 
-        HASH_ADD_INT(_hashForUniforms, location, element);
+    UniformSlot& slot = _uniformSlots[_uniformSlotIndices[location]];
+    if (bytes > slot.size)
+    {
+        slot.cached = 0;
+        return true;
     }
-    else
+
+    unsigned char* value = _uniformValues.data() + slot.offset;
+    if (bytes <= slot.cached && memcmp(value, data, bytes) == 0)
     {
-        if (memcmp(element->value, data, bytes) == 0)
-        {
-            updated = false;
-        }
-        else
-        {
-            memcpy(element->value, data, bytes);
-        }
+        --s_uniformUploads;
+        return false;
     }
 
-    return updated;
+    memcpy(value, data, bytes);
+    slot.cached = std::max(slot.cached, bytes);
+    return true;
+}
+
+unsigned int GLProgram::getUniformUploadCount()
+{
+    return s_uniformUploads;
+}
+
+void GLProgram::resetUniformUploadCount()
+{
+    s_uniformUploads = 0;
 }
 
 GLint GLProgram::getUniformLocationForName(const char* name) const
@@ -877,69 +1037,70 @@ void GLProgram::setUniformsForBuiltins()
 
 void GLProgram::setUniformsForBuiltins(const Mat4 &matrixMV)
 {
-    Mat4 matrixP = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    const BuiltinUniforms& builtins = updateBuiltinUniforms();
+    const Mat4& matrixP = builtins.projection;
+    bool stale = _builtinUniformsVersion != builtins.version;
+    _builtinUniformsVersion = builtins.version;
 
-    if(_flags.usesP)
+    if(_flags.usesP && stale)
         setUniformLocationWithMatrix4fv(_builtInUniforms[UNIFORM_P_MATRIX], matrixP.m, 1);
 
     if(_flags.usesMV)
         setUniformLocationWithMatrix4fv(_builtInUniforms[UNIFORM_MV_MATRIX], matrixMV.m, 1);
 
     if(_flags.usesMVP) {
-        Mat4 matrixMVP = matrixP * matrixMV;
+        Mat4 matrixMVP;
+        Mat4::multiply(matrixP, matrixMV, &matrixMVP);
         setUniformLocationWithMatrix4fv(_builtInUniforms[UNIFORM_MVP_MATRIX], matrixMVP.m, 1);
     }
 
     if (_flags.usesNormal)
     {
-        Mat4 mvInverse = matrixMV;
-        mvInverse.m[12] = mvInverse.m[13] = mvInverse.m[14] = 0.0f;
-        mvInverse.inverse();
-        mvInverse.transpose();
+        // inverse transpose of the upper 3x3 of the model view: its cofactors divided by its determinant
+        const float* m = matrixMV.m;
         GLfloat normalMat[9];
-        normalMat[0] = mvInverse.m[0];normalMat[1] = mvInverse.m[1];normalMat[2] = mvInverse.m[2];
-        normalMat[3] = mvInverse.m[4];normalMat[4] = mvInverse.m[5];normalMat[5] = mvInverse.m[6];
-        normalMat[6] = mvInverse.m[8];normalMat[7] = mvInverse.m[9];normalMat[8] = mvInverse.m[10];
+        normalMat[0] = m[5] * m[10] - m[6] * m[9];
+        normalMat[1] = m[6] * m[8] - m[4] * m[10];
+        normalMat[2] = m[4] * m[9] - m[5] * m[8];
+        normalMat[3] = m[2] * m[9] - m[1] * m[10];
+        normalMat[4] = m[0] * m[10] - m[2] * m[8];
+        normalMat[5] = m[1] * m[8] - m[0] * m[9];
+        normalMat[6] = m[1] * m[6] - m[2] * m[5];
+        normalMat[7] = m[2] * m[4] - m[0] * m[6];
+        normalMat[8] = m[0] * m[5] - m[1] * m[4];
+
+        float det = m[0] * normalMat[0] + m[1] * normalMat[1] + m[2] * normalMat[2];
+        if (fabsf(det) > MATH_TOLERANCE)
+        {
+            float invDet = 1.0f / det;
+            for (int i = 0; i < 9; ++i)
+                normalMat[i] *= invDet;
+        }
         setUniformLocationWithMatrix3fv(_builtInUniforms[UNIFORM_NORMAL_MATRIX], normalMat, 1);
     }
 
-    if(_flags.usesTime) {
-        Director *director = Director::getInstance();
-        // This doesn't give the most accurate global time value.
-        // Cocos2D doesn't store a high precision time value, so this will have to do.
-        // Getting Mach time per frame per shader using time could be extremely expensive.
-        float time = director->getTotalFrames() * director->getAnimationInterval();
-        
-        setUniformLocationWith4f(_builtInUniforms[GLProgram::UNIFORM_TIME], time/10.0, time, time*2, time*4);
-        setUniformLocationWith4f(_builtInUniforms[GLProgram::UNIFORM_SIN_TIME], time/8.0, time/4.0, time/2.0, sinf(time));
-        setUniformLocationWith4f(_builtInUniforms[GLProgram::UNIFORM_COS_TIME], time/8.0, time/4.0, time/2.0, cosf(time));
+    if(_flags.usesTime && stale) {
+        setUniformLocationWith4fv(_builtInUniforms[GLProgram::UNIFORM_TIME], builtins.time, 1);
+        setUniformLocationWith4fv(_builtInUniforms[GLProgram::UNIFORM_SIN_TIME], builtins.sinTime, 1);
+        setUniformLocationWith4fv(_builtInUniforms[GLProgram::UNIFORM_COS_TIME], builtins.cosTime, 1);
     }
     
-    if(_flags.usesRandom)
-        setUniformLocationWith4f(_builtInUniforms[GLProgram::UNIFORM_RANDOM01], CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1());
+    if(_flags.usesRandom && stale)
+        setUniformLocationWith4fv(_builtInUniforms[GLProgram::UNIFORM_RANDOM01], builtins.random, 1);
 }
 
 void GLProgram::reset()
 {
     _vertShader = _fragShader = 0;
     memset(_builtInUniforms, 0, sizeof(_builtInUniforms));
+    _binaryPending = false;
     
 
     // it is already deallocated by android
     //GL::deleteProgram(_program);
     _program = 0;
 
-    
-    tHashUniformEntry *current_element, *tmp;
-    
-    // Purge uniform hash
-    HASH_ITER(hh, _hashForUniforms, current_element, tmp) 
-    {
-        HASH_DEL(_hashForUniforms, current_element);
-        free(current_element->value);
-        free(current_element);
-    }
-    _hashForUniforms = nullptr;
+    clearUniformSlots();
 }
 
 NS_CC_END
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #define __CCGLPROGRAM_H__
 
 #include <unordered_map>
+#include <vector>
 
 #include "base/ccMacros.h"
 #include "base/CCRef.h"
@@ -45,7 +46,6 @@ NS_CC_BEGIN
  * @{
  */
 
-struct _hashUniformEntry;
 class GLProgram;
 
 typedef void (*GLInfoFunction)(GLuint program, GLenum pname, GLint* params);
@@ -305,10 +305,17 @@ public:
     /** calls glUniformMatrix4fv only if the values are different than the previous call for this same shader program. */
     void setUniformLocationWithMatrix4fv(GLint location, const GLfloat* matrixArray, unsigned int numberOfMatrices);
     
-    /** will update the builtin uniforms if they are different than the previous call for this same shader program. */
+    /** will update the builtin uniforms if they are different than the previous call for this same shader program.
+     The projection, time and random uniforms are computed once per camera and per frame, and only set
+     again when they changed since this program was used.
+     */
     void setUniformsForBuiltins();
     void setUniformsForBuiltins(const Mat4 &modelView);
 
+    /** number of glUniform calls made by all the programs since the last resetUniformUploadCount() */
+    static unsigned int getUniformUploadCount();
+    static void resetUniformUploadCount();
+
     // Attribute
 
     /** returns the vertexShader error log */
@@ -336,6 +343,8 @@ public:
 
 protected:
     bool updateUniformLocation(GLint location, const GLvoid* data, unsigned int bytes);
+    void addUniformSlot(GLint location, GLenum type, GLint size);
+    void clearUniformSlots();
     virtual std::string getDescription() const;
 
     void bindPredefinedVertexAttribs();
@@ -343,19 +352,28 @@ protected:
     void parseUniforms();
 
     bool compileShader(GLuint * shader, GLenum type, const GLchar* source);
+    bool compileAndAttachShaders(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray);
     std::string logForOpenGLObject(GLuint object, GLInfoFunction infoFunc, GLLogFunction logFunc) const;
 
     GLuint            _program;
     GLuint            _vertShader;
     GLuint            _fragShader;
     GLint             _builtInUniforms[UNIFORM_MAX];
-    struct _hashUniformEntry* _hashForUniforms;
     bool              _hasShaderCompiler;
         
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
     std::string       _shaderId;
 #endif
 
+    // key of the program in GLProgramBinaryCache, empty when the cache is disabled
+    std::string       _binaryKey;
+    // when a binary was saved, the sources are only compiled if the driver rejects it
+    bool              _binaryPending;
+    std::string       _vertSource;
+    std::string       _fragSource;
+    // attributes bound by bindAttribLocation(), they are part of the binary
+    mutable std::string _attribBindings;
+
     struct flag_struct {
         unsigned int usesTime:1;
         unsigned int usesNormal:1;
@@ -367,6 +385,20 @@ protected:
         flag_struct() { memset(this, 0, sizeof(*this)); }
     } _flags;
 
+    // Uniform cache. Every active uniform has a slot, which holds the last values
+    // given to glUniform in _uniformValues. The slot of a location is found in _uniformSlotIndices.
+    struct UniformSlot
+    {
+        unsigned int offset;
+        unsigned int size;
+        unsigned int cached;
+    };
+    std::vector<UniformSlot> _uniformSlots;
+    std::vector<int> _uniformSlotIndices;
+    std::vector<unsigned char> _uniformValues;
+    // version of the shared builtin uniforms last set in this program
+    unsigned int _builtinUniformsVersion;
+
     std::unordered_map<std::string, Uniform> _userUniforms;
     std::unordered_map<std::string, VertexAttrib> _vertexAttribs;
 };
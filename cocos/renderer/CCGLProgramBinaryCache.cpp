@@ -0,0 +1,272 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "renderer/CCGLProgramBinaryCache.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "base/CCConfiguration.h"
+#include "base/ccMacros.h"
+#include "platform/CCFileUtils.h"
+#include "deprecated/CCString.h"
+#include "xxhash.h"
+
+#if CC_USE_PROGRAM_BINARY_CACHE
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+#define CC_GL_PROGRAM_BINARY_LENGTH     GL_PROGRAM_BINARY_LENGTH_OES
+#define ccGetProgramBinary              glGetProgramBinaryOES
+#define ccProgramBinary                 glProgramBinaryOES
+#else
+#define CC_GL_PROGRAM_BINARY_LENGTH     GL_PROGRAM_BINARY_LENGTH
+#define ccGetProgramBinary              glGetProgramBinary
+#define ccProgramBinary                 glProgramBinary
+#endif
+
+#endif // CC_USE_PROGRAM_BINARY_CACHE
+
+NS_CC_BEGIN
+
+namespace
+{
+    // bump it when the layout of the files changes
+    const uint32_t BINARY_CACHE_VERSION = 1;
+
+    struct BinaryHeader
+    {
+        char        magic[4];
+        uint32_t    version;
+        uint32_t    format;
+        uint32_t    bindingsLength;
+        uint32_t    binaryLength;
+    };
+}
+
+static GLProgramBinaryCache* s_sharedBinaryCache = nullptr;
+
+GLProgramBinaryCache* GLProgramBinaryCache::getInstance()
+{
+    if (!s_sharedBinaryCache)
+    {
+        s_sharedBinaryCache = new (std::nothrow) GLProgramBinaryCache();
+        s_sharedBinaryCache->init();
+    }
+    return s_sharedBinaryCache;
+}
+
+void GLProgramBinaryCache::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedBinaryCache);
+}
+
+GLProgramBinaryCache::GLProgramBinaryCache()
+: _supported(false)
+, _enabled(true)
+, _directoryCreated(false)
+{
+}
+
+void GLProgramBinaryCache::init()
+{
+#if CC_USE_PROGRAM_BINARY_CACHE
+    _supported = Configuration::getInstance()->supportsProgramBinary() && ccGetProgramBinary && ccProgramBinary;
+#endif
+
+    if (_supported)
+    {
+        const char* vendor = (const char*)glGetString(GL_VENDOR);
+        const char* renderer = (const char*)glGetString(GL_RENDERER);
+        const char* version = (const char*)glGetString(GL_VERSION);
+        _driver = StringUtils::format("%s\n%s\n%s\n", vendor ? vendor : "", renderer ? renderer : "", version ? version : "");
+
+        _cachePath = FileUtils::getInstance()->getWritablePath() + "shaders/";
+    }
+}
+
+bool GLProgramBinaryCache::isEnabled() const
+{
+    return _supported && _enabled;
+}
+
+void GLProgramBinaryCache::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+std::string GLProgramBinaryCache::getKey(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray) const
+{
+    if (!isEnabled())
+        return "";
+
+    std::string sources(_driver);
+    sources.append(vShaderByteArray ? vShaderByteArray : "");
+    sources.push_back('\0');
+    sources.append(fShaderByteArray ? fShaderByteArray : "");
+
+    unsigned int low = XXH32(sources.data(), (int)sources.size(), 0);
+    unsigned int high = XXH32(sources.data(), (int)sources.size(), 0x9e3779b9);
+    return StringUtils::format("%08x%08x", high, low);
+}
+
+std::string GLProgramBinaryCache::getFilePath(const std::string& key) const
+{
+    return _cachePath + key + ".bin";
+}
+
+bool GLProgramBinaryCache::hasProgram(const std::string& key) const
+{
+    if (!isEnabled() || key.empty())
+        return false;
+
+    return FileUtils::getInstance()->isFileExist(getFilePath(key));
+}
+
+bool GLProgramBinaryCache::loadProgram(GLuint program, const std::string& key, const std::string& attribBindings)
+{
+#if CC_USE_PROGRAM_BINARY_CACHE
+    if (!isEnabled() || key.empty())
+        return false;
+
+    Data data = FileUtils::getInstance()->getDataFromFile(getFilePath(key));
+    if (data.isNull())
+        return false;
+
+    const unsigned char* bytes = data.getBytes();
+    ssize_t size = data.getSize();
+
+    BinaryHeader header;
+    bool valid = size >= (ssize_t)sizeof(header);
+    if (valid)
+    {
+        memcpy(&header, bytes, sizeof(header));
+        valid = memcmp(header.magic, "CCPB", 4) == 0
+            && header.version == BINARY_CACHE_VERSION
+            && size == (ssize_t)(sizeof(header) + header.bindingsLength + header.binaryLength)
+            && attribBindings.compare(0, std::string::npos, (const char*)bytes + sizeof(header), header.bindingsLength) == 0;
+    }
+
+    GLint status = GL_FALSE;
+    if (valid)
+    {
+        ccProgramBinary(program, header.format, bytes + sizeof(header) + header.bindingsLength, header.binaryLength);
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+    }
+
+    if (status != GL_TRUE)
+    {
+        CCLOG("cocos2d: program binary %s rejected, the program is compiled from its sources", key.c_str());
+        removeProgram(key);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void GLProgramBinaryCache::saveProgram(GLuint program, const std::string& key, const std::string& attribBindings)
+{
+#if CC_USE_PROGRAM_BINARY_CACHE
+    if (!isEnabled() || key.empty())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, CC_GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    unsigned char* binary = (unsigned char*)malloc(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    ccGetProgramBinary(program, length, &written, &format, binary);
+
+    if (written > 0)
+    {
+        auto fileUtils = FileUtils::getInstance();
+        if (!_directoryCreated)
+        {
+            _directoryCreated = fileUtils->isDirectoryExist(_cachePath) || fileUtils->createDirectory(_cachePath);
+        }
+
+        BinaryHeader header;
+        memcpy(header.magic, "CCPB", 4);
+        header.version = BINARY_CACHE_VERSION;
+        header.format = format;
+        header.bindingsLength = (uint32_t)attribBindings.size();
+        header.binaryLength = (uint32_t)written;
+
+        // write to a temporary file, a truncated binary must never be loaded
+        std::string path = getFilePath(key);
+        std::string tmpPath = path + ".tmp";
+        FILE* fp = fopen(tmpPath.c_str(), "wb");
+        if (fp)
+        {
+            bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+                && fwrite(attribBindings.data(), 1, attribBindings.size(), fp) == attribBindings.size()
+                && fwrite(binary, 1, written, fp) == (size_t)written;
+            ok = (fclose(fp) == 0) && ok;
+
+            if (!ok || !fileUtils->renameFile(_cachePath, key + ".bin.tmp", key + ".bin"))
+            {
+                fileUtils->removeFile(tmpPath);
+            }
+        }
+    }
+
+    free(binary);
+#endif
+}
+
+void GLProgramBinaryCache::setRetrievable(GLuint program) const
+{
+#if CC_USE_PROGRAM_BINARY_CACHE && (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
+    // GL_OES_get_program_binary keeps every binary, the desktop drivers only when asked
+    if (isEnabled())
+    {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
+}
+
+void GLProgramBinaryCache::removeProgram(const std::string& key)
+{
+    std::string path = getFilePath(key);
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils->isFileExist(path))
+    {
+        fileUtils->removeFile(path);
+    }
+}
+
+void GLProgramBinaryCache::purge()
+{
+    if (!_cachePath.empty() && FileUtils::getInstance()->isDirectoryExist(_cachePath))
+    {
+        FileUtils::getInstance()->removeDirectory(_cachePath);
+    }
+    _directoryCreated = false;
+}
+
+NS_CC_END
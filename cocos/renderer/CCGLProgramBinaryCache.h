@@ -0,0 +1,122 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCGLPROGRAMBINARYCACHE_H__
+#define __CCGLPROGRAMBINARYCACHE_H__
+
+#include <string>
+
+#include "platform/CCGL.h"
+#include "platform/CCPlatformMacros.h"
+
+/** Program binaries are saved and loaded back on the platforms using GL_OES_get_program_binary
+ (Android) or GL_ARB_get_program_binary (Linux). WinRT and WP8 use CCPrecompiledShaders instead.
+ */
+#ifndef CC_USE_PROGRAM_BINARY_CACHE
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+#define CC_USE_PROGRAM_BINARY_CACHE 1
+#else
+#define CC_USE_PROGRAM_BINARY_CACHE 0
+#endif
+#endif
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup shaders
+ * @{
+ */
+
+/** GLProgramBinaryCache
+ Stores the linked binaries of the GL programs under the writable path, so that the next runs
+ load them with glProgramBinary instead of compiling the sources again.
+
+ A binary is found by the key of its sources, which also hashes the GL vendor, renderer and
+ version strings: updating the driver only misses the cache. When the driver rejects a binary
+ anyway, the program falls back to a compilation from the sources and the binary is replaced.
+ GLProgram uses it transparently, it is exposed to purge the files or to disable it.
+ @since v3.3
+ @js NA
+ @lua NA
+ */
+class CC_DLL GLProgramBinaryCache
+{
+public:
+    /** returns the shared instance */
+    static GLProgramBinaryCache* getInstance();
+
+    /** deletes the shared instance. The files are kept. */
+    static void destroyInstance();
+
+    /** whether the driver supports program binaries and the cache is enabled */
+    bool isEnabled() const;
+    /** enables or disables the cache. It is enabled by default when the driver supports it. */
+    void setEnabled(bool enabled);
+
+    /** returns the key of a program for the given sources, an empty string if the cache is disabled */
+    std::string getKey(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray) const;
+
+    /** whether a binary was saved for the key */
+    bool hasProgram(const std::string& key) const;
+
+    /** loads the saved binary into a program created with glCreateProgram().
+     The attribute bindings given when it was saved must be the same.
+     Returns false, and removes the file, if the binary is missing or rejected by the driver.
+     */
+    bool loadProgram(GLuint program, const std::string& key, const std::string& attribBindings);
+
+    /** saves the binary of a linked program. It must have been created with setRetrievable(). */
+    void saveProgram(GLuint program, const std::string& key, const std::string& attribBindings);
+
+    /** asks the driver to keep the binary of a program which is about to be linked */
+    void setRetrievable(GLuint program) const;
+
+    /** removes the saved binary of a key */
+    void removeProgram(const std::string& key);
+
+    /** removes all the saved binaries */
+    void purge();
+
+    /** returns the directory of the saved binaries */
+    const std::string& getCachePath() const { return _cachePath; }
+
+protected:
+    GLProgramBinaryCache();
+    void init();
+
+    std::string getFilePath(const std::string& key) const;
+
+    bool _supported;
+    bool _enabled;
+    bool _directoryCreated;
+    std::string _cachePath;
+    std::string _driver;
+};
+
+// end of shaders group
+/// @}
+
+NS_CC_END
+
+#endif /* __CCGLPROGRAMBINARYCACHE_H__ */
@@ -106,232 +106,65 @@ GLProgramCache::~GLProgramCache()
 }
 
 bool GLProgramCache::init()
-{    
-    loadDefaultGLPrograms();
+{
+    // the built-in programs are compiled by getGLProgram() the first time they are used
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR] = kShaderType_PositionTextureColor;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP] = kShaderType_PositionTextureColor_noMVP;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST] = kShaderType_PositionTextureColorAlphaTest;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV] = kShaderType_PositionTextureColorAlphaTestNoMV;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_COLOR] = kShaderType_PositionColor;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP] = kShaderType_PositionColor_noMVP;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_TEXTURE] = kShaderType_PositionTexture;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR] = kShaderType_PositionTexture_uColor;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR] = kShaderType_PositionTextureA8Color;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_U_COLOR] = kShaderType_Position_uColor;
+    _defaultTypes[GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR] = kShaderType_PositionLengthTexureColor;
+    _defaultTypes[GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL] = kShaderType_LabelDistanceFieldNormal;
+    _defaultTypes[GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW] = kShaderType_LabelDistanceFieldGlow;
+    _defaultTypes[GLProgram::SHADER_NAME_LABEL_NORMAL] = kShaderType_LabelNormal;
+    _defaultTypes[GLProgram::SHADER_NAME_LABEL_OUTLINE] = kShaderType_LabelOutline;
+    _defaultTypes[GLProgram::SHADER_3D_POSITION] = kShaderType_3DPosition;
+    _defaultTypes[GLProgram::SHADER_3D_POSITION_TEXTURE] = kShaderType_3DPositionTex;
+    _defaultTypes[GLProgram::SHADER_3D_SKINPOSITION_TEXTURE] = kShaderType_3DSkinPositionTex;
+    _defaultTypes[GLProgram::SHADER_3D_POSITION_NORMAL] = kShaderType_3DPositionNormal;
+    _defaultTypes[GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE] = kShaderType_3DPositionNormalTex;
+    _defaultTypes[GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE] = kShaderType_3DSkinPositionNormalTex;
     return true;
 }
 
 void GLProgramCache::loadDefaultGLPrograms()
 {
-    // Position Texture Color shader
-    GLProgram *p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, p ) );
-
-    // Position Texture Color without MVP shader
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, p ) );
-
-    // Position Texture Color alpha test
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST, p) );
-
-    // Position Texture Color alpha test
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV, p) );
-    //
-    // Position, Color shader
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR, p) );
-
-    //
-    // Position, Color shader no MVP
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP, p) );
-
-    //
-    // Position Texture shader
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE, p) );
-
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR, p) );
-
-    //
-    // Position Texture A8 Color shader
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR, p) );
-
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_U_COLOR, p) );
-    
-    //
-    // Position, Legth(TexCoords, Color (used by Draw Node basically )
-    //
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_NORMAL, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_OUTLINE, p) );
-    
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPosition);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION, p) );
-
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPositionTex);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_TEXTURE, p) );
-    
-    p = new (std::nothrow) GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE, p));
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_NORMAL, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormalTex);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionNormalTex);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE, p));
+    for (const auto& type : _defaultTypes)
+    {
+        getGLProgram(type.first);
+    }
 }
 
 void GLProgramCache::reloadDefaultGLPrograms()
 {
-    // reset all programs and reload them
-    
-    // Position Texture Color shader
-    GLProgram *p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR);    
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-
-    // Position Texture Color without MVP shader
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-    
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    //
-    // Position, Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-    
-    //
-    // Position, Color shader no MVP
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP);
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-
-    //
-    // Position Texture shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-    
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-    
-    //
-    // Position Texture A8 Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-    
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-    
-    //
-    // Position, Legth(TexCoords, Color (used by Draw Node basically )
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPosition);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionTex);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormal);
-
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionNormalTex);
+    // reset the built-in programs which were created and reload them,
+    // the others are still compiled on demand
+    for (const auto& type : _defaultTypes)
+    {
+        auto it = _programs.find(type.first);
+        if (it == _programs.end())
+            continue;
+
+        GLProgram *p = it->second;
+        p->reset();
+        loadDefaultGLProgram(p, type.second);
+    }
+}
 
-    p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionNormalTex);
+void GLProgramCache::warmUpGLPrograms(const std::vector<std::string>& keys)
+{
+    for (const auto& key : keys)
+    {
+        if (!getGLProgram(key))
+        {
+            CCLOG("cocos2d: GLProgramCache: can't warm up %s, it isn't a built-in program", key.c_str());
+        }
+    }
 }
 
 void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
@@ -427,6 +260,15 @@ GLProgram* GLProgramCache::getGLProgram(const std::string &key)
     auto it = _programs.find(key);
     if( it != _programs.end() )
         return it->second;
+
+    auto type = _defaultTypes.find(key);
+    if (type != _defaultTypes.end())
+    {
+        GLProgram *p = new (std::nothrow) GLProgram();
+        loadDefaultGLProgram(p, type->second);
+        _programs.insert( std::make_pair(key, p) );
+        return p;
+    }
     return nullptr;
 }
 
@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "base/CCRef.h"
 
@@ -71,15 +72,24 @@ public:
     /** @deprecated Use destroyInstance() instead */
     CC_DEPRECATED_ATTRIBUTE static void purgeSharedShaderCache();
 
-    /** loads the default shaders */
+    /** compiles the default shaders which weren't used yet.
+     They are created on demand by getGLProgram(), so this is only needed to avoid compiling them while playing.
+     */
     void loadDefaultGLPrograms();
     CC_DEPRECATED_ATTRIBUTE void loadDefaultShaders() { loadDefaultGLPrograms(); }
 
-    /** reload the default shaders */
+    /** reload the default shaders which were created */
     void reloadDefaultGLPrograms();
     CC_DEPRECATED_ATTRIBUTE void reloadDefaultShaders() { reloadDefaultGLPrograms(); }
 
-    /** returns a GL program for a given key 
+    /** compiles the given default shaders now, typically while a loading screen is displayed.
+     The keys are the GLProgram::SHADER_NAME_XXX names. Splitting the list over several frames spreads the cost.
+     @since v3.3
+     */
+    void warmUpGLPrograms(const std::vector<std::string>& keys);
+
+    /** returns a GL program for a given key.
+     A default shader is compiled the first time it is requested.
      */
     GLProgram * getGLProgram(const std::string &key);
     CC_DEPRECATED_ATTRIBUTE GLProgram * getProgram(const std::string &key) { return getGLProgram(key); }
@@ -97,6 +107,8 @@ private:
 
 //    Dictionary* _programs;
     std::unordered_map<std::string, GLProgram*> _programs;
+    // kShaderType of the default shaders, by key
+    std::unordered_map<std::string, int> _defaultTypes;
 };
 
 // end of shaders group
@@ -42,6 +42,7 @@
 #include "base/CCEventType.h"
 #include "base/CCCamera.h"
 #include "2d/CCScene.h"
+#include "base/CCTrace.h"
 
 NS_CC_BEGIN
 
@@ -137,7 +138,10 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 // constructors, destructors, init
 //
 Renderer::Renderer()
-:_lastMaterialID(0)
+:_renderingPass(0)
+,_cameraPassCount(0)
+,_cameraPassMask(ALL_CAMERA_PASSES)
+,_lastMaterialID(0)
 ,_lastBatchedMeshCommand(nullptr)
 ,_filledVertex(0)
 ,_filledIndex(0)
@@ -151,14 +155,14 @@ Renderer::Renderer()
     
     _commandGroupStack.push(DEFAULT_RENDER_QUEUE);
     
-    RenderQueue defaultRenderQueue;
-    _renderGroups.push_back(defaultRenderQueue);
+    _renderPasses.resize(1);
+    _renderPasses[0].renderGroups.resize(1);
     _batchedCommands.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
 }
 
 Renderer::~Renderer()
 {
-    _renderGroups.clear();
+    _renderPasses.clear();
     _groupCommandManager->release();
     
     glDeleteBuffers(2, _buffersVBO);
@@ -268,10 +272,28 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(!_isRendering, "Cannot add command while rendering");
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
-    if (command->isTransparent())
-        _transparentRenderGroups.push_back(command);
-    else
-        _renderGroups[renderQueue].push_back(command);
+
+    if (_cameraPassCount == 0)
+    {
+        if (command->isTransparent())
+            _renderPasses[0].transparentRenderGroups.push_back(command);
+        else
+            _renderPasses[0].renderGroups[renderQueue].push_back(command);
+        return;
+    }
+
+    // the same command is rendered by every camera that sees its node
+    unsigned int mask = _cameraPassMask;
+    for (int pass = 0; pass < _cameraPassCount && mask; ++pass, mask >>= 1)
+    {
+        if (!(mask & 1))
+            continue;
+
+        if (command->isTransparent())
+            _renderPasses[pass].transparentRenderGroups.push_back(command);
+        else
+            _renderPasses[pass].renderGroups[renderQueue].push_back(command);
+    }
 }
 
 void Renderer::pushGroup(int renderQueueID)
@@ -288,9 +310,42 @@ void Renderer::popGroup()
 
 int Renderer::createRenderQueue()
 {
-    RenderQueue newRenderQueue;
-    _renderGroups.push_back(newRenderQueue);
-    return (int)_renderGroups.size() - 1;
+    for (auto& renderPass : _renderPasses)
+    {
+        renderPass.renderGroups.push_back(RenderQueue());
+    }
+    return (int)_renderPasses[0].renderGroups.size() - 1;
+}
+
+void Renderer::beginCameraPasses(int passCount)
+{
+    CCASSERT(!_isRendering, "Cannot begin camera passes while rendering");
+    CCASSERT(passCount > 0 && passCount <= MAX_CAMERA_PASSES, "Invalid number of camera passes");
+
+    if (_renderPasses.size() < (size_t)passCount)
+    {
+        size_t queueCount = _renderPasses[0].renderGroups.size();
+        _renderPasses.resize(passCount);
+        for (auto& renderPass : _renderPasses)
+        {
+            renderPass.renderGroups.resize(queueCount);
+        }
+    }
+
+    _cameraPassCount = passCount;
+    _cameraPassMask = ALL_CAMERA_PASSES;
+}
+
+void Renderer::renderCameraPass(int pass)
+{
+    CCASSERT(pass >= 0 && pass < _cameraPassCount, "Invalid camera pass");
+    renderPass(pass);
+}
+
+void Renderer::endCameraPasses()
+{
+    _cameraPassCount = 0;
+    _cameraPassMask = ALL_CAMERA_PASSES;
 }
 
 void Renderer::visitRenderQueue(const RenderQueue& queue)
@@ -323,7 +378,7 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
         {
             flush();
             int renderQueueID = ((GroupCommand*) command)->getRenderQueueID();
-            visitRenderQueue(_renderGroups[renderQueueID]);
+            visitRenderQueue(_renderPasses[_renderingPass].renderGroups[renderQueueID]);
         }
         else if(RenderCommand::Type::CUSTOM_COMMAND == commandType)
         {
@@ -389,7 +444,7 @@ void Renderer::visitTransparentRenderQueue(const TransparentRenderQueue& queue)
         else if(RenderCommand::Type::GROUP_COMMAND == commandType)
         {
             int renderQueueID = (static_cast<GroupCommand*>(command))->getRenderQueueID();
-            visitRenderQueue(_renderGroups[renderQueueID]);
+            visitRenderQueue(_renderPasses[_renderingPass].renderGroups[renderQueueID]);
         }
         else if(RenderCommand::Type::CUSTOM_COMMAND == commandType)
         {
@@ -419,49 +474,76 @@ void Renderer::visitTransparentRenderQueue(const TransparentRenderQueue& queue)
 }
 
 void Renderer::render()
+{
+    CC_TRACE_ZONE("Renderer::render");
+    renderPass(0);
+}
+
+void Renderer::renderPass(int pass)
 {
     //Uncomment this once everything is rendered by new renderer
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     //TODO: setup camera or MVP
     _isRendering = true;
+    _renderingPass = pass;
+
+    auto& renderGroups = _renderPasses[pass].renderGroups;
+    auto& transparentRenderGroups = _renderPasses[pass].transparentRenderGroups;
     
     if (_glViewAssigned)
     {
         //Process render commands
         //1. Sort render commands based on ID
-        for (auto &renderqueue : _renderGroups)
+        for (auto &renderqueue : renderGroups)
         {
             renderqueue.sort();
         }
-        visitRenderQueue(_renderGroups[0]);
+        visitRenderQueue(renderGroups[0]);
         flush();
         
         //Process render commands
         //draw transparent objects here, do not batch for transparent objects
-        if (0 < _transparentRenderGroups.size())
+        if (0 < transparentRenderGroups.size())
         {
-            _transparentRenderGroups.sort();
+            transparentRenderGroups.sort();
             glEnable(GL_DEPTH_TEST);
-            visitTransparentRenderQueue(_transparentRenderGroups);
+            visitTransparentRenderQueue(transparentRenderGroups);
             glDisable(GL_DEPTH_TEST);
         }
     }
-    clean();
+
+    // only this pass is cleaned, the other cameras are still to be rendered
+    for (auto &renderqueue : renderGroups)
+    {
+        renderqueue.clear();
+    }
+    transparentRenderGroups.clear();
+    _batchedCommands.clear();
+    _filledVertex = 0;
+    _filledIndex = 0;
+    _lastMaterialID = 0;
+    _lastBatchedMeshCommand = nullptr;
+
+    _renderingPass = 0;
     _isRendering = false;
 }
 
 void Renderer::clean()
 {
     // Clear render group
-    for (size_t j = 0 ; j < _renderGroups.size(); j++)
+    for (auto& renderPass : _renderPasses)
     {
         //commands are owned by nodes
-        // for (const auto &cmd : _renderGroups[j])
+        // for (const auto &cmd : renderPass.renderGroups[j])
         // {
         //     cmd->releaseToCommandPool();
         // }
-        _renderGroups[j].clear();
+        for (auto& renderqueue : renderPass.renderGroups)
+        {
+            renderqueue.clear();
+        }
+        renderPass.transparentRenderGroups.clear();
     }
 
     // Clear batch quad commands
@@ -470,8 +552,6 @@ void Renderer::clean()
     _filledIndex = 0;
     _lastMaterialID = 0;
     _lastBatchedMeshCommand = nullptr;
-    
-    _transparentRenderGroups.clear();
 }
 
 void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
@@ -628,8 +708,52 @@ void Renderer::flush3D()
 
 // helpers
 
+// whether a rectangle of the node space, transformed by transform, is inside the frustum of a camera
+static bool isRectInFrustum(const Mat4& viewProjection, const Mat4& transform, const Size& size)
+{
+    Mat4 mvp;
+    Mat4::multiply(viewProjection, transform, &mvp);
+
+    const float xs[4] = { 0, size.width, 0, size.width };
+    const float ys[4] = { 0, 0, size.height, size.height };
+
+    // the rectangle is outside if its corners are all outside of the same clipping plane
+    unsigned int outside = 0x3f;
+    for (int i = 0; i < 4; ++i)
+    {
+        float x = mvp.m[0] * xs[i] + mvp.m[4] * ys[i] + mvp.m[12];
+        float y = mvp.m[1] * xs[i] + mvp.m[5] * ys[i] + mvp.m[13];
+        float z = mvp.m[2] * xs[i] + mvp.m[6] * ys[i] + mvp.m[14];
+        float w = mvp.m[3] * xs[i] + mvp.m[7] * ys[i] + mvp.m[15];
+
+        unsigned int code = 0;
+        code |= (x < -w) ? 0x01 : 0;
+        code |= (x > w) ? 0x02 : 0;
+        code |= (y < -w) ? 0x04 : 0;
+        code |= (y > w) ? 0x08 : 0;
+        code |= (z < -w) ? 0x10 : 0;
+        code |= (z > w) ? 0x20 : 0;
+        outside &= code;
+    }
+    return outside == 0;
+}
+
 bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
 {
+    if (_cameraPassCount > 0)
+    {
+        const auto& cameras = Camera::getVisitingCameras();
+        unsigned int visible = 0;
+        unsigned int mask = _cameraPassMask;
+        for (int pass = 0; pass < _cameraPassCount && mask; ++pass, mask >>= 1)
+        {
+            if ((mask & 1) && isRectInFrustum(cameras[pass]->getViewProjectionMatrix(), transform, size))
+                visible |= 1u << pass;
+        }
+        _cameraPassMask = visible;
+        return visible != 0;
+    }
+
     auto scene = Director::getInstance()->getRunningScene();
     // only cull the default camera. The culling algorithm is valid for default camera.
     if (scene && scene->_defaultCamera != Camera::getVisitingCamera())
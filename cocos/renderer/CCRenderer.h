@@ -77,6 +77,13 @@ protected:
     std::vector<RenderCommand*> _queueCmd;
 };
 
+/** The render queues of one camera, see Renderer::beginCameraPasses() */
+struct RenderPass
+{
+    std::vector<RenderQueue> renderGroups;
+    TransparentRenderQueue transparentRenderGroups;
+};
+
 struct RenderStackElement
 {
     int renderQueueID;
@@ -97,6 +104,11 @@ public:
     
     static const int BATCH_QUADCOMMAND_RESEVER_SIZE = 64;
 
+    /** Maximum number of cameras rendered from a single visit of the scene, see beginCameraPasses() */
+    static const int MAX_CAMERA_PASSES = 32;
+    /** Pass mask selecting every camera pass */
+    static const unsigned int ALL_CAMERA_PASSES = 0xffffffff;
+
     Renderer();
     ~Renderer();
 
@@ -124,6 +136,30 @@ public:
     /** Cleans all `RenderCommand`s in the queue */
     void clean();
 
+    /**
+     * Collects the commands of several cameras at once: until endCameraPasses() is called, every command is added
+     * to the render queues of the passes selected with setCameraPassMask(), one pass per camera.
+     * Commands added before beginCameraPasses() belong to the first pass.
+     */
+    void beginCameraPasses(int passCount);
+
+    /** Renders the commands of one pass with the current projection, then cleans them */
+    void renderCameraPass(int pass);
+
+    /** Goes back to a single render pass */
+    void endCameraPasses();
+
+    /** Number of camera passes being collected, 0 outside of beginCameraPasses() / endCameraPasses() */
+    int getCameraPassCount() const { return _cameraPassCount; }
+
+    /**
+     * Selects the passes, one bit per pass, the next commands are added to.
+     * Nodes select the passes of the cameras that see them when they are visited (see Camera::selectVisitingCameras()),
+     * commands that set a state up for other nodes (clipping, grids, render targets...) go to ALL_CAMERA_PASSES.
+     */
+    void setCameraPassMask(unsigned int mask) { _cameraPassMask = mask; }
+    unsigned int getCameraPassMask() const { return _cameraPassMask; }
+
     /* returns the number of drawn batches in the last frame */
     ssize_t getDrawnBatches() const { return _drawnBatches; }
     /* RenderCommands (except) QuadCommand should update this value */
@@ -137,7 +173,11 @@ public:
 
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; };
 
-    /** returns whether or not a rectangle is visible or not */
+    /**
+     * returns whether or not a rectangle is visible or not.
+     * When several camera passes are collected, the rectangle is tested against the frustum of each selected camera,
+     * and the passes it is not visible in are unselected.
+     */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
 protected:
@@ -161,12 +201,17 @@ protected:
     
     void visitTransparentRenderQueue(const TransparentRenderQueue& queue);
 
+    void renderPass(int pass);
+
     void fillVerticesAndIndices(const TrianglesCommand* cmd);
 
     std::stack<int> _commandGroupStack;
     
-    std::vector<RenderQueue> _renderGroups;
-    TransparentRenderQueue   _transparentRenderGroups; //transparency objects
+    // one per camera pass, the first one is used when the scene is visited once per camera
+    std::vector<RenderPass> _renderPasses;
+    int _renderingPass;
+    int _cameraPassCount;
+    unsigned int _cameraPassMask;
 
     uint32_t _lastMaterialID;
 
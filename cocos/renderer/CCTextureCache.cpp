@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
+#include "base/CCTrace.h"
 
 #include "deprecated/CCString.h"
 
@@ -169,6 +170,7 @@ void TextureCache::unbindAllImageAsync()
 void TextureCache::loadImage()
 {
     AsyncStruct *asyncStruct = nullptr;
+    Trace::setThreadName("TextureCache loader");
 
     while (true)
     {
@@ -216,6 +218,7 @@ void TextureCache::loadImage()
 
         if (generateImage)
         {
+            CC_TRACE_ZONE("TextureCache::loadImage");
             const std::string& filename = asyncStruct->filename;
             // generate image      
             image = new (std::nothrow) Image();
@@ -315,6 +318,7 @@ void TextureCache::addImageAsyncCallBack(float dt)
 
 Texture2D * TextureCache::addImage(const std::string &path)
 {
+    CC_TRACE_ZONE("TextureCache::addImage");
     Texture2D * texture = nullptr;
     Image* image = nullptr;
     // Split up directory and filename
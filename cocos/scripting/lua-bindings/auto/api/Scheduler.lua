@@ -4,6 +4,23 @@
 -- @extend Ref
 -- @parent_module cc
 
+--------------------------------
+--  Enables or disables batched dispatch of script 'update' handlers.<br>
+-- When enabled, the handlers registered with Node::scheduleUpdateWithPriorityLua are collected<br>
+-- while the update lists are ticked and the handlers of each priority are sent to the script<br>
+-- engine as a single kScheduleBatchEvent, once all the updates of that priority have run.<br>
+-- Disabled by default.<br>
+-- since v3.3
+-- @function [parent=#Scheduler] setScriptUpdateBatchingEnabled 
+-- @param self
+-- @param #bool enabled
+        
+--------------------------------
+-- 
+-- @function [parent=#Scheduler] isScriptUpdateBatchingEnabled 
+-- @param self
+-- @return bool#bool ret (return value: bool)
+        
 --------------------------------
 --  Modifies the time of all scheduled callbacks.<br>
 -- You can use this property to create a 'slow motion' or 'fast forward' effect.<br>
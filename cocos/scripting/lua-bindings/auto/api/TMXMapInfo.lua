@@ -204,6 +204,27 @@
 -- @param self
 -- @param #int layerAttribs
         
+--------------------------------
+--  Enables or disables the binary cache of the parsed maps.<br>
+-- When enabled, a map loaded from a tmx file is written to the writable path in a compact binary<br>
+-- form the first time, and read back from there as long as the tmx file and its external tilesets<br>
+-- don't change. Disabled by default.<br>
+-- since v3.3
+-- @function [parent=#TMXMapInfo] setBinaryCacheEnabled 
+-- @param self
+-- @param #bool enabled
+        
+--------------------------------
+-- 
+-- @function [parent=#TMXMapInfo] isBinaryCacheEnabled 
+-- @param self
+-- @return bool#bool ret (return value: bool)
+        
+--------------------------------
+--  Removes the cached maps from the writable path. 
+-- @function [parent=#TMXMapInfo] purgeBinaryCache 
+-- @param self
+        
 --------------------------------
 --  creates a TMX Format with a tmx file 
 -- @function [parent=#TMXMapInfo] create 
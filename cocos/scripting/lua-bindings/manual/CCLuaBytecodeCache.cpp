@@ -0,0 +1,344 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "CCLuaBytecodeCache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+NS_CC_BEGIN
+
+// Layout: Header, Entry[count] sorted by name, the NUL terminated names, the chunks.
+// Like the bytecode itself, the archive is only meant to be read by the build which wrote it.
+namespace {
+    const char BYTECODE_CACHE_MAGIC[4] = { 'L', 'B', 'C', 'C' };
+    const uint32_t BYTECODE_CACHE_VERSION = 2;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t pointerSize;
+        uint32_t count;
+        uint32_t namesSize;
+        uint32_t reserved;
+    };
+}
+
+struct LuaBytecodeCache::Entry
+{
+    uint32_t nameOffset;
+    uint32_t sourceHash;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+};
+
+LuaBytecodeCache::LuaBytecodeCache()
+: _bytes(nullptr)
+, _size(0)
+, _mapped(false)
+, _entries(nullptr)
+, _entryCount(0)
+, _names(nullptr)
+{
+}
+
+LuaBytecodeCache::~LuaBytecodeCache()
+{
+    close();
+}
+
+uint32_t LuaBytecodeCache::hashSource(const char* source, ssize_t size)
+{
+    // FNV-1a, xxhash isn't exported by libcocos2d
+    uint32_t hash = 2166136261u;
+    for (ssize_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ (unsigned char)source[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool LuaBytecodeCache::open(const std::string& fullPath)
+{
+    close();
+    _path = fullPath;
+
+    map(fullPath);
+    if (!_bytes)
+        return false;
+
+    const Header* header = reinterpret_cast<const Header*>(_bytes);
+    bool valid = _size >= (ssize_t)sizeof(Header)
+        && memcmp(header->magic, BYTECODE_CACHE_MAGIC, sizeof(BYTECODE_CACHE_MAGIC)) == 0
+        && header->version == BYTECODE_CACHE_VERSION
+        && header->pointerSize == sizeof(void*);
+
+    valid = valid && header->count <= (_size - sizeof(Header)) / sizeof(Entry);
+
+    const size_t entriesEnd = sizeof(Header) + (valid ? header->count * sizeof(Entry) : 0);
+    valid = valid && header->namesSize <= _size - entriesEnd;
+
+    if (valid)
+    {
+        _entries = reinterpret_cast<const Entry*>(_bytes + sizeof(Header));
+        _names = reinterpret_cast<const char*>(_bytes + entriesEnd);
+        for (uint32_t i = 0; valid && i < header->count; ++i)
+        {
+            const Entry& entry = _entries[i];
+            valid = entry.nameOffset < header->namesSize
+                && memchr(_names + entry.nameOffset, '\0', header->namesSize - entry.nameOffset) != nullptr
+                && (size_t)entry.dataOffset + entry.dataSize <= (size_t)_size;
+        }
+    }
+
+    if (!valid)
+    {
+        CCLOG("LuaBytecodeCache: %s is not a valid bytecode cache", fullPath.c_str());
+        unmap();
+        _entries = nullptr;
+        _names = nullptr;
+        return false;
+    }
+
+    _entryCount = (int)header->count;
+    return true;
+}
+
+void LuaBytecodeCache::close()
+{
+    unmap();
+    _entries = nullptr;
+    _entryCount = 0;
+    _names = nullptr;
+    _pendingChunks.clear();
+}
+
+const LuaBytecodeCache::Entry* LuaBytecodeCache::findEntry(const char* moduleName) const
+{
+    int low = 0;
+    int high = _entryCount - 1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        int cmp = strcmp(_names + _entries[middle].nameOffset, moduleName);
+        if (cmp == 0)
+            return &_entries[middle];
+        if (cmp < 0)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+    return nullptr;
+}
+
+const char* LuaBytecodeCache::findChunk(const std::string& moduleName, ssize_t* size, uint32_t* sourceHash) const
+{
+    auto pending = _pendingChunks.find(moduleName);
+    if (pending != _pendingChunks.end())
+    {
+        *size = pending->second.second.size();
+        *sourceHash = pending->second.first;
+        return pending->second.second.data();
+    }
+
+    const Entry* entry = findEntry(moduleName.c_str());
+    if (!entry)
+        return nullptr;
+
+    *size = entry->dataSize;
+    *sourceHash = entry->sourceHash;
+    return reinterpret_cast<const char*>(_bytes + entry->dataOffset);
+}
+
+void LuaBytecodeCache::addChunk(const std::string& moduleName, uint32_t sourceHash, const char* bytecode, ssize_t size)
+{
+    auto& chunk = _pendingChunks[moduleName];
+    chunk.first = sourceHash;
+    chunk.second.assign(bytecode, size);
+}
+
+bool LuaBytecodeCache::save()
+{
+    if (_path.empty())
+        return false;
+
+    struct Chunk
+    {
+        uint32_t sourceHash;
+        const char* data;
+        uint32_t size;
+    };
+
+    // std::map sorts the names the way findEntry() expects
+    std::map<std::string, Chunk> chunks;
+    for (int i = 0; i < _entryCount; ++i)
+    {
+        const Entry& entry = _entries[i];
+        Chunk chunk = { entry.sourceHash, reinterpret_cast<const char*>(_bytes + entry.dataOffset), entry.dataSize };
+        chunks[_names + entry.nameOffset] = chunk;
+    }
+    for (const auto& pending : _pendingChunks)
+    {
+        Chunk chunk = { pending.second.first, pending.second.second.data(), (uint32_t)pending.second.second.size() };
+        chunks[pending.first] = chunk;
+    }
+
+    Header header;
+    memcpy(header.magic, BYTECODE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = BYTECODE_CACHE_VERSION;
+    header.pointerSize = sizeof(void*);
+    header.count = (uint32_t)chunks.size();
+    header.namesSize = 0;
+    header.reserved = 0;
+    for (const auto& chunk : chunks)
+    {
+        header.namesSize += (uint32_t)chunk.first.size() + 1;
+    }
+
+    // the chunks stay 4 bytes aligned
+    header.namesSize = (header.namesSize + 3) & ~3u;
+
+    std::vector<Entry> entries;
+    entries.reserve(chunks.size());
+    uint32_t nameOffset = 0;
+    uint32_t dataOffset = (uint32_t)(sizeof(Header) + chunks.size() * sizeof(Entry) + header.namesSize);
+    for (const auto& chunk : chunks)
+    {
+        Entry entry = { nameOffset, chunk.second.sourceHash, dataOffset, chunk.second.size };
+        entries.push_back(entry);
+        nameOffset += (uint32_t)chunk.first.size() + 1;
+        dataOffset += (chunk.second.size + 3) & ~3u;
+    }
+
+    // write next to the archive, which is still mapped, and replace it once complete
+    std::string tempPath = _path + ".tmp";
+    FILE* fp = fopen(tempPath.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("LuaBytecodeCache: can't write %s", tempPath.c_str());
+        return false;
+    }
+
+    auto writePadding = [fp](uint32_t size) {
+        static const char padding[4] = { 0, 0, 0, 0 };
+        return size == 0 || fwrite(padding, size, 1, fp) == 1;
+    };
+
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    ok = ok && (entries.empty() || fwrite(entries.data(), sizeof(Entry), entries.size(), fp) == entries.size());
+    for (const auto& chunk : chunks)
+    {
+        ok = ok && fwrite(chunk.first.c_str(), chunk.first.size() + 1, 1, fp) == 1;
+    }
+    ok = ok && writePadding(header.namesSize - nameOffset);
+    for (const auto& chunk : chunks)
+    {
+        ok = ok && fwrite(chunk.second.data, chunk.second.size, 1, fp) == 1;
+        ok = ok && writePadding(((chunk.second.size + 3) & ~3u) - chunk.second.size);
+    }
+    ok = (fclose(fp) == 0) && ok;
+
+    // keep the archive and the pending chunks as they are if anything couldn't be written
+    if (!ok)
+    {
+        CCLOG("LuaBytecodeCache: failed to write %s", tempPath.c_str());
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    // the archive must be released before it is replaced, the pending chunks are kept until it is
+    std::string path = _path;
+    auto pendingChunks = std::move(_pendingChunks);
+    close();
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    remove(path.c_str());
+#endif
+    ok = rename(tempPath.c_str(), path.c_str()) == 0;
+
+    open(path);
+    if (!ok)
+    {
+        CCLOG("LuaBytecodeCache: failed to replace %s", path.c_str());
+        remove(tempPath.c_str());
+        _pendingChunks = std::move(pendingChunks);
+    }
+    return ok;
+}
+
+void LuaBytecodeCache::map(const std::string& fullPath)
+{
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                _bytes = static_cast<const unsigned char*>(data);
+                _size = st.st_size;
+                _mapped = true;
+            }
+        }
+        ::close(fd);
+    }
+    if (_mapped)
+        return;
+#endif
+
+    // files inside the apk, or platforms without mmap
+    if (FileUtils::getInstance()->isFileExist(fullPath))
+    {
+        _data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        _bytes = _data.getBytes();
+        _size = _data.getSize();
+    }
+}
+
+void LuaBytecodeCache::unmap()
+{
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    if (_mapped)
+    {
+        munmap(const_cast<unsigned char*>(_bytes), _size);
+    }
+#endif
+    _mapped = false;
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+}
+
+NS_CC_END
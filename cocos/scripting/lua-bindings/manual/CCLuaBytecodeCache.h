@@ -0,0 +1,107 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_LUA_BYTECODE_CACHE_H_
+#define __CC_LUA_BYTECODE_CACHE_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "cocos2d.h"
+
+NS_CC_BEGIN
+
+/**
+ * An archive of precompiled Lua chunks, indexed by module name.
+ *
+ * The archive is memory mapped when possible and only its index is read when it is opened,
+ * a chunk is handed to the Lua loader the first time its module is required. Every chunk
+ * records the hash of the source it was compiled from, so a stale chunk can be detected
+ * by hashing the source again, which is much cheaper than compiling it.
+ *
+ * New chunks are kept in memory until save() writes a new archive holding the old and new chunks.
+ */
+class LuaBytecodeCache
+{
+public:
+    LuaBytecodeCache();
+    ~LuaBytecodeCache();
+
+    /**
+     * Opens the archive at the given full path. Returns false if it doesn't exist or isn't valid,
+     * the cache is still usable then and save() creates the archive.
+     */
+    bool open(const std::string& fullPath);
+
+    /** Releases the archive and forgets the chunks which were not saved. */
+    void close();
+
+    /** Writes the chunks of the archive and the new ones to the path given to open(), then reopens it. */
+    bool save();
+
+    /** Whether chunks were added since the archive was opened. */
+    bool isDirty() const { return !_pendingChunks.empty(); }
+
+    /**
+     * Returns the bytecode of a module, nullptr if it is not in the cache.
+     * sourceHash receives the hash of the source the chunk was compiled from.
+     */
+    const char* findChunk(const std::string& moduleName, ssize_t* size, uint32_t* sourceHash) const;
+
+    /** Records the bytecode of a module, it will be written by the next save(). */
+    void addChunk(const std::string& moduleName, uint32_t sourceHash, const char* bytecode, ssize_t size);
+
+    /** Number of chunks in the archive, not counting the ones added since it was opened. */
+    int getChunkCount() const { return _entryCount; }
+
+    const std::string& getPath() const { return _path; }
+
+    static uint32_t hashSource(const char* source, ssize_t size);
+
+private:
+    struct Entry;
+
+    const Entry* findEntry(const char* moduleName) const;
+    void map(const std::string& fullPath);
+    void unmap();
+
+    std::string _path;
+
+    // the whole archive, either mapped or read in _data
+    const unsigned char* _bytes;
+    ssize_t _size;
+    bool _mapped;
+    Data _data;
+
+    const Entry* _entries;
+    int _entryCount;
+    const char* _names;
+
+    std::map<std::string, std::pair<uint32_t, std::string>> _pendingChunks;
+};
+
+NS_CC_END
+
+#endif // __CC_LUA_BYTECODE_CACHE_H_
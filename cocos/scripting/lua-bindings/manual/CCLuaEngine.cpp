@@ -229,6 +229,11 @@ int LuaEngine::sendEvent(ScriptEvent* evt)
                 return handleScheduler(evt->data);
             }
             break;
+        case kScheduleBatchEvent:
+            {
+                return handleSchedulerBatch(evt->data);
+            }
+            break;
         case kTouchEvent:
             {
                 return handleTouchEvent(evt->data);
@@ -371,6 +376,20 @@ int LuaEngine::handleScheduler(void* data)
     return ret;
 }
 
+int LuaEngine::handleSchedulerBatch(void* data)
+{
+    if (NULL == data)
+        return 0;
+    
+    SchedulerBatchScriptData* batchInfo = static_cast<SchedulerBatchScriptData*>(data);
+    
+    _stack->pushFloat(batchInfo->elapse);
+    int ret = _stack->executeFunctionsByHandlers(batchInfo->handlers, 1, batchInfo->isActive);
+    _stack->clean();
+    
+    return ret;
+}
+
 int LuaEngine::handleKeypadEvent(void* data)
 {
     if (NULL == data)
@@ -139,6 +139,7 @@ private:
     int handleMenuClickedEvent(void* data);
     int handleCallFuncActionEvent(void* data);
     int handleScheduler(void* data);
+    int handleSchedulerBatch(void* data);
     int handleKeypadEvent(void* data);
     int handleAccelerometerEvent(void* data);
     int handleCommonEvent(void* data);
@@ -34,6 +34,7 @@ extern "C" {
 }
 
 #include "Cocos2dxLuaLoader.h"
+#include "CCLuaBytecodeCache.h"
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
 #include "platform/ios/CCLuaObjcBridge.h"
@@ -145,8 +146,10 @@ NS_CC_BEGIN
 
 LuaStack::~LuaStack()
 {
+    CC_SAFE_DELETE(_bytecodeCache);
     if (nullptr != _state)
     {
+        unregister_value_type_refs(_state);
         lua_close(_state);
     }
 }
@@ -182,6 +185,7 @@ bool LuaStack::init(void)
     luaL_register(_state, "_G", global_functions);
 
     g_luaType.clear();
+    register_value_type_refs(_state);
     register_all_cocos2dx(_state);
     tolua_opengl_open(_state);
     register_all_cocos2dx_manual(_state);
@@ -480,6 +484,102 @@ int LuaStack::executeFunctionByHandler(int nHandler, int numArgs)
     return ret;
 }
 
+// The loop run by executeFunctionsByHandlers. cursor[1] holds the index of the handler being called,
+// so that the loop can be resumed after the handler that raised an error.
+static const char* s_batchCallLoop =
+    "local mapping, handlers, cursor, count, isActive = ...\n"
+    "for i = cursor[1], count do\n"
+    "    cursor[1] = i\n"
+    "    local func = mapping[handlers[i]]\n"
+    "    if func and (not isActive or isActive(i)) then func(select(6, ...)) end\n"
+    "end\n"
+    "return 1\n";
+
+// isActive of the batch call loop, its upvalue is the std::function of executeFunctionsByHandlers
+static int batchCallIsActive(lua_State* L)
+{
+    auto isActive = static_cast<const std::function<bool(int)>*>(lua_touserdata(L, lua_upvalueindex(1)));
+    lua_pushboolean(L, (*isActive)((int)lua_tointeger(L, 1) - 1));
+    return 1;
+}
+
+static const char* s_batchCallLoopKey = "cc_batch_call_loop";
+
+int LuaStack::executeFunctionsByHandlers(const std::vector<int>& handlers, int numArgs, const std::function<bool(int)>& isActive)
+{
+    const int count = (int)handlers.size();
+    const int firstArg = lua_gettop(_state) - numArgs + 1;           /* L: ... arg1 arg2 ... */
+    
+    lua_pushstring(_state, s_batchCallLoopKey);
+    lua_rawget(_state, LUA_REGISTRYINDEX);                             /* L: ... args loop */
+    if (!lua_isfunction(_state, -1))
+    {
+        lua_pop(_state, 1);
+        if (luaL_loadbuffer(_state, s_batchCallLoop, strlen(s_batchCallLoop), "[batch call loop]") != 0)
+        {
+            CCLOG("[LUA ERROR] %s", lua_tostring(_state, -1));
+            lua_settop(_state, 0);
+            return 0;
+        }
+        lua_pushstring(_state, s_batchCallLoopKey);
+        lua_pushvalue(_state, -2);
+        lua_rawset(_state, LUA_REGISTRYINDEX);                         /* L: ... args loop */
+    }
+    const int loop = lua_gettop(_state);
+    
+    lua_createtable(_state, count, 0);                                 /* L: ... args loop handlers */
+    for (int i = 0; i < count; ++i)
+    {
+        lua_pushinteger(_state, handlers[i]);
+        lua_rawseti(_state, -2, i + 1);
+    }
+    lua_createtable(_state, 1, 0);                                     /* L: ... args loop handlers cursor */
+    const int cursor = lua_gettop(_state);
+    if (isActive)
+    {
+        lua_pushlightuserdata(_state, const_cast<std::function<bool(int)>*>(&isActive));
+        lua_pushcclosure(_state, batchCallIsActive, 1);                /* L: ... args loop handlers cursor isActive */
+    }
+    else
+    {
+        lua_pushnil(_state);                                           /* L: ... args loop handlers cursor nil */
+    }
+    const int active = lua_gettop(_state);
+    
+    int ret = 1;
+    int first = 1;
+    while (first <= count)
+    {
+        lua_pushinteger(_state, first);
+        lua_rawseti(_state, cursor, 1);
+        
+        lua_pushvalue(_state, loop);                                   /* L: ... loop */
+        lua_pushstring(_state, TOLUA_REFID_FUNCTION_MAPPING);
+        lua_rawget(_state, LUA_REGISTRYINDEX);                         /* L: ... loop mapping */
+        lua_pushvalue(_state, loop + 1);                               /* L: ... loop mapping handlers */
+        lua_pushvalue(_state, cursor);                                 /* L: ... loop mapping handlers cursor */
+        lua_pushinteger(_state, count);                                /* L: ... loop mapping handlers cursor count */
+        lua_pushvalue(_state, active);                                 /* L: ... loop mapping handlers cursor count isActive */
+        for (int i = 0; i < numArgs; ++i)
+        {
+            lua_pushvalue(_state, firstArg + i);                       /* L: ... loop mapping handlers cursor count isActive arg1 arg2 ... */
+        }
+        
+        if (executeFunction(5 + numArgs) == 0)
+        {
+            // a handler failed and was already reported, carry on with the next one
+            ret = 0;
+        }
+        
+        lua_rawgeti(_state, cursor, 1);
+        first = (int)lua_tointeger(_state, -1) + 1;
+        lua_pop(_state, 1);
+    }
+    
+    lua_settop(_state, 0);
+    return ret;
+}
+
 bool LuaStack::handleAssert(const char *msg)
 {
     if (_callFromLua == 0) return false;
@@ -777,4 +877,112 @@ int LuaStack::luaLoadBuffer(lua_State *L, const char *chunk, int chunkSize, cons
     return r;
 }
 
+bool LuaStack::openBytecodeCache(const std::string& fullPath, bool verifySources)
+{
+    closeBytecodeCache();
+    
+    _bytecodeCache = new (std::nothrow) LuaBytecodeCache();
+    if (nullptr == _bytecodeCache)
+        return false;
+    
+    _verifyBytecodeSources = verifySources;
+    return _bytecodeCache->open(fullPath);
+}
+
+bool LuaStack::saveBytecodeCache()
+{
+    if (nullptr == _bytecodeCache || !_verifyBytecodeSources)
+        return false;
+    
+    CCLOG("[LUA] %d modules loaded in %.3f s, %d from the bytecode cache",
+          _moduleLoadCount, _moduleLoadTime, _cachedModuleLoadCount);
+    
+    if (!_bytecodeCache->isDirty())
+        return true;
+    return _bytecodeCache->save();
+}
+
+void LuaStack::closeBytecodeCache()
+{
+    CC_SAFE_DELETE(_bytecodeCache);
+}
+
+static int luaBytecodeWriter(lua_State *L, const void *p, size_t size, void *ud)
+{
+    static_cast<std::string*>(ud)->append(static_cast<const char*>(p), size);
+    return 0;
+}
+
+int LuaStack::luaLoadModule(lua_State *L, const std::string& moduleName, const char *chunk, int chunkSize, const char *chunkName)
+{
+    ++_moduleLoadCount;
+    
+    // precompiled files are loaded as they are
+    if (nullptr == _bytecodeCache || chunkSize <= 0 || chunk[0] == '\033')
+    {
+        return luaLoadBuffer(L, chunk, chunkSize, chunkName);
+    }
+    
+    uint32_t sourceHash = LuaBytecodeCache::hashSource(chunk, chunkSize);
+    ssize_t bytecodeSize = 0;
+    uint32_t cachedHash = 0;
+    const char* bytecode = _bytecodeCache->findChunk(moduleName, &bytecodeSize, &cachedHash);
+    if (bytecode && cachedHash == sourceHash)
+    {
+        if (luaLoadBuffer(L, bytecode, (int)bytecodeSize, chunkName) == 0)
+        {
+            ++_cachedModuleLoadCount;
+            return 0;
+        }
+        // written by another version of Lua, compile the source again
+        lua_pop(L, 1);
+    }
+    
+    int r = luaLoadBuffer(L, chunk, chunkSize, chunkName);
+    if (r == 0 && _verifyBytecodeSources)
+    {
+        std::string dump;
+        if (lua_dump(L, luaBytecodeWriter, &dump) == 0 && !dump.empty())
+        {
+            // cached chunks are as protected as the scripts
+            if (_xxteaEnabled)
+            {
+                xxtea_long len = 0;
+                unsigned char* result = xxtea_encrypt((unsigned char*)dump.data(),
+                                                      (xxtea_long)dump.size(),
+                                                      (unsigned char*)_xxteaKey,
+                                                      (xxtea_long)_xxteaKeyLen,
+                                                      &len);
+                dump.assign(_xxteaSign, _xxteaSignLen);
+                dump.append((char*)result, len);
+                free(result);
+            }
+            _bytecodeCache->addChunk(moduleName, sourceHash, dump.data(), dump.size());
+        }
+    }
+    return r;
+}
+
+bool LuaStack::luaLoadCachedModule(lua_State *L, const std::string& moduleName)
+{
+    if (nullptr == _bytecodeCache || _verifyBytecodeSources)
+        return false;
+    
+    ssize_t bytecodeSize = 0;
+    uint32_t sourceHash = 0;
+    const char* bytecode = _bytecodeCache->findChunk(moduleName, &bytecodeSize, &sourceHash);
+    if (nullptr == bytecode)
+        return false;
+    
+    if (luaLoadBuffer(L, bytecode, (int)bytecodeSize, moduleName.c_str()) != 0)
+    {
+        lua_pop(L, 1);
+        return false;
+    }
+    
+    ++_moduleLoadCount;
+    ++_cachedModuleLoadCount;
+    return true;
+}
+
 NS_CC_END
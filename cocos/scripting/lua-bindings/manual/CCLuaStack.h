@@ -35,6 +35,8 @@ extern "C" {
 
 NS_CC_BEGIN
 
+class LuaBytecodeCache;
+
 class LuaStack : public Ref
 {
 public:
@@ -124,6 +126,13 @@ public:
     virtual int executeFunction(int numArgs);
     
     virtual int executeFunctionByHandler(int nHandler, int numArgs);
+    
+    /** Calls every handler with the numArgs arguments on the top of the stack from a single lua loop.
+     Handlers released while the loop runs are skipped, as well as those for which isActive, when set,
+     returns false when the loop reaches them. An error in one handler is reported without stopping
+     the ones after it. Returns 0 if any handler raised an error, 1 otherwise.
+     */
+    virtual int executeFunctionsByHandlers(const std::vector<int>& handlers, int numArgs, const std::function<bool(int)>& isActive = nullptr);
     virtual int executeFunctionReturnArray(int handler,int numArgs,int numResults,__Array& resultArray);
     virtual int executeFunction(int handler, int numArgs, int numResults, const std::function<void(lua_State*,int)>& func);
 
@@ -134,6 +143,43 @@ public:
     
     int luaLoadBuffer(lua_State *L, const char *chunk, int chunkSize, const char *chunkName);
     
+    /**
+     @brief Uses an archive of precompiled chunks to load the required modules, see LuaBytecodeCache.
+     @param fullPath Path of the archive. It doesn't have to exist, saveBytecodeCache() creates it.
+     @param verifySources When true, a cached chunk is only used if its source file didn't change, and the modules
+     compiled from source are written to the archive by saveBytecodeCache(). When false, the archive was made at build
+     time and the cached modules are loaded without looking for their source.
+     @return false if the archive doesn't exist or can't be used.
+     */
+    virtual bool openBytecodeCache(const std::string& fullPath, bool verifySources = true);
+    
+    /**
+     @brief Writes the modules compiled since openBytecodeCache() to the archive. Call it once the scripts needed at
+     start up are loaded.
+     */
+    virtual bool saveBytecodeCache();
+    
+    virtual void closeBytecodeCache();
+    
+    /**
+     @brief Loads the chunk of a module, using the bytecode cache when its source didn't change.
+     */
+    int luaLoadModule(lua_State *L, const std::string& moduleName, const char *chunk, int chunkSize, const char *chunkName);
+    
+    /**
+     @brief Loads a module from a bytecode cache opened without verifySources, without reading its source.
+     @return false if the module isn't in the cache.
+     */
+    bool luaLoadCachedModule(lua_State *L, const std::string& moduleName);
+    
+    /** Time spent by the lua loader, in seconds, to find and load the required modules. */
+    float getModuleLoadTime() const { return _moduleLoadTime; }
+    void addModuleLoadTime(float seconds) { _moduleLoadTime += seconds; }
+    
+    /** Number of modules loaded by the lua loader, and how many of them came from the bytecode cache. */
+    int getModuleLoadCount() const { return _moduleLoadCount; }
+    int getCachedModuleLoadCount() const { return _cachedModuleLoadCount; }
+    
 protected:
     LuaStack(void)
     : _state(nullptr)
@@ -143,6 +189,11 @@ protected:
     , _xxteaKeyLen(0)
     , _xxteaSign(nullptr)
     , _xxteaSignLen(0)
+    , _bytecodeCache(nullptr)
+    , _verifyBytecodeSources(true)
+    , _moduleLoadTime(0)
+    , _moduleLoadCount(0)
+    , _cachedModuleLoadCount(0)
     {
     }
     
@@ -156,6 +207,11 @@ protected:
     int   _xxteaKeyLen;
     char* _xxteaSign;
     int   _xxteaSignLen;
+    LuaBytecodeCache* _bytecodeCache;
+    bool  _verifyBytecodeSources;
+    float _moduleLoadTime;
+    int   _moduleLoadCount;
+    int   _cachedModuleLoadCount;
 };
 
 NS_CC_END
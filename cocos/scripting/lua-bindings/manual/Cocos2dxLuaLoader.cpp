@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "Cocos2dxLuaLoader.h"
 #include <string>
 #include <algorithm>
+#include <chrono>
 
 #include "CCLuaStack.h"
 #include "CCLuaEngine.h"
@@ -60,6 +61,16 @@ extern "C"
             pos = filename.find_first_of(".");
         }
         
+        auto startTime = std::chrono::steady_clock::now();
+        LuaStack* stack = LuaEngine::getInstance()->getLuaStack();
+        
+        // a bytecode cache made at build time is used without looking for the source
+        if (stack->luaLoadCachedModule(L, filename))
+        {
+            stack->addModuleLoadTime(std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count());
+            return 1;
+        }
+        
         // search file in package.path
         unsigned char* chunk = nullptr;
         ssize_t chunkSize = 0;
@@ -106,9 +117,9 @@ extern "C"
         
         if (chunk)
         {
-            LuaStack* stack = LuaEngine::getInstance()->getLuaStack();
-            stack->luaLoadBuffer(L, (char*)chunk, (int)chunkSize, chunkName.c_str());
+            stack->luaLoadModule(L, filename, (char*)chunk, (int)chunkSize, chunkName.c_str());
             delete []chunk;
+            stack->addModuleLoadTime(std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count());
         }
         else
         {
@@ -25,11 +25,215 @@
 #include "LuaBasicConversions.h"
 #include "tolua_fix.h"
 
+extern "C" {
+#include "lauxlib.h"
+}
+
 
 
 std::unordered_map<std::string, std::string>  g_luaType;
 std::unordered_map<std::string, std::string>  g_typeCast;
 
+// Field names of the value type tables (Vec2, Size, Rect, colors...). They are kept referenced
+// from the registry, so reading or writing a field doesn't intern its name again.
+enum ValueKey
+{
+    VALUE_KEY_X,
+    VALUE_KEY_Y,
+    VALUE_KEY_Z,
+    VALUE_KEY_WIDTH,
+    VALUE_KEY_HEIGHT,
+    VALUE_KEY_R,
+    VALUE_KEY_G,
+    VALUE_KEY_B,
+    VALUE_KEY_A,
+    VALUE_KEY_COUNT
+};
+
+static const char* s_valueKeyNames[VALUE_KEY_COUNT] = { "x", "y", "z", "width", "height", "r", "g", "b", "a" };
+
+// Tables returned to scripts when luaval_set_value_table_reuse() is enabled, one per type.
+enum ValueTable
+{
+    VALUE_TABLE_VEC2,
+    VALUE_TABLE_VEC3,
+    VALUE_TABLE_SIZE,
+    VALUE_TABLE_RECT,
+    VALUE_TABLE_COLOR3B,
+    VALUE_TABLE_COLOR4B,
+    VALUE_TABLE_COLOR4F,
+    VALUE_TABLE_COUNT
+};
+
+struct ValueTypeRefs
+{
+    const void* registry;
+    int keys[VALUE_KEY_COUNT];
+    int tables[VALUE_TABLE_COUNT];
+};
+
+// one set of references per main state, keyed by its registry
+static std::unordered_map<const void*, ValueTypeRefs> s_valueTypeRefs;
+static const ValueTypeRefs* s_lastValueTypeRefs = nullptr;
+static bool s_reuseValueTables = false;
+
+static void unref_value_type_refs(lua_State* L, const ValueTypeRefs& refs)
+{
+    for (int i = 0; i < VALUE_KEY_COUNT; ++i)
+        luaL_unref(L, LUA_REGISTRYINDEX, refs.keys[i]);
+    for (int i = 0; i < VALUE_TABLE_COUNT; ++i)
+        luaL_unref(L, LUA_REGISTRYINDEX, refs.tables[i]);
+}
+
+void register_value_type_refs(lua_State* L)
+{
+    if (nullptr == L)
+        return;
+
+    const void* registry = lua_topointer(L, LUA_REGISTRYINDEX);
+    auto iter = s_valueTypeRefs.find(registry);
+    if (iter != s_valueTypeRefs.end())
+        unref_value_type_refs(L, iter->second);
+
+    ValueTypeRefs& refs = s_valueTypeRefs[registry];
+    for (int i = 0; i < VALUE_KEY_COUNT; ++i)
+    {
+        lua_pushstring(L, s_valueKeyNames[i]);
+        refs.keys[i] = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+    for (int i = 0; i < VALUE_TABLE_COUNT; ++i)
+    {
+        lua_createtable(L, 0, 4);
+        refs.tables[i] = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+    refs.registry = registry;
+    s_lastValueTypeRefs = &refs;
+}
+
+void unregister_value_type_refs(lua_State* L)
+{
+    if (nullptr == L)
+        return;
+
+    auto iter = s_valueTypeRefs.find(lua_topointer(L, LUA_REGISTRYINDEX));
+    if (iter == s_valueTypeRefs.end())
+        return;
+
+    unref_value_type_refs(L, iter->second);
+    if (s_lastValueTypeRefs == &iter->second)
+        s_lastValueTypeRefs = nullptr;
+    s_valueTypeRefs.erase(iter);
+}
+
+void luaval_set_value_table_reuse(bool reuse)
+{
+    s_reuseValueTables = reuse;
+}
+
+bool luaval_is_value_table_reuse()
+{
+    return s_reuseValueTables;
+}
+
+static inline const ValueTypeRefs& get_value_type_refs(lua_State* L)
+{
+    // coroutines share the registry of their main state
+    const void* registry = lua_topointer(L, LUA_REGISTRYINDEX);
+    if (nullptr == s_lastValueTypeRefs || s_lastValueTypeRefs->registry != registry)
+    {
+        auto iter = s_valueTypeRefs.find(registry);
+        if (iter == s_valueTypeRefs.end())
+            register_value_type_refs(L);
+        else
+            s_lastValueTypeRefs = &iter->second;
+    }
+    return *s_lastValueTypeRefs;
+}
+
+// Reads the numeric fields of the table at lo, either by name or, for an array like {x, y}, by position.
+// Missing fields are read as 0.
+static void read_value_fields(lua_State* L, int lo, const ValueKey* keys, lua_Number* values, int count)
+{
+    if (lo < 0 && lo > LUA_REGISTRYINDEX)
+        lo = lua_gettop(L) + lo + 1;
+
+    lua_rawgeti(L, lo, 1);
+    if (!lua_isnil(L, -1))
+    {
+        values[0] = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+        for (int i = 1; i < count; ++i)
+        {
+            lua_rawgeti(L, lo, i + 1);
+            values[i] = lua_tonumber(L, -1);
+            lua_pop(L, 1);
+        }
+        return;
+    }
+    lua_pop(L, 1);
+
+    const ValueTypeRefs& refs = get_value_type_refs(L);
+    for (int i = 0; i < count; ++i)
+    {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, refs.keys[keys[i]]);  /* L: ... key */
+        lua_gettable(L, lo);                                    /* L: ... table[key] */
+        values[i] = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+    }
+}
+
+// Pushes a table holding the values, the shared table of its type if reuse is true.
+static void push_value_table(lua_State* L, ValueTable type, const ValueKey* keys, const lua_Number* values, int count, bool reuse)
+{
+    const ValueTypeRefs& refs = get_value_type_refs(L);
+    if (reuse)
+        lua_rawgeti(L, LUA_REGISTRYINDEX, refs.tables[type]);
+    else
+        lua_createtable(L, 0, count);                       /* L: table */
+
+    for (int i = 0; i < count; ++i)
+    {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, refs.keys[keys[i]]);  /* L: table key */
+        lua_pushnumber(L, values[i]);                       /* L: table key value*/
+        lua_rawset(L, -3);                                  /* table[key] = value, L: table */
+    }
+}
+
+// Variants which always create a table, for values stored inside other tables or kept by scripts.
+void new_vec2_to_luaval(lua_State* L, const cocos2d::Vec2& vec2)
+{
+    if (NULL  == L)
+        return;
+    static const ValueKey keys[] = { VALUE_KEY_X, VALUE_KEY_Y };
+    const lua_Number values[] = { (lua_Number) vec2.x, (lua_Number) vec2.y };
+    push_value_table(L, VALUE_TABLE_VEC2, keys, values, 2, false);
+}
+
+void new_size_to_luaval(lua_State* L, const Size& sz)
+{
+    if (NULL  == L)
+        return;
+    static const ValueKey keys[] = { VALUE_KEY_WIDTH, VALUE_KEY_HEIGHT };
+    const lua_Number values[] = { (lua_Number) sz.width, (lua_Number) sz.height };
+    push_value_table(L, VALUE_TABLE_SIZE, keys, values, 2, false);
+}
+
+void new_rect_to_luaval(lua_State* L, const Rect& rt)
+{
+    if (NULL  == L)
+        return;
+    static const ValueKey keys[] = { VALUE_KEY_X, VALUE_KEY_Y, VALUE_KEY_WIDTH, VALUE_KEY_HEIGHT };
+    const lua_Number values[] = { (lua_Number) rt.origin.x, (lua_Number) rt.origin.y, (lua_Number) rt.size.width, (lua_Number) rt.size.height };
+    push_value_table(L, VALUE_TABLE_RECT, keys, values, 4, false);
+}
+
+static void new_color3b_to_luaval(lua_State* L, const Color3B& cc)
+{
+    static const ValueKey keys[] = { VALUE_KEY_R, VALUE_KEY_G, VALUE_KEY_B };
+    const lua_Number values[] = { (lua_Number) cc.r, (lua_Number) cc.g, (lua_Number) cc.b };
+    push_value_table(L, VALUE_TABLE_COLOR3B, keys, values, 3, false);
+}
+
 #if COCOS2D_DEBUG >=1
 void luaval_to_native_err(lua_State* L,const char* msg,tolua_Error* err, const char* funcName)
 {
@@ -287,18 +491,13 @@ bool luaval_to_vec2(lua_State* L,int lo,cocos2d::Vec2* outValue, const char* fun
         ok = false;
     }
     
-    
     if (ok)
     {
-        lua_pushstring(L, "x");
-        lua_gettable(L, lo);
-        outValue->x = lua_isnil(L, -1) ? 0 : lua_tonumber(L, -1);
-        lua_pop(L, 1);
-        
-        lua_pushstring(L, "y");
-        lua_gettable(L, lo);
-        outValue->y = lua_isnil(L, -1) ? 0 : lua_tonumber(L, -1);
-        lua_pop(L, 1);
+        static const ValueKey keys[] = { VALUE_KEY_X, VALUE_KEY_Y };
+        lua_Number values[2];
+        read_value_fields(L, lo, keys, values, 2);
+        outValue->x = values[0];
+        outValue->y = values[1];
     }
     return ok;
 }
@@ -319,23 +518,14 @@ bool luaval_to_vec3(lua_State* L,int lo,cocos2d::Vec3* outValue, const char* fun
         ok = false;
     }
     
-    
     if (ok)
     {
-        lua_pushstring(L, "x");
-        lua_gettable(L, lo);
-        outValue->x = lua_isnil(L, -1) ? 0 : lua_tonumber(L, -1);
-        lua_pop(L, 1);
-        
-        lua_pushstring(L, "y");
-        lua_gettable(L, lo);
-        outValue->y = lua_isnil(L, -1) ? 0 : lua_tonumber(L, -1);
-        lua_pop(L, 1);
-        
-        lua_pushstring(L, "z");
-        lua_gettable(L, lo);
-        outValue->z = lua_isnil(L, -1) ? 0 : lua_tonumber(L, -1);
-        lua_pop(L, 1);
+        static const ValueKey keys[] = { VALUE_KEY_X, VALUE_KEY_Y, VALUE_KEY_Z };
+        lua_Number values[3];
+        read_value_fields(L, lo, keys, values, 3);
+        outValue->x = values[0];
+        outValue->y = values[1];
+        outValue->z = values[2];
     }
     return ok;
 }
@@ -522,15 +712,11 @@ bool luaval_to_size(lua_State* L,int lo,Size* outValue, const char* funcName)
     
     if (ok)
     {
-        lua_pushstring(L, "width");  /* L: paramStack key */
-        lua_gettable(L,lo);/* L: paramStack paramStack[lo][key] */
-        outValue->width = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);/* L: paramStack*/
-        
-        lua_pushstring(L, "height");
-        lua_gettable(L,lo);
-        outValue->height = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
+        static const ValueKey keys[] = { VALUE_KEY_WIDTH, VALUE_KEY_HEIGHT };
+        lua_Number values[2];
+        read_value_fields(L, lo, keys, values, 2);
+        outValue->width = values[0];
+        outValue->height = values[1];
     }
     
     return ok;
@@ -554,25 +740,13 @@ bool luaval_to_rect(lua_State* L,int lo,Rect* outValue, const char* funcName)
     
     if (ok)
     {
-        lua_pushstring(L, "x");
-        lua_gettable(L,lo);
-        outValue->origin.x = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "y");
-        lua_gettable(L,lo);
-        outValue->origin.y = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "width");
-        lua_gettable(L,lo);
-        outValue->size.width = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "height");
-        lua_gettable(L,lo);
-        outValue->size.height = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
+        static const ValueKey keys[] = { VALUE_KEY_X, VALUE_KEY_Y, VALUE_KEY_WIDTH, VALUE_KEY_HEIGHT };
+        lua_Number values[4];
+        read_value_fields(L, lo, keys, values, 4);
+        outValue->origin.x = values[0];
+        outValue->origin.y = values[1];
+        outValue->size.width = values[2];
+        outValue->size.height = values[3];
     }
     
     return ok;
@@ -594,27 +768,15 @@ bool luaval_to_color4b(lua_State* L,int lo,Color4B* outValue, const char* funcNa
         ok = false;
     }
     
-    if(ok)
+    if (ok)
     {
-        lua_pushstring(L, "r");
-        lua_gettable(L,lo);
-        outValue->r = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "g");
-        lua_gettable(L,lo);
-        outValue->g = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "b");
-        lua_gettable(L,lo);
-        outValue->b = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "a");
-        lua_gettable(L,lo);
-        outValue->a = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
+        static const ValueKey keys[] = { VALUE_KEY_R, VALUE_KEY_G, VALUE_KEY_B, VALUE_KEY_A };
+        lua_Number values[4];
+        read_value_fields(L, lo, keys, values, 4);
+        outValue->r = (GLubyte)values[0];
+        outValue->g = (GLubyte)values[1];
+        outValue->b = (GLubyte)values[2];
+        outValue->a = (GLubyte)values[3];
     }
     
     return ok;
@@ -638,25 +800,13 @@ bool luaval_to_color4f(lua_State* L,int lo,Color4F* outValue, const char* funcNa
     
     if (ok)
     {
-        lua_pushstring(L, "r");
-        lua_gettable(L,lo);
-        outValue->r = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "g");
-        lua_gettable(L,lo);
-        outValue->g = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "b");
-        lua_gettable(L,lo);
-        outValue->b = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "a");
-        lua_gettable(L,lo);
-        outValue->a = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
+        static const ValueKey keys[] = { VALUE_KEY_R, VALUE_KEY_G, VALUE_KEY_B, VALUE_KEY_A };
+        lua_Number values[4];
+        read_value_fields(L, lo, keys, values, 4);
+        outValue->r = (float)values[0];
+        outValue->g = (float)values[1];
+        outValue->b = (float)values[2];
+        outValue->a = (float)values[3];
     }
     
     return ok;
@@ -680,20 +830,12 @@ bool luaval_to_color3b(lua_State* L,int lo,Color3B* outValue, const char* funcNa
     
     if (ok)
     {
-        lua_pushstring(L, "r");
-        lua_gettable(L,lo);
-        outValue->r = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "g");
-        lua_gettable(L,lo);
-        outValue->g = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
-        
-        lua_pushstring(L, "b");
-        lua_gettable(L,lo);
-        outValue->b = lua_isnil(L,-1) ? 0 : lua_tonumber(L,-1);
-        lua_pop(L,1);
+        static const ValueKey keys[] = { VALUE_KEY_R, VALUE_KEY_G, VALUE_KEY_B };
+        lua_Number values[3];
+        read_value_fields(L, lo, keys, values, 3);
+        outValue->r = (GLubyte)values[0];
+        outValue->g = (GLubyte)values[1];
+        outValue->b = (GLubyte)values[2];
     }
     
     return ok;
@@ -2005,7 +2147,7 @@ void vec2_array_to_luaval(lua_State* L,const cocos2d::Vec2* points, int count)
     for (int i = 1; i <= count; ++i)
     {
         lua_pushnumber(L, i);
-        vec2_to_luaval(L, points[i-1]);
+        new_vec2_to_luaval(L, points[i-1]);
         lua_rawset(L, -3);
     }
 }
@@ -2014,31 +2156,18 @@ void vec2_to_luaval(lua_State* L,const cocos2d::Vec2& vec2)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
-    lua_pushstring(L, "x");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) vec2.x);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "y");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) vec2.y);               /* L: table key value*/
-    lua_rawset(L, -3);
-    
+    static const ValueKey keys[] = { VALUE_KEY_X, VALUE_KEY_Y };
+    const lua_Number values[] = { (lua_Number) vec2.x, (lua_Number) vec2.y };
+    push_value_table(L, VALUE_TABLE_VEC2, keys, values, 2, s_reuseValueTables);
 }
 
 void vec3_to_luaval(lua_State* L,const cocos2d::Vec3& vec3)
 {
     if (NULL  == L)
         return;
-    
-    lua_newtable(L);                                    /* L: table */
-    lua_pushstring(L, "x");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) vec3.x);             /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "y");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) vec3.y);             /* L: table key value*/
-    lua_rawset(L, -3);
-    lua_pushstring(L, "z");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) vec3.z);             /* L: table key value*/
-    lua_rawset(L, -3);
+    static const ValueKey keys[] = { VALUE_KEY_X, VALUE_KEY_Y, VALUE_KEY_Z };
+    const lua_Number values[] = { (lua_Number) vec3.x, (lua_Number) vec3.y, (lua_Number) vec3.z };
+    push_value_table(L, VALUE_TABLE_VEC3, keys, values, 3, s_reuseValueTables);
 }
 
 void vec4_to_luaval(lua_State* L,const cocos2d::Vec4& vec4)
@@ -2098,19 +2227,19 @@ void physics_raycastinfo_to_luaval(lua_State* L, const PhysicsRayCastInfo& info)
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     lua_pushstring(L, "start");                   /* L: table key */
-    vec2_to_luaval(L, info.start);
+    new_vec2_to_luaval(L, info.start);
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     lua_pushstring(L, "ended");                   /* L: table key */
-    vec2_to_luaval(L, info.end);
+    new_vec2_to_luaval(L, info.end);
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     lua_pushstring(L, "contact");                   /* L: table key */
-    vec2_to_luaval(L, info.contact);
+    new_vec2_to_luaval(L, info.contact);
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     lua_pushstring(L, "normal");                   /* L: table key */
-    vec2_to_luaval(L, info.normal);
+    new_vec2_to_luaval(L, info.normal);
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     lua_pushstring(L, "fraction");                      /* L: table key */
@@ -2130,7 +2259,7 @@ void physics_contactdata_to_luaval(lua_State* L, const PhysicsContactData* data)
     lua_rawset(L, -3);
     
     lua_pushstring(L, "normal");
-    vec2_to_luaval(L, data->normal);
+    new_vec2_to_luaval(L, data->normal);
     lua_rawset(L, -3);
     
     lua_pushstring(L, "POINT_MAX");
@@ -2142,86 +2271,45 @@ void size_to_luaval(lua_State* L,const Size& sz)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
-    lua_pushstring(L, "width");                         /* L: table key */
-    lua_pushnumber(L, (lua_Number) sz.width);           /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "height");                        /* L: table key */
-    lua_pushnumber(L, (lua_Number) sz.height);          /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
+    static const ValueKey keys[] = { VALUE_KEY_WIDTH, VALUE_KEY_HEIGHT };
+    const lua_Number values[] = { (lua_Number) sz.width, (lua_Number) sz.height };
+    push_value_table(L, VALUE_TABLE_SIZE, keys, values, 2, s_reuseValueTables);
 }
 
 void rect_to_luaval(lua_State* L,const Rect& rt)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
-    lua_pushstring(L, "x");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) rt.origin.x);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "y");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) rt.origin.y);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "width");                         /* L: table key */
-    lua_pushnumber(L, (lua_Number) rt.size.width);           /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "height");                        /* L: table key */
-    lua_pushnumber(L, (lua_Number) rt.size.height);          /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
+    static const ValueKey keys[] = { VALUE_KEY_X, VALUE_KEY_Y, VALUE_KEY_WIDTH, VALUE_KEY_HEIGHT };
+    const lua_Number values[] = { (lua_Number) rt.origin.x, (lua_Number) rt.origin.y, (lua_Number) rt.size.width, (lua_Number) rt.size.height };
+    push_value_table(L, VALUE_TABLE_RECT, keys, values, 4, s_reuseValueTables);
 }
 
 void color4b_to_luaval(lua_State* L,const Color4B& cc)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
-    lua_pushstring(L, "r");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.r);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "g");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.g);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "b");                         /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.b);           /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "a");                        /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.a);          /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
+    static const ValueKey keys[] = { VALUE_KEY_R, VALUE_KEY_G, VALUE_KEY_B, VALUE_KEY_A };
+    const lua_Number values[] = { (lua_Number) cc.r, (lua_Number) cc.g, (lua_Number) cc.b, (lua_Number) cc.a };
+    push_value_table(L, VALUE_TABLE_COLOR4B, keys, values, 4, s_reuseValueTables);
 }
 
 void color4f_to_luaval(lua_State* L,const Color4F& cc)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
-    lua_pushstring(L, "r");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.r);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "g");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.g);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "b");                         /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.b);           /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "a");                        /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.a);          /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
+    static const ValueKey keys[] = { VALUE_KEY_R, VALUE_KEY_G, VALUE_KEY_B, VALUE_KEY_A };
+    const lua_Number values[] = { (lua_Number) cc.r, (lua_Number) cc.g, (lua_Number) cc.b, (lua_Number) cc.a };
+    push_value_table(L, VALUE_TABLE_COLOR4F, keys, values, 4, s_reuseValueTables);
 }
 
 void color3b_to_luaval(lua_State* L,const Color3B& cc)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
-    lua_pushstring(L, "r");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.r);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "g");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.g);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
-    lua_pushstring(L, "b");                             /* L: table key */
-    lua_pushnumber(L, (lua_Number) cc.b);               /* L: table key value*/
-    lua_rawset(L, -3);                                  /* table[key] = value, L: table */
+    static const ValueKey keys[] = { VALUE_KEY_R, VALUE_KEY_G, VALUE_KEY_B };
+    const lua_Number values[] = { (lua_Number) cc.r, (lua_Number) cc.g, (lua_Number) cc.b };
+    push_value_table(L, VALUE_TABLE_COLOR3B, keys, values, 3, s_reuseValueTables);
 }
 
 void affinetransform_to_luaval(lua_State* L,const AffineTransform& inValue)
@@ -2269,10 +2357,10 @@ void fontdefinition_to_luaval(lua_State* L,const FontDefinition& inValue)
     lua_pushnumber(L, (lua_Number) inValue._vertAlignment);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     lua_pushstring(L, "fontFillColor");                             /* L: table key */
-    color3b_to_luaval(L, inValue._fontFillColor);               /* L: table key value*/
+    new_color3b_to_luaval(L, inValue._fontFillColor);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     lua_pushstring(L, "fontDimensions");                             /* L: table key */
-    size_to_luaval(L, inValue._dimensions);              /* L: table key value*/
+    new_size_to_luaval(L, inValue._dimensions);              /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     //Shadow
@@ -2281,7 +2369,7 @@ void fontdefinition_to_luaval(lua_State* L,const FontDefinition& inValue)
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     lua_pushstring(L, "shadowOffset");                             /* L: table key */
-    size_to_luaval(L, inValue._shadow._shadowOffset);              /* L: table key value*/
+    new_size_to_luaval(L, inValue._shadow._shadowOffset);              /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     lua_pushstring(L, "shadowBlur");                             /* L: table key */
@@ -2298,7 +2386,7 @@ void fontdefinition_to_luaval(lua_State* L,const FontDefinition& inValue)
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     lua_pushstring(L, "strokeColor");                             /* L: table key */
-    color3b_to_luaval(L, inValue._stroke._strokeColor);              /* L: table key value*/
+    new_color3b_to_luaval(L, inValue._stroke._strokeColor);              /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
     
     lua_pushstring(L, "strokeSize");                             /* L: table key */
@@ -45,6 +45,31 @@ cocos2d::log("lua: ERROR: File %s: Line: %d, Function: %s", __FILE__, __LINE__,
 cocos2d::log(__VA_ARGS__);                                                  \
 }                                                                           \
 
+/**
+ * Creates the registry references used to convert the value types (Vec2, Size, Rect, colors...).
+ * Done by LuaStack::init(), and lazily for other states.
+ */
+extern void register_value_type_refs(lua_State* L);
+/** Releases the references of register_value_type_refs(), to call before closing the state. */
+extern void unregister_value_type_refs(lua_State* L);
+
+/**
+ * When enabled, vec2_to_luaval() and the other value type conversions used for return values
+ * fill one shared table per type instead of creating a table per call. A returned table is then
+ * overwritten by the next call returning the same type, so scripts must copy what they keep.
+ * Disabled by default.
+ */
+extern void luaval_set_value_table_reuse(bool reuse);
+extern bool luaval_is_value_table_reuse();
+
+/**
+ * Always push a new table, whether value tables are reused or not.
+ * For values scripts are expected to keep, like the ones returned by constructors.
+ */
+extern void new_vec2_to_luaval(lua_State* L, const cocos2d::Vec2& vec2);
+extern void new_size_to_luaval(lua_State* L, const Size& sz);
+extern void new_rect_to_luaval(lua_State* L, const Rect& rt);
+
 extern bool luaval_is_usertype(lua_State* L,int lo,const char* type, int def);
 // to native
 extern bool luaval_to_ulong(lua_State* L,int lo, unsigned long* outValue, const char* funcName="");
@@ -246,7 +246,7 @@ static int tolua_Cocos2d_CCRect_new00(lua_State* tolua_S)
 #endif
     {
         Rect tolua_ret;
-        rect_to_luaval(tolua_S, tolua_ret);
+        new_rect_to_luaval(tolua_S, tolua_ret);
     }
     return 1;
 #ifndef TOLUA_RELEASE
@@ -272,7 +272,7 @@ static int tolua_Cocos2d_CCRect_new00_local(lua_State* tolua_S)
 #endif
     {
         Rect tolua_ret;
-        rect_to_luaval(tolua_S, tolua_ret);
+        new_rect_to_luaval(tolua_S, tolua_ret);
     }
     return 1;
 #ifndef TOLUA_RELEASE
@@ -303,7 +303,7 @@ static int tolua_Cocos2d_CCRect_new01(lua_State* tolua_S)
         float width = ((float)  tolua_tonumber(tolua_S,4,0));
         float height = ((float)  tolua_tonumber(tolua_S,5,0));
         Rect tolua_ret(x, y, width, height);
-        rect_to_luaval(tolua_S, tolua_ret);
+        new_rect_to_luaval(tolua_S, tolua_ret);
     }
     return 1;
 tolua_lerror:
@@ -332,7 +332,7 @@ static int tolua_Cocos2d_CCRect_new01_local(lua_State* tolua_S)
         float width = ((float)  tolua_tonumber(tolua_S,4,0));
         float height = ((float)  tolua_tonumber(tolua_S,5,0));
         Rect tolua_ret(x, y, width, height);
-        rect_to_luaval(tolua_S, tolua_ret);
+        new_rect_to_luaval(tolua_S, tolua_ret);
     }
     return 1;
 tolua_lerror:
@@ -371,7 +371,7 @@ static int tolua_Cocos2d_CCSize_new00(lua_State* tolua_S)
 #endif
     {
         Size tolua_ret;
-        size_to_luaval(tolua_S, tolua_ret);
+        new_size_to_luaval(tolua_S, tolua_ret);
     }
     return 1;
 #ifndef TOLUA_RELEASE
@@ -397,7 +397,7 @@ static int tolua_Cocos2d_CCSize_new00_local(lua_State* tolua_S)
 #endif
     {
         Size tolua_ret;
-        size_to_luaval(tolua_S, tolua_ret);
+        new_size_to_luaval(tolua_S, tolua_ret);
     }
     return 1;
 #ifndef TOLUA_RELEASE
@@ -425,7 +425,7 @@ static int tolua_Cocos2d_CCSize_new01(lua_State* tolua_S)
         float width = ((float)  tolua_tonumber(tolua_S,2,0));
         float height = ((float)  tolua_tonumber(tolua_S,3,0));
         Size tolua_ret(width, height);
-        size_to_luaval(tolua_S, tolua_ret);
+        new_size_to_luaval(tolua_S, tolua_ret);
     }
     return 1;
 tolua_lerror:
@@ -452,7 +452,7 @@ static int tolua_Cocos2d_CCSize_new01_local(lua_State* tolua_S)
         float width = ((float)  tolua_tonumber(tolua_S,2,0));
         float height = ((float)  tolua_tonumber(tolua_S,3,0));
         Size tolua_ret(width, height);
-        size_to_luaval(tolua_S, tolua_ret);
+        new_size_to_luaval(tolua_S, tolua_ret);
     }
     return 1;
 tolua_lerror:
@@ -3669,7 +3669,7 @@ static int lua_cocos2dx_LabelTTF_getDimensions(lua_State* tolua_S)
         if(!ok)
             return 0;
         const cocos2d::Size& ret = cobj->getDimensions();
-        size_to_luaval(tolua_S, ret);
+        new_size_to_luaval(tolua_S, ret);
         return 1;
     }
     CCLOG("%s has wrong number of arguments: %d, was expecting %d \n", "cc.LabelTTF:getDimensions",argc, 0);
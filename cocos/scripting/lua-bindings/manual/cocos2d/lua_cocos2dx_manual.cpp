@@ -7215,6 +7215,31 @@ tolua_lerror:
 #endif
 }
 
+static int tolua_cocos2d_setValueTableReuse(lua_State* tolua_S)
+{
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isboolean(tolua_S, 1, 0, &tolua_err))
+        goto tolua_lerror;
+    else
+#endif
+    {
+        luaval_set_value_table_reuse(tolua_toboolean(tolua_S, 1, 0) != 0);
+        return 0;
+    }
+#if COCOS2D_DEBUG >= 1
+tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'tolua_cocos2d_setValueTableReuse'.",&tolua_err);
+    return 0;
+#endif
+}
+
+static int tolua_cocos2d_isValueTableReuse(lua_State* tolua_S)
+{
+    tolua_pushboolean(tolua_S, luaval_is_value_table_reuse());
+    return 1;
+}
+
 int register_all_cocos2dx_module_manual(lua_State* tolua_S)
 {
     if (nullptr == tolua_S)
@@ -7223,6 +7248,8 @@ int register_all_cocos2dx_module_manual(lua_State* tolua_S)
     tolua_open(tolua_S);
     tolua_module(tolua_S, "cc", 0);
     tolua_beginmodule(tolua_S, "cc");
+        tolua_function(tolua_S, "setValueTableReuse", tolua_cocos2d_setValueTableReuse);
+        tolua_function(tolua_S, "isValueTableReuse", tolua_cocos2d_isValueTableReuse);
         tolua_module(tolua_S, "utils", 0);
         tolua_beginmodule(tolua_S,"utils");
             tolua_function(tolua_S, "captureScreen", tolua_cocos2d_utils_captureScreen);
@@ -10,6 +10,7 @@ LOCAL_SRC_FILES := ../manual/CCLuaBridge.cpp \
           ../manual/CCLuaStack.cpp \
           ../manual/CCLuaValue.cpp \
           ../manual/Cocos2dxLuaLoader.cpp \
+          ../manual/CCLuaBytecodeCache.cpp \
           ../manual/LuaBasicConversions.cpp \
           ../auto/lua_cocos2dx_auto.cpp \
           ../auto/lua_cocos2dx_physics_auto.cpp \
@@ -29,12 +29,14 @@ THE SOFTWARE.
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "base/CCDirector.h"
+#include "base/CCCamera.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "renderer/CCRenderer.h"
 #include "ui/UILayoutManager.h"
 #include "2d/CCDrawNode.h"
 #include "2d/CCLayer.h"
 #include "2d/CCSprite.h"
+#include "2d/CCClippingNode.h"
 #include "base/CCEventFocus.h"
 
 
@@ -46,7 +48,6 @@ static const int BACKGROUNDIMAGE_Z = (-1);
 static const int BCAKGROUNDCOLORRENDERER_Z = (-2);
 
 static GLint g_sStencilBits = -1;
-static GLint s_layer = -1;
     
 IMPLEMENT_CLASS_GUI_INFO(Layout)
 
@@ -72,6 +73,7 @@ _clippingStencil(nullptr),
 _scissorRectDirty(false),
 _clippingRect(Rect::ZERO),
 _clippingParent(nullptr),
+_scissorOldState(GL_FALSE),
 _doLayoutDirty(true),
 _clippingRectDirty(true),
 _currentStencilEnabled(GL_FALSE),
@@ -93,7 +95,7 @@ _loopFocus(false),
 _isFocusPassing(false),
 _isInterceptTouch(false)
 {
-    //no-op
+    _scissorOldBox[0] = _scissorOldBox[1] = _scissorOldBox[2] = _scissorOldBox[3] = 0;
 }
 
 Layout::~Layout()
@@ -207,6 +209,8 @@ bool Layout::isClippingEnabled()const
 
 void Layout::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     if (!_visible)
     {
         return;
@@ -250,18 +254,21 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
     director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
     //Add group command
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
 
     _groupCommand.init(_globalZOrder);
     renderer->addCommand(&_groupCommand);
     
     renderer->pushGroup(_groupCommand.getRenderQueueID());
     
+    ClippingNode::notifyStencilVisit();
     _beforeVisitCmdStencil.init(_globalZOrder);
     _beforeVisitCmdStencil.func = CC_CALLBACK_0(Layout::onBeforeVisitStencil, this);
     renderer->addCommand(&_beforeVisitCmdStencil);
     
     _clippingStencil->visit(renderer, _modelViewTransform, flags);
     
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _afterDrawStencilCmd.init(_globalZOrder);
     _afterDrawStencilCmd.func = CC_CALLBACK_0(Layout::onAfterDrawStencil, this);
     renderer->addCommand(&_afterDrawStencilCmd);
@@ -310,6 +317,7 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
         (*it)->visit(renderer, _modelViewTransform, flags);
 
     
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _afterVisitCmdStencil.init(_globalZOrder);
     _afterVisitCmdStencil.func = CC_CALLBACK_0(Layout::onAfterVisitStencil, this);
     renderer->addCommand(&_afterVisitCmdStencil);
@@ -321,8 +329,8 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
     
 void Layout::onBeforeVisitStencil()
 {
-    s_layer++;
-    GLint mask_layer = 0x1 << s_layer;
+    // the stencil layers are shared with the clipping nodes they nest with
+    GLint mask_layer = 0x1 << ClippingNode::pushStencilLayer();
     GLint mask_layer_l = mask_layer - 1;
     _mask_layer_le = mask_layer | mask_layer_l;
     _currentStencilEnabled = glIsEnabled(GL_STENCIL_TEST);
@@ -405,30 +413,61 @@ void Layout::onAfterVisitStencil()
     {
         glDisable(GL_STENCIL_TEST);
     }
-    s_layer--;
+    ClippingNode::popStencilLayer();
 }
     
 void Layout::onBeforeVisitScissor()
 {
     Rect clippingRect = getClippingRect();
-    glEnable(GL_SCISSOR_TEST);
     auto glview = Director::getInstance()->getOpenGLView();
+
+    // a ClippingNode or a ScrollView may already clip with the scissor test, stay inside it
+    _scissorOldState = glIsEnabled(GL_SCISSOR_TEST);
+    if (_scissorOldState)
+    {
+        glGetIntegerv(GL_SCISSOR_BOX, _scissorOldBox);
+    }
+    else
+    {
+        glEnable(GL_SCISSOR_TEST);
+    }
+
     glview->setScissorInPoints(clippingRect.origin.x, clippingRect.origin.y, clippingRect.size.width, clippingRect.size.height);
+
+    if (_scissorOldState)
+    {
+        GLint box[4];
+        glGetIntegerv(GL_SCISSOR_BOX, box);
+        GLint left = MAX(box[0], _scissorOldBox[0]);
+        GLint bottom = MAX(box[1], _scissorOldBox[1]);
+        GLint right = MIN(box[0] + box[2], _scissorOldBox[0] + _scissorOldBox[2]);
+        GLint top = MIN(box[1] + box[3], _scissorOldBox[1] + _scissorOldBox[3]);
+        glScissor(left, bottom, MAX(right - left, 0), MAX(top - bottom, 0));
+    }
 }
 
 void Layout::onAfterVisitScissor()
 {
-    glDisable(GL_SCISSOR_TEST);
+    if (_scissorOldState)
+    {
+        glScissor(_scissorOldBox[0], _scissorOldBox[1], _scissorOldBox[2], _scissorOldBox[3]);
+    }
+    else
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
 }
     
 void Layout::scissorClippingVisit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags)
 {
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _beforeVisitCmdScissor.init(_globalZOrder);
     _beforeVisitCmdScissor.func = CC_CALLBACK_0(Layout::onBeforeVisitScissor, this);
     renderer->addCommand(&_beforeVisitCmdScissor);
 
     ProtectedNode::visit(renderer, parentTransform, parentFlags);
     
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _afterVisitCmdScissor.init(_globalZOrder);
     _afterVisitCmdScissor.func = CC_CALLBACK_0(Layout::onAfterVisitScissor, this);
     renderer->addCommand(&_afterVisitCmdScissor);
@@ -517,6 +517,9 @@ protected:
     CustomCommand _afterVisitCmdStencil;
     CustomCommand _beforeVisitCmdScissor;
     CustomCommand _afterVisitCmdScissor;
+    // the scissor state of the enclosing clipping, restored after the children are drawn
+    GLboolean _scissorOldState;
+    GLint _scissorOldBox[4];
     
     bool _doLayoutDirty;
     bool _isInterceptTouch;
@@ -26,7 +26,19 @@
 #include "platform/CCFileUtils.h"
 #include "2d/CCLabel.h"
 #include "2d/CCSprite.h"
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontAtlasCache.h"
+#include "2d/CCFont.h"
 #include "base/ccUTF8.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventCustom.h"
+#include "base/CCTrace.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCQuadCommand.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCTexture2D.h"
 #include "ui/UIHelper.h"
 
 NS_CC_BEGIN
@@ -112,20 +124,227 @@ bool RichElementCustomNode::init(int tag, const Color3B &color, GLubyte opacity,
     return false;
 }
     
+/**
+ * Glyph quads of a RichText, grouped by atlas texture.
+ * Each texture is drawn with a single QuadCommand unless it holds more quads than the renderer can batch.
+ */
+class RichTextGlyphBatch : public Node
+{
+public:
+    static RichTextGlyphBatch* create();
+
+    RichTextGlyphBatch();
+    virtual ~RichTextGlyphBatch();
+
+    void clearGlyphs();
+    /** textureRect is in points in the atlas texture, rect in points in the row being laid out. */
+    void addGlyph(Texture2D* texture, const Rect& textureRect, const Rect& rect, const Color3B& color, GLubyte opacity);
+    /** Moves the glyphs added since the previous call to the given position, once the height of their row is known. */
+    void closeLine(float posY);
+
+    virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
+    virtual void updateDisplayedColor(const Color3B& parentColor) override;
+    virtual void updateDisplayedOpacity(GLubyte parentOpacity) override;
+
+protected:
+    static const ssize_t MAX_QUADS_PER_COMMAND = Renderer::VBO_SIZE / 8;
+
+    struct Batch
+    {
+        Texture2D* texture;
+        std::vector<V3F_C4B_T2F_Quad> quads;
+        // colors of the elements, before the displayed color and opacity of the node are applied
+        std::vector<Color4B> colors;
+        size_t lineStart;
+        std::vector<QuadCommand> commands;
+    };
+
+    void updateColors();
+
+    std::vector<Batch> _batches;
+    BlendFunc _blendFunc;
+    bool _colorsDirty;
+};
+
+const ssize_t RichTextGlyphBatch::MAX_QUADS_PER_COMMAND;
+
+RichTextGlyphBatch* RichTextGlyphBatch::create()
+{
+    RichTextGlyphBatch* batch = new (std::nothrow) RichTextGlyphBatch();
+    if (batch && batch->init())
+    {
+        batch->autorelease();
+        return batch;
+    }
+    CC_SAFE_DELETE(batch);
+    return nullptr;
+}
+
+RichTextGlyphBatch::RichTextGlyphBatch()
+: _blendFunc(BlendFunc::ALPHA_NON_PREMULTIPLIED)
+, _colorsDirty(false)
+{
+    // the atlases of TTF fonts are A8 textures, the color comes from the vertices
+    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR));
+}
+
+RichTextGlyphBatch::~RichTextGlyphBatch()
+{
+    clearGlyphs();
+}
+
+void RichTextGlyphBatch::clearGlyphs()
+{
+    for (auto& batch : _batches)
+    {
+        batch.texture->release();
+    }
+    _batches.clear();
+}
+
+void RichTextGlyphBatch::addGlyph(Texture2D* texture, const Rect& textureRect, const Rect& rect, const Color3B& color, GLubyte opacity)
+{
+    Batch* batch = nullptr;
+    for (auto& item : _batches)
+    {
+        if (item.texture == texture)
+        {
+            batch = &item;
+            break;
+        }
+    }
+    if (batch == nullptr)
+    {
+        _batches.push_back(Batch());
+        batch = &_batches.back();
+        batch->texture = texture;
+        batch->texture->retain();
+        batch->lineStart = 0;
+    }
+
+    float atlasWidth = (float)texture->getPixelsWide();
+    float atlasHeight = (float)texture->getPixelsHigh();
+    Rect pixelRect = CC_RECT_POINTS_TO_PIXELS(textureRect);
+    float left = pixelRect.origin.x / atlasWidth;
+    float right = (pixelRect.origin.x + pixelRect.size.width) / atlasWidth;
+    float top = pixelRect.origin.y / atlasHeight;
+    float bottom = (pixelRect.origin.y + pixelRect.size.height) / atlasHeight;
+
+    V3F_C4B_T2F_Quad quad;
+    quad.bl.vertices = Vec3(rect.getMinX(), rect.getMinY(), 0.0f);
+    quad.br.vertices = Vec3(rect.getMaxX(), rect.getMinY(), 0.0f);
+    quad.tl.vertices = Vec3(rect.getMinX(), rect.getMaxY(), 0.0f);
+    quad.tr.vertices = Vec3(rect.getMaxX(), rect.getMaxY(), 0.0f);
+    quad.bl.texCoords = Tex2F(left, bottom);
+    quad.br.texCoords = Tex2F(right, bottom);
+    quad.tl.texCoords = Tex2F(left, top);
+    quad.tr.texCoords = Tex2F(right, top);
+
+    batch->quads.push_back(quad);
+    batch->colors.push_back(Color4B(color.r, color.g, color.b, opacity));
+    _colorsDirty = true;
+}
+
+void RichTextGlyphBatch::closeLine(float posY)
+{
+    for (auto& batch : _batches)
+    {
+        size_t count = batch.quads.size();
+        for (size_t i = batch.lineStart; i < count; ++i)
+        {
+            V3F_C4B_T2F_Quad& quad = batch.quads[i];
+            quad.bl.vertices.y += posY;
+            quad.br.vertices.y += posY;
+            quad.tl.vertices.y += posY;
+            quad.tr.vertices.y += posY;
+        }
+        batch.lineStart = count;
+    }
+}
+
+void RichTextGlyphBatch::updateColors()
+{
+    for (auto& batch : _batches)
+    {
+        size_t count = batch.quads.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Color4B& elementColor = batch.colors[i];
+            Color4B color(elementColor.r * _displayedColor.r / 255,
+                          elementColor.g * _displayedColor.g / 255,
+                          elementColor.b * _displayedColor.b / 255,
+                          elementColor.a * _displayedOpacity / 255);
+            V3F_C4B_T2F_Quad& quad = batch.quads[i];
+            quad.bl.colors = color;
+            quad.br.colors = color;
+            quad.tl.colors = color;
+            quad.tr.colors = color;
+        }
+    }
+    _colorsDirty = false;
+}
+
+void RichTextGlyphBatch::updateDisplayedColor(const Color3B& parentColor)
+{
+    Node::updateDisplayedColor(parentColor);
+    _colorsDirty = true;
+}
+
+void RichTextGlyphBatch::updateDisplayedOpacity(GLubyte parentOpacity)
+{
+    Node::updateDisplayedOpacity(parentOpacity);
+    _colorsDirty = true;
+}
+
+void RichTextGlyphBatch::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    if (_colorsDirty)
+    {
+        updateColors();
+    }
+
+    for (auto& batch : _batches)
+    {
+        ssize_t quadCount = batch.quads.size();
+        // sized before any command is queued, the renderer keeps pointers to them
+        batch.commands.resize((quadCount + MAX_QUADS_PER_COMMAND - 1) / MAX_QUADS_PER_COMMAND);
+        size_t commandIndex = 0;
+        for (ssize_t offset = 0; offset < quadCount; offset += MAX_QUADS_PER_COMMAND, ++commandIndex)
+        {
+            QuadCommand& command = batch.commands[commandIndex];
+            command.init(_globalZOrder, batch.texture->getName(), getGLProgramState(), _blendFunc,
+                         &batch.quads[offset], MIN(MAX_QUADS_PER_COMMAND, quadCount - offset), transform);
+            renderer->addCommand(&command);
+        }
+    }
+}
+
 RichText::RichText():
 _formatTextDirty(true),
-_leftSpaceWidth(0.0f),
 _verticalSpace(0.0f),
-_elementRenderersContainer(nullptr)
+_elementRenderersContainer(nullptr),
+_glyphBatch(nullptr),
+_linePosX(0.0f),
+_lineHeight(0.0f),
+_linePosY(0.0f),
+_maxLineWidth(0.0f),
+_lineCount(0),
+_purgeTextureListener(nullptr)
 {
-    
+
 }
-    
+
 RichText::~RichText()
 {
+    if (_purgeTextureListener)
+    {
+        _eventDispatcher->removeEventListener(_purgeTextureListener);
+    }
+    CC_SAFE_RELEASE(_glyphBatch);
+    releaseFontAtlases(_fontAtlases);
     _richElements.clear();
 }
-    
+
 RichText* RichText::create()
 {
     RichText* widget = new (std::nothrow) RichText();
@@ -137,21 +356,33 @@ RichText* RichText::create()
     CC_SAFE_DELETE(widget);
     return nullptr;
 }
-    
+
 bool RichText::init()
 {
     if (Widget::init())
     {
+        // the glyphs of a purged atlas are rendered again, the layout has to pick up their new coordinates
+        _purgeTextureListener = EventListenerCustom::create(FontAtlas::EVENT_PURGE_TEXTURES, [this](EventCustom* event){
+            auto fontAtlas = static_cast<FontAtlas*>(event->getUserData());
+            if (std::find(_fontAtlases.begin(), _fontAtlases.end(), fontAtlas) != _fontAtlases.end())
+            {
+                _formatTextDirty = true;
+            }
+        });
+        _eventDispatcher->addEventListenerWithFixedPriority(_purgeTextureListener, 1);
         return true;
     }
     return false;
 }
-    
+
 void RichText::initRenderer()
 {
     _elementRenderersContainer = Node::create();
     _elementRenderersContainer->setAnchorPoint(Vec2(0.5f, 0.5f));
     addProtectedChild(_elementRenderersContainer, 0, -1);
+
+    _glyphBatch = RichTextGlyphBatch::create();
+    _glyphBatch->retain();
 }
 
 void RichText::insertElement(RichElement *element, int index)
@@ -159,260 +390,314 @@ void RichText::insertElement(RichElement *element, int index)
     _richElements.insert(index, element);
     _formatTextDirty = true;
 }
-    
+
 void RichText::pushBackElement(RichElement *element)
 {
     _richElements.pushBack(element);
     _formatTextDirty = true;
 }
-    
+
 void RichText::removeElement(int index)
 {
     _richElements.erase(index);
     _formatTextDirty = true;
 }
-    
+
 void RichText::removeElement(RichElement *element)
 {
     _richElements.eraseObject(element);
     _formatTextDirty = true;
 }
-    
+
 void RichText::formatText()
 {
     if (_formatTextDirty)
     {
+        CC_TRACE_ZONE("RichText::formatText");
+
         _elementRenderersContainer->removeAllChildren();
-        _elementRenders.clear();
-        if (_ignoreSize)
+        _elementRenderersContainer->addChild(_glyphBatch, 1);
+        _glyphBatch->clearGlyphs();
+
+        // the atlases of the previous layout are released once the new one holds its references
+        std::vector<FontAtlas*> previousFontAtlases;
+        previousFontAtlases.swap(_fontAtlases);
+
+        _linePosY = 0.0f;
+        _maxLineWidth = 0.0f;
+        _lineCount = 0;
+        addNewLine();
+        for (ssize_t i=0; i<_richElements.size(); i++)
         {
-            addNewLine();
-            for (ssize_t i=0; i<_richElements.size(); i++)
+            RichElement* element = _richElements.at(i);
+            switch (element->_type)
             {
-                RichElement* element = _richElements.at(i);
-                Node* elementRenderer = nullptr;
-                switch (element->_type)
+                case RichElement::Type::TEXT:
                 {
-                    case RichElement::Type::TEXT:
-                    {
-                        RichElementText* elmtText = static_cast<RichElementText*>(element);
-                        if (FileUtils::getInstance()->isFileExist(elmtText->_fontName))
-                        {
-                            elementRenderer = Label::createWithTTF(elmtText->_text.c_str(), elmtText->_fontName, elmtText->_fontSize);
-                        }
-                        else
-                        {
-                            elementRenderer = Label::createWithSystemFont(elmtText->_text.c_str(), elmtText->_fontName, elmtText->_fontSize);
-                        }
-                        break;
-                    }
-                    case RichElement::Type::IMAGE:
-                    {
-                        RichElementImage* elmtImage = static_cast<RichElementImage*>(element);
-                        elementRenderer = Sprite::create(elmtImage->_filePath.c_str());
-                        break;
-                    }
-                    case RichElement::Type::CUSTOM:
-                    {
-                        RichElementCustomNode* elmtCustom = static_cast<RichElementCustomNode*>(element);
-                        elementRenderer = elmtCustom->_customNode;
-                        break;
-                    }
-                    default:
-                        break;
+                    RichElementText* elmtText = static_cast<RichElementText*>(element);
+                    handleTextRenderer(elmtText->_text, elmtText->_fontName, elmtText->_fontSize, elmtText->_color, elmtText->_opacity);
+                    break;
                 }
-                elementRenderer->setColor(element->_color);
-                elementRenderer->setOpacity(element->_opacity);
-                pushToContainer(elementRenderer);
-            }
-        }
-        else
-        {
-            addNewLine();
-            for (ssize_t i=0; i<_richElements.size(); i++)
-            {
-                
-                RichElement* element = static_cast<RichElement*>(_richElements.at(i));
-                switch (element->_type)
+                case RichElement::Type::IMAGE:
+                {
+                    RichElementImage* elmtImage = static_cast<RichElementImage*>(element);
+                    handleImageRenderer(elmtImage->_filePath, elmtImage->_color, elmtImage->_opacity);
+                    break;
+                }
+                case RichElement::Type::CUSTOM:
                 {
-                    case RichElement::Type::TEXT:
-                    {
-                        RichElementText* elmtText = static_cast<RichElementText*>(element);
-                        handleTextRenderer(elmtText->_text.c_str(), elmtText->_fontName.c_str(), elmtText->_fontSize, elmtText->_color, elmtText->_opacity);
-                        break;
-                    }
-                    case RichElement::Type::IMAGE:
-                    {
-                        RichElementImage* elmtImage = static_cast<RichElementImage*>(element);
-                        handleImageRenderer(elmtImage->_filePath.c_str(), elmtImage->_color, elmtImage->_opacity);
-                        break;
-                    }
-                    case RichElement::Type::CUSTOM:
-                    {
-                        RichElementCustomNode* elmtCustom = static_cast<RichElementCustomNode*>(element);
-                        handleCustomRenderer(elmtCustom->_customNode);
-                        break;
-                    }
-                    default:
-                        break;
+                    RichElementCustomNode* elmtCustom = static_cast<RichElementCustomNode*>(element);
+                    elmtCustom->_customNode->setColor(elmtCustom->_color);
+                    elmtCustom->_customNode->setOpacity(elmtCustom->_opacity);
+                    handleCustomRenderer(elmtCustom->_customNode);
+                    break;
                 }
+                default:
+                    break;
             }
         }
         formarRenderers();
+        releaseFontAtlases(previousFontAtlases);
         _formatTextDirty = false;
     }
 }
-    
-void RichText::handleTextRenderer(const std::string& text, const std::string& fontName, float fontSize, const Color3B &color, GLubyte opacity)
+
+FontAtlas* RichText::getFontAtlas(const std::string& fontName, float fontSize)
 {
-    auto fileExist = FileUtils::getInstance()->isFileExist(fontName);
-    Label* textRenderer = nullptr;
-    if (fileExist)
+    if (!FileUtils::getInstance()->isFileExist(fontName))
     {
-        textRenderer = Label::createWithTTF(text, fontName, fontSize);
-    } 
-    else
+        return nullptr;
+    }
+
+    TTFConfig ttfConfig(fontName.c_str(), fontSize, GlyphCollection::DYNAMIC);
+    FontAtlas* fontAtlas = FontAtlasCache::getFontAtlasTTF(ttfConfig);
+    if (fontAtlas)
+    {
+        // a single reference is kept per atlas, whatever the number of elements using it
+        if (std::find(_fontAtlases.begin(), _fontAtlases.end(), fontAtlas) != _fontAtlases.end())
+        {
+            FontAtlasCache::releaseFontAtlas(fontAtlas);
+        }
+        else
+        {
+            _fontAtlases.push_back(fontAtlas);
+        }
+    }
+    return fontAtlas;
+}
+
+void RichText::releaseFontAtlases(std::vector<FontAtlas*>& fontAtlases)
+{
+    for (auto fontAtlas : fontAtlases)
+    {
+        FontAtlasCache::releaseFontAtlas(fontAtlas);
+    }
+    fontAtlases.clear();
+}
+
+bool RichText::fitsInLine(float width) const
+{
+    return _ignoreSize || _linePosX + width <= _customSize.width;
+}
+
+void RichText::handleTextRenderer(const std::string& text, const std::string& fontName, float fontSize, const Color3B &color, GLubyte opacity)
+{
+    FontAtlas* fontAtlas = getFontAtlas(fontName, fontSize);
+    if (fontAtlas)
     {
-        textRenderer = Label::createWithSystemFont(text, fontName, fontSize);
+        handleGlyphRenderer(text, fontAtlas, color, opacity);
+        return;
     }
-    float textRendererWidth = textRenderer->getContentSize().width;
-    _leftSpaceWidth -= textRendererWidth;
-    if (_leftSpaceWidth < 0.0f)
+
+    // system fonts can only be measured by rendering them, the longest part fitting in the row is found by bisection
+    std::string leftText = text;
+    Label* textRenderer = Label::createWithSystemFont(leftText, fontName, fontSize);
+    while (textRenderer)
     {
-        float overstepPercent = (-_leftSpaceWidth) / textRendererWidth;
-        std::string curText = text;
-        size_t stringLength = StringUtils::getCharacterCountInUTF8String(text);
-        int leftLength = stringLength * (1.0f - overstepPercent);
-        std::string leftWords = Helper::getSubStringOfUTF8String(curText,0,leftLength);
-        std::string cutWords = Helper::getSubStringOfUTF8String(curText, leftLength, stringLength - leftLength);
-        if (leftLength > 0)
+        if (fitsInLine(textRenderer->getContentSize().width))
         {
-            Label* leftRenderer = nullptr;
-            if (fileExist)
+            textRenderer->setColor(color);
+            textRenderer->setOpacity(opacity);
+            pushToContainer(textRenderer);
+            break;
+        }
+
+        size_t stringLength = StringUtils::getCharacterCountInUTF8String(leftText);
+        size_t low = 0;
+        size_t high = stringLength - 1;
+        Label* leftRenderer = nullptr;
+        while (low < high)
+        {
+            size_t middle = (low + high + 1) / 2;
+            Label* renderer = Label::createWithSystemFont(Helper::getSubStringOfUTF8String(leftText, 0, middle), fontName, fontSize);
+            if (renderer && fitsInLine(renderer->getContentSize().width))
             {
-                leftRenderer = Label::createWithTTF(Helper::getSubStringOfUTF8String(leftWords, 0, leftLength), fontName, fontSize);
+                low = middle;
+                leftRenderer = renderer;
             }
             else
             {
-                leftRenderer = Label::createWithSystemFont(Helper::getSubStringOfUTF8String(leftWords, 0, leftLength), fontName, fontSize);
+                high = middle - 1;
             }
-            if (leftRenderer)
+        }
+
+        if (leftRenderer == nullptr)
+        {
+            if (_linePosX > 0.0f)
             {
-                leftRenderer->setColor(color);
-                leftRenderer->setOpacity(opacity);
-                pushToContainer(leftRenderer);
+                addNewLine();
+                continue;
             }
+            // not even one character fits in an empty row
+            low = 1;
+            leftRenderer = Label::createWithSystemFont(Helper::getSubStringOfUTF8String(leftText, 0, low), fontName, fontSize);
+        }
+        if (leftRenderer)
+        {
+            leftRenderer->setColor(color);
+            leftRenderer->setOpacity(opacity);
+            pushToContainer(leftRenderer);
         }
 
         addNewLine();
-        handleTextRenderer(cutWords.c_str(), fontName, fontSize, color, opacity);
+        leftText = Helper::getSubStringOfUTF8String(leftText, low, stringLength - low);
+        textRenderer = Label::createWithSystemFont(leftText, fontName, fontSize);
     }
-    else
+}
+
+void RichText::handleGlyphRenderer(const std::string& text, FontAtlas* fontAtlas, const Color3B& color, GLubyte opacity)
+{
+    std::u16string utf16Text;
+    if (!StringUtils::UTF8ToUTF16(text, utf16Text) || utf16Text.empty())
     {
-        textRenderer->setColor(color);
-        textRenderer->setOpacity(opacity);
-        pushToContainer(textRenderer);
+        return;
+    }
+    fontAtlas->prepareLetterDefinitions(utf16Text);
+
+    int kerningCount = 0;
+    int* kernings = fontAtlas->getFont()->getHorizontalKerningForTextUTF16(utf16Text, kerningCount);
+
+    // the metrics of the atlas are in pixels, except the size and the texture coordinates of the letters
+    float contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    float fontLineHeight = fontAtlas->getCommonLineHeight() / contentScaleFactor;
+    FontLetterDefinition letterDef;
+    size_t length = utf16Text.length();
+    for (size_t i = 0; i < length; ++i)
+    {
+        char16_t c = utf16Text[i];
+        _lineHeight = MAX(_lineHeight, fontLineHeight);
+        if (c == '\n')
+        {
+            addNewLine();
+            continue;
+        }
+        if (!fontAtlas->getLetterDefinitionForChar(c, letterDef) || !letterDef.validDefinition)
+        {
+            CCLOG("WARNING: can't find letter definition in font file for letter: %c", c);
+            continue;
+        }
+
+        float kerning = (kernings && static_cast<int>(i) < kerningCount) ? kernings[i] : 0.0f;
+        if (_linePosX > 0.0f && !fitsInLine((letterDef.xAdvance + kerning) / contentScaleFactor))
+        {
+            addNewLine();
+            _lineHeight = fontLineHeight;
+            if (c == ' ')
+            {
+                // the space breaking the row isn't carried to the next one
+                continue;
+            }
+            kerning = 0.0f;
+        }
+
+        if (letterDef.width > 0.0f && letterDef.height > 0.0f)
+        {
+            float letterPosX = _linePosX + (letterDef.offsetX + kerning) / contentScaleFactor;
+            float letterTop = fontLineHeight - letterDef.offsetY / contentScaleFactor;
+            _glyphBatch->addGlyph(fontAtlas->getTexture(letterDef.textureID),
+                                  Rect(letterDef.U, letterDef.V, letterDef.width, letterDef.height),
+                                  Rect(letterPosX, letterTop - letterDef.height, letterDef.width, letterDef.height),
+                                  color, opacity);
+        }
+        _linePosX += (letterDef.xAdvance + kerning) / contentScaleFactor;
     }
+
+    delete [] kernings;
 }
-    
+
 void RichText::handleImageRenderer(const std::string& fileParh, const Color3B &color, GLubyte opacity)
 {
     Sprite* imageRenderer = Sprite::create(fileParh);
-    handleCustomRenderer(imageRenderer);
+    if (imageRenderer)
+    {
+        imageRenderer->setColor(color);
+        imageRenderer->setOpacity(opacity);
+        handleCustomRenderer(imageRenderer);
+    }
 }
-    
+
 void RichText::handleCustomRenderer(cocos2d::Node *renderer)
 {
-    Size imgSize = renderer->getContentSize();
-    _leftSpaceWidth -= imgSize.width;
-    if (_leftSpaceWidth < 0.0f)
+    if (_linePosX > 0.0f && !fitsInLine(renderer->getContentSize().width))
     {
         addNewLine();
-        pushToContainer(renderer);
-        _leftSpaceWidth -= imgSize.width;
     }
-    else
+    pushToContainer(renderer);
+}
+
+void RichText::closeLine()
+{
+    _linePosY -= _lineHeight;
+    if (!_ignoreSize || _lineCount > 1)
+    {
+        _linePosY -= _verticalSpace;
+    }
+
+    _glyphBatch->closeLine(_linePosY);
+    for (auto& renderer : _lineRenderers)
     {
-        pushToContainer(renderer);
+        renderer->setPositionY(_linePosY);
     }
+    _lineRenderers.clear();
+    _maxLineWidth = MAX(_maxLineWidth, _linePosX);
 }
-    
+
 void RichText::addNewLine()
 {
-    _leftSpaceWidth = _customSize.width;
-    _elementRenders.push_back(new Vector<Node*>());
+    if (_lineCount > 0)
+    {
+        closeLine();
+    }
+    _lineCount++;
+    _linePosX = 0.0f;
+    _lineHeight = 0.0f;
 }
-    
+
 void RichText::formarRenderers()
 {
+    closeLine();
+
+    // rows were stacked downward from 0, they are moved up to the top of the container
+    float top = 0.0f;
     if (_ignoreSize)
     {
-        float newContentSizeWidth = 0.0f;
-        float newContentSizeHeight = 0.0f;
-        
-        Vector<Node*>* row = (_elementRenders[0]);
-        float nextPosX = 0.0f;
-        for (ssize_t j=0; j<row->size(); j++)
-        {
-            Node* l = row->at(j);
-            l->setAnchorPoint(Vec2::ZERO);
-            l->setPosition(nextPosX, 0.0f);
-            _elementRenderersContainer->addChild(l, 1);
-            Size iSize = l->getContentSize();
-            newContentSizeWidth += iSize.width;
-            newContentSizeHeight = MAX(newContentSizeHeight, iSize.height);
-            nextPosX += iSize.width;
-        }
-        _elementRenderersContainer->setContentSize(Size(newContentSizeWidth, newContentSizeHeight));
+        top = -_linePosY;
+        _elementRenderersContainer->setContentSize(Size(_maxLineWidth, top));
     }
     else
     {
-        float newContentSizeHeight = 0.0f;
-        float *maxHeights = new float[_elementRenders.size()];
-        
-        for (size_t i=0; i<_elementRenders.size(); i++)
-        {
-            Vector<Node*>* row = (_elementRenders[i]);
-            float maxHeight = 0.0f;
-            for (ssize_t j=0; j<row->size(); j++)
-            {
-                Node* l = row->at(j);
-                maxHeight = MAX(l->getContentSize().height, maxHeight);
-            }
-            maxHeights[i] = maxHeight;
-            newContentSizeHeight += maxHeights[i];
-        }
-        
-        
-        float nextPosY = _customSize.height;
-        for (size_t i=0; i<_elementRenders.size(); i++)
+        top = _customSize.height;
+        _elementRenderersContainer->setContentSize(_contentSize);
+    }
+    _glyphBatch->setPosition(0.0f, top);
+    for (auto& child : _elementRenderersContainer->getChildren())
+    {
+        if (child != _glyphBatch)
         {
-            Vector<Node*>* row = (_elementRenders[i]);
-            float nextPosX = 0.0f;
-            nextPosY -= (maxHeights[i] + _verticalSpace);
-            
-            for (ssize_t j=0; j<row->size(); j++)
-            {
-                Node* l = row->at(j);
-                l->setAnchorPoint(Vec2::ZERO);
-                l->setPosition(nextPosX, nextPosY);
-                _elementRenderersContainer->addChild(l, 1);
-                nextPosX += l->getContentSize().width;
-            }
+            child->setPositionY(child->getPositionY() + top);
         }
-        _elementRenderersContainer->setContentSize(_contentSize);
-        delete [] maxHeights;
     }
-    
-    size_t length = _elementRenders.size();
-    for (size_t i = 0; i<length; i++)
-	{
-        Vector<Node*>* l = _elementRenders[i];
-        l->clear();
-        delete l;
-	}    
-    _elementRenders.clear();
-    
+
     if (_ignoreSize)
     {
         Size s = getVirtualRendererSize();
@@ -425,37 +710,40 @@ void RichText::formarRenderers()
     updateContentSizeWithTextureSize(_contentSize);
     _elementRenderersContainer->setPosition(_contentSize.width / 2.0f, _contentSize.height / 2.0f);
 }
-    
+
 void RichText::adaptRenderers()
 {
     this->formatText();
 }
-    
+
 void RichText::pushToContainer(cocos2d::Node *renderer)
 {
-    if (_elementRenders.size() <= 0)
-    {
-        return;
-    }
-    _elementRenders[_elementRenders.size()-1]->pushBack(renderer);
+    renderer->setAnchorPoint(Vec2::ZERO);
+    renderer->setPosition(_linePosX, 0.0f);
+    _elementRenderersContainer->addChild(renderer, 1);
+    _lineRenderers.pushBack(renderer);
+
+    const Size& size = renderer->getContentSize();
+    _linePosX += size.width;
+    _lineHeight = MAX(_lineHeight, size.height);
 }
-    
+
 void RichText::setVerticalSpace(float space)
 {
     _verticalSpace = space;
 }
-    
+
 void RichText::setAnchorPoint(const Vec2 &pt)
 {
     Widget::setAnchorPoint(pt);
     _elementRenderersContainer->setAnchorPoint(pt);
 }
-    
+
 Size RichText::getVirtualRendererSize() const
 {
     return _elementRenderersContainer->getContentSize();
 }
-    
+
 void RichText::ignoreContentAdaptWithSize(bool ignore)
 {
     if (_ignoreSize != ignore)
@@ -464,7 +752,7 @@ void RichText::ignoreContentAdaptWithSize(bool ignore)
         Widget::ignoreContentAdaptWithSize(ignore);
     }
 }
-    
+
 std::string RichText::getDescription() const
 {
     return "RichText";
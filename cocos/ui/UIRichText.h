@@ -30,7 +30,12 @@
 
 NS_CC_BEGIN
 
+class FontAtlas;
+class EventListenerCustom;
+
 namespace ui {
+
+class RichTextGlyphBatch;
     
 class CC_GUI_DLL RichElement : public Ref
 {
@@ -93,6 +98,13 @@ protected:
     friend class RichText;
 };
     
+/**
+ * Lays out text, images and custom nodes in rows.
+ *
+ * Elements using a TTF file are laid out glyph by glyph with the metrics of their FontAtlas and
+ * drawn as one quad batch per atlas texture, whatever the number of elements and lines. Elements
+ * using a system font have no glyph metrics, they are rendered with one Label per line segment.
+ */
 class CC_GUI_DLL RichText : public Widget
 {
 public:
@@ -120,17 +132,32 @@ protected:
     virtual void initRenderer();
     void pushToContainer(Node* renderer);
     void handleTextRenderer(const std::string& text, const std::string& fontName, float fontSize, const Color3B& color, GLubyte opacity);
+    void handleGlyphRenderer(const std::string& text, FontAtlas* fontAtlas, const Color3B& color, GLubyte opacity);
     void handleImageRenderer(const std::string& fileParh, const Color3B& color, GLubyte opacity);
     void handleCustomRenderer(Node* renderer);
     void formarRenderers();
     void addNewLine();
+    void closeLine();
+    bool fitsInLine(float width) const;
+    FontAtlas* getFontAtlas(const std::string& fontName, float fontSize);
+    void releaseFontAtlases(std::vector<FontAtlas*>& fontAtlases);
 protected:
     bool _formatTextDirty;
     Vector<RichElement*> _richElements;
-    std::vector<Vector<Node*>*> _elementRenders;
-    float _leftSpaceWidth;
     float _verticalSpace;
     Node* _elementRenderersContainer;
+
+    // state of the row being filled, rows are stacked downward from 0 and moved up once all of them are known
+    RichTextGlyphBatch* _glyphBatch;
+    Vector<Node*> _lineRenderers;
+    float _linePosX;
+    float _lineHeight;
+    float _linePosY;
+    float _maxLineWidth;
+    int _lineCount;
+
+    std::vector<FontAtlas*> _fontAtlases;
+    EventListenerCustom* _purgeTextureListener;
 };
     
 }
@@ -27,95 +27,43 @@
 #include "2d/CCSpriteFrameCache.h"
 #include "base/CCVector.h"
 #include "base/CCDirector.h"
+#include "base/CCCamera.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCTexture2D.h"
 
 NS_CC_BEGIN
 namespace ui {
     
+    // two triangles for each of the nine slices of the 4x4 vertex grid
+    static unsigned short s_sliceIndices[54] = {
+        0, 4, 1,    5, 1, 4,    1, 5, 2,    6, 2, 5,    2, 6, 3,    7, 3, 6,
+        4, 8, 5,    9, 5, 8,    5, 9, 6,    10, 6, 9,   6, 10, 7,   11, 7, 10,
+        8, 12, 9,   13, 9, 12,  9, 13, 10,  14, 10, 13, 10, 14, 11, 15, 11, 14,
+    };
+    
     Scale9Sprite::Scale9Sprite()
     : _spritesGenerated(false)
     , _spriteFrameRotated(false)
     , _positionsAreDirty(true)
     , _scale9Image(nullptr)
-    , _topLeft(nullptr)
-    , _top(nullptr)
-    , _topRight(nullptr)
-    , _left(nullptr)
-    , _centre(nullptr)
-    , _right(nullptr)
-    , _bottomLeft(nullptr)
-    , _bottom(nullptr)
-    , _bottomRight(nullptr)
+    , _scale9Enabled(true)
+    , _slicesGenerated(false)
+    , _insideBounds(true)
     , _insetLeft(0)
     , _insetTop(0)
     , _insetRight(0)
     , _insetBottom(0)
-    , _scale9Enabled(true)
     {
         this->setAnchorPoint(Vec2(0.5,0.5));
+        setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
     }
     
     Scale9Sprite::~Scale9Sprite()
     {
-        this->cleanupSlicedSprites();
         CC_SAFE_RELEASE(_scale9Image);
     }
     
-    void Scale9Sprite::cleanupSlicedSprites()
-    {
-        if (_topLeft && _topLeft->isRunning())
-        {
-            _topLeft->onExit();
-        }
-        if (_top && _top->isRunning())
-        {
-            _top->onExit();
-        }
-        if (_topRight && _topRight->isRunning())
-        {
-            _topRight->onExit();
-        }
-        
-        if (_left && _left->isRunning())
-        {
-            _left->onExit();
-        }
-        
-        if (_centre && _centre->isRunning())
-        {
-            _centre->onExit();
-        }
-        
-        if (_right && _right->isRunning())
-        {
-            _right->onExit();
-        }
-        
-        if (_bottomLeft && _bottomLeft->isRunning())
-        {
-            _bottomLeft->onExit();
-        }
-        
-        if (_bottomRight && _bottomRight->isRunning())
-        {
-            _bottomRight->onExit();
-        }
-        
-        if (_bottom && _bottom->isRunning())
-        {
-            _bottom->onExit();
-        }
-        
-        CC_SAFE_RELEASE_NULL(_topLeft);
-        CC_SAFE_RELEASE_NULL(_top);
-        CC_SAFE_RELEASE_NULL(_topRight);
-        CC_SAFE_RELEASE_NULL(_left);
-        CC_SAFE_RELEASE_NULL(_centre);
-        CC_SAFE_RELEASE_NULL(_right);
-        CC_SAFE_RELEASE_NULL(_bottomLeft);
-        CC_SAFE_RELEASE_NULL(_bottom);
-        CC_SAFE_RELEASE_NULL(_bottomRight);
-    }
-    
     bool Scale9Sprite::init()
     {
         return this->init(NULL, Rect::ZERO, Rect::ZERO);
@@ -152,12 +100,6 @@ namespace ui {
         return initWithBatchNode(batchnode, rect, false, capInsets);
     }
     
-#define    TRANSLATE_X(x, y, xtranslate) \
-x+=xtranslate;                       \
-
-#define    TRANSLATE_Y(x, y, ytranslate) \
-y+=ytranslate;         \
-
     bool Scale9Sprite::updateWithBatchNode(cocos2d::SpriteBatchNode *batchnode, const cocos2d::Rect &originalRect, bool rotated, const cocos2d::Rect &capInsets)
     {
         Sprite *sprite = Sprite::createWithTexture(batchnode->getTexture());
@@ -169,28 +111,12 @@ y+=ytranslate;         \
         return updateWithSprite(sprite, rect, rotated, Vec2::ZERO, rect.size, capInsets);
     }
     
-    static Rect intersectRect(const Rect &first, const Rect &second)
-    {
-        Rect ret;
-        ret.origin.x = std::max(first.origin.x,second.origin.x);
-        ret.origin.y = std::max(first.origin.y,second.origin.y);
-        
-        float rightRealPoint = std::min(first.origin.x + first.size.width, second.origin.x + second.size.width);
-        float bottomRealPoint = std::min(first.origin.y + first.size.height, second.origin.y + second.size.height);
-        
-        ret.size.width = std::max(rightRealPoint - ret.origin.x, 0.0f);
-        ret.size.height = std::max(bottomRealPoint - ret.origin.y, 0.0f);
-        return ret;
-    }
-    
     bool Scale9Sprite::updateWithSprite(Sprite* sprite, const Rect& textureRect, bool rotated, const Vec2 &offset, const Size &originalSize, const Rect& capInsets)
     {
         GLubyte opacity = getOpacity();
         Color3B color = getColor();
         
-        // Release old sprites
-        this->cleanupSlicedSprites();
-        _protectedChildren.clear();
+        _slicesGenerated = false;
         
         if(this->_scale9Image != sprite)
         {
@@ -240,7 +166,7 @@ y+=ytranslate;         \
         
         if (_scale9Enabled)
         {
-            this->createSlicedSprites();
+            this->updateSlices();
         }
         
         this->setContentSize(size);
@@ -256,13 +182,11 @@ y+=ytranslate;         \
         return true;
     }
     
-    void Scale9Sprite::createSlicedSprites()
+    void Scale9Sprite::updateSlices()
     {
         float w = _originalSize.width;
         float h = _originalSize.height;
         
-        Vec2 offsetPosition(ceil(_offset.x + (_originalSize.width - _spriteRect.size.width) / 2), ceil(_offset.y + (_originalSize.height - _spriteRect.size.height) / 2));
-        
         // If there is no specified center region
         if ( _capInsetsInternal.equals(Rect::ZERO) )
         {
@@ -270,260 +194,60 @@ y+=ytranslate;         \
             _capInsetsInternal = Rect(w/3, h/3, w/3, h/3);
         }
         
-        Rect originalRect;
-        if(_spriteFrameRotated)
-            originalRect = Rect(_spriteRect.origin.x - offsetPosition.y, _spriteRect.origin.y - offsetPosition.x, _originalSize.width, _originalSize.height);
-        else
-            originalRect = Rect(_spriteRect.origin.x - offsetPosition.x, _spriteRect.origin.y - offsetPosition.y, _originalSize.width, _originalSize.height);
-        
-        float left_w = _capInsetsInternal.origin.x;
-        float center_w = _capInsetsInternal.size.width;
-        float right_w = originalRect.size.width - (left_w + center_w);
-        
-        float top_h = _capInsetsInternal.origin.y;
-        float center_h = _capInsetsInternal.size.height;
-        float bottom_h = originalRect.size.height - (top_h + center_h);
-        
-        // calculate rects
-        
-        // ... top row
-        float x = 0.0;
-        float y = 0.0;
-        
-        Rect pixelRect = Rect(offsetPosition.x, offsetPosition.y, _spriteRect.size.width, _spriteRect.size.height);
-        
-        // top left
-        Rect lefttopboundsorig = Rect(x, y, left_w, top_h);
-        Rect lefttopbounds = lefttopboundsorig;
-        
-        // top center
-        TRANSLATE_X(x, y, left_w);
-        Rect centertopbounds = Rect(x, y, center_w, top_h);
-        
-        // top right
-        TRANSLATE_X(x, y, center_w);
-        Rect righttopbounds = Rect(x, y, right_w, top_h);
-        
-        // ... center row
-        x = 0.0;
-        y = 0.0;
-        TRANSLATE_Y(x, y, top_h);
-        
-        // center left
-        Rect leftcenterbounds = Rect(x, y, left_w, center_h);
-        
-        // center center
-        TRANSLATE_X(x, y, left_w);
-        Rect centerboundsorig = Rect(x, y, center_w, center_h);
-        Rect centerbounds = centerboundsorig;
+        _sliceColumns[0] = 0.0f;
+        _sliceColumns[1] = _capInsetsInternal.origin.x;
+        _sliceColumns[2] = _capInsetsInternal.origin.x + _capInsetsInternal.size.width;
+        _sliceColumns[3] = w;
+        _sliceRows[0] = 0.0f;
+        _sliceRows[1] = _capInsetsInternal.origin.y;
+        _sliceRows[2] = _capInsetsInternal.origin.y + _capInsetsInternal.size.height;
+        _sliceRows[3] = h;
         
-        // center right
-        TRANSLATE_X(x, y, center_w);
-        Rect rightcenterbounds = Rect(x, y, right_w, center_h);
-        
-        // ... bottom row
-        x = 0.0;
-        y = 0.0;
-        TRANSLATE_Y(x, y, top_h);
-        TRANSLATE_Y(x, y, center_h);
-        
-        // bottom left
-        Rect leftbottombounds = Rect(x, y, left_w, bottom_h);
-        
-        // bottom center
-        TRANSLATE_X(x, y, left_w);
-        Rect centerbottombounds = Rect(x, y, center_w, bottom_h);
-        
-        // bottom right
-        TRANSLATE_X(x, y, center_w);
-        Rect rightbottomboundsorig = Rect(x, y, right_w, bottom_h);
-        Rect rightbottombounds = rightbottomboundsorig;
+        // top left corner of the trimmed rect in the original frame, the offset of the frame is y-up like the one of Sprite
+        Vec2 trimmedOrigin(_offset.x + (w - _spriteRect.size.width) / 2, (h - _spriteRect.size.height) / 2 - _offset.y);
         
         if((_capInsetsInternal.origin.x + _capInsetsInternal.size.width) <= _originalSize.width
            || (_capInsetsInternal.origin.y + _capInsetsInternal.size.height) <= _originalSize.height)
         //in general case it is error but for legacy support we will check it
         {
-            lefttopbounds = intersectRect(lefttopbounds, pixelRect);
-            centertopbounds = intersectRect(centertopbounds, pixelRect);
-            righttopbounds = intersectRect(righttopbounds, pixelRect);
-            leftcenterbounds = intersectRect(leftcenterbounds, pixelRect);
-            centerbounds = intersectRect(centerbounds, pixelRect);
-            rightcenterbounds = intersectRect(rightcenterbounds, pixelRect);
-            leftbottombounds = intersectRect(leftbottombounds, pixelRect);
-            centerbottombounds = intersectRect(centerbottombounds, pixelRect);
-            rightbottombounds = intersectRect(rightbottombounds, pixelRect);
+            for (int i = 0; i < 4; ++i)
+            {
+                _sliceColumns[i] = clampf(_sliceColumns[i], trimmedOrigin.x, trimmedOrigin.x + _spriteRect.size.width);
+                _sliceRows[i] = clampf(_sliceRows[i], trimmedOrigin.y, trimmedOrigin.y + _spriteRect.size.height);
+            }
         }
         else
             //it is error but for legacy turn off clip system
             CCLOG("Scale9Sprite capInsetsInternal > originalSize");
         
-        Rect rotatedlefttopboundsorig = lefttopboundsorig;
-        Rect rotatedcenterboundsorig = centerboundsorig;
-        Rect rotatedrightbottomboundsorig = rightbottomboundsorig;
-        
-        Rect rotatedcenterbounds = centerbounds;
-        Rect rotatedrightbottombounds = rightbottombounds;
-        Rect rotatedleftbottombounds = leftbottombounds;
-        Rect rotatedrighttopbounds = righttopbounds;
-        Rect rotatedlefttopbounds = lefttopbounds;
-        Rect rotatedrightcenterbounds = rightcenterbounds;
-        Rect rotatedleftcenterbounds = leftcenterbounds;
-        Rect rotatedcenterbottombounds = centerbottombounds;
-        Rect rotatedcentertopbounds = centertopbounds;
-        
-        if (!_spriteFrameRotated)
-        {
-            
-            AffineTransform t = AffineTransform::IDENTITY;
-            t = AffineTransformTranslate(t, originalRect.origin.x, originalRect.origin.y);
-            
-            rotatedlefttopboundsorig = RectApplyAffineTransform(rotatedlefttopboundsorig, t);
-            rotatedcenterboundsorig = RectApplyAffineTransform(rotatedcenterboundsorig, t);
-            rotatedrightbottomboundsorig = RectApplyAffineTransform(rotatedrightbottomboundsorig, t);
-            
-            rotatedcenterbounds = RectApplyAffineTransform(rotatedcenterbounds, t);
-            rotatedrightbottombounds = RectApplyAffineTransform(rotatedrightbottombounds, t);
-            rotatedleftbottombounds = RectApplyAffineTransform(rotatedleftbottombounds, t);
-            rotatedrighttopbounds = RectApplyAffineTransform(rotatedrighttopbounds, t);
-            rotatedlefttopbounds = RectApplyAffineTransform(rotatedlefttopbounds, t);
-            rotatedrightcenterbounds = RectApplyAffineTransform(rotatedrightcenterbounds, t);
-            rotatedleftcenterbounds = RectApplyAffineTransform(rotatedleftcenterbounds, t);
-            rotatedcenterbottombounds = RectApplyAffineTransform(rotatedcenterbottombounds, t);
-            rotatedcentertopbounds = RectApplyAffineTransform(rotatedcentertopbounds, t);
-            
-            
-        } else {
-            // set up transformation of coordinates
-            // to handle the case where the sprite is stored rotated
-            // in the spritesheet
-            // log("rotated");
-            
-            AffineTransform t = AffineTransform::IDENTITY;
-            
-            t = AffineTransformTranslate(t, originalRect.size.height+originalRect.origin.x, originalRect.origin.y);
-            t = AffineTransformRotate(t, 1.57079633f);
-            
-            lefttopboundsorig = RectApplyAffineTransform(lefttopboundsorig, t);
-            centerboundsorig = RectApplyAffineTransform(centerboundsorig, t);
-            rightbottomboundsorig = RectApplyAffineTransform(rightbottomboundsorig, t);
-            
-            centerbounds = RectApplyAffineTransform(centerbounds, t);
-            rightbottombounds = RectApplyAffineTransform(rightbottombounds, t);
-            leftbottombounds = RectApplyAffineTransform(leftbottombounds, t);
-            righttopbounds = RectApplyAffineTransform(righttopbounds, t);
-            lefttopbounds = RectApplyAffineTransform(lefttopbounds, t);
-            rightcenterbounds = RectApplyAffineTransform(rightcenterbounds, t);
-            leftcenterbounds = RectApplyAffineTransform(leftcenterbounds, t);
-            centerbottombounds = RectApplyAffineTransform(centerbottombounds, t);
-            centertopbounds = RectApplyAffineTransform(centertopbounds, t);
-            
-            rotatedlefttopboundsorig.origin = lefttopboundsorig.origin;
-            rotatedcenterboundsorig.origin = centerboundsorig.origin;
-            rotatedrightbottomboundsorig.origin = rightbottomboundsorig.origin;
-            
-            rotatedcenterbounds.origin = centerbounds.origin;
-            rotatedrightbottombounds.origin = rightbottombounds.origin;
-            rotatedleftbottombounds.origin = leftbottombounds.origin;
-            rotatedrighttopbounds.origin = righttopbounds.origin;
-            rotatedlefttopbounds.origin = lefttopbounds.origin;
-            rotatedrightcenterbounds.origin = rightcenterbounds.origin;
-            rotatedleftcenterbounds.origin = leftcenterbounds.origin;
-            rotatedcenterbottombounds.origin = centerbottombounds.origin;
-            rotatedcentertopbounds.origin = centertopbounds.origin;
-            
-            
-        }
-        
-        _topLeftSize = rotatedlefttopboundsorig.size;
-        _centerSize = rotatedcenterboundsorig.size;
-        _bottomRightSize = rotatedrightbottomboundsorig.size;
-        
-        if(_spriteFrameRotated)
-        {
-            float offsetx = (rotatedcenterbounds.origin.x + rotatedcenterbounds.size.height/2) - (rotatedcenterboundsorig.origin.x + rotatedcenterboundsorig.size.height/2);
-            float offsety = (rotatedcenterboundsorig.origin.y + rotatedcenterboundsorig.size.width/2)- (rotatedcenterbounds.origin.y + rotatedcenterbounds.size.width/2);
-            _centerOffset.x = -offsety;
-            _centerOffset.y = offsetx;
-        }
-        else
-        {
-            float offsetx = (rotatedcenterbounds.origin.x + rotatedcenterbounds.size.width/2) - (rotatedcenterboundsorig.origin.x + rotatedcenterboundsorig.size.width/2);
-            float offsety = (rotatedcenterboundsorig.origin.y + rotatedcenterboundsorig.size.height/2)- (rotatedcenterbounds.origin.y + rotatedcenterbounds.size.height/2);
-            _centerOffset.x = offsetx;
-            _centerOffset.y = offsety;
-        }
-        
-        // Centre
-        if(rotatedcenterbounds.size.width > 0 && rotatedcenterbounds.size.height > 0 )
-        {
-            _centre = Sprite::createWithTexture(_scale9Image->getTexture(), rotatedcenterbounds, _spriteFrameRotated);
-            _centre->retain();
-            this->addProtectedChild(_centre);
-        }
-        
-        // Top
-        if(rotatedcentertopbounds.size.width > 0 && rotatedcentertopbounds.size.height > 0 )
-        {
-            _top = Sprite::createWithTexture(_scale9Image->getTexture(), rotatedcentertopbounds, _spriteFrameRotated);
-            _top->retain();
-            this->addProtectedChild(_top);
-        }
-        
-        // Bottom
-        if(rotatedcenterbottombounds.size.width > 0 && rotatedcenterbottombounds.size.height > 0 )
-        {
-            _bottom = Sprite::createWithTexture(_scale9Image->getTexture(), rotatedcenterbottombounds, _spriteFrameRotated);
-            _bottom->retain();
-            this->addProtectedChild(_bottom);
-        }
-        
-        // Left
-        if(rotatedleftcenterbounds.size.width > 0 && rotatedleftcenterbounds.size.height > 0 )
-        {
-            _left = Sprite::createWithTexture(_scale9Image->getTexture(), rotatedleftcenterbounds, _spriteFrameRotated);
-            _left->retain();
-            this->addProtectedChild(_left);
-        }
-        
-        // Right
-        if(rotatedrightcenterbounds.size.width > 0 && rotatedrightcenterbounds.size.height > 0 )
-        {
-            _right = Sprite::createWithTexture(_scale9Image->getTexture(), rotatedrightcenterbounds, _spriteFrameRotated);
-            _right->retain();
-            this->addProtectedChild(_right);
-        }
-        
-        // Top left
-        if(rotatedlefttopbounds.size.width > 0 && rotatedlefttopbounds.size.height > 0 )
-        {
-            _topLeft = Sprite::createWithTexture(_scale9Image->getTexture(), rotatedlefttopbounds, _spriteFrameRotated);
-            _topLeft->retain();
-            this->addProtectedChild(_topLeft);
-        }
-        
-        // Top right
-        if(rotatedrighttopbounds.size.width > 0 && rotatedrighttopbounds.size.height > 0 )
-        {
-            _topRight = Sprite::createWithTexture(_scale9Image->getTexture(), rotatedrighttopbounds, _spriteFrameRotated);
-            _topRight->retain();
-            this->addProtectedChild(_topRight);
-        }
+        Texture2D *texture = _scale9Image->getTexture();
+        float atlasWidth = (float)texture->getPixelsWide() / CC_CONTENT_SCALE_FACTOR();
+        float atlasHeight = (float)texture->getPixelsHigh() / CC_CONTENT_SCALE_FACTOR();
         
-        // Bottom left
-        if(rotatedleftbottombounds.size.width > 0 && rotatedleftbottombounds.size.height > 0 )
+        for (int row = 0; row < 4; ++row)
         {
-            _bottomLeft = Sprite::createWithTexture(_scale9Image->getTexture(), rotatedleftbottombounds, _spriteFrameRotated);
-            _bottomLeft->retain();
-            this->addProtectedChild(_bottomLeft);
+            for (int column = 0; column < 4; ++column)
+            {
+                float x = _sliceColumns[column] - trimmedOrigin.x;
+                float y = _sliceRows[row] - trimmedOrigin.y;
+                Tex2F& texCoords = _sliceVertices[row * 4 + column].texCoords;
+                if (_spriteFrameRotated)
+                {
+                    // stored rotated 90 degrees clockwise in the texture
+                    texCoords.u = (_spriteRect.origin.x + _spriteRect.size.height - y) / atlasWidth;
+                    texCoords.v = (_spriteRect.origin.y + x) / atlasHeight;
+                }
+                else
+                {
+                    texCoords.u = (_spriteRect.origin.x + x) / atlasWidth;
+                    texCoords.v = (_spriteRect.origin.y + y) / atlasHeight;
+                }
+            }
         }
         
-        // Bottom right
-        if(rotatedrightbottombounds.size.width > 0 && rotatedrightbottombounds.size.height > 0 )
-        {
-            _bottomRight = Sprite::createWithTexture(_scale9Image->getTexture(), rotatedrightbottombounds, _spriteFrameRotated);
-            _bottomRight->retain();
-            this->addProtectedChild(_bottomRight);
-        }
+        _slicesGenerated = true;
+        _positionsAreDirty = true;
+        updateColor();
     }
     
     void Scale9Sprite::setContentSize(const Size &size)
@@ -532,84 +256,49 @@ y+=ytranslate;         \
         this->_positionsAreDirty = true;
     }
     
-    void Scale9Sprite::updatePositions()
+    // The caps keep their size and the center absorbs the difference between the content size and the original one.
+    static float stretchSlice(float value, float capStart, float capEnd, float originalLength, float length)
     {
-        Size size = this->_contentSize;
-        
-        float sizableWidth = size.width - _topLeftSize.width - _bottomRightSize.width;
-        float sizableHeight = size.height - _topLeftSize.height - _bottomRightSize.height;
-        
-        float horizontalScale = sizableWidth/_centerSize.width;
-        float verticalScale = sizableHeight/_centerSize.height;
-        
-        if(_centre)
-        {
-            _centre->setScaleX(horizontalScale);
-            _centre->setScaleY(verticalScale);
-        }
-        
-        float rescaledWidth = _centerSize.width * horizontalScale;
-        float rescaledHeight = _centerSize.height * verticalScale;
-        
-        float leftWidth = _topLeftSize.width;
-        float bottomHeight = _bottomRightSize.height;
-        
-        Vec2 centerOffset(_centerOffset.x * horizontalScale, _centerOffset.y * verticalScale);
-        
-        // Position corners
-        if(_bottomLeft)
-        {
-            _bottomLeft->setAnchorPoint(Vec2(1,1));
-            _bottomLeft->setPosition(leftWidth,bottomHeight);
-        }
-        if(_bottomRight)
+        if (value <= capStart)
         {
-            _bottomRight->setAnchorPoint(Vec2(0,1));
-            _bottomRight->setPosition(leftWidth+rescaledWidth,bottomHeight);
+            return value;
         }
-        if(_topLeft)
+        if (value >= capEnd)
         {
-            _topLeft->setAnchorPoint(Vec2(1,0));
-            _topLeft->setPosition(leftWidth, bottomHeight+rescaledHeight);
+            return length - (originalLength - value);
         }
-        if(_topRight)
+        float centerLength = capEnd - capStart;
+        float scale = centerLength > 0 ? (length - capStart - (originalLength - capEnd)) / centerLength : 0.0f;
+        return capStart + (value - capStart) * scale;
+    }
+    
+    void Scale9Sprite::updatePositions()
+    {
+        if (!_slicesGenerated)
         {
-            _topRight->setAnchorPoint(Vec2(0,0));
-            _topRight->setPosition(leftWidth+rescaledWidth, bottomHeight+rescaledHeight);
+            return;
         }
         
-        // Scale and position borders
-        if(_left)
-        {
-            _left->setAnchorPoint(Vec2(1,0.5));
-            _left->setPosition(leftWidth, bottomHeight+rescaledHeight/2 + centerOffset.y);
-            _left->setScaleY(verticalScale);
-        }
-        if(_right)
-        {
-            _right->setAnchorPoint(Vec2(0,0.5));
-            _right->setPosition(leftWidth+rescaledWidth,bottomHeight+rescaledHeight/2 + centerOffset.y);
-            _right->setScaleY(verticalScale);
-        }
-        if(_top)
-        {
-            _top->setAnchorPoint(Vec2(0.5,0));
-            _top->setPosition(leftWidth+rescaledWidth/2 + centerOffset.x,bottomHeight+rescaledHeight);
-            _top->setScaleX(horizontalScale);
-        }
-        if(_bottom)
+        float capLeft = _capInsetsInternal.origin.x;
+        float capRight = _capInsetsInternal.origin.x + _capInsetsInternal.size.width;
+        float capTop = _capInsetsInternal.origin.y;
+        float capBottom = _capInsetsInternal.origin.y + _capInsetsInternal.size.height;
+        
+        float x[4];
+        float y[4];
+        for (int i = 0; i < 4; ++i)
         {
-            _bottom->setAnchorPoint(Vec2(0.5,1));
-            _bottom->setPosition(leftWidth+rescaledWidth/2 + centerOffset.x,bottomHeight);
-            _bottom->setScaleX(horizontalScale);
+            x[i] = stretchSlice(_sliceColumns[i], capLeft, capRight, _originalSize.width, _contentSize.width);
+            // rows go down from the top of the frame
+            y[i] = _contentSize.height - stretchSlice(_sliceRows[i], capTop, capBottom, _originalSize.height, _contentSize.height);
         }
-        // Position centre
-        if(_centre)
+        
+        for (int row = 0; row < 4; ++row)
         {
-            _centre->setAnchorPoint(Vec2(0.5,0.5));
-            _centre->setPosition(leftWidth+rescaledWidth/2 + centerOffset.x, bottomHeight+rescaledHeight/2 + centerOffset.y);
-            _centre->setScaleX(horizontalScale);
-            _centre->setScaleY(verticalScale);
+            for (int column = 0; column < 4; ++column)
+            {
+                _sliceVertices[row * 4 + column].vertices = Vec3(x[column], y[row], 0.0f);
+            }
         }
     }
     
@@ -882,6 +571,7 @@ y+=ytranslate;         \
     
     void Scale9Sprite::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
     {
+        Camera::SelectionScope cameraSelection;
         
         // quick return if not visible. children won't be drawn.
         if (!_visible)
@@ -900,13 +590,18 @@ y+=ytranslate;         \
         director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
         
         int i = 0;      // used by _children
-        int j = 0;      // used by _protectedChildren
         
         sortAllChildren();
-        sortAllProtectedChildren();
+        
+        if(this->_positionsAreDirty)
+        {
+            this->updatePositions();
+            this->adjustScale9ImagePosition();
+            this->_positionsAreDirty = false;
+        }
         
         //
-        // draw children and protectedChildren zOrder < 0
+        // draw children zOrder < 0
         //
         for( ; i < _children.size(); i++ )
         {
@@ -918,48 +613,24 @@ y+=ytranslate;         \
                 break;
         }
         
-        if (_scale9Enabled)
-        {
-            for( ; j < _protectedChildren.size(); j++ )
-            {
-                auto node = _protectedChildren.at(j);
-                
-                if ( node && node->getLocalZOrder() < 0 )
-                    node->visit(renderer, _modelViewTransform, flags);
-                else
-                    break;
-            }
-        }
-        else
+        if (!_scale9Enabled && _scale9Image && _scale9Image->getLocalZOrder() < 0 )
         {
-            if (_scale9Image && _scale9Image->getLocalZOrder() < 0 )
-            {
-                _scale9Image->visit(renderer, _modelViewTransform, flags);
-            }
+            _scale9Image->visit(renderer, _modelViewTransform, flags);
         }
         
         //
-        // draw self
+        // draw self, the slices when scale9 is enabled
         //
         if (isVisitableByVisitingCamera())
             this->draw(renderer, _modelViewTransform, flags);
         
         //
-        // draw children and protectedChildren zOrder >= 0
+        // draw children zOrder >= 0
         //
-        if (_scale9Enabled)
+        if (!_scale9Enabled && _scale9Image && _scale9Image->getLocalZOrder() >= 0 )
         {
-            for(auto it=_protectedChildren.cbegin()+j; it != _protectedChildren.cend(); ++it)
-                (*it)->visit(renderer, _modelViewTransform, flags);
+            _scale9Image->visit(renderer, _modelViewTransform, flags);
         }
-        else
-        {
-            if (_scale9Image && _scale9Image->getLocalZOrder() >= 0 )
-            {
-                _scale9Image->visit(renderer, _modelViewTransform, flags);
-            }
-        }
-        
         
         for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
             (*it)->visit(renderer, _modelViewTransform, flags);
@@ -1016,9 +687,7 @@ y+=ytranslate;         \
             return;
         }
         _scale9Enabled = enabled;
-        
-        this->cleanupSlicedSprites();
-        _protectedChildren.clear();
+        _slicesGenerated = false;
         
         if (_scale9Enabled)
         {
@@ -1035,24 +704,43 @@ y+=ytranslate;         \
         return _scale9Enabled;
     }
     
-    void Scale9Sprite::addProtectedChild(cocos2d::Node *child)
+    void Scale9Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     {
-        _reorderProtectedChildDirty = true;
-        _protectedChildren.pushBack(child);
+        if (!_scale9Enabled || !_slicesGenerated)
+        {
+            return;
+        }
+        
+        // Don't do calculate the culling if the transform and the cameras were not updated
+        _insideBounds = (flags & (FLAGS_TRANSFORM_DIRTY | FLAGS_CAMERA_DIRTY)) ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
+        
+        if (_insideBounds)
+        {
+            TrianglesCommand::Triangles triangles;
+            triangles.verts = _sliceVertices;
+            triangles.indices = s_sliceIndices;
+            triangles.vertCount = 16;
+            triangles.indexCount = 54;
+            _trianglesCommand.init(_globalZOrder, _scale9Image->getTexture()->getName(), getGLProgramState(), _scale9Image->getBlendFunc(), triangles, transform);
+            renderer->addCommand(&_trianglesCommand);
+        }
     }
     
-    void Scale9Sprite::sortAllProtectedChildren()
+    void Scale9Sprite::updateColor()
     {
-        if(this->_positionsAreDirty)
+        Color4B color4(_displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity);
+        
+        // special opacity for premultiplied textures
+        if (_scale9Image && _scale9Image->isOpacityModifyRGB())
         {
-            this->updatePositions();
-            this->adjustScale9ImagePosition();
-            this->_positionsAreDirty = false;
+            color4.r *= _displayedOpacity/255.0f;
+            color4.g *= _displayedOpacity/255.0f;
+            color4.b *= _displayedOpacity/255.0f;
         }
-        if( _reorderProtectedChildDirty )
+        
+        for (auto& vertex : _sliceVertices)
         {
-            std::sort( std::begin(_protectedChildren), std::end(_protectedChildren), nodeComparisonLess );
-            _reorderProtectedChildDirty = false;
+            vertex.colors = color4;
         }
     }
     
@@ -1078,49 +766,6 @@ y+=ytranslate;         \
         }
     }
     
-    void Scale9Sprite::cleanup()
-    {
-        Node::cleanup();
-        // timers
-        for( const auto &child: _protectedChildren)
-            child->cleanup();
-    }
-    
-    void Scale9Sprite::onEnter()
-    {
-#if CC_ENABLE_SCRIPT_BINDING
-        if (_scriptType == kScriptTypeJavascript)
-        {
-            if (ScriptEngineManager::sendNodeEventToJSExtended(this, kNodeOnEnter))
-                return;
-        }
-#endif
-        Node::onEnter();
-        for( const auto &child: _protectedChildren)
-            child->onEnter();
-    }
-    
-    void Scale9Sprite::onExit()
-    {
-        Node::onExit();
-        for( const auto &child: _protectedChildren)
-            child->onExit();
-    }
-    
-    void Scale9Sprite::onEnterTransitionDidFinish()
-    {
-        Node::onEnterTransitionDidFinish();
-        for( const auto &child: _protectedChildren)
-            child->onEnterTransitionDidFinish();
-    }
-    
-    void Scale9Sprite::onExitTransitionDidStart()
-    {
-        Node::onExitTransitionDidStart();
-        for( const auto &child: _protectedChildren)
-            child->onExitTransitionDidStart();
-    }
-    
     void Scale9Sprite::updateDisplayedColor(const cocos2d::Color3B &parentColor)
     {
         _displayedColor.r = _realColor.r * parentColor.r/255.0;
@@ -1133,11 +778,6 @@ y+=ytranslate;         \
             _scale9Image->updateDisplayedColor(_displayedColor);
         }
         
-        for(const auto &child : _protectedChildren)
-        {
-            child->updateDisplayedColor(_displayedColor);
-        }
-        
         if (_cascadeColorEnabled)
         {
             for(const auto &child : _children)
@@ -1157,11 +797,6 @@ y+=ytranslate;         \
             _scale9Image->updateDisplayedOpacity(_displayedOpacity);
         }
         
-        for(auto child : _protectedChildren)
-        {
-            child->updateDisplayedOpacity(_displayedOpacity);
-        }
-        
         if (_cascadeOpacityEnabled)
         {
             for(auto child : _children)
@@ -1177,10 +812,6 @@ y+=ytranslate;         \
         {
             child->updateDisplayedColor(Color3B::WHITE);
         }
-        for(auto child : _protectedChildren)
-        {
-            child->updateDisplayedColor(Color3B::WHITE);
-        }
         if (_scale9Image)
         {
             _scale9Image->updateDisplayedColor(Color3B::WHITE);
@@ -1194,10 +825,6 @@ y+=ytranslate;         \
         for(auto child : _children){
             child->updateDisplayedOpacity(255);
         }
-        
-        for(auto child : _protectedChildren){
-            child->updateDisplayedOpacity(255);
-        }
     }
     
     Sprite* Scale9Sprite::getSprite()const
@@ -28,6 +28,7 @@
 #include "2d/CCNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteBatchNode.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "platform/CCPlatformMacros.h"
 #include "ui/GUIExport.h"
 
@@ -44,6 +45,7 @@ namespace ui {
      *  Note: When you set _scale9Enabled to false, then you could call scale9Sprite->getSprite() to return a new Sprite pointer.
      *         Then you could call any methods of Sprite class with the return pointers.
      *
+     * The nine slices are drawn as a single mesh of 16 vertices, resizing the sprite only moves them.
      */
     class CC_GUI_DLL Scale9Sprite : public Node
     {
@@ -279,35 +281,7 @@ namespace ui {
         
         virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
         
-        virtual void cleanup() override;
-        
-        virtual void onEnter() override;
-        
-        /** Event callback that is invoked when the Node enters in the 'stage'.
-         * If the Node enters the 'stage' with a transition, this event is called when the transition finishes.
-         * If you override onEnterTransitionDidFinish, you shall call its parent's one, e.g. Node::onEnterTransitionDidFinish()
-         * @js NA
-         * @lua NA
-         */
-        virtual void onEnterTransitionDidFinish() override;
-        
-        /**
-         * Event callback that is invoked every time the Node leaves the 'stage'.
-         * If the Node leaves the 'stage' with a transition, this event is called when the transition finishes.
-         * During onExit you can't access a sibling node.
-         * If you override onExit, you shall call its parent's one, e.g., Node::onExit().
-         * @js NA
-         * @lua NA
-         */
-        virtual void onExit() override;
-        
-        /**
-         * Event callback that is called every time the Node leaves the 'stage'.
-         * If the Node leaves the 'stage' with a transition, this callback is called when the transition starts.
-         * @js NA
-         * @lua NA
-         */
-        virtual void onExitTransitionDidStart() override;
+        virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
         
         virtual void updateDisplayedOpacity(GLubyte parentOpacity) override;
         virtual void updateDisplayedColor(const Color3B& parentColor) override;
@@ -357,15 +331,9 @@ namespace ui {
     protected:
         void updateCapInset();
         void updatePositions();
-        void createSlicedSprites();
-        void cleanupSlicedSprites();
+        void updateSlices();
         void adjustScale9ImagePosition();
-        /**
-         * Sorts the children array once before drawing, instead of every time when a child is added or reordered.
-         * This appraoch can improves the performance massively.
-         * @note Don't call this manually unless a child added needs to be removed in the same frame
-         */
-        virtual void sortAllProtectedChildren();
+        virtual void updateColor() override;
         
         bool _spritesGenerated;
         Rect _spriteRect;
@@ -374,22 +342,17 @@ namespace ui {
         bool _positionsAreDirty;
         
         Sprite* _scale9Image; //the original sprite
-        Sprite* _topLeft;
-        Sprite* _top;
-        Sprite* _topRight;
-        Sprite* _left;
-        Sprite* _centre;
-        Sprite* _right;
-        Sprite* _bottomLeft;
-        Sprite* _bottom;
-        Sprite* _bottomRight;
         
         bool _scale9Enabled;
         
-        Size _topLeftSize;
-        Size _centerSize;
-        Size _bottomRightSize;
-        Vec2 _centerOffset;
+        /** Grid lines of the slices in the original frame (origin at its top left), clipped to the trimmed rect. */
+        float _sliceColumns[4];
+        float _sliceRows[4];
+        /** 4x4 grid of the nine slices, row by row from the top. */
+        V3F_C4B_T2F _sliceVertices[16];
+        TrianglesCommand _trianglesCommand;
+        bool _slicesGenerated;
+        bool _insideBounds;
         
         /** Original sprite's size. */
         Size _originalSize;
@@ -413,12 +376,6 @@ namespace ui {
         /** Sets the bottom side inset */
         float _insetBottom;
         
-        /// helper that reorder a child
-        void addProtectedChild(Node* child);
-        
-        Vector<Node*> _protectedChildren;        ///holds the 9 sprites
-        bool _reorderProtectedChildDirty;
-        
         bool _flippedX;
         bool _flippedY;
     };
@@ -29,6 +29,7 @@
 #include "2d/CCActionInterval.h"
 #include "2d/CCActionTween.h"
 #include "base/CCDirector.h"
+#include "base/CCCamera.h"
 #include "base/CCEventDispatcher.h"
 #include "renderer/CCRenderer.h"
 
@@ -515,9 +516,11 @@ void ScrollView::addChild(Node * child, int zOrder, const std::string &name)
 
 void ScrollView::beforeDraw()
 {
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _beforeDrawCommand.init(_globalZOrder);
     _beforeDrawCommand.func = CC_CALLBACK_0(ScrollView::onBeforeDraw, this);
-    Director::getInstance()->getRenderer()->addCommand(&_beforeDrawCommand);
+    renderer->addCommand(&_beforeDrawCommand);
 }
 
 /**
@@ -552,9 +555,11 @@ void ScrollView::onBeforeDraw()
 
 void ScrollView::afterDraw()
 {
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setCameraPassMask(Renderer::ALL_CAMERA_PASSES);
     _afterDrawCommand.init(_globalZOrder);
     _afterDrawCommand.func = CC_CALLBACK_0(ScrollView::onAfterDraw, this);
-    Director::getInstance()->getRenderer()->addCommand(&_afterDrawCommand);
+    renderer->addCommand(&_afterDrawCommand);
 }
 
 /**
@@ -578,6 +583,8 @@ void ScrollView::onAfterDraw()
 
 void ScrollView::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
+    Camera::SelectionScope cameraSelection;
+
     // quick return if not visible
     if (!isVisible())
     {
@@ -595,7 +602,6 @@ void ScrollView::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t
     director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
 
     this->beforeDraw();
-    bool visibleByCamera = isVisitableByVisitingCamera();
 
     if (!_children.empty())
     {
@@ -616,7 +622,7 @@ void ScrollView::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t
         }
 		
 		// this draw
-        if (visibleByCamera)
+        if (isVisitableByVisitingCamera())
             this->draw(renderer, _modelViewTransform, flags);
         
         // draw children zOrder >= 0
@@ -626,7 +632,7 @@ void ScrollView::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t
 			child->visit(renderer, _modelViewTransform, flags);
         }
     }
-    else if (visibleByCamera)
+    else if (isVisitableByVisitingCamera())
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
@@ -26,8 +26,12 @@
 #include <curl/curl.h>
 #include <curl/easy.h>
 #include <stdio.h>
+#include <algorithm>
 #include <vector>
 #include <thread>
+#include <condition_variable>
+#include <sstream>
+#include <unordered_map>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
 #include <sys/types.h>
@@ -38,6 +42,7 @@
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 #include "base/CCUserDefault.h"
 #include "platform/CCFileUtils.h"
 
@@ -50,9 +55,14 @@ NS_CC_EXT_BEGIN;
 
 #define KEY_OF_VERSION   "current-version-code"
 #define KEY_OF_DOWNLOADED_VERSION    "downloaded-version-code"
+#define KEY_OF_DOWNLOADING_VERSION   "downloading-version-code"
 #define TEMP_PACKAGE_FILE_NAME    "cocos2dx-update-temp-package.zip"
+#define MANIFEST_FILE_NAME        "cocos2dx-update-manifest"
+#define STAGING_DIRECTORY_NAME    "cocos2dx-update-staging/"
 #define BUFFER_SIZE    8192
 #define MAX_FILENAME   512
+#define MAX_RETRIES    5
+#define DEFAULT_CONCURRENT_DOWNLOADS 4
 
 #define LOW_SPEED_LIMIT 1L
 #define LOW_SPEED_TIME 5L
@@ -78,6 +88,60 @@ struct ProgressMessage
     AssetsManager* manager;
 };
 
+// Returns the size of a file, 0 if it doesn't exist
+static long long getFileSize(const std::string& fileName)
+{
+    FILE *fp = fopen(fileName.c_str(), "rb");
+    if (! fp)
+    {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+static bool getFileCrc32(const std::string& fileName, unsigned long *crc)
+{
+    FILE *fp = fopen(fileName.c_str(), "rb");
+    if (! fp)
+    {
+        return false;
+    }
+
+    char buffer[BUFFER_SIZE];
+    uLong value = crc32(0L, Z_NULL, 0);
+    size_t read;
+    while ((read = fread(buffer, 1, BUFFER_SIZE, fp)) > 0)
+    {
+        value = crc32(value, (const Bytef*)buffer, (uInt)read);
+    }
+    fclose(fp);
+
+    *crc = value;
+    return true;
+}
+
+static bool isZipFile(const std::string& fileName)
+{
+    return fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".zip") == 0;
+}
+
+// The server can't continue the download from where it stopped: it ignores ranges, or the range
+// is past the end of the file (416 over http) because the file was already complete or changed.
+static bool isRangeRefused(void *curl, CURLcode res)
+{
+    if (res == CURLE_RANGE_ERROR || res == CURLE_BAD_DOWNLOAD_RESUME)
+    {
+        return true;
+    }
+    
+    long responseCode = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
+    return res == CURLE_HTTP_RETURNED_ERROR && responseCode == 416;
+}
+
 // Implementation of AssetsManager
 
 AssetsManager::AssetsManager(const char* packageUrl/* =nullptr */, const char* versionFileUrl/* =nullptr */, const char* storagePath/* =nullptr */)
@@ -86,6 +150,12 @@ AssetsManager::AssetsManager(const char* packageUrl/* =nullptr */, const char* v
 , _packageUrl(packageUrl)
 , _versionFileUrl(versionFileUrl)
 , _downloadedVersion("")
+, _downloadingVersion("")
+, _manifestUrl("")
+, _maxConcurrentDownloads(DEFAULT_CONCURRENT_DOWNLOADS)
+, _downloadedBytes(0)
+, _totalBytes(0)
+, _percent(0)
 , _curl(nullptr)
 , _connectionTimeout(0)
 , _delegate(nullptr)
@@ -122,13 +192,19 @@ static std::string keyWithHash( const char* prefix, const std::string& url )
 // hashed version
 std::string AssetsManager::keyOfVersion() const
 {
-    return keyWithHash(KEY_OF_VERSION,_packageUrl);
+    return keyWithHash(KEY_OF_VERSION,_manifestUrl.empty() ? _packageUrl : _manifestUrl);
 }
 
 // hashed version
 std::string AssetsManager::keyOfDownloadedVersion() const
 {
-    return keyWithHash(KEY_OF_DOWNLOADED_VERSION,_packageUrl);
+    return keyWithHash(KEY_OF_DOWNLOADED_VERSION,_manifestUrl.empty() ? _packageUrl : _manifestUrl);
+}
+
+// hashed version
+std::string AssetsManager::keyOfDownloadingVersion() const
+{
+    return keyWithHash(KEY_OF_DOWNLOADING_VERSION,_manifestUrl.empty() ? _packageUrl : _manifestUrl);
 }
 
 static size_t getVersionCode(void *ptr, size_t size, size_t nmemb, void *userdata)
@@ -196,6 +272,31 @@ bool AssetsManager::checkUpdate()
 
 void AssetsManager::downloadAndUncompress()
 {
+    if (! _manifestUrl.empty())
+    {
+        std::string manifest;
+        std::vector<ManifestEntry> entries;
+        std::vector<std::string> stagedFiles;
+        if (downloadManifest(manifest, entries) &&
+            downloadManifestFiles(entries, stagedFiles) &&
+            activateStagedFiles(stagedFiles, manifest))
+        {
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread([this] {
+                // Record new version code.
+                UserDefault::getInstance()->setStringForKey(this->keyOfVersion().c_str(), this->_version.c_str());
+                UserDefault::getInstance()->flush();
+                
+                // The replaced files may have been looked up already
+                FileUtils::getInstance()->purgeCachedEntries();
+                this->setSearchPath();
+                
+                if (this->_delegate) this->_delegate->onSuccess();
+            });
+        }
+        _isDownloading = false;
+        return;
+    }
+    
     do
     {
         if (_downloadedVersion != _version)
@@ -205,6 +306,7 @@ void AssetsManager::downloadAndUncompress()
             Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
                 UserDefault::getInstance()->setStringForKey(this->keyOfDownloadedVersion().c_str(),
                                                             this->_version.c_str());
+                UserDefault::getInstance()->setStringForKey(this->keyOfDownloadingVersion().c_str(), "");
                 UserDefault::getInstance()->flush();
             });
         }
@@ -255,10 +357,9 @@ void AssetsManager::update()
     _isDownloading = true;
     
     // 1. Urls of package and version should be valid;
-    // 2. Package should be a zip file.
+    // 2. Package should be a zip file, unless the files of a manifest are downloaded.
     if (_versionFileUrl.size() == 0 ||
-        _packageUrl.size() == 0 ||
-        std::string::npos == _packageUrl.find(".zip"))
+        (_manifestUrl.empty() && (_packageUrl.size() == 0 || std::string::npos == _packageUrl.find(".zip"))))
     {
         CCLOG("no version file url, or no package url, or the package is not a zip file");
         _isDownloading = false;
@@ -274,19 +375,25 @@ void AssetsManager::update()
     
     // Is package already downloaded?
     _downloadedVersion = UserDefault::getInstance()->getStringForKey(keyOfDownloadedVersion().c_str());
+    // Or partially downloaded?
+    _downloadingVersion = UserDefault::getInstance()->getStringForKey(keyOfDownloadingVersion().c_str());
     
     auto t = std::thread(&AssetsManager::downloadAndUncompress, this);
     t.detach();
 }
 
 bool AssetsManager::uncompress()
+{
+    return uncompressFile(_storagePath + TEMP_PACKAGE_FILE_NAME, _storagePath, nullptr);
+}
+
+bool AssetsManager::uncompressFile(const std::string& zipFileName, const std::string& destPath, std::vector<std::string>* files)
 {
     // Open the zip file
-    string outFileName = _storagePath + TEMP_PACKAGE_FILE_NAME;
-    unzFile zipfile = unzOpen(outFileName.c_str());
+    unzFile zipfile = unzOpen(zipFileName.c_str());
     if (! zipfile)
     {
-        CCLOG("can not open downloaded zip file %s", outFileName.c_str());
+        CCLOG("can not open downloaded zip file %s", zipFileName.c_str());
         return false;
     }
     
@@ -294,7 +401,7 @@ bool AssetsManager::uncompress()
     unz_global_info global_info;
     if (unzGetGlobalInfo(zipfile, &global_info) != UNZ_OK)
     {
-        CCLOG("can not read file global info of %s", outFileName.c_str());
+        CCLOG("can not read file global info of %s", zipFileName.c_str());
         unzClose(zipfile);
         return false;
     }
@@ -325,7 +432,7 @@ bool AssetsManager::uncompress()
             return false;
         }
         
-        const string fullPath = _storagePath + fileName;
+        const string fullPath = destPath + fileName;
         
         // Check if this entry is a directory or a file.
         const size_t filenameLength = strlen(fileName);
@@ -345,44 +452,12 @@ bool AssetsManager::uncompress()
             //There are not directory entry in some case.
             //So we need to test whether the file directory exists when uncompressing file entry
             //, if does not exist then create directory
-            const string fileNameStr(fileName);
-            
-            size_t startIndex=0;
-            
-            size_t index=fileNameStr.find("/",startIndex);
-            
-            while(index != std::string::npos)
+            if (!createParentDirectories(destPath, fileName))
             {
-                const string dir=_storagePath+fileNameStr.substr(0,index);
-                
-                FILE *out = fopen(dir.c_str(), "r");
-                
-                if(!out)
-                {
-                    if (!createDirectory(dir.c_str()))
-                    {
-                        CCLOG("can not create directory %s", dir.c_str());
-                        unzClose(zipfile);
-                        return false;
-                    }
-                    else
-                    {
-                        CCLOG("create directory %s",dir.c_str());
-                    }
-                }
-                else
-                {
-                    fclose(out);
-                }
-                
-                startIndex=index+1;
-                
-                index=fileNameStr.find("/",startIndex);
-                
+                unzClose(zipfile);
+                return false;
             }
             
-            
-            
             // Entry is a file, so extract it.
             
             // Open current file.
@@ -423,6 +498,11 @@ bool AssetsManager::uncompress()
             } while(error > 0);
             
             fclose(out);
+            
+            if (files)
+            {
+                files->push_back(fileName);
+            }
         }
         
         unzCloseCurrentFile(zipfile);
@@ -445,6 +525,43 @@ bool AssetsManager::uncompress()
     return true;
 }
 
+bool AssetsManager::createParentDirectories(const std::string& basePath, const std::string& fileName)
+{
+    size_t startIndex=0;
+    
+    size_t index=fileName.find("/",startIndex);
+    
+    while(index != std::string::npos)
+    {
+        const string dir=basePath+fileName.substr(0,index);
+        
+        FILE *out = fopen(dir.c_str(), "r");
+        
+        if(!out)
+        {
+            if (!createDirectory(dir.c_str()))
+            {
+                CCLOG("can not create directory %s", dir.c_str());
+                return false;
+            }
+            else
+            {
+                CCLOG("create directory %s",dir.c_str());
+            }
+        }
+        else
+        {
+            fclose(out);
+        }
+        
+        startIndex=index+1;
+        
+        index=fileName.find("/",startIndex);
+    }
+    
+    return true;
+}
+
 /*
  * Create a direcotry is platform depended.
  */
@@ -487,19 +604,24 @@ static size_t downLoadPackage(void *ptr, size_t size, size_t nmemb, void *userda
 
 int assetsManagerProgressFunc(void *ptr, double totalToDownload, double nowDownloaded, double totalToUpLoad, double nowUpLoaded)
 {
-    static int percent = 0;
-    int tmp = (int)(nowDownloaded / totalToDownload * 100);
+    auto manager = static_cast<AssetsManager*>(ptr);
     
-    if (percent != tmp)
+    // A resumed download only transfers the end of the package
+    double offset = (double)manager->_downloadedBytes;
+    if (totalToDownload <= 0)
+    {
+        return 0;
+    }
+    int tmp = (int)((offset + nowDownloaded) / (offset + totalToDownload) * 100);
+    
+    if (manager->_percent.exchange(tmp) != tmp)
     {
-        percent = tmp;
         Director::getInstance()->getScheduler()->performFunctionInCocosThread([=]{
-            auto manager = static_cast<AssetsManager*>(ptr);
             if (manager->_delegate)
-                manager->_delegate->onProgress(percent);
+                manager->_delegate->onProgress(tmp);
         });
         
-        CCLOG("downloading... %d%%", percent);
+        CCLOG("downloading... %d%%", tmp);
     }
     
     return 0;
@@ -507,51 +629,480 @@ int assetsManagerProgressFunc(void *ptr, double totalToDownload, double nowDownl
 
 bool AssetsManager::downLoad()
 {
-    // Create a file to save package.
     const string outFileName = _storagePath + TEMP_PACKAGE_FILE_NAME;
-    FILE *fp = fopen(outFileName.c_str(), "wb");
-    if (! fp)
+    
+    // Resume the package if the download of the same version was interrupted
+    bool resume = (_downloadingVersion == _version);
+    
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread([this]{
+        UserDefault::getInstance()->setStringForKey(this->keyOfDownloadingVersion().c_str(), this->_version.c_str());
+        UserDefault::getInstance()->flush();
+    });
+    
+    ErrorCode error;
+    bool succeed = downloadPackage(_curl, _packageUrl, outFileName, resume, &error);
+    curl_easy_cleanup(_curl);
+    if (! succeed)
     {
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
-            if (this->_delegate)
-                this->_delegate->onError(ErrorCode::CREATE_FILE);
-        });
-        CCLOG("can not create file %s", outFileName.c_str());
+        postError(error);
         return false;
     }
     
-    // Download pacakge
-    CURLcode res;
-    curl_easy_setopt(_curl, CURLOPT_URL, _packageUrl.c_str());
-    curl_easy_setopt(_curl, CURLOPT_WRITEFUNCTION, downLoadPackage);
-    curl_easy_setopt(_curl, CURLOPT_WRITEDATA, fp);
-    curl_easy_setopt(_curl, CURLOPT_NOPROGRESS, false);
-    curl_easy_setopt(_curl, CURLOPT_PROGRESSFUNCTION, assetsManagerProgressFunc);
-    curl_easy_setopt(_curl, CURLOPT_PROGRESSDATA, this);
-    curl_easy_setopt(_curl, CURLOPT_NOSIGNAL, 1L);
-    curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_LIMIT, LOW_SPEED_LIMIT);
-    curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME);
-    curl_easy_setopt(_curl, CURLOPT_FOLLOWLOCATION, 1 );
+    CCLOG("succeed downloading package %s", _packageUrl.c_str());
+    
+    return true;
+}
 
-    res = curl_easy_perform(_curl);
+bool AssetsManager::downloadPackage(void *curl, const std::string& url, const std::string& outFileName, bool resume, ErrorCode *error)
+{
+    long long offset = resume ? getFileSize(outFileName) : 0;
+    
+    _percent = -1;
+    
+    for (int attempt = 0; ; ++attempt)
+    {
+        // Create a file to save package.
+        FILE *fp = fopen(outFileName.c_str(), offset > 0 ? "ab" : "wb");
+        if (! fp)
+        {
+            CCLOG("can not create file %s", outFileName.c_str());
+            *error = ErrorCode::CREATE_FILE;
+            return false;
+        }
+        _downloadedBytes = offset;
+        
+        // Download pacakge
+        CURLcode res;
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, downLoadPackage);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
+        curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)offset);
+        curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, false);
+        curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, assetsManagerProgressFunc);
+        curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, this);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, LOW_SPEED_LIMIT);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME);
+        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1 );
+        
+        res = curl_easy_perform(curl);
+        fclose(fp);
+        if (res == CURLE_OK)
+        {
+            return true;
+        }
+        
+        bool rangeRefused = (offset > 0 && isRangeRefused(curl, res));
+        if (rangeRefused)
+        {
+            // What was downloaded can't be continued, the next update mustn't resume it either
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread([this]{
+                UserDefault::getInstance()->setStringForKey(this->keyOfDownloadingVersion().c_str(), "");
+                UserDefault::getInstance()->flush();
+            });
+        }
+        
+        if (attempt >= MAX_RETRIES)
+        {
+            CCLOG("error when download package, error code is %d", res);
+            *error = ErrorCode::NETWORK;
+            return false;
+        }
+        
+        // Start again when the range was refused, otherwise continue where the connection dropped
+        offset = rangeRefused ? 0 : getFileSize(outFileName);
+        CCLOG("download of package interrupted, error code is %d, retrying from %lld", res, offset);
+    }
+}
+
+struct DownloadContext
+{
+    FILE *fp;
+    AssetsManager *manager;
+};
+
+size_t assetsManagerWriteFunc(void *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    DownloadContext *context = (DownloadContext*)userdata;
+    size_t written = fwrite(ptr, size, nmemb, context->fp);
+    context->manager->addDownloadedBytes(written * size);
+    return written;
+}
+
+bool AssetsManager::parseManifest(const std::string& content, std::vector<ManifestEntry>& entries)
+{
+    std::istringstream stream(content);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (!line.empty() && line[line.size() - 1] == '\r')
+        {
+            line.erase(line.size() - 1);
+        }
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        
+        ManifestEntry entry;
+        char *end = nullptr;
+        entry.crc = strtoul(line.c_str(), &end, 16);
+        entry.size = strtol(end, &end, 10);
+        while (*end == ' ' || *end == '\t')
+        {
+            ++end;
+        }
+        entry.path = end;
+        
+        // The files must stay in the storage path
+        if (entry.path.empty() || entry.path[0] == '/' || entry.path.find("..") != std::string::npos)
+        {
+            CCLOG("invalid manifest entry %s", line.c_str());
+            return false;
+        }
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+bool AssetsManager::downloadManifest(std::string& content, std::vector<ManifestEntry>& entries)
+{
+    // The curl handle was created by checkUpdate()
+    curl_easy_setopt(_curl, CURLOPT_URL, _manifestUrl.c_str());
+    curl_easy_setopt(_curl, CURLOPT_WRITEFUNCTION, getVersionCode);
+    curl_easy_setopt(_curl, CURLOPT_WRITEDATA, &content);
+    curl_easy_setopt(_curl, CURLOPT_FAILONERROR, 1L);
+    CURLcode res = curl_easy_perform(_curl);
     curl_easy_cleanup(_curl);
-    if (res != 0)
+    _curl = nullptr;
+    
+    if (res != CURLE_OK)
     {
-        Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, this]{
-            if (this->_delegate)
-                this->_delegate->onError(ErrorCode::NETWORK);
-        });
-        CCLOG("error when download package");
+        postError(ErrorCode::NETWORK);
+        CCLOG("can not get manifest content, error code is %d", res);
+        return false;
+    }
+    
+    if (!parseManifest(content, entries))
+    {
+        postError(ErrorCode::VERIFY);
+        return false;
+    }
+    
+    return true;
+}
+
+bool AssetsManager::downloadManifestFiles(const std::vector<ManifestEntry>& entries, std::vector<std::string>& stagedFiles)
+{
+    const std::string stagingPath = _storagePath + STAGING_DIRECTORY_NAME;
+    const std::string baseUrl = _manifestUrl.substr(0, _manifestUrl.rfind('/') + 1);
+    
+    if (!createDirectory(stagingPath.c_str()))
+    {
+        postError(ErrorCode::CREATE_FILE);
+        CCLOG("can not create directory %s", stagingPath.c_str());
+        return false;
+    }
+    
+    // Only download the files which changed since the last update
+    std::unordered_map<std::string, unsigned long> installedFiles;
+    std::vector<ManifestEntry> installedEntries;
+    if (parseManifest(FileUtils::getInstance()->getStringFromFile(_storagePath + MANIFEST_FILE_NAME), installedEntries))
+    {
+        for (const auto& entry : installedEntries)
+        {
+            installedFiles[entry.path] = entry.crc;
+        }
+    }
+    
+    std::vector<const ManifestEntry*> changedEntries;
+    _totalBytes = 0;
+    for (const auto& entry : entries)
+    {
+        auto iter = installedFiles.find(entry.path);
+        if (iter == installedFiles.end() || iter->second != entry.crc)
+        {
+            changedEntries.push_back(&entry);
+            _totalBytes += entry.size;
+        }
+    }
+    _downloadedBytes = 0;
+    _percent = -1;
+    
+    CCLOG("%d files to download, %lld bytes", (int)changedEntries.size(), _totalBytes);
+    
+    // The download threads hand the files to the thread pool, which verifies and uncompresses them
+    // while the next files are downloaded.
+    std::atomic<size_t> nextEntry(0);
+    std::atomic<int> errorCode(-1);
+    std::mutex stageMutex;
+    std::condition_variable stageCondition;
+    int pendingFiles = 0;
+    
+    auto fail = [&errorCode](ErrorCode code) {
+        int expected = -1;
+        errorCode.compare_exchange_strong(expected, (int)code);
+    };
+    
+    auto downloadFiles = [&]() {
+        CURL *curl = curl_easy_init();
+        if (! curl)
+        {
+            fail(ErrorCode::NETWORK);
+            return;
+        }
+        
+        size_t index;
+        while (errorCode == -1 && (index = nextEntry++) < changedEntries.size())
+        {
+            const ManifestEntry *entry = changedEntries[index];
+            
+            // The checksum is part of the name, so a partial download of another version is never resumed
+            char suffix[32];
+            sprintf(suffix, ".%08lx.part", entry->crc);
+            const std::string partFileName = stagingPath + entry->path + suffix;
+            
+            ErrorCode error = ErrorCode::NETWORK;
+            if (!createParentDirectories(stagingPath, entry->path))
+            {
+                fail(ErrorCode::CREATE_FILE);
+                break;
+            }
+            if (!downloadFile(curl, baseUrl + entry->path, partFileName, entry->size, &error))
+            {
+                fail(error);
+                break;
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(stageMutex);
+                ++pendingFiles;
+            }
+            ThreadPool::getInstance()->pushTask([&, entry, partFileName]() {
+                std::vector<std::string> files;
+                ErrorCode error = ErrorCode::VERIFY;
+                bool staged = stageFile(*entry, partFileName, files, &error);
+                
+                std::lock_guard<std::mutex> lock(stageMutex);
+                if (staged)
+                {
+                    stagedFiles.insert(stagedFiles.end(), files.begin(), files.end());
+                }
+                else
+                {
+                    fail(error);
+                }
+                if (--pendingFiles == 0)
+                {
+                    stageCondition.notify_all();
+                }
+            });
+        }
+        
+        curl_easy_cleanup(curl);
+    };
+    
+    int threadCount = std::max(1, std::min(_maxConcurrentDownloads, (int)changedEntries.size()));
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; ++i)
+    {
+        threads.push_back(std::thread(downloadFiles));
+    }
+    downloadFiles();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(stageMutex);
+        stageCondition.wait(lock, [&pendingFiles]() { return pendingFiles == 0; });
+    }
+    
+    if (errorCode != -1)
+    {
+        postError((ErrorCode)(int)errorCode);
+        return false;
+    }
+    
+    return true;
+}
+
+bool AssetsManager::downloadFile(void *curl, const std::string& url, const std::string& outFileName, long size, ErrorCode *error)
+{
+    // Resume the download of a previous update
+    long long offset = getFileSize(outFileName);
+    if (offset > size)
+    {
+        offset = 0;
+    }
+    addDownloadedBytes(offset);
+    if (offset == size)
+    {
+        return true;
+    }
+    
+    for (int attempt = 0; ; ++attempt)
+    {
+        FILE *fp = fopen(outFileName.c_str(), offset > 0 ? "ab" : "wb");
+        if (! fp)
+        {
+            CCLOG("can not create file %s", outFileName.c_str());
+            *error = ErrorCode::CREATE_FILE;
+            return false;
+        }
+        
+        DownloadContext context = { fp, this };
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, assetsManagerWriteFunc);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &context);
+        curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)offset);
+        curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+        if (_connectionTimeout) curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, _connectionTimeout);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, LOW_SPEED_LIMIT);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME);
+        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1 );
+        
+        CURLcode res = curl_easy_perform(curl);
         fclose(fp);
+        if (res == CURLE_OK)
+        {
+            return true;
+        }
+        
+        if (attempt >= MAX_RETRIES)
+        {
+            CCLOG("error when downloading %s, error code is %d", url.c_str(), res);
+            *error = ErrorCode::NETWORK;
+            return false;
+        }
+        
+        long long written = getFileSize(outFileName);
+        if (offset > 0 && isRangeRefused(curl, res))
+        {
+            // The server can't continue the file, start again
+            addDownloadedBytes(-written);
+            offset = 0;
+        }
+        else
+        {
+            offset = written;
+        }
+    }
+}
+
+bool AssetsManager::stageFile(const ManifestEntry& entry, const std::string& partFileName, std::vector<std::string>& stagedFiles, ErrorCode *error)
+{
+    const std::string stagingPath = _storagePath + STAGING_DIRECTORY_NAME;
+    
+    unsigned long crc = 0;
+    if (!getFileCrc32(partFileName, &crc) || crc != entry.crc)
+    {
+        CCLOG("%s doesn't match the manifest", entry.path.c_str());
+        remove(partFileName.c_str());
+        *error = ErrorCode::VERIFY;
         return false;
     }
     
-    CCLOG("succeed downloading package %s", _packageUrl.c_str());
+    // Zip files are uncompressed into the storage path
+    if (isZipFile(entry.path))
+    {
+        bool uncompressed = uncompressFile(partFileName, stagingPath, &stagedFiles);
+        remove(partFileName.c_str());
+        if (!uncompressed)
+        {
+            *error = ErrorCode::UNCOMPRESS;
+        }
+        return uncompressed;
+    }
+    
+    // rename() doesn't replace an existing file on Windows
+    const std::string stagedFileName = stagingPath + entry.path;
+    remove(stagedFileName.c_str());
+    if (rename(partFileName.c_str(), stagedFileName.c_str()) != 0)
+    {
+        CCLOG("can not rename %s", partFileName.c_str());
+        *error = ErrorCode::CREATE_FILE;
+        return false;
+    }
+    
+    stagedFiles.push_back(entry.path);
+    return true;
+}
+
+bool AssetsManager::activateStagedFiles(const std::vector<std::string>& stagedFiles, const std::string& manifest)
+{
+    const std::string stagingPath = _storagePath + STAGING_DIRECTORY_NAME;
     
+    for (const auto& file : stagedFiles)
+    {
+        const std::string fileName = _storagePath + file;
+        if (!createParentDirectories(_storagePath, file))
+        {
+            postError(ErrorCode::CREATE_FILE);
+            return false;
+        }
+        
+        remove(fileName.c_str());
+        if (rename((stagingPath + file).c_str(), fileName.c_str()) != 0)
+        {
+            CCLOG("can not move %s to %s", (stagingPath + file).c_str(), fileName.c_str());
+            postError(ErrorCode::CREATE_FILE);
+            return false;
+        }
+    }
+    
+    // The manifest is replaced last: if the update is interrupted before, the next one
+    // downloads the files again.
+    const std::string manifestFileName = _storagePath + MANIFEST_FILE_NAME;
+    const std::string tempFileName = manifestFileName + ".tmp";
+    FILE *fp = fopen(tempFileName.c_str(), "wb");
+    if (! fp)
+    {
+        CCLOG("can not create file %s", tempFileName.c_str());
+        postError(ErrorCode::CREATE_FILE);
+        return false;
+    }
+    fwrite(manifest.c_str(), manifest.size(), 1, fp);
     fclose(fp);
+    
+    remove(manifestFileName.c_str());
+    if (rename(tempFileName.c_str(), manifestFileName.c_str()) != 0)
+    {
+        CCLOG("can not rename %s", tempFileName.c_str());
+        postError(ErrorCode::CREATE_FILE);
+        return false;
+    }
+    
+    CCLOG("succeed updating %d files from %s", (int)stagedFiles.size(), _manifestUrl.c_str());
     return true;
 }
 
+void AssetsManager::addDownloadedBytes(long long bytes)
+{
+    long long downloaded = (_downloadedBytes += bytes);
+    int percent = _totalBytes > 0 ? (int)(downloaded * 100 / _totalBytes) : 100;
+    
+    if (_percent.exchange(percent) != percent)
+    {
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, percent]{
+            if (this->_delegate)
+                this->_delegate->onProgress(percent);
+        });
+    }
+}
+
+void AssetsManager::postError(ErrorCode code)
+{
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, code]{
+        if (this->_delegate)
+            this->_delegate->onError(code);
+    });
+}
+
 const char* AssetsManager::getPackageUrl() const
 {
     return _packageUrl.c_str();
@@ -608,6 +1159,26 @@ unsigned int AssetsManager::getConnectionTimeout()
     return _connectionTimeout;
 }
 
+void AssetsManager::setManifestUrl(const char *manifestUrl)
+{
+    _manifestUrl = manifestUrl;
+}
+
+const char* AssetsManager::getManifestUrl() const
+{
+    return _manifestUrl.c_str();
+}
+
+void AssetsManager::setMaxConcurrentDownloads(int count)
+{
+    _maxConcurrentDownloads = std::max(1, count);
+}
+
+int AssetsManager::getMaxConcurrentDownloads() const
+{
+    return _maxConcurrentDownloads;
+}
+
 AssetsManager* AssetsManager::create(const char* packageUrl, const char* versionFileUrl, const char* storagePath, ErrorCallback errorCallback, ProgressCallback progressCallback, SuccessCallback successCallback )
 {
     class DelegateProtocolImpl : public AssetsManagerDelegateProtocol 
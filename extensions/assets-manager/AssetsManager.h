@@ -26,7 +26,9 @@
 #define __AssetsManager__
 
 #include <string>
+#include <vector>
 
+#include <atomic>
 #include <mutex>
 
 #include "2d/CCNode.h"
@@ -66,6 +68,9 @@ public:
          -- ...
          */
         UNCOMPRESS,
+        /** A downloaded file doesn't match the checksum of the manifest
+         */
+        VERIFY,
     };
     
     /* @brief Creates a AssetsManager with new package url, version code url and storage path.
@@ -157,17 +162,63 @@ public:
      */
     unsigned int getConnectionTimeout();
     
+    /* @brief Sets the url of the manifest of the resources.
+     *
+     * When a manifest url is set, update() downloads the files of the manifest which changed
+     * since the last update instead of the package. Each line of the manifest describes a file:
+     *
+     *     <crc32 in hexadecimal> <size in bytes> <path>
+     *
+     * The path is relative to the url of the manifest, and to the storage path once downloaded.
+     * The files are downloaded to a staging directory, several at a time, and interrupted
+     * downloads resume with HTTP range requests. Each file is verified, and zip files are
+     * uncompressed, while the next ones are downloaded. The files replace the previous ones
+     * only after all of them have been verified.
+     */
+    void setManifestUrl(const char* manifestUrl);
+    
+    /* @brief Gets the url of the manifest, empty when the package is used.
+     */
+    const char* getManifestUrl() const;
+    
+    /** @brief Sets how many files of the manifest are downloaded at the same time, 4 by default.
+     */
+    void setMaxConcurrentDownloads(int count);
+    int getMaxConcurrentDownloads() const;
+    
     /* downloadAndUncompress is the entry of a new thread 
      */
     friend int assetsManagerProgressFunc(void *, double, double, double, double);
+    friend size_t assetsManagerWriteFunc(void *, size_t, size_t, void *);
 
 protected:
     bool downLoad();
+    /** Downloads the package to outFileName, continuing the previous download of the file if resume is true. */
+    bool downloadPackage(void *curl, const std::string& url, const std::string& outFileName, bool resume, ErrorCode *error);
     void checkStoragePath();
     bool uncompress();
     bool createDirectory(const char *path);
     void setSearchPath();
     void downloadAndUncompress();
+    
+    struct ManifestEntry
+    {
+        std::string path;
+        unsigned long crc;
+        long size;
+    };
+    
+    static bool parseManifest(const std::string& content, std::vector<ManifestEntry>& entries);
+    bool downloadManifest(std::string& content, std::vector<ManifestEntry>& entries);
+    bool downloadManifestFiles(const std::vector<ManifestEntry>& entries, std::vector<std::string>& stagedFiles);
+    bool downloadFile(void *curl, const std::string& url, const std::string& outFileName, long size, ErrorCode *error);
+    bool stageFile(const ManifestEntry& entry, const std::string& partFileName, std::vector<std::string>& stagedFiles, ErrorCode *error);
+    bool activateStagedFiles(const std::vector<std::string>& stagedFiles, const std::string& manifest);
+    
+    bool uncompressFile(const std::string& zipFileName, const std::string& destPath, std::vector<std::string>* files);
+    bool createParentDirectories(const std::string& basePath, const std::string& fileName);
+    void addDownloadedBytes(long long bytes);
+    void postError(ErrorCode code);
 
 private:
     /** @brief Initializes storage path.
@@ -189,6 +240,15 @@ private:
     std::string _versionFileUrl;
     
     std::string _downloadedVersion;
+    std::string _downloadingVersion;
+    
+    std::string _manifestUrl;
+    int _maxConcurrentDownloads;
+    
+    // Bytes of the current download, for the progress
+    std::atomic<long long> _downloadedBytes;
+    long long _totalBytes;
+    std::atomic<int> _percent;
     
     void *_curl;
 
@@ -201,6 +261,7 @@ private:
     
     std::string keyOfVersion() const;
     std::string keyOfDownloadedVersion() const;
+    std::string keyOfDownloadingVersion() const;
 };
 
 class AssetsManagerDelegateProtocol
@@ -33,6 +33,7 @@ static std::function<Layer*()> createFunctions[] = {
     CL(RawStencilBufferTest5),
     CL(RawStencilBufferTest6),
     CL(ClippingToRenderTextureTest),
+    CL(ScissorClippingTest),
 };
 
 static int sceneIdx=-1;
@@ -1097,6 +1098,103 @@ void ClippingToRenderTextureTest::reproduceBug()
     rt->end();
 }
 
+// ScissorClippingTest
+
+std::string ScissorClippingTest::title() const
+{
+    return "Scissor Clipping";
+}
+
+std::string ScissorClippingTest::subtitle() const
+{
+    return "Rectangles use the scissor test, circles share their stencil";
+}
+
+void ScissorClippingTest::setup()
+{
+    _scissorClippingEnabled = true;
+
+    auto s = Director::getInstance()->getWinSize();
+    static const int columns = 10;
+    static const int rows = 5;
+    float cellWidth = s.width * 0.8f / columns;
+    float cellHeight = s.height * 0.5f / rows;
+    Color4F white(1, 1, 1, 1);
+
+    // a grid of rectangular clippers, clipped with the scissor test
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            auto stencil = DrawNode::create();
+            stencil->drawSolidRect(Vec2::ZERO, Vec2(cellWidth - 4, cellHeight - 4), white);
+
+            auto clipper = ClippingNode::create(stencil);
+            clipper->setPosition(s.width * 0.1f + column * cellWidth, s.height * 0.3f + row * cellHeight);
+            this->addChild(clipper);
+            _clippers.pushBack(clipper);
+
+            auto content = Sprite::create(s_pathGrossini);
+            content->setPosition(cellWidth / 2, cellHeight / 2);
+            content->runAction(RepeatForever::create(Sequence::createWithTwoActions(MoveBy::create(1, Vec2(0, -cellHeight)), MoveBy::create(1, Vec2(0, cellHeight)))));
+            clipper->addChild(content);
+        }
+    }
+
+    // sibling clippers with the same circular stencil at the same place: the stencil is drawn once
+    auto stencil = DrawNode::create();
+    stencil->drawSolidCircle(Vec2::ZERO, cellHeight, 0, 32, white);
+    for (int i = 0; i < 3; ++i)
+    {
+        auto background = ClippingNode::create(stencil);
+        background->setPosition(s.width * (0.25f + i * 0.25f), s.height * 0.18f);
+        this->addChild(background);
+        _clippers.pushBack(background);
+
+        auto layer = LayerColor::create(Color4B(0, 0, 255, 255), cellHeight * 2, cellHeight * 2);
+        layer->setPosition(-cellHeight, -cellHeight);
+        background->addChild(layer);
+
+        auto foreground = ClippingNode::create(stencil);
+        foreground->setPosition(background->getPosition());
+        this->addChild(foreground);
+        _clippers.pushBack(foreground);
+
+        auto content = Sprite::create(s_pathGrossini);
+        content->runAction(RepeatForever::create(RotateBy::create(2, 360)));
+        foreground->addChild(content);
+    }
+
+    auto button = MenuItemFont::create("Toggle scissor clipping", CC_CALLBACK_1(ScissorClippingTest::toggleScissorClipping, this));
+    auto menu = Menu::create(button, nullptr);
+    menu->setPosition(s.width / 2, s.height * 0.86f);
+    this->addChild(menu, 1);
+
+    _drawCallsLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _drawCallsLabel->setPosition(s.width / 2, s.height * 0.8f);
+    this->addChild(_drawCallsLabel, 1);
+
+    schedule(schedule_selector(ScissorClippingTest::updateDrawCalls), 0.5f);
+}
+
+void ScissorClippingTest::toggleScissorClipping(Ref* sender)
+{
+    _scissorClippingEnabled = !_scissorClippingEnabled;
+    for (const auto& clipper : _clippers)
+    {
+        clipper->setScissorClippingEnabled(_scissorClippingEnabled);
+    }
+}
+
+void ScissorClippingTest::updateDrawCalls(float dt)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    char text[128];
+    sprintf(text, "scissor clipping: %s, draw calls: %d, vertices: %d",
+            _scissorClippingEnabled ? "on" : "off", (int)renderer->getDrawnBatches(), (int)renderer->getDrawnVertices());
+    _drawCallsLabel->setString(text);
+}
+
 
 // main entry point
 
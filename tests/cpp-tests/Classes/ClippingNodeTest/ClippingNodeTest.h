@@ -244,6 +244,25 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class ScissorClippingTest : public BaseClippingNodeTest
+{
+public:
+    CREATE_FUNC(ScissorClippingTest);
+
+    void toggleScissorClipping(Ref* sender);
+    void updateDrawCalls(float dt);
+
+    // override
+    virtual void setup() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    Vector<ClippingNode*> _clippers;
+    Label* _drawCallsLabel;
+    bool _scissorClippingEnabled;
+};
+
 
 class ClippingNodeTestScene : public TestScene
 {
@@ -359,6 +359,14 @@ void CocosDenshionTest::addButtons()
         SimpleAudioEngine::getInstance()->stopAllEffects();
     });
     addChildAt(btnStopAll, 0.9f, 0.6f);
+
+    Button *btnPreloadAsync = Button::createWithText("preload async");
+    btnPreloadAsync->onTriggered([this]() {
+        SimpleAudioEngine::getInstance()->preloadEffectAsync(EFFECT_FILE, [](bool loaded) {
+            log("preloadEffectAsync: %s", loaded ? "loaded" : "failed");
+        });
+    });
+    addChildAt(btnPreloadAsync, 0.75f, 0.5f);
 }
 
 void CocosDenshionTest::addSliders()
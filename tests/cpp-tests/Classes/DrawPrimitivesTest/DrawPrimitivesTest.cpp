@@ -25,11 +25,13 @@ static Layer* create##className() \
 
 DRAWPRIMITIVES_CREATE_FUNC(DrawPrimitivesTest);
 DRAWPRIMITIVES_CREATE_FUNC(DrawNodeTest);
+DRAWPRIMITIVES_CREATE_FUNC(DrawNodeBatchTest);
 
 static NEWDRAWPRIMITIVESFUNC createFunctions[] =
 {
     createDrawPrimitivesTest,
     createDrawNodeTest,
+    createDrawNodeBatchTest,
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -387,6 +389,54 @@ string DrawNodeTest::subtitle() const
     return "Testing DrawNode - batched draws. Concave polygons are BROKEN";
 }
 
+// DrawNodeBatchTest
+
+DrawNodeBatchTest::DrawNodeBatchTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    
+    // health bars: a lot of small DrawNodes, moving so that they are transformed every frame
+    for (int i = 0; i < 200; i++)
+    {
+        auto draw = DrawNode::create();
+        draw->drawSolidRect(Vec2(-20, -3), Vec2(20, 3), Color4F(0.2f, 0.2f, 0.2f, 1));
+        draw->drawSolidRect(Vec2(-19, -2), Vec2(-19 + 38 * CCRANDOM_0_1(), 2), Color4F(0, 1, 0, 1));
+        draw->drawRect(Vec2(-20, -3), Vec2(20, 3), Color4F(1, 1, 1, 1));
+        draw->drawDot(Vec2(-24, 0), 3, Color4F(1, 0, 0, 1));
+        draw->drawPoint(Vec2(24, 0), 3, Color4F(1, 1, 0, 1));
+        draw->setPosition(Vec2(s.width * CCRANDOM_0_1(), s.height * CCRANDOM_0_1()));
+        draw->runAction(RepeatForever::create(Sequence::create(MoveBy::create(1, Vec2(0, 20)), MoveBy::create(1, Vec2(0, -20)), nullptr)));
+        addChild(draw, 10);
+        _drawNodes.pushBack(draw);
+    }
+    
+    _modeLabel = Label::createWithTTF("Batched", "fonts/arial.ttf", 20);
+    auto item = MenuItemLabel::create(_modeLabel, CC_CALLBACK_1(DrawNodeBatchTest::toggleBatched, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(Vec2(s.width / 2, 60));
+    addChild(menu, 20);
+}
+
+void DrawNodeBatchTest::toggleBatched(Ref* sender)
+{
+    bool batched = !_drawNodes.front()->isBatched();
+    for (auto draw : _drawNodes)
+    {
+        draw->setBatched(batched);
+    }
+    _modeLabel->setString(batched ? "Batched" : "Not batched");
+}
+
+string DrawNodeBatchTest::title() const
+{
+    return "DrawNode batching";
+}
+
+string DrawNodeBatchTest::subtitle() const
+{
+    return "200 DrawNodes. Click the label to toggle batching and compare the draw calls";
+}
+
 void DrawPrimitivesTestScene::runThisTest()
 {
     auto layer = nextAction();
@@ -43,6 +43,21 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class DrawNodeBatchTest : public BaseLayer
+{
+public:
+    DrawNodeBatchTest();
+    
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    void toggleBatched(Ref* sender);
+
+    Vector<DrawNode*> _drawNodes;
+    Label* _modeLabel;
+};
+
 class DrawPrimitivesTestScene : public TestScene
 {
 public:
@@ -33,6 +33,9 @@ Layer *CreateLayer(int index)
     case TEST_PERFORMANCE:
         pLayer = new (std::nothrow) TestPerformance();
         break;
+    case TEST_PARALLEL_PERFORMANCE:
+        pLayer = new (std::nothrow) TestParallelPerformance();
+        break;
 //    case TEST_PERFORMANCE_BATCHNODE:
 //        pLayer = new (std::nothrow) TestPerformanceBatchNode();
 //        break;
@@ -441,6 +444,80 @@ void TestPerformance::refreshTitle()
 }
 
 
+void TestParallelPerformance::onEnter()
+{
+    TestPerformance::onEnter();
+
+    // 200 armatures, as in a battle scene
+    addArmature(100);
+
+    auto toggleLabel = Label::createWithTTF("Parallel update: off", "fonts/arial.ttf", 24);
+    toggleLabel->setColor(Color3B(0,200,20));
+    auto toggle = MenuItemLabel::create(toggleLabel, CC_CALLBACK_1(TestParallelPerformance::onToggleParallel, this));
+    Menu *menu = Menu::create(toggle, nullptr);
+    menu->setPosition(VisibleRect::getVisibleRect().size.width/2, VisibleRect::getVisibleRect().size.height-150);
+    addChild(menu, 10000);
+
+    timeLabel = Label::createWithTTF("", "fonts/arial.ttf", 18);
+    timeLabel->setColor(Color3B::BLACK);
+    timeLabel->setPosition(VisibleRect::center().x, VisibleRect::bottom().y + 80);
+    addChild(timeLabel, 10000);
+
+    updateStart = updateTime = 0;
+    updateFrames = 0;
+
+    // update() runs before the armatures' update, EVENT_AFTER_UPDATE after the parallel poses are computed
+    scheduleUpdateWithPriority(-1);
+    afterUpdateListener = _eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom*) {
+        onAfterUpdate();
+    });
+}
+
+void TestParallelPerformance::onExit()
+{
+    _eventDispatcher->removeEventListener(afterUpdateListener);
+    Armature::setParallelUpdateEnabled(false);
+
+    TestPerformance::onExit();
+}
+
+std::string TestParallelPerformance::title() const
+{
+    return "Test Parallel Pose Update";
+}
+
+void TestParallelPerformance::update(float dt)
+{
+    updateStart = utils::gettime();
+}
+
+void TestParallelPerformance::onAfterUpdate()
+{
+    // update() hasn't run yet on the frame the layer enters
+    if (updateStart == 0)
+        return;
+
+    updateTime += utils::gettime() - updateStart;
+    if (++updateFrames == 60)
+    {
+        char text[64];
+        sprintf(text, "Update: %.2f ms per frame", updateTime * 1000 / updateFrames);
+        timeLabel->setString(text);
+        updateTime = 0;
+        updateFrames = 0;
+    }
+}
+
+void TestParallelPerformance::onToggleParallel(Ref* pSender)
+{
+    bool enabled = !Armature::isParallelUpdateEnabled();
+    Armature::setParallelUpdateEnabled(enabled);
+    static_cast<MenuItemLabel*>(pSender)->setString(enabled ? "Parallel update: on" : "Parallel update: off");
+
+    updateTime = 0;
+    updateFrames = 0;
+}
+
 void TestPerformanceBatchNode::onEnter()
 {
     batchNode = BatchNode::create();
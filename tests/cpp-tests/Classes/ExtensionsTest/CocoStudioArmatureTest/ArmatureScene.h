@@ -31,6 +31,7 @@ enum {
 	TEST_COCOSTUDIO_WITH_SKELETON,
 	TEST_DRAGON_BONES_2_0,
 	TEST_PERFORMANCE,
+	TEST_PARALLEL_PERFORMANCE,
 //    TEST_PERFORMANCE_BATCHNODE,
 	TEST_CHANGE_ZORDER,
 	TEST_ANIMATION_EVENT,
@@ -127,6 +128,23 @@ public:
 	bool generated;
 };
 
+class TestParallelPerformance : public TestPerformance
+{
+public:
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual void update(float dt) override;
+    void onToggleParallel(Ref* pSender);
+    void onAfterUpdate();
+
+    cocos2d::EventListenerCustom *afterUpdateListener;
+    cocos2d::Label *timeLabel;
+    double updateStart;
+    double updateTime;
+    int updateFrames;
+};
+
 class TestPerformanceBatchNode : public TestPerformance
 {
     virtual void onEnter() override;
@@ -1,4 +1,5 @@
 #include "FileUtilsTest.h"
+#include <chrono>
 
 static std::function<Layer*()> createFunctions[] = {
     CL(TestResolutionDirectories),
@@ -7,6 +8,7 @@ static std::function<Layer*()> createFunctions[] = {
     CL(TestIsFileExist),
     CL(TestFileFuncs),
     CL(TestDirectoryFuncs),
+    CL(TestDirectoryIndex),
     CL(TextWritePlist),
 };
 
@@ -471,6 +473,96 @@ std::string TestDirectoryFuncs::subtitle() const
     return "";
 }
 
+// TestDirectoryIndex
+
+void TestDirectoryIndex::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto s = Director::getInstance()->getWinSize();
+    auto sharedFileUtils = FileUtils::getInstance();
+
+    _defaultSearchPathArray = sharedFileUtils->getSearchPaths();
+    std::vector<std::string> searchPaths = _defaultSearchPathArray;
+    searchPaths.insert(searchPaths.begin(), "Misc");
+    sharedFileUtils->setSearchPaths(searchPaths);
+
+    _defaultResolutionsOrderArray = sharedFileUtils->getSearchResolutionsOrder();
+    std::vector<std::string> resolutionsOrder = _defaultResolutionsOrderArray;
+    resolutionsOrder.insert(resolutionsOrder.begin(), "resources-ipadhd");
+    resolutionsOrder.insert(resolutionsOrder.begin()+1, "resources-ipad");
+    resolutionsOrder.insert(resolutionsOrder.begin()+2, "resources-widehd");
+    resolutionsOrder.insert(resolutionsOrder.begin()+3, "resources-wide");
+    resolutionsOrder.insert(resolutionsOrder.begin()+4, "resources-hd");
+    resolutionsOrder.insert(resolutionsOrder.begin()+5, "resources-iphone");
+    sharedFileUtils->setSearchResolutionsOrder(resolutionsOrder);
+
+    // found in different resolution directories, and missing
+    const std::vector<std::string> filenames = {
+        "test1.txt", "test2.txt", "test3.txt", "test4.txt", "test5.txt", "test6.txt",
+        "Images/grossini.png", "Images/grossini-hd.png", "Images/grossini.xcf",
+    };
+    const int loops = 100;
+
+    auto resolve = [&](std::vector<std::string>* results) -> double {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loops; ++i)
+        {
+            results->clear();
+            sharedFileUtils->purgeCachedEntries();
+            for (const auto& filename : filenames)
+            {
+                results->push_back(sharedFileUtils->fullPathForFilename(filename));
+                // the second lookup hits the cache, a miss too when the index is enabled
+                sharedFileUtils->fullPathForFilename(filename);
+            }
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    };
+
+    std::vector<std::string> statResults;
+    std::vector<std::string> indexResults;
+    sharedFileUtils->setDirectoryIndexEnabled(false);
+    double statTime = resolve(&statResults);
+    sharedFileUtils->setDirectoryIndexEnabled(true);
+    double indexTime = resolve(&indexResults);
+    sharedFileUtils->setDirectoryIndexEnabled(false);
+
+    for (size_t i = 0; i < filenames.size(); ++i)
+    {
+        log("%s -> %s | %s", filenames[i].c_str(), statResults[i].c_str(), indexResults[i].c_str());
+    }
+
+    std::string msg = (statResults == indexResults) ? "The index finds the same files" : "The index finds different files!";
+    auto label = Label::createWithSystemFont(msg, "", 20);
+    label->setPosition(s.width/2, s.height/3*2);
+    this->addChild(label);
+
+    msg = StringUtils::format("%d lookups: %.2f ms without index, %.2f ms with index", loops * (int)filenames.size() * 2, statTime, indexTime);
+    label = Label::createWithSystemFont(msg, "", 20);
+    label->setPosition(s.width/2, s.height/3);
+    this->addChild(label);
+}
+
+void TestDirectoryIndex::onExit()
+{
+    auto sharedFileUtils = FileUtils::getInstance();
+
+    // reset search path
+    sharedFileUtils->setSearchPaths(_defaultSearchPathArray);
+    sharedFileUtils->setSearchResolutionsOrder(_defaultResolutionsOrderArray);
+    FileUtilsDemo::onExit();
+}
+
+std::string TestDirectoryIndex::title() const
+{
+    return "FileUtils: directory index";
+}
+
+std::string TestDirectoryIndex::subtitle() const
+{
+    return "Resolves files with and without the index, see the console";
+}
+
 // TestWritePlist
 
 void TextWritePlist::onEnter()
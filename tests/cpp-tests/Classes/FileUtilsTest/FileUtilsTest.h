@@ -92,6 +92,20 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class TestDirectoryIndex : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestDirectoryIndex);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::vector<std::string> _defaultSearchPathArray;
+    std::vector<std::string> _defaultResolutionsOrderArray;
+};
+
 class TextWritePlist : public FileUtilsDemo
 {
 public:
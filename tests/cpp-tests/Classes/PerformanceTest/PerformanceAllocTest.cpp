@@ -5,6 +5,9 @@
 
 #include <algorithm>
 
+#include "../ExtensionsTest/CocosBuilderTest/AnimationsTest/AnimationsLayerLoader.h"
+#include "../ExtensionsTest/CocosBuilderTest/TestHeader/TestHeaderLayerLoader.h"
+
 // Enable profiles for this file
 #undef CC_PROFILER_DISPLAY_TIMERS
 #define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
@@ -39,6 +42,10 @@ static std::function<PerformceAllocScene*()> createFunctions[] =
     CL(SpriteCreateEmptyTest),
     CL(SpriteCreateTest),
     CL(SpriteDeallocTest),
+    CL(SpriteCreateAddChildTest),
+    CL(PrefabInstantiateTest),
+    CL(CCBReaderReadTest),
+    CL(CCBReaderTemplateTest),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -470,6 +477,226 @@ const char*  SpriteDeallocTest::testName()
     return "Sprite::~Sprite()";
 }
 
+////////////////////////////////////////////////////////
+//
+// SpriteCreateAddChildTest
+//
+////////////////////////////////////////////////////////
+
+// a bullet: a sprite with a smaller glow sprite
+static Sprite* createBullet()
+{
+    auto bullet = Sprite::create("Images/r1.png");
+    auto glow = Sprite::create("Images/r1.png");
+    glow->setScale(0.5f);
+    glow->setOpacity(128);
+    glow->setPosition(Vec2(bullet->getContentSize().width / 2, bullet->getContentSize().height / 2));
+    bullet->addChild(glow);
+    return bullet;
+}
+
+void SpriteCreateAddChildTest::updateQuantityOfNodes()
+{
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void SpriteCreateAddChildTest::initWithQuantityOfNodes(unsigned int nNodes)
+{
+    PerformceAllocScene::initWithQuantityOfNodes(nNodes);
+
+    _spawnLayer = Node::create();
+    addChild(_spawnLayer);
+
+    scheduleUpdate();
+}
+
+void SpriteCreateAddChildTest::update(float dt)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    CC_PROFILER_START(this->profilerName());
+    for( int i=0; i<quantityOfNodes; ++i)
+    {
+        auto bullet = createBullet();
+        bullet->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        _spawnLayer->addChild(bullet);
+    }
+    CC_PROFILER_STOP(this->profilerName());
+
+    _spawnLayer->removeAllChildren();
+}
+
+std::string SpriteCreateAddChildTest::title() const
+{
+    return "Spawn with create + addChild";
+}
+
+std::string SpriteCreateAddChildTest::subtitle() const
+{
+    return "Sprite with a child sprite, spawned every frame. See console";
+}
+
+const char*  SpriteCreateAddChildTest::testName()
+{
+    return "Sprite::create + addChild";
+}
+
+////////////////////////////////////////////////////////
+//
+// PrefabInstantiateTest
+//
+////////////////////////////////////////////////////////
+PrefabInstantiateTest::~PrefabInstantiateTest()
+{
+    CC_SAFE_RELEASE(_prefab);
+}
+
+void PrefabInstantiateTest::updateQuantityOfNodes()
+{
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void PrefabInstantiateTest::initWithQuantityOfNodes(unsigned int nNodes)
+{
+    PerformceAllocScene::initWithQuantityOfNodes(nNodes);
+
+    _spawnLayer = Node::create();
+    addChild(_spawnLayer);
+
+    _prefab = Prefab::create(createBullet());
+    _prefab->retain();
+
+    scheduleUpdate();
+}
+
+void PrefabInstantiateTest::update(float dt)
+{
+    auto s = Director::getInstance()->getWinSize();
+    std::vector<Node*> bullets;
+
+    CC_PROFILER_START(this->profilerName());
+    _prefab->instantiate(quantityOfNodes, _spawnLayer, &bullets);
+    for (auto bullet : bullets)
+    {
+        bullet->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+    }
+    CC_PROFILER_STOP(this->profilerName());
+
+    // the bullets go back to the prefab's pool
+    _spawnLayer->removeAllChildren();
+}
+
+std::string PrefabInstantiateTest::title() const
+{
+    return "Spawn with Prefab";
+}
+
+std::string PrefabInstantiateTest::subtitle() const
+{
+    return "Same subtree instantiated from a Prefab. See console";
+}
+
+const char*  PrefabInstantiateTest::testName()
+{
+    return "Prefab::instantiate";
+}
+
+////////////////////////////////////////////////////////
+//
+// CCBReaderReadTest
+//
+////////////////////////////////////////////////////////
+CCBReaderReadTest::~CCBReaderReadTest()
+{
+    CC_SAFE_RELEASE(_nodeLoaderLibrary);
+}
+
+void CCBReaderReadTest::updateQuantityOfNodes()
+{
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void CCBReaderReadTest::initWithQuantityOfNodes(unsigned int nNodes)
+{
+    PerformceAllocScene::initWithQuantityOfNodes(nNodes);
+
+    _spawnLayer = Node::create();
+    addChild(_spawnLayer);
+
+    _nodeLoaderLibrary = cocosbuilder::NodeLoaderLibrary::newDefaultNodeLoaderLibrary();
+    _nodeLoaderLibrary->registerNodeLoader("TestHeaderLayer", TestHeaderLayerLoader::loader());
+    _nodeLoaderLibrary->registerNodeLoader("TestAnimationsLayer", AnimationsTestLayerLoader::loader());
+    _nodeLoaderLibrary->retain();
+
+    scheduleUpdate();
+}
+
+void CCBReaderReadTest::update(float dt)
+{
+    cocosbuilder::CCBReader::setTemplateCacheEnabled(isTemplateCacheEnabled());
+
+    // a ccbi file creates a few dozen nodes: read one file per 100 nodes
+    int files = std::max(quantityOfNodes / 100, 1);
+
+    CC_PROFILER_START(this->profilerName());
+    for( int i=0; i<files; ++i)
+    {
+        auto reader = new (std::nothrow) cocosbuilder::CCBReader(_nodeLoaderLibrary);
+        auto node = reader->readNodeGraphFromFile("ccb/ccb/TestAnimations.ccbi");
+        reader->release();
+
+        if (node)
+        {
+            _spawnLayer->addChild(node);
+        }
+    }
+    CC_PROFILER_STOP(this->profilerName());
+
+    _spawnLayer->removeAllChildren();
+}
+
+void CCBReaderReadTest::onExitTransitionDidStart()
+{
+    PerformceAllocScene::onExitTransitionDidStart();
+
+    cocosbuilder::CCBReader::setTemplateCacheEnabled(true);
+}
+
+std::string CCBReaderReadTest::title() const
+{
+    return "CCBReader without template cache";
+}
+
+std::string CCBReaderReadTest::subtitle() const
+{
+    return "TestAnimations.ccbi read every frame. See console";
+}
+
+const char*  CCBReaderReadTest::testName()
+{
+    return "CCBReader::readNodeGraphFromFile (uncached)";
+}
+
+////////////////////////////////////////////////////////
+//
+// CCBReaderTemplateTest
+//
+////////////////////////////////////////////////////////
+std::string CCBReaderTemplateTest::title() const
+{
+    return "CCBReader with template cache";
+}
+
+std::string CCBReaderTemplateTest::subtitle() const
+{
+    return "Same file, instantiated from its cached template. See console";
+}
+
+const char*  CCBReaderTemplateTest::testName()
+{
+    return "CCBReader::readNodeGraphFromFile (cached)";
+}
+
 ///----------------------------------------
 void runAllocPerformanceTest()
 {
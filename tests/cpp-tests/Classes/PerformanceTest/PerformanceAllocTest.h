@@ -5,6 +5,7 @@
 #define __PERFORMANCE_ALLOC_TEST_H__
 
 #include "PerformanceTest.h"
+#include "cocosbuilder/CocosBuilder.h"
 
 class AllocBasicLayer : public PerformBasicLayer
 {
@@ -115,6 +116,82 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class SpriteCreateAddChildTest : public PerformceAllocScene
+{
+public:
+    CREATE_FUNC(SpriteCreateAddChildTest);
+
+    virtual void updateQuantityOfNodes();
+    virtual void initWithQuantityOfNodes(unsigned int nNodes);
+    virtual void update(float dt);
+    virtual const char* testName();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    Node* _spawnLayer;
+};
+
+class PrefabInstantiateTest : public PerformceAllocScene
+{
+public:
+    CREATE_FUNC(PrefabInstantiateTest);
+
+    PrefabInstantiateTest() : _spawnLayer(nullptr), _prefab(nullptr) {}
+    virtual ~PrefabInstantiateTest();
+
+    virtual void updateQuantityOfNodes();
+    virtual void initWithQuantityOfNodes(unsigned int nNodes);
+    virtual void update(float dt);
+    virtual const char* testName();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    Node* _spawnLayer;
+    Prefab* _prefab;
+};
+
+class CCBReaderReadTest : public PerformceAllocScene
+{
+public:
+    CREATE_FUNC(CCBReaderReadTest);
+
+    CCBReaderReadTest() : _spawnLayer(nullptr), _nodeLoaderLibrary(nullptr) {}
+    virtual ~CCBReaderReadTest();
+
+    virtual void updateQuantityOfNodes();
+    virtual void initWithQuantityOfNodes(unsigned int nNodes);
+    virtual void update(float dt);
+    virtual const char* testName();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onExitTransitionDidStart() override;
+
+protected:
+    virtual bool isTemplateCacheEnabled() const { return false; }
+
+    Node* _spawnLayer;
+    cocosbuilder::NodeLoaderLibrary* _nodeLoaderLibrary;
+};
+
+class CCBReaderTemplateTest : public CCBReaderReadTest
+{
+public:
+    CREATE_FUNC(CCBReaderTemplateTest);
+
+    virtual const char* testName();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    virtual bool isTemplateCacheEnabled() const override { return true; }
+};
 
 void runAllocPerformanceTest();
 
@@ -38,6 +38,7 @@ static std::function<PerformanceEventDispatcherScene*()> createFunctions[] =
     CL(TouchEventDispatchingPerfTest),
     CL(KeyboardEventDispatchingPerfTest),
     CL(CustomEventDispatchingPerfTest),
+    CL(CustomEventListenerCountPerfTest),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -781,6 +782,94 @@ std::string CustomEventDispatchingPerfTest::subtitle() const
     return "Test 'custom-scenegraph', See console";
 }
 
+////////////////////////////////////////////////////////
+//
+// CustomEventListenerCountPerfTest
+//
+////////////////////////////////////////////////////////
+
+static const char* LISTENER_COUNT_EVENT_NAME = "custom_event_listener_count";
+static const int LISTENER_COUNT_DISPATCHES = 100;
+
+void CustomEventListenerCountPerfTest::onExit()
+{
+    setListenerCount(0);
+    PerformanceEventDispatcherScene::onExit();
+}
+
+void CustomEventListenerCountPerfTest::setListenerCount(int count)
+{
+    if ((int)_countListeners.size() == count)
+        return;
+    
+    for (auto& l : _countListeners)
+    {
+        _eventDispatcher->removeEventListener(l);
+    }
+    _countListeners.clear();
+    
+    for (int i = 0; i < count; ++i)
+    {
+        auto listener = EventListenerCustom::create(LISTENER_COUNT_EVENT_NAME, [](EventCustom* event){});
+        _eventDispatcher->addEventListenerWithFixedPriority(listener, i + 1);
+        _countListeners.push_back(listener);
+    }
+}
+
+void CustomEventListenerCountPerfTest::generateTestFunctions()
+{
+    // like the events the director dispatches every frame, the event is created once with the interned id of its name
+    auto dispatchByID = [=](int listenerCount){
+        auto dispatcher = Director::getInstance()->getEventDispatcher();
+        this->setListenerCount(listenerCount);
+        
+        static EventCustom event(EventListener::internListenerID(LISTENER_COUNT_EVENT_NAME));
+        
+        CC_PROFILER_START(this->profilerName());
+        for (int i = 0; i < LISTENER_COUNT_DISPATCHES; ++i)
+        {
+            dispatcher->dispatchEvent(&event);
+        }
+        CC_PROFILER_STOP(this->profilerName());
+    };
+    
+    auto dispatchByName = [=](int listenerCount){
+        auto dispatcher = Director::getInstance()->getEventDispatcher();
+        this->setListenerCount(listenerCount);
+        
+        CC_PROFILER_START(this->profilerName());
+        for (int i = 0; i < LISTENER_COUNT_DISPATCHES; ++i)
+        {
+            dispatcher->dispatchCustomEvent(LISTENER_COUNT_EVENT_NAME);
+        }
+        CC_PROFILER_STOP(this->profilerName());
+    };
+    
+    TestFunction testFunctions[] = {
+        { "0-listeners",            [=](){ dispatchByID(0); } },
+        { "1-listener",             [=](){ dispatchByID(1); } },
+        { "1000-listeners",         [=](){ dispatchByID(1000); } },
+        { "0-listeners-by-name",    [=](){ dispatchByName(0); } },
+        { "1-listener-by-name",     [=](){ dispatchByName(1); } },
+        { "1000-listeners-by-name", [=](){ dispatchByName(1000); } },
+    };
+    
+    for (const auto& func : testFunctions)
+    {
+        _testFunctions.push_back(func);
+    }
+}
+
+std::string CustomEventListenerCountPerfTest::title() const
+{
+    return "Custom Event Listener Count Perf test";
+}
+
+std::string CustomEventListenerCountPerfTest::subtitle() const
+{
+    return "Test '0-listeners', 100 dispatches per sample, See console";
+}
+
 ///----------------------------------------
 void runEventDispatcherPerformanceTest()
 {
@@ -100,6 +100,24 @@ private:
     std::vector<EventListener*> _customListeners;
 };
 
+class CustomEventListenerCountPerfTest : public PerformanceEventDispatcherScene
+{
+public:
+    CREATE_FUNC(CustomEventListenerCountPerfTest);
+    
+    virtual void onExit() override;
+    
+    virtual void generateTestFunctions() override;
+    
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    
+private:
+    void setListenerCount(int count);
+    
+    std::vector<EventListener*> _countListeners;
+};
+
 void runEventDispatcherPerformanceTest();
 
 #endif /* defined(__PERFORMANCE_EVENTDISPATCHER_TEST_H__) */
@@ -53,3 +53,137 @@ void runRendererTest()
     auto scene = RenderTestLayer::scene();
     Director::getInstance()->replaceScene(scene);
 }
+
+////////////////////////////////////////////////////////
+//
+// UniformUploadTestLayer
+//
+////////////////////////////////////////////////////////
+
+static const int kUniformTestMaxNodes = 2000;
+static const int kUniformTestNodesIncrease = 100;
+
+UniformUploadTestLayer::UniformUploadTestLayer()
+: PerformBasicLayer(false)
+, _nodes(nullptr)
+, _infoLabel(nullptr)
+, _uploadsLabel(nullptr)
+, _quantityOfNodes(kUniformTestNodesIncrease)
+, _frames(0)
+, _uploads(0)
+{
+}
+
+Scene* UniformUploadTestLayer::scene()
+{
+    auto scene = Scene::create();
+    UniformUploadTestLayer *layer = new (std::nothrow) UniformUploadTestLayer();
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+void UniformUploadTestLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto title = Label::createWithTTF("Uniform uploads", "fonts/arial.ttf", 32);
+    title->setPosition(Vec2(s.width/2, s.height-32));
+    addChild(title, 1);
+
+    auto subtitle = Label::createWithTTF("Sprites alternating 3 programs, + and - change their number", "fonts/Thonburi.ttf", 16);
+    subtitle->setPosition(Vec2(s.width/2, s.height-80));
+    addChild(subtitle, 1);
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", [&](Ref *sender) {
+        _quantityOfNodes = std::max(_quantityOfNodes - kUniformTestNodesIncrease, kUniformTestNodesIncrease);
+        updateQuantityOfNodes();
+    });
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", [&](Ref *sender) {
+        _quantityOfNodes = std::min(_quantityOfNodes + kUniformTestNodesIncrease, kUniformTestMaxNodes);
+        updateQuantityOfNodes();
+    });
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, nullptr);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height/2+15));
+    addChild(menu, 1);
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 30);
+    _infoLabel->setColor(Color3B(0,200,20));
+    _infoLabel->setPosition(Vec2(s.width/2, s.height/2-15));
+    addChild(_infoLabel, 1);
+
+    _uploadsLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    _uploadsLabel->setPosition(Vec2(s.width/2, s.height/2-50));
+    addChild(_uploadsLabel, 1);
+
+    _nodes = Node::create();
+    addChild(_nodes);
+
+    updateQuantityOfNodes();
+    scheduleUpdate();
+}
+
+void UniformUploadTestLayer::onExit()
+{
+    unscheduleUpdate();
+    PerformBasicLayer::onExit();
+}
+
+void UniformUploadTestLayer::updateQuantityOfNodes()
+{
+    static const char* programs[] = {
+        GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP,
+        GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR,
+        GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV,
+    };
+
+    auto s = Director::getInstance()->getWinSize();
+    _nodes->removeAllChildren();
+    for (int i = 0; i < _quantityOfNodes; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossinis_sister1.png");
+        sprite->setGLProgram(GLProgramCache::getInstance()->getGLProgram(programs[i % 3]));
+        sprite->setScale(0.2f);
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        _nodes->addChild(sprite);
+    }
+
+    _infoLabel->setString(StringUtils::format("%d nodes", _quantityOfNodes));
+    _frames = 0;
+    _uploads = 0;
+    GLProgram::resetUniformUploadCount();
+}
+
+void UniformUploadTestLayer::update(float dt)
+{
+    // the count covers the frame rendered since the previous update
+    _uploads += GLProgram::getUniformUploadCount();
+    GLProgram::resetUniformUploadCount();
+
+    if (++_frames == 60)
+    {
+        auto stats = StringUtils::format("%.1f glUniform calls per frame", _uploads / (float)_frames);
+        _uploadsLabel->setString(stats);
+        CCLOG("UniformUploadTest: %d nodes, %s", _quantityOfNodes, stats.c_str());
+        _frames = 0;
+        _uploads = 0;
+    }
+}
+
+void UniformUploadTestLayer::showCurrentTest()
+{
+}
+
+void runUniformUploadTest()
+{
+    auto scene = UniformUploadTestLayer::scene();
+    Director::getInstance()->replaceScene(scene);
+}
@@ -24,5 +24,31 @@ public:
     static Scene* scene();
 };
 
+// Counts the glUniform calls of a frame drawing nodes which use different programs,
+// so that every batch sets the builtin uniforms again.
+class UniformUploadTestLayer : public PerformBasicLayer
+{
+public:
+    UniformUploadTestLayer();
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual void showCurrentTest() override;
+
+    void updateQuantityOfNodes();
+
+    static Scene* scene();
+
+protected:
+    Node* _nodes;
+    Label* _infoLabel;
+    Label* _uploadsLabel;
+    int _quantityOfNodes;
+    unsigned int _frames;
+    unsigned int _uploads;
+};
+
 void runRendererTest();
+void runUniformUploadTest();
 #endif
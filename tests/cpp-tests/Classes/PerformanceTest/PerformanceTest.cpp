@@ -32,6 +32,7 @@ struct {
 	{ "Touches Perf Test",[](Ref*sender){runTouchesTest();} },
     { "Label Perf Test",[](Ref*sender){runLabelTest();} },
     //{ "Renderer Perf Test",[](Ref*sender){runRendererTest();} },
+    { "Uniform Perf Test",[](Ref*sender){runUniformUploadTest();} },
     { "Container Perf Test", [](Ref* sender ) { runContainerPerformanceTest(); } },
     { "EventDispatcher Perf Test", [](Ref* sender ) { runEventDispatcherPerformanceTest(); } },
     { "Scenario Perf Test", [](Ref* sender ) { runScenarioTest(); } },
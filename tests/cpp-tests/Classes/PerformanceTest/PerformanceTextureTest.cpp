@@ -1,4 +1,5 @@
 #include "PerformanceTextureTest.h"
+#include "base/etc1.h"
 
 enum
 {
@@ -333,6 +334,60 @@ void TextureTest::performTests()
 //     else
 //         log("ERROR");
 //     cache->removeTexture(texture);
+
+    performTestsCompressed();
+}
+
+void TextureTest::performTestsCompressed()
+{
+    // Atlases are synthesized, any bit pattern is a valid ETC1/S3TC block.
+    const int size = 2048;
+    struct timeval now;
+    
+    log("--- SOFTWARE DECODE %dx%d ---", size, size);
+    log("worker threads: %d", ThreadPool::getInstance()->getThreadCount());
+
+    std::vector<unsigned char> etcData(ETC_PKM_HEADER_SIZE + etc1_get_encoded_data_size(size, size));
+    etc1_pkm_format_header(&etcData[0], size, size);
+    for (size_t i = ETC_PKM_HEADER_SIZE; i < etcData.size(); ++i)
+        etcData[i] = (unsigned char)rand();
+
+    log("ETC1 %s", Configuration::getInstance()->supportsETC() ? "(hardware supported, not decoded)" : "");
+    auto image = new (std::nothrow) Image();
+    gettimeofday(&now, nullptr);
+    if (image->initWithImageData(&etcData[0], etcData.size()))
+        log("  ms:%f", calculateDeltaTime(&now) );
+    else
+        log(" ERROR");
+    image->release();
+
+    // DDS header: "DDS " + DDSURFACEDESC2, followed by a full DXT5 mipmap chain
+    const int headerSize = 128;
+    int levels = 0;
+    size_t dataSize = headerSize;
+    for (int w = size; w > 0; w >>= 1, ++levels)
+        dataSize += MAX(w / 4, 1) * MAX(w / 4, 1) * 16;
+
+    std::vector<unsigned char> ddsData(dataSize, 0);
+    auto writeUInt32 = [&ddsData](size_t offset, uint32_t value) { memcpy(&ddsData[offset], &value, 4); };
+    memcpy(&ddsData[0], "DDS ", 4);
+    writeUInt32(4, 124);
+    writeUInt32(12, size);
+    writeUInt32(16, size);
+    writeUInt32(28, levels);
+    writeUInt32(76, 32);
+    memcpy(&ddsData[84], "DXT5", 4);
+    for (size_t i = headerSize; i < ddsData.size(); ++i)
+        ddsData[i] = (unsigned char)rand();
+
+    log("S3TC DXT5 + %d mipmaps %s", levels - 1, Configuration::getInstance()->supportsS3TC() ? "(hardware supported, not decoded)" : "");
+    image = new (std::nothrow) Image();
+    gettimeofday(&now, nullptr);
+    if (image->initWithImageData(&ddsData[0], ddsData.size()))
+        log("  ms:%f", calculateDeltaTime(&now) );
+    else
+        log(" ERROR");
+    image->release();
 }
 
 std::string TextureTest::title() const
@@ -31,6 +31,7 @@ public:
     virtual std::string title() const override;
     virtual std::string subtitle() const override;
     void performTestsPNG(const char* filename);
+    void performTestsCompressed();
 
     static Scene* scene();
 };
@@ -1,5 +1,6 @@
 #include "TileMapTest.h"
 #include "../testResource.h"
+#include <chrono>
 
 enum 
 {
@@ -25,7 +26,7 @@ enum
 
 static int sceneIdx = -1;
 
-#define MAX_LAYER    29
+#define MAX_LAYER    31
 
 static std::function<Layer*()> createFunctions[] = {
     CLN(TMXIsoZorder),
@@ -57,6 +58,8 @@ static std::function<Layer*()> createFunctions[] = {
     CLN(TMXBug987),
     CLN(TMXBug787),
     CLN(TMXGIDObjectsTest),
+    CLN(TMXOrthoCSVTest),
+    CLN(TMXBinaryCacheTest),
 
 };
 
@@ -1508,3 +1511,125 @@ std::string TMXGIDObjectsTest::subtitle() const
 {
     return "Tiles are created from an object group";
 }
+
+//------------------------------------------------------------------
+//
+// TMXOrthoCSVTest
+//
+//------------------------------------------------------------------
+TMXOrthoCSVTest::TMXOrthoCSVTest()
+{
+    auto map = TMXTiledMap::create("TileMaps/orthogonal-test-csv.tmx");
+    addChild(map, 0, kTagTileMap);
+
+    Size CC_UNUSED s = map->getContentSize();
+    CCLOG("ContentSize: %f, %f", s.width,s.height);
+
+    // the same map, gzip compressed
+    auto reference = TMXMapInfo::create("TileMaps/orthogonal-test2.tmx");
+    auto layer = map->getLayer("Layer 0");
+    auto referenceLayer = reference->getLayers().at(0);
+    Size layerSize = layer->getLayerSize();
+    bool same = (layerSize.equals(referenceLayer->_layerSize)
+                 && memcmp(layer->getTiles(), referenceLayer->_tiles, layerSize.width * layerSize.height * sizeof(uint32_t)) == 0);
+    CCLOG("csv tiles %s the gzip compressed ones", same ? "match" : "DON'T match");
+
+    map->runAction( ScaleBy::create(2, 0.5f) ) ;
+}
+
+std::string TMXOrthoCSVTest::title() const
+{
+    return "TMX CSV encoding";
+}
+
+std::string TMXOrthoCSVTest::subtitle() const
+{
+    return "Should look like TMX Orthogonal test";
+}
+
+//------------------------------------------------------------------
+//
+// TMXBinaryCacheTest
+//
+//------------------------------------------------------------------
+TMXBinaryCacheTest::TMXBinaryCacheTest()
+{
+    const std::string tmxFile = "TileMaps/iso-test-objectgroup.tmx";
+    const int loops = 20;
+
+    auto load = [&](TMXMapInfo** mapInfo) -> double {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loops; ++i)
+        {
+            *mapInfo = TMXMapInfo::create(tmxFile);
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    };
+
+    TMXMapInfo::purgeBinaryCache();
+    TMXMapInfo* parsed = nullptr;
+    TMXMapInfo* cached = nullptr;
+    TMXMapInfo::setBinaryCacheEnabled(false);
+    double parseTime = load(&parsed);
+    TMXMapInfo::setBinaryCacheEnabled(true);
+    // writes the cache
+    TMXMapInfo::create(tmxFile);
+    double cacheTime = load(&cached);
+
+    // the objects are cached in points, a cache written with another content scale factor isn't loaded
+    auto director = Director::getInstance();
+    const float scaleFactor = director->getContentScaleFactor();
+    director->setContentScaleFactor(scaleFactor * 2);
+    auto scaledCached = TMXMapInfo::create(tmxFile);
+    TMXMapInfo::setBinaryCacheEnabled(false);
+    auto scaledParsed = TMXMapInfo::create(tmxFile);
+    director->setContentScaleFactor(scaleFactor);
+
+    bool same = (parsed->getLayers().size() == cached->getLayers().size()
+                 && parsed->getTilesets().size() == cached->getTilesets().size()
+                 && parsed->getObjectGroups().size() == cached->getObjectGroups().size()
+                 && parsed->getProperties() == cached->getProperties());
+    for (ssize_t i = 0; same && i < parsed->getLayers().size(); ++i)
+    {
+        auto parsedLayer = parsed->getLayers().at(i);
+        auto cachedLayer = cached->getLayers().at(i);
+        same = (parsedLayer->_name == cachedLayer->_name
+                && parsedLayer->_layerSize.equals(cachedLayer->_layerSize)
+                && memcmp(parsedLayer->_tiles, cachedLayer->_tiles, parsedLayer->_layerSize.width * parsedLayer->_layerSize.height * sizeof(uint32_t)) == 0);
+    }
+    for (ssize_t i = 0; same && i < parsed->getObjectGroups().size(); ++i)
+    {
+        same = (parsed->getObjectGroups().at(i)->getObjects() == cached->getObjectGroups().at(i)->getObjects()
+                && scaledParsed->getObjectGroups().at(i)->getObjects() == scaledCached->getObjectGroups().at(i)->getObjects());
+    }
+
+    auto map = TMXTiledMap::create(tmxFile);
+    addChild(map, -1, kTagTileMap);
+
+    auto s = Director::getInstance()->getWinSize();
+    std::string msg = same ? "The cached map is the same" : "The cached map is different!";
+    auto label = Label::createWithSystemFont(msg, "", 20);
+    label->setPosition(s.width/2, s.height/3*2);
+    this->addChild(label);
+
+    msg = StringUtils::format("%d loads: %.2f ms parsed, %.2f ms cached", loops, parseTime, cacheTime);
+    label = Label::createWithSystemFont(msg, "", 20);
+    label->setPosition(s.width/2, s.height/3);
+    this->addChild(label);
+}
+
+void TMXBinaryCacheTest::onExit()
+{
+    TMXMapInfo::purgeBinaryCache();
+    TileDemo::onExit();
+}
+
+std::string TMXBinaryCacheTest::title() const
+{
+    return "TMX binary cache";
+}
+
+std::string TMXBinaryCacheTest::subtitle() const
+{
+    return "Loads a map parsed and from its binary cache";
+}
@@ -286,6 +286,23 @@ public:
     virtual std::string subtitle() const override;    
 };
 
+class TMXOrthoCSVTest : public TileDemo
+{
+public:
+    TMXOrthoCSVTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class TMXBinaryCacheTest : public TileDemo
+{
+public:
+    TMXBinaryCacheTest();
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 class TileMapTestScene : public TestScene
 {
 public:
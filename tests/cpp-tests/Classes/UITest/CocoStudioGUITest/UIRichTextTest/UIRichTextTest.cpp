@@ -1,6 +1,7 @@
 
 
 #include "UIRichTextTest.h"
+#include <chrono>
 #include "cocostudio/CCArmatureDataManager.h"
 #include "cocostudio/CCArmature.h"
 
@@ -114,3 +115,58 @@ void UIRichTextTest::touchEvent(Ref *pSender, Widget::TouchEventType type)
             break;
     }
 }
+
+// UIRichTextChatTest
+
+bool UIRichTextChatTest::init()
+{
+    if (UIScene::init())
+    {
+        Size widgetSize = _widget->getContentSize();
+
+        Text *alert = Text::create("RichText chat log, 200 messages", "fonts/Marker Felt.ttf", 20);
+        alert->setColor(Color3B(159, 168, 176));
+        alert->setPosition(Vec2(widgetSize.width / 2.0f, widgetSize.height / 2.0f - alert->getContentSize().height * 4.5f));
+        _widget->addChild(alert);
+
+        static const char* names[] = { "Alice", "Bob", "Carol", "Dave" };
+        static const Color3B colors[] = { Color3B::YELLOW, Color3B::GREEN, Color3B::ORANGE, Color3B::MAGENTA };
+
+        RichText* richText = RichText::create();
+        richText->ignoreContentAdaptWithSize(false);
+        richText->setContentSize(Size(widgetSize.width * 0.8f, 6000.0f));
+        richText->setVerticalSpace(2.0f);
+        for (int i = 0; i < 200; ++i)
+        {
+            int speaker = i % 4;
+            richText->pushBackElement(RichElementText::create(i, colors[speaker], 255, StringUtils::format("%s: ", names[speaker]), "fonts/Marker Felt.ttf", 14));
+            richText->pushBackElement(RichElementText::create(i, Color3B::WHITE, 255, StringUtils::format("message %d, long enough to be wrapped on the next row of the chat window.", i), "fonts/arial.ttf", 12));
+            if (i % 10 == 0)
+            {
+                richText->pushBackElement(RichElementImage::create(i, Color3B::WHITE, 255, "cocosui/sliderballnormal.png"));
+            }
+            richText->pushBackElement(RichElementText::create(i, Color3B::WHITE, 255, "\n", "fonts/arial.ttf", 12));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        richText->formatText();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        ui::ScrollView* scrollView = ui::ScrollView::create();
+        scrollView->setContentSize(Size(widgetSize.width * 0.8f, widgetSize.height * 0.5f));
+        scrollView->setInnerContainerSize(richText->getContentSize());
+        scrollView->setPosition(Vec2(widgetSize.width * 0.1f, widgetSize.height * 0.25f));
+        richText->setAnchorPoint(Vec2::ZERO);
+        richText->setPosition(Vec2::ZERO);
+        scrollView->addChild(richText);
+        _widget->addChild(scrollView);
+        scrollView->jumpToTop();
+
+        Text *timing = Text::create(StringUtils::format("formatText: %.2f ms", duration.count() / 1000.0f), "fonts/Marker Felt.ttf", 16);
+        timing->setPosition(Vec2(widgetSize.width / 2.0f, widgetSize.height * 0.2f));
+        _widget->addChild(timing);
+
+        return true;
+    }
+    return false;
+}
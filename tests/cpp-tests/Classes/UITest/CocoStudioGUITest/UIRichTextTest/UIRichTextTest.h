@@ -20,4 +20,13 @@ protected:
     RichText* _richText;
 };
 
+class UIRichTextChatTest : public UIScene
+{
+public:
+    bool init();
+
+protected:
+    UI_SCENE_CREATE_FUNC(UIRichTextChatTest)
+};
+
 #endif /* defined(__TestCpp__UIRichTextTest__) */
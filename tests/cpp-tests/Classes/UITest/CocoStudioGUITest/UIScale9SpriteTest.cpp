@@ -769,3 +769,40 @@ bool UIS9ChangeAnchorPoint::init()
     }
     return false;
 }
+
+// UIS9ResizeEveryFrame
+
+bool UIS9ResizeEveryFrame::init()
+{
+    if (UIScene::init()) {
+        SpriteFrameCache::getInstance()->addSpriteFramesWithFile(s_s9s_blocks9_plist);
+        
+        auto winSize = Director::getInstance()->getWinSize();
+        static const char* frameNames[] = { "blocks9.png", "blocks9r.png", "blocks9cr.png" };
+        
+        _elapsed = 0;
+        for (int i = 0; i < 300; i++)
+        {
+            auto sprite = ui::Scale9Sprite::createWithSpriteFrameName(frameNames[i % 3]);
+            sprite->setPosition(Vec2(winSize.width * (0.1f + 0.8f * (i % 20) / 19.0f),
+                                     winSize.height * (0.25f + 0.5f * (i / 20) / 14.0f)));
+            this->addChild(sprite);
+            _sprites.pushBack(sprite);
+        }
+        
+        scheduleUpdate();
+        return true;
+    }
+    return false;
+}
+
+void UIS9ResizeEveryFrame::update(float dt)
+{
+    _elapsed += dt;
+    float width = 40 + 30 * sinf(_elapsed * 2);
+    float height = 30 + 20 * cosf(_elapsed * 3);
+    for (auto& sprite : _sprites)
+    {
+        sprite->setContentSize(Size(width, height));
+    }
+}
@@ -289,4 +289,20 @@ protected:
     UI_SCENE_CREATE_FUNC(UIS9ChangeAnchorPoint)
 };
 
+// Scale9Sprite resized every frame, with plain, rotated and cropped rotated frames
+
+class UIS9ResizeEveryFrame : public UIScene
+{
+public:
+    CREATE_FUNC(UIS9ResizeEveryFrame);
+    
+    bool init();
+    virtual void update(float dt) override;
+protected:
+    UI_SCENE_CREATE_FUNC(UIS9ResizeEveryFrame)
+    
+    Vector<ui::Scale9Sprite*> _sprites;
+    float _elapsed;
+};
+
 #endif /* defined(__cocos2d_tests__UIScale9SpriteTest__) */
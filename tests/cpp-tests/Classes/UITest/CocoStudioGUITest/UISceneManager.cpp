@@ -99,6 +99,7 @@ static const char* s_testArray[] =
    
     "UIWidgetAddNodeTest",
     "UIRichTextTest",
+    "UIRichTextChatTest",
     "UIFocusTest-HBox",
     "UIFocusTest-VBox",
     "UIFocusTest-NestedLayout1",
@@ -133,6 +134,7 @@ static const char* s_testArray[] =
     "UIS9ZOrder",
     "UIS9Flip",
     "UIS9ChangeAnchorPoint",
+    "UIS9ResizeEveryFrame",
 };
 
 static UISceneManager *sharedInstance = nullptr;
@@ -337,6 +339,8 @@ Scene *UISceneManager::currentUIScene()
             
         case kUIRichTextTest:
             return UIRichTextTest::sceneWithTitle(s_testArray[_currentUISceneId]);
+        case kUIRichTextChatTest:
+            return UIRichTextChatTest::sceneWithTitle(s_testArray[_currentUISceneId]);
         case KUIFocusTest_HBox:
             return UIFocusTestHorizontal::sceneWithTitle(s_testArray[_currentUISceneId]);
         case KUIFocusTest_VBox:
@@ -401,6 +405,8 @@ Scene *UISceneManager::currentUIScene()
             return UIS9Flip::sceneWithTitle(s_testArray[_currentUISceneId]);
         case kUIS9ChangeAnchorPoint:
             return UIS9ChangeAnchorPoint::sceneWithTitle(s_testArray[_currentUISceneId]);
+        case kUIS9ResizeEveryFrame:
+            return UIS9ResizeEveryFrame::sceneWithTitle(s_testArray[_currentUISceneId]);
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
         case kUIEditBoxTest:
             return UIEditBoxTest::sceneWithTitle(s_testArray[_currentUISceneId]);
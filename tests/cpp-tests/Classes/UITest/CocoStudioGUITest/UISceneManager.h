@@ -90,6 +90,7 @@ enum
     kUIListViewTest_Horizontal,
     kUIWidgetAddNodeTest,
     kUIRichTextTest,
+    kUIRichTextChatTest,
     KUIFocusTest_HBox,
     KUIFocusTest_VBox,
     KUIFocusTest_NestedLayout1,
@@ -124,6 +125,7 @@ enum
     kUIS9ZOrder,
     kUIS9Flip,
     kUIS9ChangeAnchorPoint,
+    kUIS9ResizeEveryFrame,
     kUITestMax
 };
 
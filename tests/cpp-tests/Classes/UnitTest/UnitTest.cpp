@@ -1,5 +1,7 @@
 #include "UnitTest.h"
 #include "RefPtrTest.h"
+#include "extensions/cocos-ext.h"
+#include "curl/curl.h"
 
 // For ' < o > ' multiply test scene.
 
@@ -8,7 +10,11 @@ static std::function<Layer*()> createFunctions[] = {
     CL(TemplateMapTest),
     CL(ValueTest),
     CL(RefPtrTest),
-    CL(UTFConversionTest)
+    CL(UTFConversionTest),
+    CL(ValueBinaryTest),
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_EMSCRIPTEN) && (CC_TARGET_PLATFORM != CC_PLATFORM_NACL) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    CL(AssetsManagerResumeTest)
+#endif
 };
 
 static int sceneIdx = -1;
@@ -816,3 +822,315 @@ std::string UTFConversionTest::subtitle() const
 {
     return "UTF8 <-> UTF16 Conversion Test, no crash";
 }
+
+// ValueBinaryTest
+
+// Value::operator== doesn't compare the sizes of containers
+static bool isSameValue(const Value& a, const Value& b)
+{
+    if (a.getType() != b.getType())
+        return false;
+
+    switch (a.getType())
+    {
+        case Value::Type::DOUBLE:
+            return a.asDouble() == b.asDouble();
+        case Value::Type::VECTOR:
+        {
+            const auto& v1 = a.asValueVector();
+            const auto& v2 = b.asValueVector();
+            if (v1.size() != v2.size())
+                return false;
+            for (size_t i = 0; i < v1.size(); ++i)
+            {
+                if (!isSameValue(v1[i], v2[i]))
+                    return false;
+            }
+            return true;
+        }
+        case Value::Type::MAP:
+        {
+            const auto& m1 = a.asValueMap();
+            const auto& m2 = b.asValueMap();
+            if (m1.size() != m2.size())
+                return false;
+            for (const auto& kvp : m1)
+            {
+                auto iter = m2.find(kvp.first);
+                if (iter == m2.end() || !isSameValue(kvp.second, iter->second))
+                    return false;
+            }
+            return true;
+        }
+        case Value::Type::INT_KEY_MAP:
+        {
+            const auto& m1 = a.asIntKeyMap();
+            const auto& m2 = b.asIntKeyMap();
+            if (m1.size() != m2.size())
+                return false;
+            for (const auto& kvp : m1)
+            {
+                auto iter = m2.find(kvp.first);
+                if (iter == m2.end() || !isSameValue(kvp.second, iter->second))
+                    return false;
+            }
+            return true;
+        }
+        default:
+            return a == b;
+    }
+}
+
+static Value createValueBinarySample()
+{
+    ValueMap frame;
+    frame["x"] = Value(12);
+    frame["y"] = Value(-34);
+    frame["rotated"] = Value(true);
+    frame["offset"] = Value("{0,-2}");
+
+    ValueMap frames;
+    frames["hero_01.png"] = Value(frame);
+    frames["hero_02.png"] = Value(frame);
+
+    ValueMapIntKey tiles;
+    tiles[-7] = Value("negative");
+    tiles[0] = Value(0.5f);
+    tiles[1024] = Value(ValueVector());
+
+    ValueVector vector;
+    vector.push_back(Value(1.0 / 3.0));
+    vector.push_back(Value(false));
+    vector.push_back(Value(ValueMap()));
+    vector.push_back(Value(ValueMapIntKey()));
+    vector.push_back(Value(frame));
+
+    ValueMap root;
+    root["byte"] = Value((unsigned char)200);
+    root["int"] = Value(-2147483647 - 1);
+    root["float"] = Value(-101.25f);
+    root["double"] = Value(106.1);
+    root["true"] = Value(true);
+    root["false"] = Value(false);
+    root["string"] = Value("string");
+    root["empty string"] = Value("");
+    root["long string"] = Value(std::string(100000, 'a') + "b");
+    root["frames"] = Value(frames);
+    root["tiles"] = Value(tiles);
+    root["vector"] = Value(vector);
+    root["empty vector"] = Value(ValueVector());
+    root["empty map"] = Value(ValueMap());
+    root["empty int key map"] = Value(ValueMapIntKey());
+    return Value(root);
+}
+
+static void doValueBinaryRoundTrip()
+{
+    Value sample = createValueBinarySample();
+    Data data = ValueBinary::encode(sample);
+    CCASSERT(!data.isNull() && ValueBinary::isValueBinary(data.getBytes(), data.getSize()), "ValueBinary::encode failed");
+    CCASSERT(isSameValue(ValueBinary::decode(data.getBytes(), data.getSize()), sample), "ValueBinary::decode of a map failed");
+
+    ValueVector vector;
+    vector.push_back(sample);
+    vector.push_back(Value(ValueVector()));
+    Data vectorData = ValueBinary::encode(Value(vector));
+    CCASSERT(isSameValue(ValueBinary::decode(vectorData.getBytes(), vectorData.getSize()), Value(vector)), "ValueBinary::decode of a vector failed");
+
+    CCASSERT(ValueBinary::encode(Value(1)).isNull(), "ValueBinary::encode accepted a scalar root");
+
+    // reading in place
+    ValueBinaryNode root = ValueBinary::getRoot(data.getBytes(), data.getSize());
+    CCASSERT(root.getType() == Value::Type::MAP && root.size() == (ssize_t)sample.asValueMap().size(), "ValueBinaryNode::size failed");
+    CCASSERT(root["byte"].asByte() == 200, "ValueBinaryNode::asByte failed");
+    CCASSERT(root["int"].asInt() == -2147483647 - 1, "ValueBinaryNode::asInt failed");
+    CCASSERT(root["float"].asFloat() == -101.25f, "ValueBinaryNode::asFloat failed");
+    CCASSERT(root["double"].asDouble() == 106.1, "ValueBinaryNode::asDouble failed");
+    CCASSERT(root["true"].asBool() && !root["false"].asBool(), "ValueBinaryNode::asBool failed");
+    CCASSERT(root["frames"]["hero_02.png"]["y"].asInt() == -34, "ValueBinaryNode::operator[] failed");
+    CCASSERT(root["missing"].isNull() && root["frames"]["missing"]["y"].isNull(), "ValueBinaryNode::operator[] found a missing key");
+    CCASSERT(root["tiles"].intKeyAt(0) == -7 && root["tiles"].valueAt(0).asString() == "negative", "int key maps must be sorted");
+    CCASSERT(root["vector"].at(4)["offset"].asString() == "{0,-2}", "ValueBinaryNode::at failed");
+    CCASSERT(root["vector"].at(5).isNull() && root["vector"].at(-1).isNull(), "ValueBinaryNode::at read out of range");
+    CCASSERT(root["empty vector"].size() == 0 && root["empty map"].size() == 0, "empty containers must stay empty");
+
+    ssize_t length = 0;
+    const char* longString = root["long string"].getCString(&length);
+    CCASSERT(length == 100001 && longString[length - 1] == 'b' && longString[length] == '\0', "ValueBinaryNode::getCString failed");
+
+    // keys are sorted by strcmp
+    const char* previous = root.keyAt(0);
+    for (ssize_t i = 1; i < root.size(); ++i)
+    {
+        CCASSERT(strcmp(previous, root.keyAt(i)) < 0, "map keys must be sorted");
+        previous = root.keyAt(i);
+    }
+}
+
+static void doValueBinaryRejection()
+{
+    ValueMap map;
+    map["name"] = Value("value");
+    map["list"] = Value(ValueVector(3, Value(7)));
+    map["number"] = Value(3.5);
+    Data data = ValueBinary::encode(Value(map));
+
+    // every truncation is detected
+    for (ssize_t size = 0; size < data.getSize(); ++size)
+    {
+        CCASSERT(ValueBinary::decode(data.getBytes(), size).isNull(), "ValueBinary::decode accepted truncated data");
+    }
+    CCASSERT(ValueBinary::decode(nullptr, 0).isNull(), "ValueBinary::decode accepted nullptr");
+
+    // corrupted words must not crash, whatever they decode to
+    std::vector<unsigned char> corrupted(data.getBytes(), data.getBytes() + data.getSize());
+    for (size_t i = 4; i + sizeof(uint32_t) <= corrupted.size(); i += sizeof(uint32_t))
+    {
+        const uint32_t patterns[] = { 0, 1, 0x7fffffff, 0xffffffff };
+        for (uint32_t pattern : patterns)
+        {
+            std::vector<unsigned char> bytes(corrupted);
+            memcpy(&bytes[i], &pattern, sizeof(pattern));
+            Value value = ValueBinary::decode(bytes.data(), bytes.size());
+            ValueBinaryNode root = ValueBinary::getRoot(bytes.data(), bytes.size());
+            root["name"].asString();
+            root["list"].at(2).asInt();
+            root["number"].asDouble();
+            CC_UNUSED_PARAM(value);
+        }
+    }
+
+    // header: magic, version, node count, pool size, string count, string bytes,
+    // then a vector node whose only element is itself
+    uint32_t cyclic[] = { 0, 1, 1, 2, 0, 0, (uint32_t)Value::Type::VECTOR, 0, 1, 0 };
+    memcpy(cyclic, "CCVB", 4);
+    Value value = ValueBinary::decode((const unsigned char*)cyclic, sizeof(cyclic));
+    CCASSERT(value.getType() == Value::Type::VECTOR && value.asValueVector().size() == 1 && value.asValueVector()[0].isNull(), "ValueBinary::decode followed a cycle");
+
+    // a container pointing outside of the pool is read as empty
+    uint32_t outOfPool[] = { 0, 1, 1, 2, 0, 0, (uint32_t)Value::Type::MAP, 1000, 0, 0 };
+    memcpy(outOfPool, "CCVB", 4);
+    value = ValueBinary::decode((const unsigned char*)outOfPool, sizeof(outOfPool));
+    CCASSERT(value.getType() == Value::Type::MAP && value.asValueMap().empty(), "ValueBinary::decode read outside of the pool");
+
+    // the version must match
+    uint32_t badVersion[] = { 0, 2, 1, 0, 0, 0, (uint32_t)Value::Type::VECTOR, 0 };
+    memcpy(badVersion, "CCVB", 4);
+    CCASSERT(ValueBinary::decode((const unsigned char*)badVersion, sizeof(badVersion)).isNull(), "ValueBinary::decode accepted an unknown version");
+
+    // nesting deeper than the limit is cut
+    Value deep = Value(ValueVector());
+    for (int i = 0; i < 200; ++i)
+    {
+        deep = Value(ValueVector(1, deep));
+    }
+    Data deepData = ValueBinary::encode(deep);
+    value = ValueBinary::decode(deepData.getBytes(), deepData.getSize());
+    CCASSERT(value.getType() == Value::Type::VECTOR && !isSameValue(value, deep), "ValueBinary::decode ignored the depth limit");
+}
+
+void ValueBinaryTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    doValueBinaryRoundTrip();
+    doValueBinaryRejection();
+}
+
+std::string ValueBinaryTest::subtitle() const
+{
+    return "ValueBinary encode/decode, should not crash";
+}
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_EMSCRIPTEN) && (CC_TARGET_PLATFORM != CC_PLATFORM_NACL) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+
+// AssetsManagerResumeTest
+
+class ResumeTestAssetsManager : public extension::AssetsManager
+{
+public:
+    ResumeTestAssetsManager(const std::string& packageUrl, const std::string& storagePath)
+    : AssetsManager(packageUrl.c_str(), "", storagePath.c_str())
+    {
+    }
+
+    using AssetsManager::downloadPackage;
+};
+
+static void writeTestFile(const std::string& fileName, const std::string& content)
+{
+    FILE* fp = fopen(fileName.c_str(), "wb");
+    CCASSERT(fp, "can't create the test file");
+    fwrite(content.data(), 1, content.size(), fp);
+    fclose(fp);
+}
+
+static bool hasContent(const std::string& fileName, const std::string& content)
+{
+    Data data = FileUtils::getInstance()->getDataFromFile(fileName);
+    return (size_t)data.getSize() == content.size() && memcmp(data.getBytes(), content.data(), content.size()) == 0;
+}
+
+// downloads the package served at packageUrl to a file which already holds partialContent
+static bool downloadTestPackage(ResumeTestAssetsManager* manager, const std::string& packageUrl, const std::string& outFileName,
+                                const std::string& partialContent, bool resume)
+{
+    writeTestFile(outFileName, partialContent);
+
+    void* curl = curl_easy_init();
+    extension::AssetsManager::ErrorCode error;
+    bool succeed = manager->downloadPackage(curl, packageUrl, outFileName, resume, &error);
+    curl_easy_cleanup(curl);
+    return succeed;
+}
+
+void AssetsManagerResumeTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    std::string path = FileUtils::getInstance()->getWritablePath();
+    std::string packageFileName = path + "assets-manager-test-package.zip";
+    std::string outFileName = path + "assets-manager-test-download.zip";
+    std::string packageUrl = std::string("file://") + (path[0] == '/' ? "" : "/") + packageFileName;
+
+    std::string package;
+    for (int i = 0; i < 100000; ++i)
+    {
+        package += (char)('a' + i % 26);
+    }
+    writeTestFile(packageFileName, package);
+
+    // the progress is reported on the cocos thread, the manager must outlive this frame
+    auto manager = new (std::nothrow) ResumeTestAssetsManager(packageUrl, path);
+    manager->autorelease();
+    addChild(manager);
+
+    // an interrupted download continues where it stopped
+    std::string interrupted = package.substr(0, 40000);
+    CCASSERT(downloadTestPackage(manager, packageUrl, outFileName, interrupted, true) && hasContent(outFileName, package),
+             "the interrupted package wasn't resumed");
+
+    // a package which was complete already is kept
+    CCASSERT(downloadTestPackage(manager, packageUrl, outFileName, package, true) && hasContent(outFileName, package),
+             "the complete package was damaged");
+
+    // a range the server can't serve makes the download start again
+    std::string tooLong = package + "garbage";
+    CCASSERT(downloadTestPackage(manager, packageUrl, outFileName, tooLong, true) && hasContent(outFileName, package),
+             "the download didn't start again when the range was refused");
+
+    // nothing is resumed from another version
+    std::string otherVersion = std::string(40000, 'z');
+    CCASSERT(downloadTestPackage(manager, packageUrl, outFileName, otherVersion, false) && hasContent(outFileName, package),
+             "the package of another version was resumed");
+
+    remove(packageFileName.c_str());
+    remove(outFileName.c_str());
+}
+
+std::string AssetsManagerResumeTest::subtitle() const
+{
+    return "AssetsManager resumes downloads, should not crash";
+}
+
+#endif
@@ -61,4 +61,22 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class ValueBinaryTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(ValueBinaryTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_EMSCRIPTEN) && (CC_TARGET_PLATFORM != CC_PLATFORM_NACL) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+class AssetsManagerResumeTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(AssetsManagerResumeTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+#endif
+
 #endif /* __UNIT_TEST__ */
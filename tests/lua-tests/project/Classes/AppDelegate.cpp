@@ -47,7 +47,10 @@ bool AppDelegate::applicationDidFinishLaunching()
     lua_pop(L, 1);
     #endif
 
+    // compiled modules are cached in the writable path, compare the logged load time of the first and next launches
+    stack->openBytecodeCache(FileUtils::getInstance()->getWritablePath() + "lua-tests.luacache");
     pEngine->executeScriptFile("src/controller.lua");
+    stack->saveBytecodeCache();
 
     return true;
 }
@@ -1,6 +1,6 @@
 require "src/PerformanceTest/PerformanceSpriteTest"
 
-local MAX_COUNT     = 6
+local MAX_COUNT     = 7
 local LINE_SPACE    = 40
 local kItemTagBasic = 1000
 
@@ -12,6 +12,7 @@ local testsName =
     "PerformanceTextureTest",
     "PerformanceTouchesTest",
     "PerformanceFuncRelateWithTable",
+    "PerformanceScriptUpdateTest",
 }
 
 local s = cc.Director:getInstance():getWinSize()
@@ -1678,6 +1679,7 @@ local function runFuncRelateWithTable()
     local averageTime2 = 0.0
     local totalTime    = 0.0
     local numberOfCalls = 0
+    local totalGarbage = 0.0
 
     local function GetTitle()
         return "Func Releated Table Performance Test"
@@ -1694,6 +1696,7 @@ local function runFuncRelateWithTable()
         averageTime2 = 0.0
         totalTime    = 0.0
         numberOfCalls = 0
+        totalGarbage = 0.0
     end
 
     --Title
@@ -1751,12 +1754,18 @@ local function runFuncRelateWithTable()
     --setPosition,getPosition,Point
     cc.MenuItemFont:setFontSize(18)
     local setPositionItem = cc.MenuItemFont:create("setPosition")
+    local setPositionXYItem = cc.MenuItemFont:create("setPosition(x, y)")
+    local setPositionArrayItem = cc.MenuItemFont:create("setPosition({x, y})")
     local getPositionItem = cc.MenuItemFont:create("getPosition")
     local getAnchorPointItem = cc.MenuItemFont:create("getAnchorPoint")
+    local getAnchorPointReuseItem = cc.MenuItemFont:create("getAnchorPoint (reused table)")
     local pointItem       = cc.MenuItemFont:create("object")
     local funcToggleItem  = cc.MenuItemToggle:create(setPositionItem)
+    funcToggleItem:addSubItem(setPositionXYItem)
+    funcToggleItem:addSubItem(setPositionArrayItem)
     funcToggleItem:addSubItem(getPositionItem)
     funcToggleItem:addSubItem(getAnchorPointItem)
+    funcToggleItem:addSubItem(getAnchorPointReuseItem)
     funcToggleItem:addSubItem(pointItem)
     funcToggleItem:setAnchorPoint(cc.p(0.0, 0.5))
     funcToggleItem:setPosition(cc.p(VisibleRect:left()))
@@ -1769,10 +1778,24 @@ local function runFuncRelateWithTable()
 
     local function step(dt)
         print(string.format("push num: %d, avg1:%f, avg2:%f,min:%f, max:%f, total: %f, calls: %d",quantityOfNodes, averageTime1, averageTime2, minTime, maxTime, totalTime, numberOfCalls))
+        if totalTime > 0 and numberOfCalls > 0 then
+            print(string.format("calls per second: %d, garbage per frame: %.1f KB", quantityOfNodes * numberOfCalls / totalTime, totalGarbage / numberOfCalls))
+        end
+    end
+
+    -- the collector is stopped while measuring, so the memory growth is the garbage made by the calls
+    local startMemory = 0
+    local function profileBegin()
+        numberOfCalls = numberOfCalls + 1
+        collectgarbage("stop")
+        startMemory = collectgarbage("count")
+        return socket.gettime()
     end
 
     local function profileEnd(startTime)
         local duration = socket.gettime() - startTime
+        totalGarbage = totalGarbage + collectgarbage("count") - startMemory
+        collectgarbage("restart")
         totalTime = totalTime + duration
         averageTime1 = (averageTime1 + duration) / 2
         averageTime2 = totalTime / numberOfCalls
@@ -1787,17 +1810,32 @@ local function runFuncRelateWithTable()
     end
 
     local function callSetPosition()
-        numberOfCalls = numberOfCalls + 1
-        local startTime = socket.gettime()
+        local startTime = profileBegin()
         for i=1,quantityOfNodes do
             testNode:setPosition(cc.p(1,2))
         end
         profileEnd(startTime)
     end
 
+    local function callSetPositionXY()
+        local startTime = profileBegin()
+        for i=1,quantityOfNodes do
+            testNode:setPosition(1, 2)
+        end
+        profileEnd(startTime)
+    end
+
+    local function callSetPositionArray()
+        local pt = {1, 2}
+        local startTime = profileBegin()
+        for i=1,quantityOfNodes do
+            testNode:setPosition(pt)
+        end
+        profileEnd(startTime)
+    end
+
     local function callGetPosition()
-        numberOfCalls = numberOfCalls + 1
-        local startTime = socket.gettime()
+        local startTime = profileBegin()
         for i=1,quantityOfNodes do
             local x,y = testNode:getPosition()
         end
@@ -1805,35 +1843,45 @@ local function runFuncRelateWithTable()
     end
 
     local function callGetAnchorPoint()
-        numberOfCalls = numberOfCalls + 1
-        local startTime = socket.gettime()
+        local startTime = profileBegin()
+        for i=1,quantityOfNodes do
+            local anchorPoint = testNode:getAnchorPoint()
+        end
+        profileEnd(startTime)
+    end
+
+    local function callGetAnchorPointReuse()
+        cc.setValueTableReuse(true)
+        local startTime = profileBegin()
         for i=1,quantityOfNodes do
             local anchorPoint = testNode:getAnchorPoint()
         end
         profileEnd(startTime)
+        cc.setValueTableReuse(false)
     end
 
     local function callTableObject()
-        numberOfCalls = numberOfCalls + 1
-        local startTime = socket.gettime()
+        local startTime = profileBegin()
         for i=1,quantityOfNodes do
             local pt = cc.p(1,2)
         end
         profileEnd(startTime)
     end
 
-    local function update(dt)
+    local testFuncs =
+    {
+        callSetPosition,
+        callSetPositionXY,
+        callSetPositionArray,
+        callGetPosition,
+        callGetAnchorPoint,
+        callGetAnchorPointReuse,
+        callTableObject,
+    }
 
+    local function update(dt)
         local funcSelected = funcToggleItem:getSelectedIndex()
-        if 0 == funcSelected then
-            callSetPosition()
-        elseif 1 == funcSelected then
-            callGetPosition()
-        elseif 2 == funcSelected then
-            callGetAnchorPoint()
-        elseif 3 == funcSelected then
-            callTableObject()
-        end
+        testFuncs[funcSelected + 1]()
     end
 
     local function onNodeEvent(tag)
@@ -1884,6 +1932,121 @@ local function runFuncRelateWithTable()
 end
 
 
+----------------------------------
+--PerformanceScriptUpdateTest
+----------------------------------
+local function runScriptUpdateTest()
+    local newscene  = cc.Scene:create()
+    local layer     = cc.Layer:create()
+    local s         = cc.Director:getInstance():getWinSize()
+    local scheduler = cc.Director:getInstance():getScheduler()
+    local quantityOfNodes = 2000
+    local nodes = {}
+    local startTime = 0.0
+    local totalTime = 0.0
+    local numberOfFrames = 0
+    local scheduleEntryID = 0
+
+    --Title
+    local title = cc.Label:createWithTTF("Script Update Performance Test", s_arialPath, 28)
+    layer:addChild(title, 1)
+    title:setPosition(cc.p(s.width/2, s.height-32))
+    title:setColor(cc.c3b(255,255,40))
+    --Subtitle
+    local subTitle = cc.Label:createWithTTF("Lua 'update' handlers of many nodes, per node or batched", s_thonburiPath, 16)
+    layer:addChild(subTitle, 1)
+    subTitle:setPosition(cc.p(s.width/2, s.height-80))
+
+    local infoLabel = cc.Label:createWithTTF("", s_markerFeltFontPath, 24)
+    infoLabel:setColor(cc.c3b(0,200,20))
+    infoLabel:setPosition(cc.p(s.width/2, s.height/2-40))
+    layer:addChild(infoLabel, 1)
+
+    local function nodeUpdate(dt)
+    end
+
+    local function removeNodes()
+        for _, node in ipairs(nodes) do
+            node:unscheduleUpdate()
+            node:removeFromParent()
+        end
+        nodes = {}
+    end
+
+    local function addNodes()
+        removeNodes()
+        for i = 1, quantityOfNodes do
+            local node = cc.Node:create()
+            layer:addChild(node)
+            node:scheduleUpdateWithPriorityLua(nodeUpdate, 0)
+            nodes[i] = node
+        end
+    end
+
+    -- run just before and just after the node updates, which use priority 0
+    local function beginFrame(dt)
+        startTime = os.clock()
+    end
+
+    local function endFrame(dt)
+        totalTime = totalTime + os.clock() - startTime
+        numberOfFrames = numberOfFrames + 1
+    end
+
+    local beginNode = cc.Node:create()
+    layer:addChild(beginNode)
+    local endNode = cc.Node:create()
+    layer:addChild(endNode)
+
+    local function step(dt)
+        if numberOfFrames > 0 then
+            local mode = scheduler:isScriptUpdateBatchingEnabled() and "batched" or "per node"
+            infoLabel:setString(string.format("%d nodes, %s: %.3f ms per frame", quantityOfNodes, mode, totalTime * 1000 / numberOfFrames))
+        end
+        totalTime = 0.0
+        numberOfFrames = 0
+    end
+
+    cc.MenuItemFont:setFontSize(24)
+    local perNodeItem = cc.MenuItemFont:create("per node dispatch")
+    local batchedItem = cc.MenuItemFont:create("batched dispatch")
+    local modeToggleItem = cc.MenuItemToggle:create(perNodeItem)
+    modeToggleItem:addSubItem(batchedItem)
+    modeToggleItem:registerScriptTapHandler(function()
+        scheduler:setScriptUpdateBatchingEnabled(modeToggleItem:getSelectedIndex() == 1)
+        step(0)
+    end)
+    local modeMenu = cc.Menu:create(modeToggleItem)
+    modeMenu:setPosition(cc.p(s.width/2, s.height/2+20))
+    layer:addChild(modeMenu, 1)
+
+    local function onNodeEvent(tag)
+        if tag == "enter" then
+            addNodes()
+            beginNode:scheduleUpdateWithPriorityLua(beginFrame, -1)
+            endNode:scheduleUpdateWithPriorityLua(endFrame, 1)
+            scheduleEntryID = scheduler:scheduleScriptFunc(step, 1, false)
+        elseif tag == "exit" then
+            removeNodes()
+            beginNode:unscheduleUpdate()
+            endNode:unscheduleUpdate()
+            scheduler:unscheduleScriptEntry(scheduleEntryID)
+            scheduler:setScriptUpdateBatchingEnabled(false)
+        end
+    end
+
+    layer:registerScriptHandler(onNodeEvent)
+
+    --back menu
+    local menu = cc.Menu:create()
+    CreatePerfomBasicLayerMenu(menu)
+    menu:setPosition(cc.p(0, 0))
+    layer:addChild(menu)
+
+    newscene:addChild(layer)
+    return newscene
+end
+
 ------------------------
 --
 ------------------------
@@ -1894,7 +2057,8 @@ local CreatePerformancesTestTable =
     runSpriteTest,
     runTextureTest,
     runTouchesTest,
-    runFuncRelateWithTable,    
+    runFuncRelateWithTable,
+    runScriptUpdateTest,
 }
 
 local function CreatePerformancesTestScene(nPerformanceNo)
@@ -1922,7 +2086,7 @@ local function PerformanceMainLayer()
         item:registerScriptTapHandler(menuCallback)
         item:setPosition(s.width / 2, s.height - i * LINE_SPACE)
         menu:addChild(item, kItemTagBasic + i)
-        if i == MAX_COUNT then
+        if testsName[i] == "PerformanceFuncRelateWithTable" then
             local targetPlatform = cc.Application:getInstance():getTargetPlatform()
             if (cc.PLATFORM_OS_IPHONE ~= targetPlatform) and (cc.PLATFORM_OS_IPAD ~= targetPlatform) and 
                (cc.PLATFORM_OS_ANDROID ~= targetPlatform) and (cc.PLATFORM_OS_WINDOWS ~= targetPlatform) and